@@ -1153,13 +1153,16 @@ function printMember(fullName_m, memName_m, additionalIndices_m) {
 	}
 
 
-	isArray = part_isArray(fullName_m, metaComment);
-	if (isArray) {
+	# a function may have more then one array parameter (eg. the bulk unit
+	# getters are supplied unit IDs and fetch values for them); supplied
+	# arrays have to be tagged first, as their conversion code has to run
+	# before the size of the fetched array is queried
+	_arrayTags = metaComment;
+	while (match(_arrayTags, /ARRAY:[^ \t]+/)) {
 		_refObj = "";
-		_arrayPaNa = metaComment;
+		_arrayPaNa = substr(_arrayTags, RSTART + 6, RLENGTH - 6);
+		_arrayTags = substr(_arrayTags, RSTART + RLENGTH);
 		_addWrappVars = "";
-		sub(/^.*ARRAY:/, "", _arrayPaNa);
-		sub(/[ \t].*$/,  "", _arrayPaNa);
 		if (match(_arrayPaNa, /->/)) {
 			_refObj = _arrayPaNa;
 			sub(/->.*$/, "", _arrayPaNa);
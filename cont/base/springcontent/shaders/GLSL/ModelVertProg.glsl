@@ -6,6 +6,10 @@
 // gl_ClipDistance or gl_ClipPosition are used, so it might
 // be better to use may a `discard` in the fragment shader
 //
+// note: when <instanced> is set the model matrix is taken
+// from the per-instance <instanceMatrix> attribute (used by
+// CUnitDrawer to draw many copies of a piece at once)
+//
 // note: shadow-map texture coordinates should be generated
 // per fragment (the non-linear projection used can produce
 // shifting artefacts with large triangles due to the linear
@@ -37,18 +41,30 @@
 
 uniform int numModelDynLights;
 
+uniform bool instanced;
+attribute mat4 instanceMatrix;
+
 
 void main(void)
 {
+	mat4 modelMatrix  = gl_ModelViewMatrix;
+	mat3 normalMatrix = gl_NormalMatrix;
+
+	if (instanced) {
+		// piece matrices are never scaled, so no inverse-transpose needed
+		modelMatrix  = gl_ModelViewMatrix * instanceMatrix;
+		normalMatrix = gl_NormalMatrix * mat3(instanceMatrix[0].xyz, instanceMatrix[1].xyz, instanceMatrix[2].xyz);
+	}
+
 #ifdef use_normalmapping
 	vec3 tangent   = gl_MultiTexCoord5.xyz;
 	vec3 bitangent = gl_MultiTexCoord6.xyz;
-	tbnMatrix      = gl_NormalMatrix * mat3(tangent, bitangent, gl_Normal);
+	tbnMatrix      = normalMatrix * mat3(tangent, bitangent, gl_Normal);
 #else
-	normalv = gl_NormalMatrix * gl_Normal;
+	normalv = normalMatrix * gl_Normal;
 #endif
 
-	vertexWorldPos = gl_ModelViewMatrix * gl_Vertex;
+	vertexWorldPos = modelMatrix * gl_Vertex;
 	gl_Position    = gl_ProjectionMatrix * vertexWorldPos;
 	cameraDir      = vertexWorldPos.xyz - cameraPos;
 
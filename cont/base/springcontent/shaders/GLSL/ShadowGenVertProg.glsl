@@ -1,5 +1,11 @@
 uniform vec4 shadowParams;   // {x = xmid, y = ymid, z = p17, w = p18}
 
+#ifdef SHADOWGEN_PROGRAM_MODEL
+// set when drawing many copies of a piece at once (CUnitDrawer)
+uniform bool instanced;
+attribute mat4 instanceMatrix;
+#endif
+
 #ifdef SHADOWGEN_PROGRAM_TREE_NEAR
 uniform vec3 cameraDirX;
 uniform vec3 cameraDirY;
@@ -21,6 +27,12 @@ void main() {
 	vertexPos.xyz += (cameraDirY * gl_Normal.y);
 	#endif
 
+	#ifdef SHADOWGEN_PROGRAM_MODEL
+	if (instanced) {
+		vertexPos = instanceMatrix * vertexPos;
+	}
+	#endif
+
 	vec4 vertexShadowPos = gl_ModelViewMatrix * vertexPos;
 		vertexShadowPos.st *= (inversesqrt(abs(vertexShadowPos.st) + p17) + p18);
 		vertexShadowPos.st += shadowParams.xy;
@@ -46,6 +46,7 @@
 #include "Sim/Units/UnitDefHandler.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
+#include "Sim/Units/VisibleUnitIndex.h"
 #include "Sim/Weapons/WeaponDefHandler.h"
 #include "Sim/Weapons/Weapon.h"
 #include "ExternalAI/SkirmishAIHandler.h"
@@ -906,35 +907,67 @@ static inline bool unit_IsEnemyAndInLos(const CUnit* unit) {
 	return (unit_IsEnemy(unit) && unit_IsInLos(unit));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsEnemyAndInLosOrRadar(const CUnit* unit) {
-	return (unit_IsEnemy(unit) && (unit_IsInLos(unit) || unit_IsInRadar(unit)));
-}
-
 /// You have to set myAllyTeamId before calling this function. NOT thread safe!
 static inline bool unit_IsNeutralAndInLos(const CUnit* unit) {
 	return (unit_IsNeutral(unit) && unit_IsInLos(unit));
 }
 
+/**
+ * Enemy units in LOS (VIS_LOS) or in LOS or radar (VIS_ANY) of myAllyTeamId;
+ * only visits the units it sees of allyteams it is not allied with.
+ * You have to set myAllyTeamId before calling this function. NOT thread safe!
+ */
+static int FilterVisibleEnemyUnits(CVisibleUnitIndex::VisibilityType visType, int* unitIds, int unitIds_max)
+{
+	int a = 0;
+
+	if (unitIds_max < 0) {
+		unitIds = NULL;
+		unitIds_max = MAX_UNITS;
+	}
+
+	for (int unitAllyTeam = 0; unitAllyTeam < teamHandler->ActiveAllyTeams(); ++unitAllyTeam) {
+		if (teamHandler->Ally(unitAllyTeam, myAllyTeamId))
+			continue;
+
+		const std::vector<CUnit*>& units = visibleUnitIndex->GetUnits(myAllyTeamId, unitAllyTeam, visType);
+
+		std::vector<CUnit*>::const_iterator ui;
+		for (ui = units.begin(); (ui != units.end()) && (a < unitIds_max); ++ui) {
+			const CUnit* u = *ui;
+
+			if (!unit_IsNeutral(u)) {
+				if (unitIds != NULL) {
+					unitIds[a] = u->id;
+				}
+				a++;
+			}
+		}
+	}
+
+	return a;
+}
+
 int CAICallback::GetEnemyUnits(int* unitIds, int unitIds_max)
 {
 	verify();
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsList(unitHandler->activeUnits, unitIds, unitIds_max, &unit_IsEnemyAndInLos);
+	return FilterVisibleEnemyUnits(CVisibleUnitIndex::VIS_LOS, unitIds, unitIds_max);
 }
 
 int CAICallback::GetEnemyUnitsInRadarAndLos(int* unitIds, int unitIds_max)
 {
 	verify();
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsList(unitHandler->activeUnits, unitIds, unitIds_max, &unit_IsEnemyAndInLosOrRadar);
+	return FilterVisibleEnemyUnits(CVisibleUnitIndex::VIS_ANY, unitIds, unitIds_max);
 }
 
 int CAICallback::GetEnemyUnits(int* unitIds, const float3& pos, float radius,
 		int unitIds_max)
 {
 	verify();
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	std::vector<CUnit*> units;
+	quadField->GetUnitsExactConcurrent(pos, radius, units);
 	myAllyTeamId = teamHandler->AllyTeam(team);
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsEnemyAndInLos);
 }
@@ -951,7 +984,8 @@ int CAICallback::GetFriendlyUnits(int* unitIds, const float3& pos, float radius,
 		int unitIds_max)
 {
 	verify();
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	std::vector<CUnit*> units;
+	quadField->GetUnitsExactConcurrent(pos, radius, units);
 	myAllyTeamId = teamHandler->AllyTeam(team);
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsFriendly);
 }
@@ -967,7 +1001,8 @@ int CAICallback::GetNeutralUnits(int* unitIds, int unitIds_max)
 int CAICallback::GetNeutralUnits(int* unitIds, const float3& pos, float radius, int unitIds_max)
 {
 	verify();
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	std::vector<CUnit*> units;
+	quadField->GetUnitsExactConcurrent(pos, radius, units);
 	myAllyTeamId = teamHandler->AllyTeam(team);
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsNeutralAndInLos);
 }
@@ -1291,7 +1326,8 @@ int CAICallback::GetFeatures(int* featureIds, int featureIds_sizeMax, const floa
 	int featureIds_size = 0;
 
 	verify();
-	const std::vector<CFeature*>& ft = quadField->GetFeaturesExact(pos, radius);
+	std::vector<CFeature*> ft;
+	quadField->GetFeaturesExactConcurrent(pos, radius, ft);
 	const int allyteam = teamHandler->AllyTeam(team);
 
 	std::vector<CFeature*>::const_iterator it;
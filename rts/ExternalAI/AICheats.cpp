@@ -206,7 +206,8 @@ int CAICheats::GetEnemyUnits(int* unitIds, int unitIds_max)
 
 int CAICheats::GetEnemyUnits(int* unitIds, const float3& pos, float radius, int unitIds_max)
 {
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	std::vector<CUnit*> units;
+	quadField->GetUnitsExactConcurrent(pos, radius, units);
 	myAllyTeamId = teamHandler->AllyTeam(ai->GetTeamId());
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsEnemy);
 }
@@ -218,7 +219,8 @@ int CAICheats::GetNeutralUnits(int* unitIds, int unitIds_max)
 
 int CAICheats::GetNeutralUnits(int* unitIds, const float3& pos, float radius, int unitIds_max)
 {
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	std::vector<CUnit*> units;
+	quadField->GetUnitsExactConcurrent(pos, radius, units);
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsNeutral);
 }
 
@@ -5,6 +5,7 @@
 #include "ExternalAI/SkirmishAIWrapper.h"
 #include "ExternalAI/SkirmishAIData.h"
 #include "ExternalAI/SkirmishAIHandler.h"
+#include "ExternalAI/SkirmishAIThread.h"
 #include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/IAILibraryManager.h"
 #include "ExternalAI/Interface/AISCommands.h"
@@ -23,10 +24,13 @@
 #include "System/Log/ILog.h"
 #include "System/Util.h"
 #include "System/TimeProfiler.h"
+#include "lib/gml/gmlcnf.h"
 
 #include "System/creg/STL_Map.h"
 
 CONFIG(int, CatchAIExceptions).defaultValue(1);
+CONFIG(bool, AIThreaded).defaultValue(false).description("Run native (C/C++) Skirmish AIs on their own thread. Their events are delivered late, up to AIThreadedMaxLag frames behind the game, so units named in them may already be gone (or their IDs reused); their unit orders are applied before the next frame. Not supported in multithreaded (GML) builds.");
+CONFIG(int, AIThreadedMaxLag).defaultValue(150).minimumValue(0).description("Frames threaded Skirmish AIs may lag behind the game before it waits for them.");
 //CONFIG(bool, AI_UnpauseAfterInit).defaultValue(true);
 
 CR_BIND_DERIVED(CEngineOutHandler, CObject, )
@@ -105,7 +109,26 @@ void CEngineOutHandler::Destroy() {
 	}
 }
 
+CEngineOutHandler::CEngineOutHandler(): aiThread(NULL) {
+	if (configHandler->GetBool("AIThreaded")) {
+		// the world lock assumes sim and draw run on the same thread
+		if (GML::Enabled()) {
+			LOG_L(L_WARNING, "AIThreaded is not supported in multithreaded (GML) builds, Skirmish AIs run on the engine thread");
+			return;
+		}
+
+		aiThread = new CSkirmishAIThread(configHandler->GetInt("AIThreadedMaxLag"));
+		skirmishAIThread = aiThread;
+	}
+}
+
 CEngineOutHandler::~CEngineOutHandler() {
+	if (aiThread != NULL) {
+		// AI callbacks still read the global until the worker is gone
+		SafeDelete(aiThread);
+		skirmishAIThread = NULL;
+	}
+
 	// id_skirmishAI should be empty already, but this can not hurt
 	for (id_ai_t::iterator ai = id_skirmishAI.begin(); ai != id_skirmishAI.end(); ++ai) {
 		delete ai->second;
@@ -133,18 +156,29 @@ void CEngineOutHandler::PostLoad() {}
 void CEngineOutHandler::PreDestroy() {
 	AI_EVT_MTH();
 
+	// no more events from here on, the queued ones are dropped with the thread
+	if (aiThread != NULL) {
+		aiThread->Pause();
+	}
+
 	DO_FOR_SKIRMISH_AIS(PreDestroy())
 }
 
 void CEngineOutHandler::Load(std::istream* s) {
 	AI_EVT_MTH();
 
+	FlushAIs();
+	const CSkirmishAIThread::ScopedPause pause(aiThread);
+
 	DO_FOR_SKIRMISH_AIS(Load(s))
 }
 
 void CEngineOutHandler::Save(std::ostream* s) {
 	AI_EVT_MTH();
 
+	FlushAIs();
+	const CSkirmishAIThread::ScopedPause pause(aiThread);
+
 	DO_FOR_SKIRMISH_AIS(Save(s))
 }
 
@@ -155,6 +189,69 @@ void CEngineOutHandler::Update() {
 	const int frame = gs->frameNum;
 
 	DO_FOR_SKIRMISH_AIS(Update(frame))
+
+	UpdateAIThread();
+}
+
+
+void CEngineOutHandler::UpdateAIThread() {
+	if (aiThread == NULL)
+		return;
+
+	std::vector< std::pair<int, std::string> > failedAIs;
+	aiThread->GetFailedAIs(failedAIs);
+
+	for (std::vector< std::pair<int, std::string> >::const_iterator it = failedAIs.begin(); it != failedAIs.end(); ++it) {
+		HandleAIException(it->second.c_str());
+
+		if (skirmishAIHandler.IsLocalSkirmishAIDieing(it->first))
+			continue;
+
+		skirmishAIHandler.SetLocalSkirmishAIDieing(it->first, 4 /* = AI crashed */);
+	}
+
+	// the profiler is not thread-safe, so the worker's numbers
+	// are published from here (once per sim frame)
+	std::map<int, CSkirmishAIThread::Stats> stats;
+	aiThread->GetStats(stats);
+
+	for (std::map<int, CSkirmishAIThread::Stats>::const_iterator it = stats.begin(); it != stats.end(); ++it) {
+		const std::string name = "AI id:" + IntToString(it->first);
+		const CSkirmishAIThread::Stats& s = it->second;
+
+		profiler.AddCounter(name + " busy ms", s.busyTime.toMilliSecs());
+		profiler.AddCounter(name + " wait ms", s.waitTime.toMilliSecs());
+		profiler.AddCounter(name + " stalled frames", s.numStalls);
+		profiler.AddCounter(name + " lag frames", s.maxLag);
+	}
+}
+
+void CEngineOutHandler::FlushAIs() {
+	if (aiThread == NULL)
+		return;
+
+	aiThread->Flush();
+}
+
+void CEngineOutHandler::PollAIs() {
+	if (aiThread == NULL)
+		return;
+
+	aiThread->Poll();
+}
+
+
+
+CScopedAIWorldLock::CScopedAIWorldLock(): aiThread(skirmishAIThread) {
+	if (aiThread != NULL) {
+		aiThread->LockWorld(gs->frameNum);
+	}
+}
+
+CScopedAIWorldLock::~CScopedAIWorldLock() {
+	if (aiThread != NULL) {
+		aiThread->UnlockWorld();
+	}
 }
 
 
@@ -507,6 +604,9 @@ bool CEngineOutHandler::SendLuaMessages(int aiTeam, const char* inData, std::vec
 		return false;
 	}
 
+	// the messages are handled right away, between two events of the worker
+	const CSkirmishAIThread::ScopedPause pause(aiThread);
+
 	id_ai_t::iterator it;
 	unsigned int n = 0;
 
@@ -570,6 +670,8 @@ void CEngineOutHandler::CreateSkirmishAI(const size_t skirmishAIId) {
 		net->Send(CBaseNetProtocol::Get().SendPause(gu->myPlayerNum, true));
 	}*/
 
+	const CSkirmishAIThread::ScopedPause pause(aiThread);
+
 	const SkirmishAIData* aiData = skirmishAIHandler.GetSkirmishAI(skirmishAIId);
 
 	if (aiData->status != SKIRMAISTATE_RELOADING) {
@@ -619,6 +721,8 @@ void CEngineOutHandler::CreateSkirmishAI(const size_t skirmishAIId) {
 void CEngineOutHandler::SetSkirmishAIDieing(const size_t skirmishAIId) {
 	SCOPED_TIMER("AI Total");
 
+	const CSkirmishAIThread::ScopedPause pause(aiThread);
+
 	try {
 		assert(id_skirmishAI[skirmishAIId] != NULL);
 		id_skirmishAI[skirmishAIId]->Dieing();
@@ -639,6 +743,13 @@ static void internal_aiErase(std::vector<unsigned char>& ais, const unsigned cha
 void CEngineOutHandler::DestroySkirmishAI(const size_t skirmishAIId) {
 	SCOPED_TIMER("AI Total");
 
+	if (aiThread != NULL) {
+		aiThread->RemoveEvents(skirmishAIId);
+	}
+
+	// the wrapper is deleted below, the worker may be in one of its events
+	const CSkirmishAIThread::ScopedPause pause(aiThread);
+
 	try {
 		CSkirmishAIWrapper* aiWrapper = id_skirmishAI[skirmishAIId];
 		const int reason = skirmishAIHandler.GetLocalSkirmishAIDieReason(skirmishAIId);
@@ -18,6 +18,7 @@ struct WeaponDef;
 class SkirmishAIKey;
 class CSkirmishAIWrapper;
 struct SSkirmishAICallback;
+class CSkirmishAIThread;
 
 
 void handleAIException(const char* description);
@@ -25,6 +26,7 @@ void handleAIException(const char* description);
 class CEngineOutHandler : public CObject {
 	CR_DECLARE(CEngineOutHandler);
 
+	CEngineOutHandler();
 	~CEngineOutHandler();
 
 public:
@@ -37,6 +39,13 @@ public:
 
 	void Update();
 
+	/**
+	 * Runs the orders and requests the Skirmish AI thread queued, if
+	 * any (no-op unless AIThreaded is enabled); call now and then
+	 * outside of sim frames, eg. while drawing.
+	 */
+	void PollAIs();
+
 	/** Group should return false if it doenst want the unit for some reason. */
 	bool UnitAddedToGroup(const CUnit& unit, const CGroup& group);
 	/** No way to refuse giving up a unit. */
@@ -152,6 +161,14 @@ private:
 	typedef std::map<unsigned char, CSkirmishAIWrapper*> id_ai_t;
 	typedef std::map<int, ids_t> team_ais_t;
 
+	/// waits until the Skirmish AI thread handled all queued events
+	void FlushAIs();
+	/// reports AIs that crashed on the Skirmish AI thread, publishes its stats
+	void UpdateAIThread();
+
+	/// runs the AI events, NULL unless AIThreaded
+	CSkirmishAIThread* aiThread;
+
 	/// Contains all local Skirmish AIs, indexed by their ID
 	id_ai_t id_skirmishAI;
 
@@ -164,4 +181,20 @@ private:
 
 #define eoh CEngineOutHandler::GetInstance()
 
+
+/**
+ * Keeps threaded Skirmish AIs out of the engine for its lifetime (no-op
+ * unless AIThreaded is enabled); use around anything that changes state
+ * the AI callbacks read, outside of network message processing.
+ * @see CSkirmishAIThread::LockWorld
+ */
+class CScopedAIWorldLock {
+public:
+	CScopedAIWorldLock();
+	~CScopedAIWorldLock();
+
+private:
+	CSkirmishAIThread* aiThread;
+};
+
 #endif // ENGINE_OUT_HANDLER_H
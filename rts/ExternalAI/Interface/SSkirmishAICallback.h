@@ -1185,6 +1185,26 @@ struct SSkirmishAICallback {
 	 */
 	int               (CALLING_CONV *getSelectedUnits)(int skirmishAIId, int* unitIds, int unitIds_sizeMax); //$ FETCHER:MULTI:IDs:Unit:unitIds
 
+	/**
+	 * Bulk versions of Unit_getPos, Unit_getVel, Unit_getHealth, Unit_getDef
+	 * and Unit_getTeam, meant for AIs that read the state of many units each
+	 * frame. Value i belongs to unit unitIds[i] (positions and velocities use
+	 * three floats per unit), and is what the single unit getter would return
+	 * for it (eg. ZeroVector for positions of units not in LOS or radar).
+	 * @return the number of values written, or the number required for all
+	 *   the given units if the output array is NULL
+	 */
+	int               (CALLING_CONV *getUnitsPositions)(int skirmishAIId, int* unitIds, int unitIds_size, float* positions_AposF3, int positions_AposF3_sizeMax); //$ ARRAY:unitIds->Unit ARRAY:positions_AposF3
+
+	int               (CALLING_CONV *getUnitsVelocities)(int skirmishAIId, int* unitIds, int unitIds_size, float* velocities_AposF3, int velocities_AposF3_sizeMax); //$ ARRAY:unitIds->Unit ARRAY:velocities_AposF3
+
+	int               (CALLING_CONV *getUnitsHealths)(int skirmishAIId, int* unitIds, int unitIds_size, float* healths, int healths_sizeMax); //$ ARRAY:unitIds->Unit ARRAY:healths
+
+	/// unit-def IDs, -1 for units whose type is not known
+	int               (CALLING_CONV *getUnitsDefs)(int skirmishAIId, int* unitIds, int unitIds_size, int* unitDefIds, int unitDefIds_sizeMax); //$ ARRAY:unitIds->Unit ARRAY:unitDefIds->UnitDef
+
+	int               (CALLING_CONV *getUnitsTeams)(int skirmishAIId, int* unitIds, int unitIds_size, int* teams, int teams_sizeMax); //$ ARRAY:unitIds->Unit ARRAY:teams
+
 	/**
 	 * Returns the unit's unitdef struct from which you can read all
 	 * the statistics of the unit, do NOT try to change any values in it.
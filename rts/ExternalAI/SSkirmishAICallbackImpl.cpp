@@ -7,6 +7,7 @@
 #include "ExternalAI/SkirmishAILibraryInfo.h"
 #include "ExternalAI/SAIInterfaceCallbackImpl.h"
 #include "ExternalAI/SkirmishAIHandler.h"
+#include "ExternalAI/SkirmishAIThread.h"
 #include "ExternalAI/Interface/AISCommands.h"
 #include "ExternalAI/Interface/SSkirmishAICallback.h"
 #include "ExternalAI/Interface/SSkirmishAILibrary.h"
@@ -36,12 +37,17 @@
 #include "Sim/Misc/RadarHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/ModInfo.h"
-#include "Sim/Misc/QuadField.h" // for quadField->GetFeaturesExact(pos, radius)
+#include "Sim/Misc/QuadField.h" // for quadField->GetFeaturesExactConcurrent(pos, radius)
 #include "System/SafeCStrings.h"
 #include "System/myMath.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/Log/ILog.h"
 
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <boost/shared_ptr.hpp>
+
 
 static const char* SKIRMISH_AIS_VERSION_COMMON = "common";
 
@@ -56,6 +62,10 @@ static const size_t MARKERS_MAX_SIZE = 16384;
 static std::vector<PointMarker> tmpPointMarkerArr[MAX_SKIRMISH_AIS];
 static std::vector<LineMarker> tmpLineMarkerArr[MAX_SKIRMISH_AIS];
 
+/// the destroyed unit a threaded Skirmish AI is handling the event of, if any
+static SSkirmishAIUnitSnapshot skirmishAIId_deadUnit[MAX_SKIRMISH_AIS];
+static bool skirmishAIId_hasDeadUnit[MAX_SKIRMISH_AIS] = {false};
+
 static void checkSkirmishAIId(int skirmishAIId) {
 
 	if ((skirmishAIId < 0) || (skirmishAIId_cCallback.find(static_cast<size_t>(skirmishAIId)) == skirmishAIId_cCallback.end())) {
@@ -70,6 +80,22 @@ static void checkSkirmishAIId(int skirmishAIId) {
 	}
 }
 
+/// selection, map markers, etc. change on the engine thread at any time,
+/// so threaded Skirmish AIs have to read them from there (see Invoke)
+static bool OnSkirmishAIThread() {
+	return ((skirmishAIThread != NULL) && skirmishAIThread->IsCurrentThread());
+}
+
+static const SSkirmishAIUnitSnapshot* getDeadUnit(int skirmishAIId, int unitId) {
+
+	if (!skirmishAIId_hasDeadUnit[skirmishAIId])
+		return NULL;
+	if (skirmishAIId_deadUnit[skirmishAIId].unitId != unitId)
+		return NULL;
+
+	return &skirmishAIId_deadUnit[skirmishAIId];
+}
+
 static int fillCMap(const std::map<std::string,std::string>* map,
 		const char* cMapKeys[], const char* cMapValues[]) {
 	std::map<std::string,std::string>::const_iterator it;
@@ -197,8 +223,7 @@ static int wrapper_HandleCommand(CAICallback* clb, CAICheats* clbCheat,
 	return ret;
 }
 
-EXPORT(int) skirmishAiCallback_Engine_handleCommand(int skirmishAIId, int toId, int commandId,
-		int commandTopic, void* commandData) {
+static int HandleCommand(int skirmishAIId, int toId, int commandId, int commandTopic, void* commandData) {
 
 	int ret = 0;
 
@@ -776,6 +801,255 @@ EXPORT(int) skirmishAiCallback_Engine_handleCommand(int skirmishAIId, int toId,
 	return ret;
 }
 
+/// commands a threaded Skirmish AI queued or requested run on the engine thread,
+/// where the current AI ID is only set while an event is being sent otherwise
+static int HandleCommandAs(int skirmishAIId, int toId, int commandId, int commandTopic, void* commandData) {
+
+	const unsigned char prevAIId = skirmishAIHandler.GetCurrentAIID();
+
+	skirmishAIHandler.SetCurrentAIID(skirmishAIId);
+	const int ret = HandleCommand(skirmishAIId, toId, commandId, commandTopic, commandData);
+	skirmishAIHandler.SetCurrentAIID(prevAIId);
+
+	return ret;
+}
+
+static void GiveQueuedOrder(int skirmishAIId, int unitId, int groupId, const Command& c) {
+
+	CAICallback* clb = skirmishAIId_callback[skirmishAIId];
+	Command cmd = c;
+
+	const unsigned char prevAIId = skirmishAIHandler.GetCurrentAIID();
+	skirmishAIHandler.SetCurrentAIID(skirmishAIId);
+
+	if (unitId >= 0) {
+		clb->GiveOrder(unitId, &cmd);
+	} else {
+		clb->GiveGroupOrder(groupId, &cmd);
+	}
+
+	skirmishAIHandler.SetCurrentAIID(prevAIId);
+}
+
+/**
+ * Deep copy of a command which only draws or sends something, so a threaded
+ * Skirmish AI can queue it instead of waiting for the engine thread.
+ */
+class CQueuedCommand {
+public:
+	CQueuedCommand(int toId, int commandId, int commandTopic)
+		: toId(toId), commandId(commandId), commandTopic(commandTopic), data(NULL) {}
+
+	template<typename T> T* CopyData(const void* commandData) {
+		T* cmd = Copy(static_cast<const T*>(commandData));
+		data = cmd;
+		return cmd;
+	}
+
+	template<typename T> T* Copy(const T* src, size_t count = 1) {
+		if ((src == NULL) || (count == 0))
+			return NULL;
+
+		// vector<char> storage is suitably aligned for any of the command members
+		buffers.push_back(std::vector<char>(sizeof(T) * count));
+		T* dst = reinterpret_cast<T*>(&buffers.back()[0]);
+		std::copy(src, src + count, dst);
+		return dst;
+	}
+
+	const char* CopyString(const char* str) {
+		return ((str == NULL)? NULL: Copy(str, strlen(str) + 1));
+	}
+
+	void Run(int skirmishAIId) {
+		HandleCommandAs(skirmishAIId, toId, commandId, commandTopic, data);
+	}
+
+private:
+	int toId;
+	int commandId;
+	int commandTopic;
+
+	void* data;
+	std::list< std::vector<char> > buffers;
+};
+
+/// @return a copy of the command, or NULL if it has to return something (or is unknown)
+static CQueuedCommand* CopyQueueableCommand(int toId, int commandId, int commandTopic, const void* commandData) {
+
+	CQueuedCommand* q = new CQueuedCommand(toId, commandId, commandTopic);
+
+	switch (commandTopic) {
+		case COMMAND_SEND_START_POS: {
+			SSendStartPosCommand* cmd = q->CopyData<SSendStartPosCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+		} break;
+		case COMMAND_DRAWER_POINT_ADD: {
+			SAddPointDrawCommand* cmd = q->CopyData<SAddPointDrawCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+			cmd->label = q->CopyString(cmd->label);
+		} break;
+		case COMMAND_DRAWER_POINT_REMOVE: {
+			SRemovePointDrawCommand* cmd = q->CopyData<SRemovePointDrawCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+		} break;
+		case COMMAND_DRAWER_LINE_ADD: {
+			SAddLineDrawCommand* cmd = q->CopyData<SAddLineDrawCommand>(commandData);
+			cmd->posFrom_posF3 = q->Copy(cmd->posFrom_posF3, 3);
+			cmd->posTo_posF3 = q->Copy(cmd->posTo_posF3, 3);
+		} break;
+		case COMMAND_SEND_TEXT_MESSAGE: {
+			SSendTextMessageCommand* cmd = q->CopyData<SSendTextMessageCommand>(commandData);
+			cmd->text = q->CopyString(cmd->text);
+		} break;
+		case COMMAND_SET_LAST_POS_MESSAGE: {
+			SSetLastPosMessageCommand* cmd = q->CopyData<SSetLastPosMessageCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+		} break;
+		case COMMAND_DRAWER_ADD_NOTIFICATION: {
+			SAddNotificationDrawerCommand* cmd = q->CopyData<SAddNotificationDrawerCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DRAWER_PATH_START: {
+			SStartPathDrawerCommand* cmd = q->CopyData<SStartPathDrawerCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DRAWER_PATH_FINISH: {
+			q->CopyData<SFinishPathDrawerCommand>(commandData);
+		} break;
+		case COMMAND_DRAWER_PATH_DRAW_LINE: {
+			SDrawLinePathDrawerCommand* cmd = q->CopyData<SDrawLinePathDrawerCommand>(commandData);
+			cmd->endPos_posF3 = q->Copy(cmd->endPos_posF3, 3);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DRAWER_PATH_DRAW_LINE_AND_ICON: {
+			SDrawLineAndIconPathDrawerCommand* cmd = q->CopyData<SDrawLineAndIconPathDrawerCommand>(commandData);
+			cmd->endPos_posF3 = q->Copy(cmd->endPos_posF3, 3);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DRAWER_PATH_DRAW_ICON_AT_LAST_POS: {
+			q->CopyData<SDrawIconAtLastPosPathDrawerCommand>(commandData);
+		} break;
+		case COMMAND_DRAWER_PATH_BREAK: {
+			SBreakPathDrawerCommand* cmd = q->CopyData<SBreakPathDrawerCommand>(commandData);
+			cmd->endPos_posF3 = q->Copy(cmd->endPos_posF3, 3);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DRAWER_PATH_RESTART: {
+			q->CopyData<SRestartPathDrawerCommand>(commandData);
+		} break;
+		case COMMAND_DRAWER_FIGURE_SET_COLOR: {
+			SSetColorFigureDrawerCommand* cmd = q->CopyData<SSetColorFigureDrawerCommand>(commandData);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DRAWER_FIGURE_DELETE: {
+			q->CopyData<SDeleteFigureDrawerCommand>(commandData);
+		} break;
+		case COMMAND_DRAWER_DRAW_UNIT: {
+			SDrawUnitDrawerCommand* cmd = q->CopyData<SDrawUnitDrawerCommand>(commandData);
+			cmd->pos_posF3 = q->Copy(cmd->pos_posF3, 3);
+		} break;
+		case COMMAND_PAUSE: {
+			SPauseCommand* cmd = q->CopyData<SPauseCommand>(commandData);
+			cmd->reason = q->CopyString(cmd->reason);
+		} break;
+		case COMMAND_GROUP_ERASE: {
+			q->CopyData<SEraseGroupCommand>(commandData);
+		} break;
+
+		case COMMAND_DEBUG_DRAWER_GRAPH_LINE_ADD_POINT: {
+			q->CopyData<SAddPointLineGraphDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_GRAPH_LINE_DELETE_POINTS: {
+			q->CopyData<SDeletePointsLineGraphDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_GRAPH_SET_POS: {
+			q->CopyData<SSetPositionGraphDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_GRAPH_SET_SIZE: {
+			q->CopyData<SSetSizeGraphDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_GRAPH_LINE_SET_COLOR: {
+			SSetColorLineGraphDrawerDebugCommand* cmd = q->CopyData<SSetColorLineGraphDrawerDebugCommand>(commandData);
+			cmd->color_colorS3 = q->Copy(cmd->color_colorS3, 3);
+		} break;
+		case COMMAND_DEBUG_DRAWER_GRAPH_LINE_SET_LABEL: {
+			SSetLabelLineGraphDrawerDebugCommand* cmd = q->CopyData<SSetLabelLineGraphDrawerDebugCommand>(commandData);
+			cmd->label = q->CopyString(cmd->label);
+		} break;
+		case COMMAND_DEBUG_DRAWER_OVERLAYTEXTURE_UPDATE: {
+			SUpdateOverlayTextureDrawerDebugCommand* cmd = q->CopyData<SUpdateOverlayTextureDrawerDebugCommand>(commandData);
+			cmd->texData = q->Copy(cmd->texData, std::max(0, cmd->w) * std::max(0, cmd->h));
+		} break;
+		case COMMAND_DEBUG_DRAWER_OVERLAYTEXTURE_DELETE: {
+			q->CopyData<SDeleteOverlayTextureDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_OVERLAYTEXTURE_SET_POS: {
+			q->CopyData<SSetPositionOverlayTextureDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_OVERLAYTEXTURE_SET_SIZE: {
+			q->CopyData<SSetSizeOverlayTextureDrawerDebugCommand>(commandData);
+		} break;
+		case COMMAND_DEBUG_DRAWER_OVERLAYTEXTURE_SET_LABEL: {
+			SSetLabelOverlayTextureDrawerDebugCommand* cmd = q->CopyData<SSetLabelOverlayTextureDrawerDebugCommand>(commandData);
+			cmd->label = q->CopyString(cmd->label);
+		} break;
+
+		default: {
+			delete q;
+			q = NULL;
+		} break;
+	}
+
+	return q;
+}
+
+EXPORT(int) skirmishAiCallback_Engine_handleCommand(int skirmishAIId, int toId, int commandId,
+		int commandTopic, void* commandData) {
+
+	if (!OnSkirmishAIThread())
+		return HandleCommand(skirmishAIId, toId, commandId, commandTopic, commandData);
+
+	// on the Skirmish AI thread (holding the world, see SET_CALLBACK):
+	// * the path manager is only used by the engine while it holds the world,
+	//   so path requests are handled right here
+	// * unit orders and commands which only draw or send something are copied
+	//   and run by the engine thread the next time it takes the world (the
+	//   validation result is lost, the AI is told 0)
+	// * all other commands return something and are run by the engine thread
+	//   while the AI waits for them
+	switch (commandTopic) {
+		case COMMAND_PATH_INIT:
+		case COMMAND_PATH_GET_APPROXIMATE_LENGTH:
+		case COMMAND_PATH_GET_NEXT_WAYPOINT:
+		case COMMAND_PATH_FREE:
+			return HandleCommand(skirmishAIId, toId, commandId, commandTopic, commandData);
+		default:
+			break;
+	}
+
+	Command* c = static_cast<Command*>(newCommand(commandData, commandTopic, unitHandler->MaxUnits()));
+
+	if (c != NULL) {
+		c->aiCommandId = commandId;
+		const SStopUnitCommand* cmd = static_cast<SStopUnitCommand*>(commandData);
+		skirmishAIThread->QueueCall(skirmishAIId, boost::bind(&GiveQueuedOrder, skirmishAIId, cmd->unitId, cmd->groupId, *c));
+		delete c;
+		return 0;
+	}
+
+	CQueuedCommand* queuedCmd = CopyQueueableCommand(toId, commandId, commandTopic, commandData);
+
+	if (queuedCmd != NULL) {
+		skirmishAIThread->QueueCall(skirmishAIId, boost::bind(&CQueuedCommand::Run, boost::shared_ptr<CQueuedCommand>(queuedCmd), skirmishAIId));
+		return 0;
+	}
+
+	return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&HandleCommandAs, skirmishAIId, toId, commandId, commandTopic, commandData));
+}
+
 
 EXPORT(const char*) skirmishAiCallback_Engine_Version_getMajor(int skirmishAIId) {
 	return aiInterfaceCallback_Engine_Version_getMajor(-1);
@@ -952,7 +1226,11 @@ EXPORT(void) skirmishAiCallback_Log_exception(int skirmishAIId, const char* cons
 			info->GetName().c_str(), info->GetVersion().c_str(), severety,
 			(die ? "AI shutting down" : "AI still running"), msg);
 	if (die) {
-		skirmishAIHandler.SetLocalSkirmishAIDieing(skirmishAIId, 4 /* = AI crashed */);
+		if (OnSkirmishAIThread()) {
+			skirmishAIThread->QueueCall(skirmishAIId, boost::bind(&CSkirmishAIHandler::SetLocalSkirmishAIDieing, &skirmishAIHandler, skirmishAIId, 4 /* = AI crashed */));
+		} else {
+			skirmishAIHandler.SetLocalSkirmishAIDieing(skirmishAIId, 4 /* = AI crashed */);
+		}
 	}
 }
 
@@ -1768,6 +2046,11 @@ EXPORT(bool) skirmishAiCallback_Map_isPossibleToBuildAt(int skirmishAIId, int un
 		float* pos_posF3, int facing) {
 
 	const UnitDef* unitDef = getUnitDefById(skirmishAIId, unitDefId);
+
+	// geothermal build-squares are tested with the tempNum feature query
+	if (unitDef != NULL && unitDef->needGeo && OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<bool>(skirmishAIId, boost::bind(&skirmishAiCallback_Map_isPossibleToBuildAt, skirmishAIId, unitDefId, pos_posF3, facing));
+
 	return skirmishAIId_callback[skirmishAIId]->CanBuildAt(unitDef, pos_posF3, facing);
 }
 
@@ -1775,12 +2058,21 @@ EXPORT(void) skirmishAiCallback_Map_findClosestBuildSite(int skirmishAIId, int u
 		float* pos_posF3, float searchRadius, int minDist, int facing, float* return_posF3_out) {
 
 			const UnitDef* unitDef = getUnitDefById(skirmishAIId, unitDefId);
+
+	if (unitDef != NULL && unitDef->needGeo && OnSkirmishAIThread()) {
+		skirmishAIThread->Invoke(skirmishAIId, boost::bind(&skirmishAiCallback_Map_findClosestBuildSite, skirmishAIId, unitDefId, pos_posF3, searchRadius, minDist, facing, return_posF3_out));
+		return;
+	}
+
 	skirmishAIId_callback[skirmishAIId]->ClosestBuildSite(unitDef, pos_posF3, searchRadius, minDist, facing)
 			.copyInto(return_posF3_out);
 }
 
 EXPORT(int) skirmishAiCallback_Map_getPoints(int skirmishAIId, bool includeAllies) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_Map_getPoints, skirmishAIId, includeAllies));
+
 	skirmishAIId_callback[skirmishAIId]->GetMapPoints(
 			tmpPointMarkerArr[skirmishAIId], MARKERS_MAX_SIZE, includeAllies);
 	return (int)tmpPointMarkerArr[skirmishAIId].size();
@@ -1804,6 +2096,9 @@ EXPORT(const char*) skirmishAiCallback_Map_Point_getLabel(int skirmishAIId, int
 
 EXPORT(int) skirmishAiCallback_Map_getLines(int skirmishAIId, bool includeAllies) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_Map_getLines, skirmishAIId, includeAllies));
+
 	skirmishAIId_callback[skirmishAIId]->GetMapLines(
 			tmpLineMarkerArr[skirmishAIId], MARKERS_MAX_SIZE, includeAllies);
 	return (int)tmpLineMarkerArr[skirmishAIId].size();
@@ -1830,6 +2125,11 @@ EXPORT(void) skirmishAiCallback_Map_getStartPos(int skirmishAIId, float* return_
 }
 
 EXPORT(void) skirmishAiCallback_Map_getMousePos(int skirmishAIId, float* return_posF3_out) {
+	if (OnSkirmishAIThread()) {
+		skirmishAIThread->Invoke(skirmishAIId, boost::bind(&skirmishAiCallback_Map_getMousePos, skirmishAIId, return_posF3_out));
+		return;
+	}
+
 	skirmishAIId_callback[skirmishAIId]->GetMousePos().copyInto(return_posF3_out);
 }
 
@@ -3096,6 +3396,11 @@ EXPORT(int) skirmishAiCallback_Unit_getMax(int skirmishAIId) {
 
 EXPORT(int) skirmishAiCallback_Unit_getDef(int skirmishAIId, int unitId) {
 
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->def;
+
 	const UnitDef* unitDef;
 
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
@@ -3155,6 +3460,11 @@ EXPORT(float) skirmishAiCallback_Unit_ModParam_getValue(int skirmishAIId,
 }
 
 EXPORT(int) skirmishAiCallback_Unit_getTeam(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->team;
+
 //	return skirmishAIId_callback[skirmishAIId]->GetUnitTeam(unitId);
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetUnitTeam(unitId);
@@ -3164,6 +3474,11 @@ EXPORT(int) skirmishAiCallback_Unit_getTeam(int skirmishAIId, int unitId) {
 }
 
 EXPORT(int) skirmishAiCallback_Unit_getAllyTeam(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->allyTeam;
+
 //	return skirmishAIId_callback[skirmishAIId]->GetUnitAllyTeam(unitId);
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetUnitAllyTeam(unitId);
@@ -3265,6 +3580,11 @@ EXPORT(float) skirmishAiCallback_Unit_getMaxRange(int skirmishAIId, int unitId)
 }
 
 EXPORT(float) skirmishAiCallback_Unit_getMaxHealth(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->maxHealth;
+
 //	return skirmishAIId_callback[skirmishAIId]->GetUnitMaxHealth(unitId);
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetUnitMaxHealth(unitId);
@@ -3365,6 +3685,11 @@ EXPORT(int) skirmishAiCallback_Unit_CurrentCommand_getParams(int skirmishAIId,
 
 
 EXPORT(float) skirmishAiCallback_Unit_getExperience(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->experience;
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetUnitExperience(unitId);
 	} else {
@@ -3377,6 +3702,11 @@ EXPORT(int) skirmishAiCallback_Unit_getGroup(int skirmishAIId, int unitId) {
 }
 
 EXPORT(float) skirmishAiCallback_Unit_getHealth(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->health;
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetUnitHealth(unitId);
 	} else {
@@ -3385,10 +3715,20 @@ EXPORT(float) skirmishAiCallback_Unit_getHealth(int skirmishAIId, int unitId) {
 }
 
 EXPORT(float) skirmishAiCallback_Unit_getSpeed(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->speed;
+
 	return skirmishAIId_callback[skirmishAIId]->GetUnitSpeed(unitId);
 }
 
 EXPORT(float) skirmishAiCallback_Unit_getPower(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->power;
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetUnitPower(unitId);
 	} else {
@@ -3397,6 +3737,13 @@ EXPORT(float) skirmishAiCallback_Unit_getPower(int skirmishAIId, int unitId) {
 }
 
 EXPORT(void) skirmishAiCallback_Unit_getPos(int skirmishAIId, int unitId, float* return_posF3_out) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL) {
+		std::copy(deadUnit->pos, deadUnit->pos + 3, return_posF3_out);
+		return;
+	}
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		skirmishAIId_cheatCallback[skirmishAIId]->GetUnitPos(unitId).copyInto(return_posF3_out);
 	} else {
@@ -3405,6 +3752,13 @@ EXPORT(void) skirmishAiCallback_Unit_getPos(int skirmishAIId, int unitId, float*
 }
 
 EXPORT(void) skirmishAiCallback_Unit_getVel(int skirmishAIId, int unitId, float* return_posF3_out) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL) {
+		std::copy(deadUnit->vel, deadUnit->vel + 3, return_posF3_out);
+		return;
+	}
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		skirmishAIId_cheatCallback[skirmishAIId]->GetUnitVelocity(unitId).copyInto(return_posF3_out);
 	} else {
@@ -3475,6 +3829,11 @@ EXPORT(bool) skirmishAiCallback_Unit_isActivated(int skirmishAIId, int unitId) {
 }
 
 EXPORT(bool) skirmishAiCallback_Unit_isBeingBuilt(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->beingBuilt;
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->UnitBeingBuilt(unitId);
 	} else {
@@ -3499,6 +3858,11 @@ EXPORT(bool) skirmishAiCallback_Unit_isParalyzed(int skirmishAIId, int unitId) {
 }
 
 EXPORT(bool) skirmishAiCallback_Unit_isNeutral(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->neutral;
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->IsUnitNeutral(unitId);
 	} else {
@@ -3507,6 +3871,11 @@ EXPORT(bool) skirmishAiCallback_Unit_isNeutral(int skirmishAIId, int unitId) {
 }
 
 EXPORT(int) skirmishAiCallback_Unit_getBuildingFacing(int skirmishAIId, int unitId) {
+	const SSkirmishAIUnitSnapshot* deadUnit = getDeadUnit(skirmishAIId, unitId);
+
+	if (deadUnit != NULL)
+		return deadUnit->buildingFacing;
+
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetBuildingFacing(unitId);
 	} else {
@@ -3573,6 +3942,9 @@ EXPORT(int) skirmishAiCallback_getNeutralUnitsIn(int skirmishAIId, float* pos_po
 }
 
 EXPORT(int) skirmishAiCallback_getSelectedUnits(int skirmishAIId, int* unitIds, int unitIds_sizeMax) {
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_getSelectedUnits, skirmishAIId, unitIds, unitIds_sizeMax));
+
 	return skirmishAIId_callback[skirmishAIId]->GetSelectedUnits(unitIds, unitIds_sizeMax);
 }
 
@@ -3600,6 +3972,75 @@ EXPORT(int) skirmishAiCallback_getTeamUnits(int skirmishAIId, int* unitIds, int
 	return a;
 }
 
+
+// the bulk unit getters look up the (cheat-)callback once per call and
+// then return exactly what the single unit getters would for each unit
+struct UnitPosGetter {
+	template<typename C> void operator() (C* clb, int unitId, float* pos) const { clb->GetUnitPos(unitId).copyInto(pos); }
+};
+struct UnitVelGetter {
+	template<typename C> void operator() (C* clb, int unitId, float* vel) const { clb->GetUnitVelocity(unitId).copyInto(vel); }
+};
+struct UnitHealthGetter {
+	template<typename C> void operator() (C* clb, int unitId, float* health) const { *health = clb->GetUnitHealth(unitId); }
+};
+struct UnitDefGetter {
+	template<typename C> void operator() (C* clb, int unitId, int* unitDefId) const {
+		const UnitDef* unitDef = clb->GetUnitDef(unitId);
+		*unitDefId = (unitDef != NULL)? unitDef->id: -1;
+	}
+};
+struct UnitTeamGetter {
+	template<typename C> void operator() (C* clb, int unitId, int* team) const { *team = clb->GetUnitTeam(unitId); }
+};
+
+template<typename C, typename T, typename G>
+static int fillUnitsValues(C* clb, const int* unitIds, int unitIds_size,
+		T* values, int values_sizeMax, int stride, const G& getter)
+{
+	if (values == NULL)
+		return (unitIds_size * stride);
+
+	const int numUnits = min(unitIds_size, values_sizeMax / stride);
+
+	for (int i = 0; i < numUnits; ++i) {
+		getter(clb, unitIds[i], &values[i * stride]);
+	}
+
+	return (numUnits * stride);
+}
+
+template<typename T, typename G>
+static int getUnitsValues(int skirmishAIId, const int* unitIds, int unitIds_size,
+		T* values, int values_sizeMax, int stride, const G& getter)
+{
+	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
+		return fillUnitsValues(skirmishAIId_cheatCallback[skirmishAIId], unitIds, unitIds_size, values, values_sizeMax, stride, getter);
+	} else {
+		return fillUnitsValues(skirmishAIId_callback[skirmishAIId], unitIds, unitIds_size, values, values_sizeMax, stride, getter);
+	}
+}
+
+EXPORT(int) skirmishAiCallback_getUnitsPositions(int skirmishAIId, int* unitIds, int unitIds_size, float* positions_AposF3, int positions_AposF3_sizeMax) {
+	return getUnitsValues(skirmishAIId, unitIds, unitIds_size, positions_AposF3, positions_AposF3_sizeMax, 3, UnitPosGetter());
+}
+
+EXPORT(int) skirmishAiCallback_getUnitsVelocities(int skirmishAIId, int* unitIds, int unitIds_size, float* velocities_AposF3, int velocities_AposF3_sizeMax) {
+	return getUnitsValues(skirmishAIId, unitIds, unitIds_size, velocities_AposF3, velocities_AposF3_sizeMax, 3, UnitVelGetter());
+}
+
+EXPORT(int) skirmishAiCallback_getUnitsHealths(int skirmishAIId, int* unitIds, int unitIds_size, float* healths, int healths_sizeMax) {
+	return getUnitsValues(skirmishAIId, unitIds, unitIds_size, healths, healths_sizeMax, 1, UnitHealthGetter());
+}
+
+EXPORT(int) skirmishAiCallback_getUnitsDefs(int skirmishAIId, int* unitIds, int unitIds_size, int* unitDefIds, int unitDefIds_sizeMax) {
+	return getUnitsValues(skirmishAIId, unitIds, unitIds_size, unitDefIds, unitDefIds_sizeMax, 1, UnitDefGetter());
+}
+
+EXPORT(int) skirmishAiCallback_getUnitsTeams(int skirmishAIId, int* unitIds, int unitIds_size, int* teams, int teams_sizeMax) {
+	return getUnitsValues(skirmishAIId, unitIds, unitIds_size, teams, teams_sizeMax, 1, UnitTeamGetter());
+}
+
 //########### BEGINN FeatureDef
 EXPORT(int) skirmishAiCallback_getFeatureDefs(int skirmishAIId, int* featureDefIds, int featureDefIds_sizeMax) {
 
@@ -3770,7 +4211,8 @@ EXPORT(int) skirmishAiCallback_getFeaturesIn(int skirmishAIId, float* pos_posF3,
 
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		// cheating
-		const std::vector<CFeature*>& fset = quadField->GetFeaturesExact(pos_posF3, radius);
+		std::vector<CFeature*> fset;
+		quadField->GetFeaturesExactConcurrent(pos_posF3, radius, fset);
 		const int featureIds_sizeReal = fset.size();
 
 		int featureIds_size = featureIds_sizeReal;
@@ -4462,6 +4904,9 @@ EXPORT(int) skirmishAiCallback_Group_SupportedCommand_getParams(int skirmishAIId
 
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getId(int skirmishAIId, int groupId) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_Group_OrderPreview_getId, skirmishAIId, groupId));
+
 	if (!isControlledByLocalPlayer(skirmishAIId)) return -1;
 
 	//TODO: need to add support for new gui
@@ -4471,6 +4916,9 @@ EXPORT(int) skirmishAiCallback_Group_OrderPreview_getId(int skirmishAIId, int gr
 
 EXPORT(short) skirmishAiCallback_Group_OrderPreview_getOptions(int skirmishAIId, int groupId) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<short>(skirmishAIId, boost::bind(&skirmishAiCallback_Group_OrderPreview_getOptions, skirmishAIId, groupId));
+
 	if (!isControlledByLocalPlayer(skirmishAIId)) return '\0';
 
 	//TODO: need to add support for new gui
@@ -4480,6 +4928,9 @@ EXPORT(short) skirmishAiCallback_Group_OrderPreview_getOptions(int skirmishAIId,
 
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getTag(int skirmishAIId, int groupId) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_Group_OrderPreview_getTag, skirmishAIId, groupId));
+
 	if (!isControlledByLocalPlayer(skirmishAIId)) return 0;
 
 	//TODO: need to add support for new gui
@@ -4489,6 +4940,9 @@ EXPORT(int) skirmishAiCallback_Group_OrderPreview_getTag(int skirmishAIId, int g
 
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getTimeOut(int skirmishAIId, int groupId) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_Group_OrderPreview_getTimeOut, skirmishAIId, groupId));
+
 	if (!isControlledByLocalPlayer(skirmishAIId)) return -1;
 
 	//TODO: need to add support for new gui
@@ -4499,6 +4953,9 @@ EXPORT(int) skirmishAiCallback_Group_OrderPreview_getTimeOut(int skirmishAIId, i
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getParams(int skirmishAIId,
 		int groupId, float* params, int params_sizeMax) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<int>(skirmishAIId, boost::bind(&skirmishAiCallback_Group_OrderPreview_getParams, skirmishAIId, groupId, params, params_sizeMax));
+
 	if (!isControlledByLocalPlayer(skirmishAIId)) { return 0; }
 
 	const std::vector<float>& ps = guihandler->GetOrderPreview().params;
@@ -4520,6 +4977,9 @@ EXPORT(int) skirmishAiCallback_Group_OrderPreview_getParams(int skirmishAIId,
 
 EXPORT(bool) skirmishAiCallback_Group_isSelected(int skirmishAIId, int groupId) {
 
+	if (OnSkirmishAIThread())
+		return skirmishAIThread->Invoke<bool>(skirmishAIId, boost::bind(&skirmishAiCallback_Group_isSelected, skirmishAIId, groupId));
+
 	if (!isControlledByLocalPlayer(skirmishAIId)) return false;
 
 	return (selectedUnitsHandler.IsGroupSelected(groupId));
@@ -4530,616 +4990,687 @@ EXPORT(bool) skirmishAiCallback_Group_isSelected(int skirmishAIId, int groupId)
 
 
 
-static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
+/**
+ * Threaded Skirmish AIs hold the world for the duration of every callback
+ * (see CSkirmishAIThread), WorldLocked(&f).Get<&f>() returns a wrapper of f
+ * which does so. One template per number of arguments.
+ */
+template<typename R, typename A0> struct SWorldLocked1 {
+	typedef R (CALLING_CONV *Func)(A0);
+	template<Func F> static R CALLING_CONV Call(A0 a0) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0> static SWorldLocked1<R, A0> WorldLocked(R (CALLING_CONV *)(A0)) { return SWorldLocked1<R, A0>(); }
+
+template<typename R, typename A0, typename A1> struct SWorldLocked2 {
+	typedef R (CALLING_CONV *Func)(A0, A1);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1> static SWorldLocked2<R, A0, A1> WorldLocked(R (CALLING_CONV *)(A0, A1)) { return SWorldLocked2<R, A0, A1>(); }
+
+template<typename R, typename A0, typename A1, typename A2> struct SWorldLocked3 {
+	typedef R (CALLING_CONV *Func)(A0, A1, A2);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1, A2 a2) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1, a2); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1, typename A2> static SWorldLocked3<R, A0, A1, A2> WorldLocked(R (CALLING_CONV *)(A0, A1, A2)) { return SWorldLocked3<R, A0, A1, A2>(); }
+
+template<typename R, typename A0, typename A1, typename A2, typename A3> struct SWorldLocked4 {
+	typedef R (CALLING_CONV *Func)(A0, A1, A2, A3);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1, A2 a2, A3 a3) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1, a2, a3); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1, typename A2, typename A3> static SWorldLocked4<R, A0, A1, A2, A3> WorldLocked(R (CALLING_CONV *)(A0, A1, A2, A3)) { return SWorldLocked4<R, A0, A1, A2, A3>(); }
+
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4> struct SWorldLocked5 {
+	typedef R (CALLING_CONV *Func)(A0, A1, A2, A3, A4);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1, A2 a2, A3 a3, A4 a4) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1, a2, a3, a4); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4> static SWorldLocked5<R, A0, A1, A2, A3, A4> WorldLocked(R (CALLING_CONV *)(A0, A1, A2, A3, A4)) { return SWorldLocked5<R, A0, A1, A2, A3, A4>(); }
+
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5> struct SWorldLocked6 {
+	typedef R (CALLING_CONV *Func)(A0, A1, A2, A3, A4, A5);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1, a2, a3, a4, a5); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5> static SWorldLocked6<R, A0, A1, A2, A3, A4, A5> WorldLocked(R (CALLING_CONV *)(A0, A1, A2, A3, A4, A5)) { return SWorldLocked6<R, A0, A1, A2, A3, A4, A5>(); }
+
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6> struct SWorldLocked7 {
+	typedef R (CALLING_CONV *Func)(A0, A1, A2, A3, A4, A5, A6);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1, a2, a3, a4, a5, a6); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6> static SWorldLocked7<R, A0, A1, A2, A3, A4, A5, A6> WorldLocked(R (CALLING_CONV *)(A0, A1, A2, A3, A4, A5, A6)) { return SWorldLocked7<R, A0, A1, A2, A3, A4, A5, A6>(); }
+
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7> struct SWorldLocked8 {
+	typedef R (CALLING_CONV *Func)(A0, A1, A2, A3, A4, A5, A6, A7);
+	template<Func F> static R CALLING_CONV Call(A0 a0, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) { const CSkirmishAIThread::WorldLock lock(skirmishAIThread); return F(a0, a1, a2, a3, a4, a5, a6, a7); }
+	template<Func F> Func Get() const { return &Call<F>; }
+};
+template<typename R, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7> static SWorldLocked8<R, A0, A1, A2, A3, A4, A5, A6, A7> WorldLocked(R (CALLING_CONV *)(A0, A1, A2, A3, A4, A5, A6, A7)) { return SWorldLocked8<R, A0, A1, A2, A3, A4, A5, A6, A7>(); }
+
+#define SET_CALLBACK(name) \
+	callback->name = (worldLocked)? WorldLocked(&skirmishAiCallback_##name).Get<&skirmishAiCallback_##name>(): &skirmishAiCallback_##name;
+
+static void skirmishAiCallback_init(SSkirmishAICallback* callback, bool worldLocked) {
 	//! register function pointers to the accessors
-	callback->Engine_handleCommand = &skirmishAiCallback_Engine_handleCommand;
-	callback->Engine_Version_getMajor = &skirmishAiCallback_Engine_Version_getMajor;
-	callback->Engine_Version_getMinor = &skirmishAiCallback_Engine_Version_getMinor;
-	callback->Engine_Version_getPatchset = &skirmishAiCallback_Engine_Version_getPatchset;
-	callback->Engine_Version_getCommits = &skirmishAiCallback_Engine_Version_getCommits;
-	callback->Engine_Version_getHash = &skirmishAiCallback_Engine_Version_getHash;
-	callback->Engine_Version_getBranch = &skirmishAiCallback_Engine_Version_getBranch;
-	callback->Engine_Version_getAdditional = &skirmishAiCallback_Engine_Version_getAdditional;
-	callback->Engine_Version_getBuildTime = &skirmishAiCallback_Engine_Version_getBuildTime;
-	callback->Engine_Version_isRelease = &skirmishAiCallback_Engine_Version_isRelease;
-	callback->Engine_Version_getNormal = &skirmishAiCallback_Engine_Version_getNormal;
-	callback->Engine_Version_getSync = &skirmishAiCallback_Engine_Version_getSync;
-	callback->Engine_Version_getFull = &skirmishAiCallback_Engine_Version_getFull;
-	callback->Teams_getSize = &skirmishAiCallback_Teams_getSize;
-	callback->SkirmishAIs_getSize = &skirmishAiCallback_SkirmishAIs_getSize;
-	callback->SkirmishAIs_getMax = &skirmishAiCallback_SkirmishAIs_getMax;
-	callback->SkirmishAI_getTeamId = &skirmishAiCallback_SkirmishAI_getTeamId;
-	callback->SkirmishAI_Info_getSize = &skirmishAiCallback_SkirmishAI_Info_getSize;
-	callback->SkirmishAI_Info_getKey = &skirmishAiCallback_SkirmishAI_Info_getKey;
-	callback->SkirmishAI_Info_getValue = &skirmishAiCallback_SkirmishAI_Info_getValue;
-	callback->SkirmishAI_Info_getDescription = &skirmishAiCallback_SkirmishAI_Info_getDescription;
-	callback->SkirmishAI_Info_getValueByKey = &skirmishAiCallback_SkirmishAI_Info_getValueByKey;
-	callback->SkirmishAI_OptionValues_getSize = &skirmishAiCallback_SkirmishAI_OptionValues_getSize;
-	callback->SkirmishAI_OptionValues_getKey = &skirmishAiCallback_SkirmishAI_OptionValues_getKey;
-	callback->SkirmishAI_OptionValues_getValue = &skirmishAiCallback_SkirmishAI_OptionValues_getValue;
-	callback->SkirmishAI_OptionValues_getValueByKey = &skirmishAiCallback_SkirmishAI_OptionValues_getValueByKey;
-	callback->Log_log = &skirmishAiCallback_Log_log;
-	callback->Log_exception = &skirmishAiCallback_Log_exception;
-	callback->DataDirs_getPathSeparator = &skirmishAiCallback_DataDirs_getPathSeparator;
-	callback->DataDirs_getConfigDir = &skirmishAiCallback_DataDirs_getConfigDir;
-	callback->DataDirs_getWriteableDir = &skirmishAiCallback_DataDirs_getWriteableDir;
-	callback->DataDirs_locatePath = &skirmishAiCallback_DataDirs_locatePath;
-	callback->DataDirs_allocatePath = &skirmishAiCallback_DataDirs_allocatePath;
-	callback->DataDirs_Roots_getSize = &skirmishAiCallback_DataDirs_Roots_getSize;
-	callback->DataDirs_Roots_getDir = &skirmishAiCallback_DataDirs_Roots_getDir;
-	callback->DataDirs_Roots_locatePath = &skirmishAiCallback_DataDirs_Roots_locatePath;
-	callback->DataDirs_Roots_allocatePath = &skirmishAiCallback_DataDirs_Roots_allocatePath;
-	callback->Game_getCurrentFrame = &skirmishAiCallback_Game_getCurrentFrame;
-	callback->Game_getAiInterfaceVersion = &skirmishAiCallback_Game_getAiInterfaceVersion;
-	callback->Game_getMyTeam = &skirmishAiCallback_Game_getMyTeam;
-	callback->Game_getMyAllyTeam = &skirmishAiCallback_Game_getMyAllyTeam;
-	callback->Game_getPlayerTeam = &skirmishAiCallback_Game_getPlayerTeam;
-	callback->Game_getTeams = &skirmishAiCallback_Game_getTeams;
-	callback->Game_getTeamSide = &skirmishAiCallback_Game_getTeamSide;
-	callback->Game_getTeamColor = &skirmishAiCallback_Game_getTeamColor;
-	callback->Game_getTeamIncomeMultiplier = &skirmishAiCallback_Game_getTeamIncomeMultiplier;
-	callback->Game_getTeamAllyTeam = &skirmishAiCallback_Game_getTeamAllyTeam;
-	callback->Game_getTeamResourceCurrent = &skirmishAiCallback_Game_getTeamResourceCurrent;
-	callback->Game_getTeamResourceIncome = &skirmishAiCallback_Game_getTeamResourceIncome;
-	callback->Game_getTeamResourceUsage = &skirmishAiCallback_Game_getTeamResourceUsage;
-	callback->Game_getTeamResourceStorage = &skirmishAiCallback_Game_getTeamResourceStorage;
-	callback->Game_isAllied = &skirmishAiCallback_Game_isAllied;
-	callback->Game_isExceptionHandlingEnabled = &skirmishAiCallback_Game_isExceptionHandlingEnabled;
-	callback->Game_isDebugModeEnabled = &skirmishAiCallback_Game_isDebugModeEnabled;
-	callback->Game_isPaused = &skirmishAiCallback_Game_isPaused;
-	callback->Game_getSpeedFactor = &skirmishAiCallback_Game_getSpeedFactor;
-	callback->Game_getSetupScript = &skirmishAiCallback_Game_getSetupScript;
-	callback->Game_getCategoryFlag = &skirmishAiCallback_Game_getCategoryFlag;
-	callback->Game_getCategoriesFlag = &skirmishAiCallback_Game_getCategoriesFlag;
-	callback->Game_getCategoryName = &skirmishAiCallback_Game_getCategoryName;
-	callback->Gui_getViewRange = &skirmishAiCallback_Gui_getViewRange;
-	callback->Gui_getScreenX = &skirmishAiCallback_Gui_getScreenX;
-	callback->Gui_getScreenY = &skirmishAiCallback_Gui_getScreenY;
-	callback->Gui_Camera_getDirection = &skirmishAiCallback_Gui_Camera_getDirection;
-	callback->Gui_Camera_getPosition = &skirmishAiCallback_Gui_Camera_getPosition;
-	callback->Cheats_isEnabled = &skirmishAiCallback_Cheats_isEnabled;
-	callback->Cheats_setEnabled = &skirmishAiCallback_Cheats_setEnabled;
-	callback->Cheats_setEventsEnabled = &skirmishAiCallback_Cheats_setEventsEnabled;
-	callback->Cheats_isOnlyPassive = &skirmishAiCallback_Cheats_isOnlyPassive;
-	callback->getResources = &skirmishAiCallback_getResources;
-	callback->getResourceByName = &skirmishAiCallback_getResourceByName;
-	callback->Resource_getName = &skirmishAiCallback_Resource_getName;
-	callback->Resource_getOptimum = &skirmishAiCallback_Resource_getOptimum;
-	callback->Economy_getCurrent = &skirmishAiCallback_Economy_getCurrent;
-	callback->Economy_getIncome = &skirmishAiCallback_Economy_getIncome;
-	callback->Economy_getUsage = &skirmishAiCallback_Economy_getUsage;
-	callback->Economy_getStorage = &skirmishAiCallback_Economy_getStorage;
-	callback->File_getSize = &skirmishAiCallback_File_getSize;
-	callback->File_getContent = &skirmishAiCallback_File_getContent;
-	callback->getUnitDefs = &skirmishAiCallback_getUnitDefs;
-	callback->getUnitDefByName = &skirmishAiCallback_getUnitDefByName;
-	callback->UnitDef_getHeight = &skirmishAiCallback_UnitDef_getHeight;
-	callback->UnitDef_getRadius = &skirmishAiCallback_UnitDef_getRadius;
-	callback->UnitDef_getName = &skirmishAiCallback_UnitDef_getName;
-	callback->UnitDef_getHumanName = &skirmishAiCallback_UnitDef_getHumanName;
-	callback->UnitDef_getFileName = &skirmishAiCallback_UnitDef_getFileName;
-	callback->UnitDef_getAiHint = &skirmishAiCallback_UnitDef_getAiHint;
-	callback->UnitDef_getCobId = &skirmishAiCallback_UnitDef_getCobId;
-	callback->UnitDef_getTechLevel = &skirmishAiCallback_UnitDef_getTechLevel;
-	callback->UnitDef_getGaia = &skirmishAiCallback_UnitDef_getGaia;
-	callback->UnitDef_getUpkeep = &skirmishAiCallback_UnitDef_getUpkeep;
-	callback->UnitDef_getResourceMake = &skirmishAiCallback_UnitDef_getResourceMake;
-	callback->UnitDef_getMakesResource = &skirmishAiCallback_UnitDef_getMakesResource;
-	callback->UnitDef_getCost = &skirmishAiCallback_UnitDef_getCost;
-	callback->UnitDef_getExtractsResource = &skirmishAiCallback_UnitDef_getExtractsResource;
-	callback->UnitDef_getResourceExtractorRange = &skirmishAiCallback_UnitDef_getResourceExtractorRange;
-	callback->UnitDef_getWindResourceGenerator = &skirmishAiCallback_UnitDef_getWindResourceGenerator;
-	callback->UnitDef_getTidalResourceGenerator = &skirmishAiCallback_UnitDef_getTidalResourceGenerator;
-	callback->UnitDef_getStorage = &skirmishAiCallback_UnitDef_getStorage;
-	callback->UnitDef_isSquareResourceExtractor = &skirmishAiCallback_UnitDef_isSquareResourceExtractor;
-	callback->UnitDef_getBuildTime = &skirmishAiCallback_UnitDef_getBuildTime;
-	callback->UnitDef_getAutoHeal = &skirmishAiCallback_UnitDef_getAutoHeal;
-	callback->UnitDef_getIdleAutoHeal = &skirmishAiCallback_UnitDef_getIdleAutoHeal;
-	callback->UnitDef_getIdleTime = &skirmishAiCallback_UnitDef_getIdleTime;
-	callback->UnitDef_getPower = &skirmishAiCallback_UnitDef_getPower;
-	callback->UnitDef_getHealth = &skirmishAiCallback_UnitDef_getHealth;
-	callback->UnitDef_getCategory = &skirmishAiCallback_UnitDef_getCategory;
-	callback->UnitDef_getSpeed = &skirmishAiCallback_UnitDef_getSpeed;
-	callback->UnitDef_getTurnRate = &skirmishAiCallback_UnitDef_getTurnRate;
-	callback->UnitDef_isTurnInPlace = &skirmishAiCallback_UnitDef_isTurnInPlace;
-	callback->UnitDef_getTurnInPlaceDistance = &skirmishAiCallback_UnitDef_getTurnInPlaceDistance;
-	callback->UnitDef_getTurnInPlaceSpeedLimit = &skirmishAiCallback_UnitDef_getTurnInPlaceSpeedLimit;
-	callback->UnitDef_isUpright = &skirmishAiCallback_UnitDef_isUpright;
-	callback->UnitDef_isCollide = &skirmishAiCallback_UnitDef_isCollide;
-	callback->UnitDef_getLosRadius = &skirmishAiCallback_UnitDef_getLosRadius;
-	callback->UnitDef_getAirLosRadius = &skirmishAiCallback_UnitDef_getAirLosRadius;
-	callback->UnitDef_getLosHeight = &skirmishAiCallback_UnitDef_getLosHeight;
-	callback->UnitDef_getRadarRadius = &skirmishAiCallback_UnitDef_getRadarRadius;
-	callback->UnitDef_getSonarRadius = &skirmishAiCallback_UnitDef_getSonarRadius;
-	callback->UnitDef_getJammerRadius = &skirmishAiCallback_UnitDef_getJammerRadius;
-	callback->UnitDef_getSonarJamRadius = &skirmishAiCallback_UnitDef_getSonarJamRadius;
-	callback->UnitDef_getSeismicRadius = &skirmishAiCallback_UnitDef_getSeismicRadius;
-	callback->UnitDef_getSeismicSignature = &skirmishAiCallback_UnitDef_getSeismicSignature;
-	callback->UnitDef_isStealth = &skirmishAiCallback_UnitDef_isStealth;
-	callback->UnitDef_isSonarStealth = &skirmishAiCallback_UnitDef_isSonarStealth;
-	callback->UnitDef_isBuildRange3D = &skirmishAiCallback_UnitDef_isBuildRange3D;
-	callback->UnitDef_getBuildDistance = &skirmishAiCallback_UnitDef_getBuildDistance;
-	callback->UnitDef_getBuildSpeed = &skirmishAiCallback_UnitDef_getBuildSpeed;
-	callback->UnitDef_getReclaimSpeed = &skirmishAiCallback_UnitDef_getReclaimSpeed;
-	callback->UnitDef_getRepairSpeed = &skirmishAiCallback_UnitDef_getRepairSpeed;
-	callback->UnitDef_getMaxRepairSpeed = &skirmishAiCallback_UnitDef_getMaxRepairSpeed;
-	callback->UnitDef_getResurrectSpeed = &skirmishAiCallback_UnitDef_getResurrectSpeed;
-	callback->UnitDef_getCaptureSpeed = &skirmishAiCallback_UnitDef_getCaptureSpeed;
-	callback->UnitDef_getTerraformSpeed = &skirmishAiCallback_UnitDef_getTerraformSpeed;
-	callback->UnitDef_getMass = &skirmishAiCallback_UnitDef_getMass;
-	callback->UnitDef_isPushResistant = &skirmishAiCallback_UnitDef_isPushResistant;
-	callback->UnitDef_isStrafeToAttack = &skirmishAiCallback_UnitDef_isStrafeToAttack;
-	callback->UnitDef_getMinCollisionSpeed = &skirmishAiCallback_UnitDef_getMinCollisionSpeed;
-	callback->UnitDef_getSlideTolerance = &skirmishAiCallback_UnitDef_getSlideTolerance;
-	callback->UnitDef_getMaxSlope = &skirmishAiCallback_UnitDef_getMaxSlope;
-	callback->UnitDef_getMaxHeightDif = &skirmishAiCallback_UnitDef_getMaxHeightDif;
-	callback->UnitDef_getMinWaterDepth = &skirmishAiCallback_UnitDef_getMinWaterDepth;
-	callback->UnitDef_getWaterline = &skirmishAiCallback_UnitDef_getWaterline;
-	callback->UnitDef_getMaxWaterDepth = &skirmishAiCallback_UnitDef_getMaxWaterDepth;
-	callback->UnitDef_getArmoredMultiple = &skirmishAiCallback_UnitDef_getArmoredMultiple;
-	callback->UnitDef_getArmorType = &skirmishAiCallback_UnitDef_getArmorType;
-	callback->UnitDef_FlankingBonus_getMode = &skirmishAiCallback_UnitDef_FlankingBonus_getMode;
-	callback->UnitDef_FlankingBonus_getDir = &skirmishAiCallback_UnitDef_FlankingBonus_getDir;
-	callback->UnitDef_FlankingBonus_getMax = &skirmishAiCallback_UnitDef_FlankingBonus_getMax;
-	callback->UnitDef_FlankingBonus_getMin = &skirmishAiCallback_UnitDef_FlankingBonus_getMin;
-	callback->UnitDef_FlankingBonus_getMobilityAdd = &skirmishAiCallback_UnitDef_FlankingBonus_getMobilityAdd;
-	callback->UnitDef_getMaxWeaponRange = &skirmishAiCallback_UnitDef_getMaxWeaponRange;
-	callback->UnitDef_getType = &skirmishAiCallback_UnitDef_getType;
-	callback->UnitDef_getTooltip = &skirmishAiCallback_UnitDef_getTooltip;
-	callback->UnitDef_getWreckName = &skirmishAiCallback_UnitDef_getWreckName;
-	callback->UnitDef_getDeathExplosion = &skirmishAiCallback_UnitDef_getDeathExplosion;
-	callback->UnitDef_getSelfDExplosion = &skirmishAiCallback_UnitDef_getSelfDExplosion;
-	callback->UnitDef_getCategoryString = &skirmishAiCallback_UnitDef_getCategoryString;
-	callback->UnitDef_isAbleToSelfD = &skirmishAiCallback_UnitDef_isAbleToSelfD;
-	callback->UnitDef_getSelfDCountdown = &skirmishAiCallback_UnitDef_getSelfDCountdown;
-	callback->UnitDef_isAbleToSubmerge = &skirmishAiCallback_UnitDef_isAbleToSubmerge;
-	callback->UnitDef_isAbleToFly = &skirmishAiCallback_UnitDef_isAbleToFly;
-	callback->UnitDef_isAbleToMove = &skirmishAiCallback_UnitDef_isAbleToMove;
-	callback->UnitDef_isAbleToHover = &skirmishAiCallback_UnitDef_isAbleToHover;
-	callback->UnitDef_isFloater = &skirmishAiCallback_UnitDef_isFloater;
-	callback->UnitDef_isBuilder = &skirmishAiCallback_UnitDef_isBuilder;
-	callback->UnitDef_isActivateWhenBuilt = &skirmishAiCallback_UnitDef_isActivateWhenBuilt;
-	callback->UnitDef_isOnOffable = &skirmishAiCallback_UnitDef_isOnOffable;
-	callback->UnitDef_isFullHealthFactory = &skirmishAiCallback_UnitDef_isFullHealthFactory;
-	callback->UnitDef_isFactoryHeadingTakeoff = &skirmishAiCallback_UnitDef_isFactoryHeadingTakeoff;
-	callback->UnitDef_isReclaimable = &skirmishAiCallback_UnitDef_isReclaimable;
-	callback->UnitDef_isCapturable = &skirmishAiCallback_UnitDef_isCapturable;
-	callback->UnitDef_isAbleToRestore = &skirmishAiCallback_UnitDef_isAbleToRestore;
-	callback->UnitDef_isAbleToRepair = &skirmishAiCallback_UnitDef_isAbleToRepair;
-	callback->UnitDef_isAbleToSelfRepair = &skirmishAiCallback_UnitDef_isAbleToSelfRepair;
-	callback->UnitDef_isAbleToReclaim = &skirmishAiCallback_UnitDef_isAbleToReclaim;
-	callback->UnitDef_isAbleToAttack = &skirmishAiCallback_UnitDef_isAbleToAttack;
-	callback->UnitDef_isAbleToPatrol = &skirmishAiCallback_UnitDef_isAbleToPatrol;
-	callback->UnitDef_isAbleToFight = &skirmishAiCallback_UnitDef_isAbleToFight;
-	callback->UnitDef_isAbleToGuard = &skirmishAiCallback_UnitDef_isAbleToGuard;
-	callback->UnitDef_isAbleToAssist = &skirmishAiCallback_UnitDef_isAbleToAssist;
-	callback->UnitDef_isAssistable = &skirmishAiCallback_UnitDef_isAssistable;
-	callback->UnitDef_isAbleToRepeat = &skirmishAiCallback_UnitDef_isAbleToRepeat;
-	callback->UnitDef_isAbleToFireControl = &skirmishAiCallback_UnitDef_isAbleToFireControl;
-	callback->UnitDef_getFireState = &skirmishAiCallback_UnitDef_getFireState;
-	callback->UnitDef_getMoveState = &skirmishAiCallback_UnitDef_getMoveState;
-	callback->UnitDef_getWingDrag = &skirmishAiCallback_UnitDef_getWingDrag;
-	callback->UnitDef_getWingAngle = &skirmishAiCallback_UnitDef_getWingAngle;
-	callback->UnitDef_getDrag = &skirmishAiCallback_UnitDef_getDrag;
-	callback->UnitDef_getFrontToSpeed = &skirmishAiCallback_UnitDef_getFrontToSpeed;
-	callback->UnitDef_getSpeedToFront = &skirmishAiCallback_UnitDef_getSpeedToFront;
-	callback->UnitDef_getMyGravity = &skirmishAiCallback_UnitDef_getMyGravity;
-	callback->UnitDef_getMaxBank = &skirmishAiCallback_UnitDef_getMaxBank;
-	callback->UnitDef_getMaxPitch = &skirmishAiCallback_UnitDef_getMaxPitch;
-	callback->UnitDef_getTurnRadius = &skirmishAiCallback_UnitDef_getTurnRadius;
-	callback->UnitDef_getWantedHeight = &skirmishAiCallback_UnitDef_getWantedHeight;
-	callback->UnitDef_getVerticalSpeed = &skirmishAiCallback_UnitDef_getVerticalSpeed;
-	callback->UnitDef_isAbleToCrash = &skirmishAiCallback_UnitDef_isAbleToCrash;
-	callback->UnitDef_isHoverAttack = &skirmishAiCallback_UnitDef_isHoverAttack;
-	callback->UnitDef_isAirStrafe = &skirmishAiCallback_UnitDef_isAirStrafe;
-	callback->UnitDef_getDlHoverFactor = &skirmishAiCallback_UnitDef_getDlHoverFactor;
-	callback->UnitDef_getMaxAcceleration = &skirmishAiCallback_UnitDef_getMaxAcceleration;
-	callback->UnitDef_getMaxDeceleration = &skirmishAiCallback_UnitDef_getMaxDeceleration;
-	callback->UnitDef_getMaxAileron = &skirmishAiCallback_UnitDef_getMaxAileron;
-	callback->UnitDef_getMaxElevator = &skirmishAiCallback_UnitDef_getMaxElevator;
-	callback->UnitDef_getMaxRudder = &skirmishAiCallback_UnitDef_getMaxRudder;
-	callback->UnitDef_getYardMap = &skirmishAiCallback_UnitDef_getYardMap;
-	callback->UnitDef_getXSize = &skirmishAiCallback_UnitDef_getXSize;
-	callback->UnitDef_getZSize = &skirmishAiCallback_UnitDef_getZSize;
-	callback->UnitDef_getBuildAngle = &skirmishAiCallback_UnitDef_getBuildAngle;
-	callback->UnitDef_getLoadingRadius = &skirmishAiCallback_UnitDef_getLoadingRadius;
-	callback->UnitDef_getUnloadSpread = &skirmishAiCallback_UnitDef_getUnloadSpread;
-	callback->UnitDef_getTransportCapacity = &skirmishAiCallback_UnitDef_getTransportCapacity;
-	callback->UnitDef_getTransportSize = &skirmishAiCallback_UnitDef_getTransportSize;
-	callback->UnitDef_getMinTransportSize = &skirmishAiCallback_UnitDef_getMinTransportSize;
-	callback->UnitDef_isAirBase = &skirmishAiCallback_UnitDef_isAirBase;
-	callback->UnitDef_isFirePlatform = &skirmishAiCallback_UnitDef_isFirePlatform;
-	callback->UnitDef_getTransportMass = &skirmishAiCallback_UnitDef_getTransportMass;
-	callback->UnitDef_getMinTransportMass = &skirmishAiCallback_UnitDef_getMinTransportMass;
-	callback->UnitDef_isHoldSteady = &skirmishAiCallback_UnitDef_isHoldSteady;
-	callback->UnitDef_isReleaseHeld = &skirmishAiCallback_UnitDef_isReleaseHeld;
-	callback->UnitDef_isNotTransportable = &skirmishAiCallback_UnitDef_isNotTransportable;
-	callback->UnitDef_isTransportByEnemy = &skirmishAiCallback_UnitDef_isTransportByEnemy;
-	callback->UnitDef_getTransportUnloadMethod = &skirmishAiCallback_UnitDef_getTransportUnloadMethod;
-	callback->UnitDef_getFallSpeed = &skirmishAiCallback_UnitDef_getFallSpeed;
-	callback->UnitDef_getUnitFallSpeed = &skirmishAiCallback_UnitDef_getUnitFallSpeed;
-	callback->UnitDef_isAbleToCloak = &skirmishAiCallback_UnitDef_isAbleToCloak;
-	callback->UnitDef_isStartCloaked = &skirmishAiCallback_UnitDef_isStartCloaked;
-	callback->UnitDef_getCloakCost = &skirmishAiCallback_UnitDef_getCloakCost;
-	callback->UnitDef_getCloakCostMoving = &skirmishAiCallback_UnitDef_getCloakCostMoving;
-	callback->UnitDef_getDecloakDistance = &skirmishAiCallback_UnitDef_getDecloakDistance;
-	callback->UnitDef_isDecloakSpherical = &skirmishAiCallback_UnitDef_isDecloakSpherical;
-	callback->UnitDef_isDecloakOnFire = &skirmishAiCallback_UnitDef_isDecloakOnFire;
-	callback->UnitDef_isAbleToKamikaze = &skirmishAiCallback_UnitDef_isAbleToKamikaze;
-	callback->UnitDef_getKamikazeDist = &skirmishAiCallback_UnitDef_getKamikazeDist;
-	callback->UnitDef_isTargetingFacility = &skirmishAiCallback_UnitDef_isTargetingFacility;
-	callback->UnitDef_canManualFire = &skirmishAiCallback_UnitDef_canManualFire;
-	callback->UnitDef_isNeedGeo = &skirmishAiCallback_UnitDef_isNeedGeo;
-	callback->UnitDef_isFeature = &skirmishAiCallback_UnitDef_isFeature;
-	callback->UnitDef_isHideDamage = &skirmishAiCallback_UnitDef_isHideDamage;
-	callback->UnitDef_isCommander = &skirmishAiCallback_UnitDef_isCommander;
-	callback->UnitDef_isShowPlayerName = &skirmishAiCallback_UnitDef_isShowPlayerName;
-	callback->UnitDef_isAbleToResurrect = &skirmishAiCallback_UnitDef_isAbleToResurrect;
-	callback->UnitDef_isAbleToCapture = &skirmishAiCallback_UnitDef_isAbleToCapture;
-	callback->UnitDef_getHighTrajectoryType = &skirmishAiCallback_UnitDef_getHighTrajectoryType;
-	callback->UnitDef_getNoChaseCategory = &skirmishAiCallback_UnitDef_getNoChaseCategory;
-	callback->UnitDef_isLeaveTracks = &skirmishAiCallback_UnitDef_isLeaveTracks;
-	callback->UnitDef_getTrackWidth = &skirmishAiCallback_UnitDef_getTrackWidth;
-	callback->UnitDef_getTrackOffset = &skirmishAiCallback_UnitDef_getTrackOffset;
-	callback->UnitDef_getTrackStrength = &skirmishAiCallback_UnitDef_getTrackStrength;
-	callback->UnitDef_getTrackStretch = &skirmishAiCallback_UnitDef_getTrackStretch;
-	callback->UnitDef_getTrackType = &skirmishAiCallback_UnitDef_getTrackType;
-	callback->UnitDef_isAbleToDropFlare = &skirmishAiCallback_UnitDef_isAbleToDropFlare;
-	callback->UnitDef_getFlareReloadTime = &skirmishAiCallback_UnitDef_getFlareReloadTime;
-	callback->UnitDef_getFlareEfficiency = &skirmishAiCallback_UnitDef_getFlareEfficiency;
-	callback->UnitDef_getFlareDelay = &skirmishAiCallback_UnitDef_getFlareDelay;
-	callback->UnitDef_getFlareDropVector = &skirmishAiCallback_UnitDef_getFlareDropVector;
-	callback->UnitDef_getFlareTime = &skirmishAiCallback_UnitDef_getFlareTime;
-	callback->UnitDef_getFlareSalvoSize = &skirmishAiCallback_UnitDef_getFlareSalvoSize;
-	callback->UnitDef_getFlareSalvoDelay = &skirmishAiCallback_UnitDef_getFlareSalvoDelay;
-	callback->UnitDef_isAbleToLoopbackAttack = &skirmishAiCallback_UnitDef_isAbleToLoopbackAttack;
-	callback->UnitDef_isLevelGround = &skirmishAiCallback_UnitDef_isLevelGround;
-	callback->UnitDef_isUseBuildingGroundDecal = &skirmishAiCallback_UnitDef_isUseBuildingGroundDecal;
-	callback->UnitDef_getBuildingDecalType = &skirmishAiCallback_UnitDef_getBuildingDecalType;
-	callback->UnitDef_getBuildingDecalSizeX = &skirmishAiCallback_UnitDef_getBuildingDecalSizeX;
-	callback->UnitDef_getBuildingDecalSizeY = &skirmishAiCallback_UnitDef_getBuildingDecalSizeY;
-	callback->UnitDef_getBuildingDecalDecaySpeed = &skirmishAiCallback_UnitDef_getBuildingDecalDecaySpeed;
-	callback->UnitDef_getMaxFuel = &skirmishAiCallback_UnitDef_getMaxFuel;
-	callback->UnitDef_getRefuelTime = &skirmishAiCallback_UnitDef_getRefuelTime;
-	callback->UnitDef_getMinAirBasePower = &skirmishAiCallback_UnitDef_getMinAirBasePower;
-	callback->UnitDef_getMaxThisUnit = &skirmishAiCallback_UnitDef_getMaxThisUnit;
-	callback->UnitDef_getDecoyDef = &skirmishAiCallback_UnitDef_getDecoyDef;
-	callback->UnitDef_isDontLand = &skirmishAiCallback_UnitDef_isDontLand;
-	callback->UnitDef_getShieldDef = &skirmishAiCallback_UnitDef_getShieldDef;
-	callback->UnitDef_getStockpileDef = &skirmishAiCallback_UnitDef_getStockpileDef;
-	callback->UnitDef_getBuildOptions = &skirmishAiCallback_UnitDef_getBuildOptions;
-	callback->UnitDef_getCustomParams = &skirmishAiCallback_UnitDef_getCustomParams;
-	callback->UnitDef_isMoveDataAvailable = &skirmishAiCallback_UnitDef_isMoveDataAvailable;
-	callback->UnitDef_MoveData_getMaxAcceleration = &skirmishAiCallback_UnitDef_MoveData_getMaxAcceleration;
-	callback->UnitDef_MoveData_getMaxBreaking = &skirmishAiCallback_UnitDef_MoveData_getMaxBreaking;
-	callback->UnitDef_MoveData_getMaxSpeed = &skirmishAiCallback_UnitDef_MoveData_getMaxSpeed;
-	callback->UnitDef_MoveData_getMaxTurnRate = &skirmishAiCallback_UnitDef_MoveData_getMaxTurnRate;
-	callback->UnitDef_MoveData_getXSize = &skirmishAiCallback_UnitDef_MoveData_getXSize;
-	callback->UnitDef_MoveData_getZSize = &skirmishAiCallback_UnitDef_MoveData_getZSize;
-	callback->UnitDef_MoveData_getDepth = &skirmishAiCallback_UnitDef_MoveData_getDepth;
-	callback->UnitDef_MoveData_getMaxSlope = &skirmishAiCallback_UnitDef_MoveData_getMaxSlope;
-	callback->UnitDef_MoveData_getSlopeMod = &skirmishAiCallback_UnitDef_MoveData_getSlopeMod;
-	callback->UnitDef_MoveData_getDepthMod = &skirmishAiCallback_UnitDef_MoveData_getDepthMod;
-	callback->UnitDef_MoveData_getPathType = &skirmishAiCallback_UnitDef_MoveData_getPathType;
-	callback->UnitDef_MoveData_getCrushStrength = &skirmishAiCallback_UnitDef_MoveData_getCrushStrength;
-	callback->UnitDef_MoveData_getMoveType = &skirmishAiCallback_UnitDef_MoveData_getMoveType;
-	callback->UnitDef_MoveData_getMoveFamily = &skirmishAiCallback_UnitDef_MoveData_getMoveFamily;
-	callback->UnitDef_MoveData_getTerrainClass = &skirmishAiCallback_UnitDef_MoveData_getTerrainClass;
-	callback->UnitDef_MoveData_getFollowGround = &skirmishAiCallback_UnitDef_MoveData_getFollowGround;
-	callback->UnitDef_MoveData_isSubMarine = &skirmishAiCallback_UnitDef_MoveData_isSubMarine;
-	callback->UnitDef_MoveData_getName = &skirmishAiCallback_UnitDef_MoveData_getName;
-	callback->UnitDef_getWeaponMounts = &skirmishAiCallback_UnitDef_getWeaponMounts;
-	callback->UnitDef_WeaponMount_getName = &skirmishAiCallback_UnitDef_WeaponMount_getName;
-	callback->UnitDef_WeaponMount_getWeaponDef = &skirmishAiCallback_UnitDef_WeaponMount_getWeaponDef;
-	callback->UnitDef_WeaponMount_getSlavedTo = &skirmishAiCallback_UnitDef_WeaponMount_getSlavedTo;
-	callback->UnitDef_WeaponMount_getMainDir = &skirmishAiCallback_UnitDef_WeaponMount_getMainDir;
-	callback->UnitDef_WeaponMount_getMaxAngleDif = &skirmishAiCallback_UnitDef_WeaponMount_getMaxAngleDif;
-	callback->UnitDef_WeaponMount_getFuelUsage = &skirmishAiCallback_UnitDef_WeaponMount_getFuelUsage;
-	callback->UnitDef_WeaponMount_getBadTargetCategory = &skirmishAiCallback_UnitDef_WeaponMount_getBadTargetCategory;
-	callback->UnitDef_WeaponMount_getOnlyTargetCategory = &skirmishAiCallback_UnitDef_WeaponMount_getOnlyTargetCategory;
-	callback->Unit_getLimit = &skirmishAiCallback_Unit_getLimit;
-	callback->Unit_getMax = &skirmishAiCallback_Unit_getMax;
-	callback->getEnemyUnits = &skirmishAiCallback_getEnemyUnits;
-	callback->getEnemyUnitsIn = &skirmishAiCallback_getEnemyUnitsIn;
-	callback->getEnemyUnitsInRadarAndLos = &skirmishAiCallback_getEnemyUnitsInRadarAndLos;
-	callback->getFriendlyUnits = &skirmishAiCallback_getFriendlyUnits;
-	callback->getFriendlyUnitsIn = &skirmishAiCallback_getFriendlyUnitsIn;
-	callback->getNeutralUnits = &skirmishAiCallback_getNeutralUnits;
-	callback->getNeutralUnitsIn = &skirmishAiCallback_getNeutralUnitsIn;
-	callback->getTeamUnits = &skirmishAiCallback_getTeamUnits;
-	callback->getSelectedUnits = &skirmishAiCallback_getSelectedUnits;
-	callback->Unit_getDef = &skirmishAiCallback_Unit_getDef;
-	callback->Unit_getModParams = &skirmishAiCallback_Unit_getModParams;
-	callback->Unit_ModParam_getName = &skirmishAiCallback_Unit_ModParam_getName;
-	callback->Unit_ModParam_getValue = &skirmishAiCallback_Unit_ModParam_getValue;
-	callback->Unit_getTeam = &skirmishAiCallback_Unit_getTeam;
-	callback->Unit_getAllyTeam = &skirmishAiCallback_Unit_getAllyTeam;
-	callback->Unit_getAiHint = &skirmishAiCallback_Unit_getAiHint;
-	callback->Unit_getStockpile = &skirmishAiCallback_Unit_getStockpile;
-	callback->Unit_getStockpileQueued = &skirmishAiCallback_Unit_getStockpileQueued;
-	callback->Unit_getCurrentFuel = &skirmishAiCallback_Unit_getCurrentFuel;
-	callback->Unit_getMaxSpeed = &skirmishAiCallback_Unit_getMaxSpeed;
-	callback->Unit_getMaxRange = &skirmishAiCallback_Unit_getMaxRange;
-	callback->Unit_getMaxHealth = &skirmishAiCallback_Unit_getMaxHealth;
-	callback->Unit_getExperience = &skirmishAiCallback_Unit_getExperience;
-	callback->Unit_getGroup = &skirmishAiCallback_Unit_getGroup;
-	callback->Unit_getCurrentCommands = &skirmishAiCallback_Unit_getCurrentCommands;
-	callback->Unit_CurrentCommand_getType = &skirmishAiCallback_Unit_CurrentCommand_getType;
-	callback->Unit_CurrentCommand_getId = &skirmishAiCallback_Unit_CurrentCommand_getId;
-	callback->Unit_CurrentCommand_getOptions = &skirmishAiCallback_Unit_CurrentCommand_getOptions;
-	callback->Unit_CurrentCommand_getTag = &skirmishAiCallback_Unit_CurrentCommand_getTag;
-	callback->Unit_CurrentCommand_getTimeOut = &skirmishAiCallback_Unit_CurrentCommand_getTimeOut;
-	callback->Unit_CurrentCommand_getParams = &skirmishAiCallback_Unit_CurrentCommand_getParams;
-	callback->Unit_getSupportedCommands = &skirmishAiCallback_Unit_getSupportedCommands;
-	callback->Unit_SupportedCommand_getId = &skirmishAiCallback_Unit_SupportedCommand_getId;
-	callback->Unit_SupportedCommand_getName = &skirmishAiCallback_Unit_SupportedCommand_getName;
-	callback->Unit_SupportedCommand_getToolTip = &skirmishAiCallback_Unit_SupportedCommand_getToolTip;
-	callback->Unit_SupportedCommand_isShowUnique = &skirmishAiCallback_Unit_SupportedCommand_isShowUnique;
-	callback->Unit_SupportedCommand_isDisabled = &skirmishAiCallback_Unit_SupportedCommand_isDisabled;
-	callback->Unit_SupportedCommand_getParams = &skirmishAiCallback_Unit_SupportedCommand_getParams;
-	callback->Unit_getHealth = &skirmishAiCallback_Unit_getHealth;
-	callback->Unit_getSpeed = &skirmishAiCallback_Unit_getSpeed;
-	callback->Unit_getPower = &skirmishAiCallback_Unit_getPower;
-	callback->Unit_getResourceUse = &skirmishAiCallback_Unit_getResourceUse;
-	callback->Unit_getResourceMake = &skirmishAiCallback_Unit_getResourceMake;
-	callback->Unit_getPos = &skirmishAiCallback_Unit_getPos;
-	callback->Unit_getVel = &skirmishAiCallback_Unit_getVel;
-	callback->Unit_isActivated = &skirmishAiCallback_Unit_isActivated;
-	callback->Unit_isBeingBuilt = &skirmishAiCallback_Unit_isBeingBuilt;
-	callback->Unit_isCloaked = &skirmishAiCallback_Unit_isCloaked;
-	callback->Unit_isParalyzed = &skirmishAiCallback_Unit_isParalyzed;
-	callback->Unit_isNeutral = &skirmishAiCallback_Unit_isNeutral;
-	callback->Unit_getBuildingFacing = &skirmishAiCallback_Unit_getBuildingFacing;
-	callback->Unit_getLastUserOrderFrame = &skirmishAiCallback_Unit_getLastUserOrderFrame;
-	callback->getGroups = &skirmishAiCallback_getGroups;
-	callback->Group_getSupportedCommands = &skirmishAiCallback_Group_getSupportedCommands;
-	callback->Group_SupportedCommand_getId = &skirmishAiCallback_Group_SupportedCommand_getId;
-	callback->Group_SupportedCommand_getName = &skirmishAiCallback_Group_SupportedCommand_getName;
-	callback->Group_SupportedCommand_getToolTip = &skirmishAiCallback_Group_SupportedCommand_getToolTip;
-	callback->Group_SupportedCommand_isShowUnique = &skirmishAiCallback_Group_SupportedCommand_isShowUnique;
-	callback->Group_SupportedCommand_isDisabled = &skirmishAiCallback_Group_SupportedCommand_isDisabled;
-	callback->Group_SupportedCommand_getParams = &skirmishAiCallback_Group_SupportedCommand_getParams;
-	callback->Group_OrderPreview_getId = &skirmishAiCallback_Group_OrderPreview_getId;
-	callback->Group_OrderPreview_getOptions = &skirmishAiCallback_Group_OrderPreview_getOptions;
-	callback->Group_OrderPreview_getTag = &skirmishAiCallback_Group_OrderPreview_getTag;
-	callback->Group_OrderPreview_getTimeOut = &skirmishAiCallback_Group_OrderPreview_getTimeOut;
-	callback->Group_OrderPreview_getParams = &skirmishAiCallback_Group_OrderPreview_getParams;
-	callback->Group_isSelected = &skirmishAiCallback_Group_isSelected;
-	callback->Mod_getFileName = &skirmishAiCallback_Mod_getFileName;
-	callback->Mod_getHash = &skirmishAiCallback_Mod_getHash;
-	callback->Mod_getHumanName = &skirmishAiCallback_Mod_getHumanName;
-	callback->Mod_getShortName = &skirmishAiCallback_Mod_getShortName;
-	callback->Mod_getVersion = &skirmishAiCallback_Mod_getVersion;
-	callback->Mod_getMutator = &skirmishAiCallback_Mod_getMutator;
-	callback->Mod_getDescription = &skirmishAiCallback_Mod_getDescription;
-	callback->Mod_getAllowTeamColors = &skirmishAiCallback_Mod_getAllowTeamColors;
-	callback->Mod_getConstructionDecay = &skirmishAiCallback_Mod_getConstructionDecay;
-	callback->Mod_getConstructionDecayTime = &skirmishAiCallback_Mod_getConstructionDecayTime;
-	callback->Mod_getConstructionDecaySpeed = &skirmishAiCallback_Mod_getConstructionDecaySpeed;
-	callback->Mod_getMultiReclaim = &skirmishAiCallback_Mod_getMultiReclaim;
-	callback->Mod_getReclaimMethod = &skirmishAiCallback_Mod_getReclaimMethod;
-	callback->Mod_getReclaimUnitMethod = &skirmishAiCallback_Mod_getReclaimUnitMethod;
-	callback->Mod_getReclaimUnitEnergyCostFactor = &skirmishAiCallback_Mod_getReclaimUnitEnergyCostFactor;
-	callback->Mod_getReclaimUnitEfficiency = &skirmishAiCallback_Mod_getReclaimUnitEfficiency;
-	callback->Mod_getReclaimFeatureEnergyCostFactor = &skirmishAiCallback_Mod_getReclaimFeatureEnergyCostFactor;
-	callback->Mod_getReclaimAllowEnemies = &skirmishAiCallback_Mod_getReclaimAllowEnemies;
-	callback->Mod_getReclaimAllowAllies = &skirmishAiCallback_Mod_getReclaimAllowAllies;
-	callback->Mod_getRepairEnergyCostFactor = &skirmishAiCallback_Mod_getRepairEnergyCostFactor;
-	callback->Mod_getResurrectEnergyCostFactor = &skirmishAiCallback_Mod_getResurrectEnergyCostFactor;
-	callback->Mod_getCaptureEnergyCostFactor = &skirmishAiCallback_Mod_getCaptureEnergyCostFactor;
-	callback->Mod_getTransportGround = &skirmishAiCallback_Mod_getTransportGround;
-	callback->Mod_getTransportHover = &skirmishAiCallback_Mod_getTransportHover;
-	callback->Mod_getTransportShip = &skirmishAiCallback_Mod_getTransportShip;
-	callback->Mod_getTransportAir = &skirmishAiCallback_Mod_getTransportAir;
-	callback->Mod_getFireAtKilled = &skirmishAiCallback_Mod_getFireAtKilled;
-	callback->Mod_getFireAtCrashing = &skirmishAiCallback_Mod_getFireAtCrashing;
-	callback->Mod_getFlankingBonusModeDefault = &skirmishAiCallback_Mod_getFlankingBonusModeDefault;
-	callback->Mod_getLosMipLevel = &skirmishAiCallback_Mod_getLosMipLevel;
-	callback->Mod_getAirMipLevel = &skirmishAiCallback_Mod_getAirMipLevel;
-	callback->Mod_getLosMul = &skirmishAiCallback_Mod_getLosMul;
-	callback->Mod_getAirLosMul = &skirmishAiCallback_Mod_getAirLosMul;
-	callback->Mod_getRequireSonarUnderWater = &skirmishAiCallback_Mod_getRequireSonarUnderWater;
-	callback->Map_getChecksum = &skirmishAiCallback_Map_getChecksum;
-	callback->Map_getStartPos = &skirmishAiCallback_Map_getStartPos;
-	callback->Map_getMousePos = &skirmishAiCallback_Map_getMousePos;
-	callback->Map_isPosInCamera = &skirmishAiCallback_Map_isPosInCamera;
-	callback->Map_getWidth = &skirmishAiCallback_Map_getWidth;
-	callback->Map_getHeight = &skirmishAiCallback_Map_getHeight;
-	callback->Map_getHeightMap = &skirmishAiCallback_Map_getHeightMap;
-	callback->Map_getCornersHeightMap = &skirmishAiCallback_Map_getCornersHeightMap;
-	callback->Map_getMinHeight = &skirmishAiCallback_Map_getMinHeight;
-	callback->Map_getMaxHeight = &skirmishAiCallback_Map_getMaxHeight;
-	callback->Map_getSlopeMap = &skirmishAiCallback_Map_getSlopeMap;
-	callback->Map_getLosMap = &skirmishAiCallback_Map_getLosMap;
-	callback->Map_getRadarMap = &skirmishAiCallback_Map_getRadarMap;
-	callback->Map_getJammerMap = &skirmishAiCallback_Map_getJammerMap;
-	callback->Map_getResourceMapRaw = &skirmishAiCallback_Map_getResourceMapRaw;
-	callback->Map_getResourceMapSpotsPositions = &skirmishAiCallback_Map_getResourceMapSpotsPositions;
-	callback->Map_getResourceMapSpotsAverageIncome = &skirmishAiCallback_Map_getResourceMapSpotsAverageIncome;
-	callback->Map_getResourceMapSpotsNearest = &skirmishAiCallback_Map_getResourceMapSpotsNearest;
-	callback->Map_getHash = &skirmishAiCallback_Map_getHash;
-	callback->Map_getName = &skirmishAiCallback_Map_getName;
-	callback->Map_getHumanName = &skirmishAiCallback_Map_getHumanName;
-	callback->Map_getElevationAt = &skirmishAiCallback_Map_getElevationAt;
-	callback->Map_getMaxResource = &skirmishAiCallback_Map_getMaxResource;
-	callback->Map_getExtractorRadius = &skirmishAiCallback_Map_getExtractorRadius;
-	callback->Map_getMinWind = &skirmishAiCallback_Map_getMinWind;
-	callback->Map_getMaxWind = &skirmishAiCallback_Map_getMaxWind;
-	callback->Map_getCurWind = &skirmishAiCallback_Map_getCurWind;
-	callback->Map_getTidalStrength = &skirmishAiCallback_Map_getTidalStrength;
-	callback->Map_getGravity = &skirmishAiCallback_Map_getGravity;
-	callback->Map_getPoints = &skirmishAiCallback_Map_getPoints;
-	callback->Map_Point_getPosition = &skirmishAiCallback_Map_Point_getPosition;
-	callback->Map_Point_getColor = &skirmishAiCallback_Map_Point_getColor;
-	callback->Map_Point_getLabel = &skirmishAiCallback_Map_Point_getLabel;
-	callback->Map_getLines = &skirmishAiCallback_Map_getLines;
-	callback->Map_Line_getFirstPosition = &skirmishAiCallback_Map_Line_getFirstPosition;
-	callback->Map_Line_getSecondPosition = &skirmishAiCallback_Map_Line_getSecondPosition;
-	callback->Map_Line_getColor = &skirmishAiCallback_Map_Line_getColor;
-	callback->Map_isPossibleToBuildAt = &skirmishAiCallback_Map_isPossibleToBuildAt;
-	callback->Map_findClosestBuildSite = &skirmishAiCallback_Map_findClosestBuildSite;
-	callback->getFeatureDefs = &skirmishAiCallback_getFeatureDefs;
-	callback->FeatureDef_getName = &skirmishAiCallback_FeatureDef_getName;
-	callback->FeatureDef_getDescription = &skirmishAiCallback_FeatureDef_getDescription;
-	callback->FeatureDef_getFileName = &skirmishAiCallback_FeatureDef_getFileName;
-	callback->FeatureDef_getContainedResource = &skirmishAiCallback_FeatureDef_getContainedResource;
-	callback->FeatureDef_getMaxHealth = &skirmishAiCallback_FeatureDef_getMaxHealth;
-	callback->FeatureDef_getReclaimTime = &skirmishAiCallback_FeatureDef_getReclaimTime;
-	callback->FeatureDef_getMass = &skirmishAiCallback_FeatureDef_getMass;
-	callback->FeatureDef_isUpright = &skirmishAiCallback_FeatureDef_isUpright;
-	callback->FeatureDef_getDrawType = &skirmishAiCallback_FeatureDef_getDrawType;
-	callback->FeatureDef_getModelName = &skirmishAiCallback_FeatureDef_getModelName;
-	callback->FeatureDef_getResurrectable = &skirmishAiCallback_FeatureDef_getResurrectable;
-	callback->FeatureDef_getSmokeTime = &skirmishAiCallback_FeatureDef_getSmokeTime;
-	callback->FeatureDef_isDestructable = &skirmishAiCallback_FeatureDef_isDestructable;
-	callback->FeatureDef_isReclaimable = &skirmishAiCallback_FeatureDef_isReclaimable;
-	callback->FeatureDef_isBlocking = &skirmishAiCallback_FeatureDef_isBlocking;
-	callback->FeatureDef_isBurnable = &skirmishAiCallback_FeatureDef_isBurnable;
-	callback->FeatureDef_isFloating = &skirmishAiCallback_FeatureDef_isFloating;
-	callback->FeatureDef_isNoSelect = &skirmishAiCallback_FeatureDef_isNoSelect;
-	callback->FeatureDef_isGeoThermal = &skirmishAiCallback_FeatureDef_isGeoThermal;
-	callback->FeatureDef_getDeathFeature = &skirmishAiCallback_FeatureDef_getDeathFeature;
-	callback->FeatureDef_getXSize = &skirmishAiCallback_FeatureDef_getXSize;
-	callback->FeatureDef_getZSize = &skirmishAiCallback_FeatureDef_getZSize;
-	callback->FeatureDef_getCustomParams = &skirmishAiCallback_FeatureDef_getCustomParams;
-	callback->getFeatures = &skirmishAiCallback_getFeatures;
-	callback->getFeaturesIn = &skirmishAiCallback_getFeaturesIn;
-	callback->Feature_getDef = &skirmishAiCallback_Feature_getDef;
-	callback->Feature_getHealth = &skirmishAiCallback_Feature_getHealth;
-	callback->Feature_getReclaimLeft = &skirmishAiCallback_Feature_getReclaimLeft;
-	callback->Feature_getPosition = &skirmishAiCallback_Feature_getPosition;
-	callback->getWeaponDefs = &skirmishAiCallback_getWeaponDefs;
-	callback->getWeaponDefByName = &skirmishAiCallback_getWeaponDefByName;
-	callback->WeaponDef_getName = &skirmishAiCallback_WeaponDef_getName;
-	callback->WeaponDef_getType = &skirmishAiCallback_WeaponDef_getType;
-	callback->WeaponDef_getDescription = &skirmishAiCallback_WeaponDef_getDescription;
-	callback->WeaponDef_getFileName = &skirmishAiCallback_WeaponDef_getFileName;
-	callback->WeaponDef_getCegTag = &skirmishAiCallback_WeaponDef_getCegTag;
-	callback->WeaponDef_getRange = &skirmishAiCallback_WeaponDef_getRange;
-	callback->WeaponDef_getHeightMod = &skirmishAiCallback_WeaponDef_getHeightMod;
-	callback->WeaponDef_getAccuracy = &skirmishAiCallback_WeaponDef_getAccuracy;
-	callback->WeaponDef_getSprayAngle = &skirmishAiCallback_WeaponDef_getSprayAngle;
-	callback->WeaponDef_getMovingAccuracy = &skirmishAiCallback_WeaponDef_getMovingAccuracy;
-	callback->WeaponDef_getTargetMoveError = &skirmishAiCallback_WeaponDef_getTargetMoveError;
-	callback->WeaponDef_getLeadLimit = &skirmishAiCallback_WeaponDef_getLeadLimit;
-	callback->WeaponDef_getLeadBonus = &skirmishAiCallback_WeaponDef_getLeadBonus;
-	callback->WeaponDef_getPredictBoost = &skirmishAiCallback_WeaponDef_getPredictBoost;
-	callback->WeaponDef_getNumDamageTypes = &skirmishAiCallback_WeaponDef_getNumDamageTypes;
-	callback->WeaponDef_Damage_getParalyzeDamageTime = &skirmishAiCallback_WeaponDef_Damage_getParalyzeDamageTime;
-	callback->WeaponDef_Damage_getImpulseFactor = &skirmishAiCallback_WeaponDef_Damage_getImpulseFactor;
-	callback->WeaponDef_Damage_getImpulseBoost = &skirmishAiCallback_WeaponDef_Damage_getImpulseBoost;
-	callback->WeaponDef_Damage_getCraterMult = &skirmishAiCallback_WeaponDef_Damage_getCraterMult;
-	callback->WeaponDef_Damage_getCraterBoost = &skirmishAiCallback_WeaponDef_Damage_getCraterBoost;
-	callback->WeaponDef_Damage_getTypes = &skirmishAiCallback_WeaponDef_Damage_getTypes;
-	callback->WeaponDef_getAreaOfEffect = &skirmishAiCallback_WeaponDef_getAreaOfEffect;
-	callback->WeaponDef_isNoSelfDamage = &skirmishAiCallback_WeaponDef_isNoSelfDamage;
-	callback->WeaponDef_getFireStarter = &skirmishAiCallback_WeaponDef_getFireStarter;
-	callback->WeaponDef_getEdgeEffectiveness = &skirmishAiCallback_WeaponDef_getEdgeEffectiveness;
-	callback->WeaponDef_getSize = &skirmishAiCallback_WeaponDef_getSize;
-	callback->WeaponDef_getSizeGrowth = &skirmishAiCallback_WeaponDef_getSizeGrowth;
-	callback->WeaponDef_getCollisionSize = &skirmishAiCallback_WeaponDef_getCollisionSize;
-	callback->WeaponDef_getSalvoSize = &skirmishAiCallback_WeaponDef_getSalvoSize;
-	callback->WeaponDef_getSalvoDelay = &skirmishAiCallback_WeaponDef_getSalvoDelay;
-	callback->WeaponDef_getReload = &skirmishAiCallback_WeaponDef_getReload;
-	callback->WeaponDef_getBeamTime = &skirmishAiCallback_WeaponDef_getBeamTime;
-	callback->WeaponDef_isBeamBurst = &skirmishAiCallback_WeaponDef_isBeamBurst;
-	callback->WeaponDef_isWaterBounce = &skirmishAiCallback_WeaponDef_isWaterBounce;
-	callback->WeaponDef_isGroundBounce = &skirmishAiCallback_WeaponDef_isGroundBounce;
-	callback->WeaponDef_getBounceRebound = &skirmishAiCallback_WeaponDef_getBounceRebound;
-	callback->WeaponDef_getBounceSlip = &skirmishAiCallback_WeaponDef_getBounceSlip;
-	callback->WeaponDef_getNumBounce = &skirmishAiCallback_WeaponDef_getNumBounce;
-	callback->WeaponDef_getMaxAngle = &skirmishAiCallback_WeaponDef_getMaxAngle;
-	callback->WeaponDef_getUpTime = &skirmishAiCallback_WeaponDef_getUpTime;
-	callback->WeaponDef_getFlightTime = &skirmishAiCallback_WeaponDef_getFlightTime;
-	callback->WeaponDef_getCost = &skirmishAiCallback_WeaponDef_getCost;
-	callback->WeaponDef_getProjectilesPerShot = &skirmishAiCallback_WeaponDef_getProjectilesPerShot;
-	callback->WeaponDef_isTurret = &skirmishAiCallback_WeaponDef_isTurret;
-	callback->WeaponDef_isOnlyForward = &skirmishAiCallback_WeaponDef_isOnlyForward;
-	callback->WeaponDef_isFixedLauncher = &skirmishAiCallback_WeaponDef_isFixedLauncher;
-	callback->WeaponDef_isWaterWeapon = &skirmishAiCallback_WeaponDef_isWaterWeapon;
-	callback->WeaponDef_isFireSubmersed = &skirmishAiCallback_WeaponDef_isFireSubmersed;
-	callback->WeaponDef_isSubMissile = &skirmishAiCallback_WeaponDef_isSubMissile;
-	callback->WeaponDef_isTracks = &skirmishAiCallback_WeaponDef_isTracks;
-	callback->WeaponDef_isDropped = &skirmishAiCallback_WeaponDef_isDropped;
-	callback->WeaponDef_isParalyzer = &skirmishAiCallback_WeaponDef_isParalyzer;
-	callback->WeaponDef_isImpactOnly = &skirmishAiCallback_WeaponDef_isImpactOnly;
-	callback->WeaponDef_isNoAutoTarget = &skirmishAiCallback_WeaponDef_isNoAutoTarget;
-	callback->WeaponDef_isManualFire = &skirmishAiCallback_WeaponDef_isManualFire;
-	callback->WeaponDef_getInterceptor = &skirmishAiCallback_WeaponDef_getInterceptor;
-	callback->WeaponDef_getTargetable = &skirmishAiCallback_WeaponDef_getTargetable;
-	callback->WeaponDef_isStockpileable = &skirmishAiCallback_WeaponDef_isStockpileable;
-	callback->WeaponDef_getCoverageRange = &skirmishAiCallback_WeaponDef_getCoverageRange;
-	callback->WeaponDef_getStockpileTime = &skirmishAiCallback_WeaponDef_getStockpileTime;
-	callback->WeaponDef_getIntensity = &skirmishAiCallback_WeaponDef_getIntensity;
-	callback->WeaponDef_getThickness = &skirmishAiCallback_WeaponDef_getThickness;
-	callback->WeaponDef_getLaserFlareSize = &skirmishAiCallback_WeaponDef_getLaserFlareSize;
-	callback->WeaponDef_getCoreThickness = &skirmishAiCallback_WeaponDef_getCoreThickness;
-	callback->WeaponDef_getDuration = &skirmishAiCallback_WeaponDef_getDuration;
-	callback->WeaponDef_getLodDistance = &skirmishAiCallback_WeaponDef_getLodDistance;
-	callback->WeaponDef_getFalloffRate = &skirmishAiCallback_WeaponDef_getFalloffRate;
-	callback->WeaponDef_getGraphicsType = &skirmishAiCallback_WeaponDef_getGraphicsType;
-	callback->WeaponDef_isSoundTrigger = &skirmishAiCallback_WeaponDef_isSoundTrigger;
-	callback->WeaponDef_isSelfExplode = &skirmishAiCallback_WeaponDef_isSelfExplode;
-	callback->WeaponDef_isGravityAffected = &skirmishAiCallback_WeaponDef_isGravityAffected;
-	callback->WeaponDef_getHighTrajectory = &skirmishAiCallback_WeaponDef_getHighTrajectory;
-	callback->WeaponDef_getMyGravity = &skirmishAiCallback_WeaponDef_getMyGravity;
-	callback->WeaponDef_isNoExplode = &skirmishAiCallback_WeaponDef_isNoExplode;
-	callback->WeaponDef_getStartVelocity = &skirmishAiCallback_WeaponDef_getStartVelocity;
-	callback->WeaponDef_getWeaponAcceleration = &skirmishAiCallback_WeaponDef_getWeaponAcceleration;
-	callback->WeaponDef_getTurnRate = &skirmishAiCallback_WeaponDef_getTurnRate;
-	callback->WeaponDef_getMaxVelocity = &skirmishAiCallback_WeaponDef_getMaxVelocity;
-	callback->WeaponDef_getProjectileSpeed = &skirmishAiCallback_WeaponDef_getProjectileSpeed;
-	callback->WeaponDef_getExplosionSpeed = &skirmishAiCallback_WeaponDef_getExplosionSpeed;
-	callback->WeaponDef_getOnlyTargetCategory = &skirmishAiCallback_WeaponDef_getOnlyTargetCategory;
-	callback->WeaponDef_getWobble = &skirmishAiCallback_WeaponDef_getWobble;
-	callback->WeaponDef_getDance = &skirmishAiCallback_WeaponDef_getDance;
-	callback->WeaponDef_getTrajectoryHeight = &skirmishAiCallback_WeaponDef_getTrajectoryHeight;
-	callback->WeaponDef_isLargeBeamLaser = &skirmishAiCallback_WeaponDef_isLargeBeamLaser;
-	callback->WeaponDef_isShield = &skirmishAiCallback_WeaponDef_isShield;
-	callback->WeaponDef_isShieldRepulser = &skirmishAiCallback_WeaponDef_isShieldRepulser;
-	callback->WeaponDef_isSmartShield = &skirmishAiCallback_WeaponDef_isSmartShield;
-	callback->WeaponDef_isExteriorShield = &skirmishAiCallback_WeaponDef_isExteriorShield;
-	callback->WeaponDef_isVisibleShield = &skirmishAiCallback_WeaponDef_isVisibleShield;
-	callback->WeaponDef_isVisibleShieldRepulse = &skirmishAiCallback_WeaponDef_isVisibleShieldRepulse;
-	callback->WeaponDef_getVisibleShieldHitFrames = &skirmishAiCallback_WeaponDef_getVisibleShieldHitFrames;
-	callback->WeaponDef_Shield_getResourceUse = &skirmishAiCallback_WeaponDef_Shield_getResourceUse;
-	callback->WeaponDef_Shield_getRadius = &skirmishAiCallback_WeaponDef_Shield_getRadius;
-	callback->WeaponDef_Shield_getForce = &skirmishAiCallback_WeaponDef_Shield_getForce;
-	callback->WeaponDef_Shield_getMaxSpeed = &skirmishAiCallback_WeaponDef_Shield_getMaxSpeed;
-	callback->WeaponDef_Shield_getPower = &skirmishAiCallback_WeaponDef_Shield_getPower;
-	callback->WeaponDef_Shield_getPowerRegen = &skirmishAiCallback_WeaponDef_Shield_getPowerRegen;
-	callback->WeaponDef_Shield_getPowerRegenResource = &skirmishAiCallback_WeaponDef_Shield_getPowerRegenResource;
-	callback->WeaponDef_Shield_getStartingPower = &skirmishAiCallback_WeaponDef_Shield_getStartingPower;
-	callback->WeaponDef_Shield_getRechargeDelay = &skirmishAiCallback_WeaponDef_Shield_getRechargeDelay;
-	callback->WeaponDef_Shield_getGoodColor = &skirmishAiCallback_WeaponDef_Shield_getGoodColor;
-	callback->WeaponDef_Shield_getBadColor = &skirmishAiCallback_WeaponDef_Shield_getBadColor;
-	callback->WeaponDef_Shield_getAlpha = &skirmishAiCallback_WeaponDef_Shield_getAlpha;
-	callback->WeaponDef_Shield_getInterceptType = &skirmishAiCallback_WeaponDef_Shield_getInterceptType;
-	callback->WeaponDef_getInterceptedByShieldType = &skirmishAiCallback_WeaponDef_getInterceptedByShieldType;
-	callback->WeaponDef_isAvoidFriendly = &skirmishAiCallback_WeaponDef_isAvoidFriendly;
-	callback->WeaponDef_isAvoidFeature = &skirmishAiCallback_WeaponDef_isAvoidFeature;
-	callback->WeaponDef_isAvoidNeutral = &skirmishAiCallback_WeaponDef_isAvoidNeutral;
-	callback->WeaponDef_getTargetBorder = &skirmishAiCallback_WeaponDef_getTargetBorder;
-	callback->WeaponDef_getCylinderTargetting = &skirmishAiCallback_WeaponDef_getCylinderTargetting;
-	callback->WeaponDef_getMinIntensity = &skirmishAiCallback_WeaponDef_getMinIntensity;
-	callback->WeaponDef_getHeightBoostFactor = &skirmishAiCallback_WeaponDef_getHeightBoostFactor;
-	callback->WeaponDef_getProximityPriority = &skirmishAiCallback_WeaponDef_getProximityPriority;
-	callback->WeaponDef_getCollisionFlags = &skirmishAiCallback_WeaponDef_getCollisionFlags;
-	callback->WeaponDef_isSweepFire = &skirmishAiCallback_WeaponDef_isSweepFire;
-	callback->WeaponDef_isAbleToAttackGround = &skirmishAiCallback_WeaponDef_isAbleToAttackGround;
-	callback->WeaponDef_getCameraShake = &skirmishAiCallback_WeaponDef_getCameraShake;
-	callback->WeaponDef_getDynDamageExp = &skirmishAiCallback_WeaponDef_getDynDamageExp;
-	callback->WeaponDef_getDynDamageMin = &skirmishAiCallback_WeaponDef_getDynDamageMin;
-	callback->WeaponDef_getDynDamageRange = &skirmishAiCallback_WeaponDef_getDynDamageRange;
-	callback->WeaponDef_isDynDamageInverted = &skirmishAiCallback_WeaponDef_isDynDamageInverted;
-	callback->WeaponDef_getCustomParams = &skirmishAiCallback_WeaponDef_getCustomParams;
-	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
-}
+	SET_CALLBACK(Engine_handleCommand)
+	SET_CALLBACK(Engine_Version_getMajor)
+	SET_CALLBACK(Engine_Version_getMinor)
+	SET_CALLBACK(Engine_Version_getPatchset)
+	SET_CALLBACK(Engine_Version_getCommits)
+	SET_CALLBACK(Engine_Version_getHash)
+	SET_CALLBACK(Engine_Version_getBranch)
+	SET_CALLBACK(Engine_Version_getAdditional)
+	SET_CALLBACK(Engine_Version_getBuildTime)
+	SET_CALLBACK(Engine_Version_isRelease)
+	SET_CALLBACK(Engine_Version_getNormal)
+	SET_CALLBACK(Engine_Version_getSync)
+	SET_CALLBACK(Engine_Version_getFull)
+	SET_CALLBACK(Teams_getSize)
+	SET_CALLBACK(SkirmishAIs_getSize)
+	SET_CALLBACK(SkirmishAIs_getMax)
+	SET_CALLBACK(SkirmishAI_getTeamId)
+	SET_CALLBACK(SkirmishAI_Info_getSize)
+	SET_CALLBACK(SkirmishAI_Info_getKey)
+	SET_CALLBACK(SkirmishAI_Info_getValue)
+	SET_CALLBACK(SkirmishAI_Info_getDescription)
+	SET_CALLBACK(SkirmishAI_Info_getValueByKey)
+	SET_CALLBACK(SkirmishAI_OptionValues_getSize)
+	SET_CALLBACK(SkirmishAI_OptionValues_getKey)
+	SET_CALLBACK(SkirmishAI_OptionValues_getValue)
+	SET_CALLBACK(SkirmishAI_OptionValues_getValueByKey)
+	SET_CALLBACK(Log_log)
+	SET_CALLBACK(Log_exception)
+	SET_CALLBACK(DataDirs_getPathSeparator)
+	SET_CALLBACK(DataDirs_getConfigDir)
+	SET_CALLBACK(DataDirs_getWriteableDir)
+	SET_CALLBACK(DataDirs_locatePath)
+	SET_CALLBACK(DataDirs_allocatePath)
+	SET_CALLBACK(DataDirs_Roots_getSize)
+	SET_CALLBACK(DataDirs_Roots_getDir)
+	SET_CALLBACK(DataDirs_Roots_locatePath)
+	SET_CALLBACK(DataDirs_Roots_allocatePath)
+	SET_CALLBACK(Game_getCurrentFrame)
+	SET_CALLBACK(Game_getAiInterfaceVersion)
+	SET_CALLBACK(Game_getMyTeam)
+	SET_CALLBACK(Game_getMyAllyTeam)
+	SET_CALLBACK(Game_getPlayerTeam)
+	SET_CALLBACK(Game_getTeams)
+	SET_CALLBACK(Game_getTeamSide)
+	SET_CALLBACK(Game_getTeamColor)
+	SET_CALLBACK(Game_getTeamIncomeMultiplier)
+	SET_CALLBACK(Game_getTeamAllyTeam)
+	SET_CALLBACK(Game_getTeamResourceCurrent)
+	SET_CALLBACK(Game_getTeamResourceIncome)
+	SET_CALLBACK(Game_getTeamResourceUsage)
+	SET_CALLBACK(Game_getTeamResourceStorage)
+	SET_CALLBACK(Game_isAllied)
+	SET_CALLBACK(Game_isExceptionHandlingEnabled)
+	SET_CALLBACK(Game_isDebugModeEnabled)
+	SET_CALLBACK(Game_isPaused)
+	SET_CALLBACK(Game_getSpeedFactor)
+	SET_CALLBACK(Game_getSetupScript)
+	SET_CALLBACK(Game_getCategoryFlag)
+	SET_CALLBACK(Game_getCategoriesFlag)
+	SET_CALLBACK(Game_getCategoryName)
+	SET_CALLBACK(Gui_getViewRange)
+	SET_CALLBACK(Gui_getScreenX)
+	SET_CALLBACK(Gui_getScreenY)
+	SET_CALLBACK(Gui_Camera_getDirection)
+	SET_CALLBACK(Gui_Camera_getPosition)
+	SET_CALLBACK(Cheats_isEnabled)
+	SET_CALLBACK(Cheats_setEnabled)
+	SET_CALLBACK(Cheats_setEventsEnabled)
+	SET_CALLBACK(Cheats_isOnlyPassive)
+	SET_CALLBACK(getResources)
+	SET_CALLBACK(getResourceByName)
+	SET_CALLBACK(Resource_getName)
+	SET_CALLBACK(Resource_getOptimum)
+	SET_CALLBACK(Economy_getCurrent)
+	SET_CALLBACK(Economy_getIncome)
+	SET_CALLBACK(Economy_getUsage)
+	SET_CALLBACK(Economy_getStorage)
+	SET_CALLBACK(File_getSize)
+	SET_CALLBACK(File_getContent)
+	SET_CALLBACK(getUnitDefs)
+	SET_CALLBACK(getUnitDefByName)
+	SET_CALLBACK(UnitDef_getHeight)
+	SET_CALLBACK(UnitDef_getRadius)
+	SET_CALLBACK(UnitDef_getName)
+	SET_CALLBACK(UnitDef_getHumanName)
+	SET_CALLBACK(UnitDef_getFileName)
+	SET_CALLBACK(UnitDef_getAiHint)
+	SET_CALLBACK(UnitDef_getCobId)
+	SET_CALLBACK(UnitDef_getTechLevel)
+	SET_CALLBACK(UnitDef_getGaia)
+	SET_CALLBACK(UnitDef_getUpkeep)
+	SET_CALLBACK(UnitDef_getResourceMake)
+	SET_CALLBACK(UnitDef_getMakesResource)
+	SET_CALLBACK(UnitDef_getCost)
+	SET_CALLBACK(UnitDef_getExtractsResource)
+	SET_CALLBACK(UnitDef_getResourceExtractorRange)
+	SET_CALLBACK(UnitDef_getWindResourceGenerator)
+	SET_CALLBACK(UnitDef_getTidalResourceGenerator)
+	SET_CALLBACK(UnitDef_getStorage)
+	SET_CALLBACK(UnitDef_isSquareResourceExtractor)
+	SET_CALLBACK(UnitDef_getBuildTime)
+	SET_CALLBACK(UnitDef_getAutoHeal)
+	SET_CALLBACK(UnitDef_getIdleAutoHeal)
+	SET_CALLBACK(UnitDef_getIdleTime)
+	SET_CALLBACK(UnitDef_getPower)
+	SET_CALLBACK(UnitDef_getHealth)
+	SET_CALLBACK(UnitDef_getCategory)
+	SET_CALLBACK(UnitDef_getSpeed)
+	SET_CALLBACK(UnitDef_getTurnRate)
+	SET_CALLBACK(UnitDef_isTurnInPlace)
+	SET_CALLBACK(UnitDef_getTurnInPlaceDistance)
+	SET_CALLBACK(UnitDef_getTurnInPlaceSpeedLimit)
+	SET_CALLBACK(UnitDef_isUpright)
+	SET_CALLBACK(UnitDef_isCollide)
+	SET_CALLBACK(UnitDef_getLosRadius)
+	SET_CALLBACK(UnitDef_getAirLosRadius)
+	SET_CALLBACK(UnitDef_getLosHeight)
+	SET_CALLBACK(UnitDef_getRadarRadius)
+	SET_CALLBACK(UnitDef_getSonarRadius)
+	SET_CALLBACK(UnitDef_getJammerRadius)
+	SET_CALLBACK(UnitDef_getSonarJamRadius)
+	SET_CALLBACK(UnitDef_getSeismicRadius)
+	SET_CALLBACK(UnitDef_getSeismicSignature)
+	SET_CALLBACK(UnitDef_isStealth)
+	SET_CALLBACK(UnitDef_isSonarStealth)
+	SET_CALLBACK(UnitDef_isBuildRange3D)
+	SET_CALLBACK(UnitDef_getBuildDistance)
+	SET_CALLBACK(UnitDef_getBuildSpeed)
+	SET_CALLBACK(UnitDef_getReclaimSpeed)
+	SET_CALLBACK(UnitDef_getRepairSpeed)
+	SET_CALLBACK(UnitDef_getMaxRepairSpeed)
+	SET_CALLBACK(UnitDef_getResurrectSpeed)
+	SET_CALLBACK(UnitDef_getCaptureSpeed)
+	SET_CALLBACK(UnitDef_getTerraformSpeed)
+	SET_CALLBACK(UnitDef_getMass)
+	SET_CALLBACK(UnitDef_isPushResistant)
+	SET_CALLBACK(UnitDef_isStrafeToAttack)
+	SET_CALLBACK(UnitDef_getMinCollisionSpeed)
+	SET_CALLBACK(UnitDef_getSlideTolerance)
+	SET_CALLBACK(UnitDef_getMaxSlope)
+	SET_CALLBACK(UnitDef_getMaxHeightDif)
+	SET_CALLBACK(UnitDef_getMinWaterDepth)
+	SET_CALLBACK(UnitDef_getWaterline)
+	SET_CALLBACK(UnitDef_getMaxWaterDepth)
+	SET_CALLBACK(UnitDef_getArmoredMultiple)
+	SET_CALLBACK(UnitDef_getArmorType)
+	SET_CALLBACK(UnitDef_FlankingBonus_getMode)
+	SET_CALLBACK(UnitDef_FlankingBonus_getDir)
+	SET_CALLBACK(UnitDef_FlankingBonus_getMax)
+	SET_CALLBACK(UnitDef_FlankingBonus_getMin)
+	SET_CALLBACK(UnitDef_FlankingBonus_getMobilityAdd)
+	SET_CALLBACK(UnitDef_getMaxWeaponRange)
+	SET_CALLBACK(UnitDef_getType)
+	SET_CALLBACK(UnitDef_getTooltip)
+	SET_CALLBACK(UnitDef_getWreckName)
+	SET_CALLBACK(UnitDef_getDeathExplosion)
+	SET_CALLBACK(UnitDef_getSelfDExplosion)
+	SET_CALLBACK(UnitDef_getCategoryString)
+	SET_CALLBACK(UnitDef_isAbleToSelfD)
+	SET_CALLBACK(UnitDef_getSelfDCountdown)
+	SET_CALLBACK(UnitDef_isAbleToSubmerge)
+	SET_CALLBACK(UnitDef_isAbleToFly)
+	SET_CALLBACK(UnitDef_isAbleToMove)
+	SET_CALLBACK(UnitDef_isAbleToHover)
+	SET_CALLBACK(UnitDef_isFloater)
+	SET_CALLBACK(UnitDef_isBuilder)
+	SET_CALLBACK(UnitDef_isActivateWhenBuilt)
+	SET_CALLBACK(UnitDef_isOnOffable)
+	SET_CALLBACK(UnitDef_isFullHealthFactory)
+	SET_CALLBACK(UnitDef_isFactoryHeadingTakeoff)
+	SET_CALLBACK(UnitDef_isReclaimable)
+	SET_CALLBACK(UnitDef_isCapturable)
+	SET_CALLBACK(UnitDef_isAbleToRestore)
+	SET_CALLBACK(UnitDef_isAbleToRepair)
+	SET_CALLBACK(UnitDef_isAbleToSelfRepair)
+	SET_CALLBACK(UnitDef_isAbleToReclaim)
+	SET_CALLBACK(UnitDef_isAbleToAttack)
+	SET_CALLBACK(UnitDef_isAbleToPatrol)
+	SET_CALLBACK(UnitDef_isAbleToFight)
+	SET_CALLBACK(UnitDef_isAbleToGuard)
+	SET_CALLBACK(UnitDef_isAbleToAssist)
+	SET_CALLBACK(UnitDef_isAssistable)
+	SET_CALLBACK(UnitDef_isAbleToRepeat)
+	SET_CALLBACK(UnitDef_isAbleToFireControl)
+	SET_CALLBACK(UnitDef_getFireState)
+	SET_CALLBACK(UnitDef_getMoveState)
+	SET_CALLBACK(UnitDef_getWingDrag)
+	SET_CALLBACK(UnitDef_getWingAngle)
+	SET_CALLBACK(UnitDef_getDrag)
+	SET_CALLBACK(UnitDef_getFrontToSpeed)
+	SET_CALLBACK(UnitDef_getSpeedToFront)
+	SET_CALLBACK(UnitDef_getMyGravity)
+	SET_CALLBACK(UnitDef_getMaxBank)
+	SET_CALLBACK(UnitDef_getMaxPitch)
+	SET_CALLBACK(UnitDef_getTurnRadius)
+	SET_CALLBACK(UnitDef_getWantedHeight)
+	SET_CALLBACK(UnitDef_getVerticalSpeed)
+	SET_CALLBACK(UnitDef_isAbleToCrash)
+	SET_CALLBACK(UnitDef_isHoverAttack)
+	SET_CALLBACK(UnitDef_isAirStrafe)
+	SET_CALLBACK(UnitDef_getDlHoverFactor)
+	SET_CALLBACK(UnitDef_getMaxAcceleration)
+	SET_CALLBACK(UnitDef_getMaxDeceleration)
+	SET_CALLBACK(UnitDef_getMaxAileron)
+	SET_CALLBACK(UnitDef_getMaxElevator)
+	SET_CALLBACK(UnitDef_getMaxRudder)
+	SET_CALLBACK(UnitDef_getYardMap)
+	SET_CALLBACK(UnitDef_getXSize)
+	SET_CALLBACK(UnitDef_getZSize)
+	SET_CALLBACK(UnitDef_getBuildAngle)
+	SET_CALLBACK(UnitDef_getLoadingRadius)
+	SET_CALLBACK(UnitDef_getUnloadSpread)
+	SET_CALLBACK(UnitDef_getTransportCapacity)
+	SET_CALLBACK(UnitDef_getTransportSize)
+	SET_CALLBACK(UnitDef_getMinTransportSize)
+	SET_CALLBACK(UnitDef_isAirBase)
+	SET_CALLBACK(UnitDef_isFirePlatform)
+	SET_CALLBACK(UnitDef_getTransportMass)
+	SET_CALLBACK(UnitDef_getMinTransportMass)
+	SET_CALLBACK(UnitDef_isHoldSteady)
+	SET_CALLBACK(UnitDef_isReleaseHeld)
+	SET_CALLBACK(UnitDef_isNotTransportable)
+	SET_CALLBACK(UnitDef_isTransportByEnemy)
+	SET_CALLBACK(UnitDef_getTransportUnloadMethod)
+	SET_CALLBACK(UnitDef_getFallSpeed)
+	SET_CALLBACK(UnitDef_getUnitFallSpeed)
+	SET_CALLBACK(UnitDef_isAbleToCloak)
+	SET_CALLBACK(UnitDef_isStartCloaked)
+	SET_CALLBACK(UnitDef_getCloakCost)
+	SET_CALLBACK(UnitDef_getCloakCostMoving)
+	SET_CALLBACK(UnitDef_getDecloakDistance)
+	SET_CALLBACK(UnitDef_isDecloakSpherical)
+	SET_CALLBACK(UnitDef_isDecloakOnFire)
+	SET_CALLBACK(UnitDef_isAbleToKamikaze)
+	SET_CALLBACK(UnitDef_getKamikazeDist)
+	SET_CALLBACK(UnitDef_isTargetingFacility)
+	SET_CALLBACK(UnitDef_canManualFire)
+	SET_CALLBACK(UnitDef_isNeedGeo)
+	SET_CALLBACK(UnitDef_isFeature)
+	SET_CALLBACK(UnitDef_isHideDamage)
+	SET_CALLBACK(UnitDef_isCommander)
+	SET_CALLBACK(UnitDef_isShowPlayerName)
+	SET_CALLBACK(UnitDef_isAbleToResurrect)
+	SET_CALLBACK(UnitDef_isAbleToCapture)
+	SET_CALLBACK(UnitDef_getHighTrajectoryType)
+	SET_CALLBACK(UnitDef_getNoChaseCategory)
+	SET_CALLBACK(UnitDef_isLeaveTracks)
+	SET_CALLBACK(UnitDef_getTrackWidth)
+	SET_CALLBACK(UnitDef_getTrackOffset)
+	SET_CALLBACK(UnitDef_getTrackStrength)
+	SET_CALLBACK(UnitDef_getTrackStretch)
+	SET_CALLBACK(UnitDef_getTrackType)
+	SET_CALLBACK(UnitDef_isAbleToDropFlare)
+	SET_CALLBACK(UnitDef_getFlareReloadTime)
+	SET_CALLBACK(UnitDef_getFlareEfficiency)
+	SET_CALLBACK(UnitDef_getFlareDelay)
+	SET_CALLBACK(UnitDef_getFlareDropVector)
+	SET_CALLBACK(UnitDef_getFlareTime)
+	SET_CALLBACK(UnitDef_getFlareSalvoSize)
+	SET_CALLBACK(UnitDef_getFlareSalvoDelay)
+	SET_CALLBACK(UnitDef_isAbleToLoopbackAttack)
+	SET_CALLBACK(UnitDef_isLevelGround)
+	SET_CALLBACK(UnitDef_isUseBuildingGroundDecal)
+	SET_CALLBACK(UnitDef_getBuildingDecalType)
+	SET_CALLBACK(UnitDef_getBuildingDecalSizeX)
+	SET_CALLBACK(UnitDef_getBuildingDecalSizeY)
+	SET_CALLBACK(UnitDef_getBuildingDecalDecaySpeed)
+	SET_CALLBACK(UnitDef_getMaxFuel)
+	SET_CALLBACK(UnitDef_getRefuelTime)
+	SET_CALLBACK(UnitDef_getMinAirBasePower)
+	SET_CALLBACK(UnitDef_getMaxThisUnit)
+	SET_CALLBACK(UnitDef_getDecoyDef)
+	SET_CALLBACK(UnitDef_isDontLand)
+	SET_CALLBACK(UnitDef_getShieldDef)
+	SET_CALLBACK(UnitDef_getStockpileDef)
+	SET_CALLBACK(UnitDef_getBuildOptions)
+	SET_CALLBACK(UnitDef_getCustomParams)
+	SET_CALLBACK(UnitDef_isMoveDataAvailable)
+	SET_CALLBACK(UnitDef_MoveData_getMaxAcceleration)
+	SET_CALLBACK(UnitDef_MoveData_getMaxBreaking)
+	SET_CALLBACK(UnitDef_MoveData_getMaxSpeed)
+	SET_CALLBACK(UnitDef_MoveData_getMaxTurnRate)
+	SET_CALLBACK(UnitDef_MoveData_getXSize)
+	SET_CALLBACK(UnitDef_MoveData_getZSize)
+	SET_CALLBACK(UnitDef_MoveData_getDepth)
+	SET_CALLBACK(UnitDef_MoveData_getMaxSlope)
+	SET_CALLBACK(UnitDef_MoveData_getSlopeMod)
+	SET_CALLBACK(UnitDef_MoveData_getDepthMod)
+	SET_CALLBACK(UnitDef_MoveData_getPathType)
+	SET_CALLBACK(UnitDef_MoveData_getCrushStrength)
+	SET_CALLBACK(UnitDef_MoveData_getMoveType)
+	SET_CALLBACK(UnitDef_MoveData_getMoveFamily)
+	SET_CALLBACK(UnitDef_MoveData_getTerrainClass)
+	SET_CALLBACK(UnitDef_MoveData_getFollowGround)
+	SET_CALLBACK(UnitDef_MoveData_isSubMarine)
+	SET_CALLBACK(UnitDef_MoveData_getName)
+	SET_CALLBACK(UnitDef_getWeaponMounts)
+	SET_CALLBACK(UnitDef_WeaponMount_getName)
+	SET_CALLBACK(UnitDef_WeaponMount_getWeaponDef)
+	SET_CALLBACK(UnitDef_WeaponMount_getSlavedTo)
+	SET_CALLBACK(UnitDef_WeaponMount_getMainDir)
+	SET_CALLBACK(UnitDef_WeaponMount_getMaxAngleDif)
+	SET_CALLBACK(UnitDef_WeaponMount_getFuelUsage)
+	SET_CALLBACK(UnitDef_WeaponMount_getBadTargetCategory)
+	SET_CALLBACK(UnitDef_WeaponMount_getOnlyTargetCategory)
+	SET_CALLBACK(Unit_getLimit)
+	SET_CALLBACK(Unit_getMax)
+	SET_CALLBACK(getEnemyUnits)
+	SET_CALLBACK(getEnemyUnitsIn)
+	SET_CALLBACK(getEnemyUnitsInRadarAndLos)
+	SET_CALLBACK(getFriendlyUnits)
+	SET_CALLBACK(getFriendlyUnitsIn)
+	SET_CALLBACK(getNeutralUnits)
+	SET_CALLBACK(getNeutralUnitsIn)
+	SET_CALLBACK(getTeamUnits)
+	SET_CALLBACK(getSelectedUnits)
+	SET_CALLBACK(getUnitsPositions)
+	SET_CALLBACK(getUnitsVelocities)
+	SET_CALLBACK(getUnitsHealths)
+	SET_CALLBACK(getUnitsDefs)
+	SET_CALLBACK(getUnitsTeams)
+	SET_CALLBACK(Unit_getDef)
+	SET_CALLBACK(Unit_getModParams)
+	SET_CALLBACK(Unit_ModParam_getName)
+	SET_CALLBACK(Unit_ModParam_getValue)
+	SET_CALLBACK(Unit_getTeam)
+	SET_CALLBACK(Unit_getAllyTeam)
+	SET_CALLBACK(Unit_getAiHint)
+	SET_CALLBACK(Unit_getStockpile)
+	SET_CALLBACK(Unit_getStockpileQueued)
+	SET_CALLBACK(Unit_getCurrentFuel)
+	SET_CALLBACK(Unit_getMaxSpeed)
+	SET_CALLBACK(Unit_getMaxRange)
+	SET_CALLBACK(Unit_getMaxHealth)
+	SET_CALLBACK(Unit_getExperience)
+	SET_CALLBACK(Unit_getGroup)
+	SET_CALLBACK(Unit_getCurrentCommands)
+	SET_CALLBACK(Unit_CurrentCommand_getType)
+	SET_CALLBACK(Unit_CurrentCommand_getId)
+	SET_CALLBACK(Unit_CurrentCommand_getOptions)
+	SET_CALLBACK(Unit_CurrentCommand_getTag)
+	SET_CALLBACK(Unit_CurrentCommand_getTimeOut)
+	SET_CALLBACK(Unit_CurrentCommand_getParams)
+	SET_CALLBACK(Unit_getSupportedCommands)
+	SET_CALLBACK(Unit_SupportedCommand_getId)
+	SET_CALLBACK(Unit_SupportedCommand_getName)
+	SET_CALLBACK(Unit_SupportedCommand_getToolTip)
+	SET_CALLBACK(Unit_SupportedCommand_isShowUnique)
+	SET_CALLBACK(Unit_SupportedCommand_isDisabled)
+	SET_CALLBACK(Unit_SupportedCommand_getParams)
+	SET_CALLBACK(Unit_getHealth)
+	SET_CALLBACK(Unit_getSpeed)
+	SET_CALLBACK(Unit_getPower)
+	SET_CALLBACK(Unit_getResourceUse)
+	SET_CALLBACK(Unit_getResourceMake)
+	SET_CALLBACK(Unit_getPos)
+	SET_CALLBACK(Unit_getVel)
+	SET_CALLBACK(Unit_isActivated)
+	SET_CALLBACK(Unit_isBeingBuilt)
+	SET_CALLBACK(Unit_isCloaked)
+	SET_CALLBACK(Unit_isParalyzed)
+	SET_CALLBACK(Unit_isNeutral)
+	SET_CALLBACK(Unit_getBuildingFacing)
+	SET_CALLBACK(Unit_getLastUserOrderFrame)
+	SET_CALLBACK(getGroups)
+	SET_CALLBACK(Group_getSupportedCommands)
+	SET_CALLBACK(Group_SupportedCommand_getId)
+	SET_CALLBACK(Group_SupportedCommand_getName)
+	SET_CALLBACK(Group_SupportedCommand_getToolTip)
+	SET_CALLBACK(Group_SupportedCommand_isShowUnique)
+	SET_CALLBACK(Group_SupportedCommand_isDisabled)
+	SET_CALLBACK(Group_SupportedCommand_getParams)
+	SET_CALLBACK(Group_OrderPreview_getId)
+	SET_CALLBACK(Group_OrderPreview_getOptions)
+	SET_CALLBACK(Group_OrderPreview_getTag)
+	SET_CALLBACK(Group_OrderPreview_getTimeOut)
+	SET_CALLBACK(Group_OrderPreview_getParams)
+	SET_CALLBACK(Group_isSelected)
+	SET_CALLBACK(Mod_getFileName)
+	SET_CALLBACK(Mod_getHash)
+	SET_CALLBACK(Mod_getHumanName)
+	SET_CALLBACK(Mod_getShortName)
+	SET_CALLBACK(Mod_getVersion)
+	SET_CALLBACK(Mod_getMutator)
+	SET_CALLBACK(Mod_getDescription)
+	SET_CALLBACK(Mod_getAllowTeamColors)
+	SET_CALLBACK(Mod_getConstructionDecay)
+	SET_CALLBACK(Mod_getConstructionDecayTime)
+	SET_CALLBACK(Mod_getConstructionDecaySpeed)
+	SET_CALLBACK(Mod_getMultiReclaim)
+	SET_CALLBACK(Mod_getReclaimMethod)
+	SET_CALLBACK(Mod_getReclaimUnitMethod)
+	SET_CALLBACK(Mod_getReclaimUnitEnergyCostFactor)
+	SET_CALLBACK(Mod_getReclaimUnitEfficiency)
+	SET_CALLBACK(Mod_getReclaimFeatureEnergyCostFactor)
+	SET_CALLBACK(Mod_getReclaimAllowEnemies)
+	SET_CALLBACK(Mod_getReclaimAllowAllies)
+	SET_CALLBACK(Mod_getRepairEnergyCostFactor)
+	SET_CALLBACK(Mod_getResurrectEnergyCostFactor)
+	SET_CALLBACK(Mod_getCaptureEnergyCostFactor)
+	SET_CALLBACK(Mod_getTransportGround)
+	SET_CALLBACK(Mod_getTransportHover)
+	SET_CALLBACK(Mod_getTransportShip)
+	SET_CALLBACK(Mod_getTransportAir)
+	SET_CALLBACK(Mod_getFireAtKilled)
+	SET_CALLBACK(Mod_getFireAtCrashing)
+	SET_CALLBACK(Mod_getFlankingBonusModeDefault)
+	SET_CALLBACK(Mod_getLosMipLevel)
+	SET_CALLBACK(Mod_getAirMipLevel)
+	SET_CALLBACK(Mod_getLosMul)
+	SET_CALLBACK(Mod_getAirLosMul)
+	SET_CALLBACK(Mod_getRequireSonarUnderWater)
+	SET_CALLBACK(Map_getChecksum)
+	SET_CALLBACK(Map_getStartPos)
+	SET_CALLBACK(Map_getMousePos)
+	SET_CALLBACK(Map_isPosInCamera)
+	SET_CALLBACK(Map_getWidth)
+	SET_CALLBACK(Map_getHeight)
+	SET_CALLBACK(Map_getHeightMap)
+	SET_CALLBACK(Map_getCornersHeightMap)
+	SET_CALLBACK(Map_getMinHeight)
+	SET_CALLBACK(Map_getMaxHeight)
+	SET_CALLBACK(Map_getSlopeMap)
+	SET_CALLBACK(Map_getLosMap)
+	SET_CALLBACK(Map_getRadarMap)
+	SET_CALLBACK(Map_getJammerMap)
+	SET_CALLBACK(Map_getResourceMapRaw)
+	SET_CALLBACK(Map_getResourceMapSpotsPositions)
+	SET_CALLBACK(Map_getResourceMapSpotsAverageIncome)
+	SET_CALLBACK(Map_getResourceMapSpotsNearest)
+	SET_CALLBACK(Map_getHash)
+	SET_CALLBACK(Map_getName)
+	SET_CALLBACK(Map_getHumanName)
+	SET_CALLBACK(Map_getElevationAt)
+	SET_CALLBACK(Map_getMaxResource)
+	SET_CALLBACK(Map_getExtractorRadius)
+	SET_CALLBACK(Map_getMinWind)
+	SET_CALLBACK(Map_getMaxWind)
+	SET_CALLBACK(Map_getCurWind)
+	SET_CALLBACK(Map_getTidalStrength)
+	SET_CALLBACK(Map_getGravity)
+	SET_CALLBACK(Map_getPoints)
+	SET_CALLBACK(Map_Point_getPosition)
+	SET_CALLBACK(Map_Point_getColor)
+	SET_CALLBACK(Map_Point_getLabel)
+	SET_CALLBACK(Map_getLines)
+	SET_CALLBACK(Map_Line_getFirstPosition)
+	SET_CALLBACK(Map_Line_getSecondPosition)
+	SET_CALLBACK(Map_Line_getColor)
+	SET_CALLBACK(Map_isPossibleToBuildAt)
+	SET_CALLBACK(Map_findClosestBuildSite)
+	SET_CALLBACK(getFeatureDefs)
+	SET_CALLBACK(FeatureDef_getName)
+	SET_CALLBACK(FeatureDef_getDescription)
+	SET_CALLBACK(FeatureDef_getFileName)
+	SET_CALLBACK(FeatureDef_getContainedResource)
+	SET_CALLBACK(FeatureDef_getMaxHealth)
+	SET_CALLBACK(FeatureDef_getReclaimTime)
+	SET_CALLBACK(FeatureDef_getMass)
+	SET_CALLBACK(FeatureDef_isUpright)
+	SET_CALLBACK(FeatureDef_getDrawType)
+	SET_CALLBACK(FeatureDef_getModelName)
+	SET_CALLBACK(FeatureDef_getResurrectable)
+	SET_CALLBACK(FeatureDef_getSmokeTime)
+	SET_CALLBACK(FeatureDef_isDestructable)
+	SET_CALLBACK(FeatureDef_isReclaimable)
+	SET_CALLBACK(FeatureDef_isBlocking)
+	SET_CALLBACK(FeatureDef_isBurnable)
+	SET_CALLBACK(FeatureDef_isFloating)
+	SET_CALLBACK(FeatureDef_isNoSelect)
+	SET_CALLBACK(FeatureDef_isGeoThermal)
+	SET_CALLBACK(FeatureDef_getDeathFeature)
+	SET_CALLBACK(FeatureDef_getXSize)
+	SET_CALLBACK(FeatureDef_getZSize)
+	SET_CALLBACK(FeatureDef_getCustomParams)
+	SET_CALLBACK(getFeatures)
+	SET_CALLBACK(getFeaturesIn)
+	SET_CALLBACK(Feature_getDef)
+	SET_CALLBACK(Feature_getHealth)
+	SET_CALLBACK(Feature_getReclaimLeft)
+	SET_CALLBACK(Feature_getPosition)
+	SET_CALLBACK(getWeaponDefs)
+	SET_CALLBACK(getWeaponDefByName)
+	SET_CALLBACK(WeaponDef_getName)
+	SET_CALLBACK(WeaponDef_getType)
+	SET_CALLBACK(WeaponDef_getDescription)
+	SET_CALLBACK(WeaponDef_getFileName)
+	SET_CALLBACK(WeaponDef_getCegTag)
+	SET_CALLBACK(WeaponDef_getRange)
+	SET_CALLBACK(WeaponDef_getHeightMod)
+	SET_CALLBACK(WeaponDef_getAccuracy)
+	SET_CALLBACK(WeaponDef_getSprayAngle)
+	SET_CALLBACK(WeaponDef_getMovingAccuracy)
+	SET_CALLBACK(WeaponDef_getTargetMoveError)
+	SET_CALLBACK(WeaponDef_getLeadLimit)
+	SET_CALLBACK(WeaponDef_getLeadBonus)
+	SET_CALLBACK(WeaponDef_getPredictBoost)
+	SET_CALLBACK(WeaponDef_getNumDamageTypes)
+	SET_CALLBACK(WeaponDef_Damage_getParalyzeDamageTime)
+	SET_CALLBACK(WeaponDef_Damage_getImpulseFactor)
+	SET_CALLBACK(WeaponDef_Damage_getImpulseBoost)
+	SET_CALLBACK(WeaponDef_Damage_getCraterMult)
+	SET_CALLBACK(WeaponDef_Damage_getCraterBoost)
+	SET_CALLBACK(WeaponDef_Damage_getTypes)
+	SET_CALLBACK(WeaponDef_getAreaOfEffect)
+	SET_CALLBACK(WeaponDef_isNoSelfDamage)
+	SET_CALLBACK(WeaponDef_getFireStarter)
+	SET_CALLBACK(WeaponDef_getEdgeEffectiveness)
+	SET_CALLBACK(WeaponDef_getSize)
+	SET_CALLBACK(WeaponDef_getSizeGrowth)
+	SET_CALLBACK(WeaponDef_getCollisionSize)
+	SET_CALLBACK(WeaponDef_getSalvoSize)
+	SET_CALLBACK(WeaponDef_getSalvoDelay)
+	SET_CALLBACK(WeaponDef_getReload)
+	SET_CALLBACK(WeaponDef_getBeamTime)
+	SET_CALLBACK(WeaponDef_isBeamBurst)
+	SET_CALLBACK(WeaponDef_isWaterBounce)
+	SET_CALLBACK(WeaponDef_isGroundBounce)
+	SET_CALLBACK(WeaponDef_getBounceRebound)
+	SET_CALLBACK(WeaponDef_getBounceSlip)
+	SET_CALLBACK(WeaponDef_getNumBounce)
+	SET_CALLBACK(WeaponDef_getMaxAngle)
+	SET_CALLBACK(WeaponDef_getUpTime)
+	SET_CALLBACK(WeaponDef_getFlightTime)
+	SET_CALLBACK(WeaponDef_getCost)
+	SET_CALLBACK(WeaponDef_getProjectilesPerShot)
+	SET_CALLBACK(WeaponDef_isTurret)
+	SET_CALLBACK(WeaponDef_isOnlyForward)
+	SET_CALLBACK(WeaponDef_isFixedLauncher)
+	SET_CALLBACK(WeaponDef_isWaterWeapon)
+	SET_CALLBACK(WeaponDef_isFireSubmersed)
+	SET_CALLBACK(WeaponDef_isSubMissile)
+	SET_CALLBACK(WeaponDef_isTracks)
+	SET_CALLBACK(WeaponDef_isDropped)
+	SET_CALLBACK(WeaponDef_isParalyzer)
+	SET_CALLBACK(WeaponDef_isImpactOnly)
+	SET_CALLBACK(WeaponDef_isNoAutoTarget)
+	SET_CALLBACK(WeaponDef_isManualFire)
+	SET_CALLBACK(WeaponDef_getInterceptor)
+	SET_CALLBACK(WeaponDef_getTargetable)
+	SET_CALLBACK(WeaponDef_isStockpileable)
+	SET_CALLBACK(WeaponDef_getCoverageRange)
+	SET_CALLBACK(WeaponDef_getStockpileTime)
+	SET_CALLBACK(WeaponDef_getIntensity)
+	SET_CALLBACK(WeaponDef_getThickness)
+	SET_CALLBACK(WeaponDef_getLaserFlareSize)
+	SET_CALLBACK(WeaponDef_getCoreThickness)
+	SET_CALLBACK(WeaponDef_getDuration)
+	SET_CALLBACK(WeaponDef_getLodDistance)
+	SET_CALLBACK(WeaponDef_getFalloffRate)
+	SET_CALLBACK(WeaponDef_getGraphicsType)
+	SET_CALLBACK(WeaponDef_isSoundTrigger)
+	SET_CALLBACK(WeaponDef_isSelfExplode)
+	SET_CALLBACK(WeaponDef_isGravityAffected)
+	SET_CALLBACK(WeaponDef_getHighTrajectory)
+	SET_CALLBACK(WeaponDef_getMyGravity)
+	SET_CALLBACK(WeaponDef_isNoExplode)
+	SET_CALLBACK(WeaponDef_getStartVelocity)
+	SET_CALLBACK(WeaponDef_getWeaponAcceleration)
+	SET_CALLBACK(WeaponDef_getTurnRate)
+	SET_CALLBACK(WeaponDef_getMaxVelocity)
+	SET_CALLBACK(WeaponDef_getProjectileSpeed)
+	SET_CALLBACK(WeaponDef_getExplosionSpeed)
+	SET_CALLBACK(WeaponDef_getOnlyTargetCategory)
+	SET_CALLBACK(WeaponDef_getWobble)
+	SET_CALLBACK(WeaponDef_getDance)
+	SET_CALLBACK(WeaponDef_getTrajectoryHeight)
+	SET_CALLBACK(WeaponDef_isLargeBeamLaser)
+	SET_CALLBACK(WeaponDef_isShield)
+	SET_CALLBACK(WeaponDef_isShieldRepulser)
+	SET_CALLBACK(WeaponDef_isSmartShield)
+	SET_CALLBACK(WeaponDef_isExteriorShield)
+	SET_CALLBACK(WeaponDef_isVisibleShield)
+	SET_CALLBACK(WeaponDef_isVisibleShieldRepulse)
+	SET_CALLBACK(WeaponDef_getVisibleShieldHitFrames)
+	SET_CALLBACK(WeaponDef_Shield_getResourceUse)
+	SET_CALLBACK(WeaponDef_Shield_getRadius)
+	SET_CALLBACK(WeaponDef_Shield_getForce)
+	SET_CALLBACK(WeaponDef_Shield_getMaxSpeed)
+	SET_CALLBACK(WeaponDef_Shield_getPower)
+	SET_CALLBACK(WeaponDef_Shield_getPowerRegen)
+	SET_CALLBACK(WeaponDef_Shield_getPowerRegenResource)
+	SET_CALLBACK(WeaponDef_Shield_getStartingPower)
+	SET_CALLBACK(WeaponDef_Shield_getRechargeDelay)
+	SET_CALLBACK(WeaponDef_Shield_getGoodColor)
+	SET_CALLBACK(WeaponDef_Shield_getBadColor)
+	SET_CALLBACK(WeaponDef_Shield_getAlpha)
+	SET_CALLBACK(WeaponDef_Shield_getInterceptType)
+	SET_CALLBACK(WeaponDef_getInterceptedByShieldType)
+	SET_CALLBACK(WeaponDef_isAvoidFriendly)
+	SET_CALLBACK(WeaponDef_isAvoidFeature)
+	SET_CALLBACK(WeaponDef_isAvoidNeutral)
+	SET_CALLBACK(WeaponDef_getTargetBorder)
+	SET_CALLBACK(WeaponDef_getCylinderTargetting)
+	SET_CALLBACK(WeaponDef_getMinIntensity)
+	SET_CALLBACK(WeaponDef_getHeightBoostFactor)
+	SET_CALLBACK(WeaponDef_getProximityPriority)
+	SET_CALLBACK(WeaponDef_getCollisionFlags)
+	SET_CALLBACK(WeaponDef_isSweepFire)
+	SET_CALLBACK(WeaponDef_isAbleToAttackGround)
+	SET_CALLBACK(WeaponDef_getCameraShake)
+	SET_CALLBACK(WeaponDef_getDynDamageExp)
+	SET_CALLBACK(WeaponDef_getDynDamageMin)
+	SET_CALLBACK(WeaponDef_getDynDamageRange)
+	SET_CALLBACK(WeaponDef_isDynDamageInverted)
+	SET_CALLBACK(WeaponDef_getCustomParams)
+	SET_CALLBACK(Debug_GraphDrawer_isEnabled)
+}
+
+#undef SET_CALLBACK
 
 SSkirmishAICallback* skirmishAiCallback_getInstanceFor(int skirmishAIId, int teamId, CAICallback* aiCallback, CAICheats* aiCheats) {
 
 	SSkirmishAICallback* callback = new SSkirmishAICallback();
-	skirmishAiCallback_init(callback);
+	skirmishAiCallback_init(callback, (skirmishAIThread != NULL));
 
 	skirmishAIId_callback[skirmishAIId]      = aiCallback;
 	skirmishAIId_cheatCallback[skirmishAIId] = aiCheats;
@@ -5162,3 +5693,31 @@ void skirmishAiCallback_release(int skirmishAIId) {
 	skirmishAIId_teamId.erase(skirmishAIId);
 }
 
+void skirmishAiCallback_snapshotUnit(int skirmishAIId, int unitId, SSkirmishAIUnitSnapshot* snapshot) {
+
+	snapshot->unitId         = unitId;
+	snapshot->def            = skirmishAiCallback_Unit_getDef(skirmishAIId, unitId);
+	snapshot->team           = skirmishAiCallback_Unit_getTeam(skirmishAIId, unitId);
+	snapshot->allyTeam       = skirmishAiCallback_Unit_getAllyTeam(skirmishAIId, unitId);
+	snapshot->health         = skirmishAiCallback_Unit_getHealth(skirmishAIId, unitId);
+	snapshot->maxHealth      = skirmishAiCallback_Unit_getMaxHealth(skirmishAIId, unitId);
+	snapshot->experience     = skirmishAiCallback_Unit_getExperience(skirmishAIId, unitId);
+	snapshot->speed          = skirmishAiCallback_Unit_getSpeed(skirmishAIId, unitId);
+	snapshot->power          = skirmishAiCallback_Unit_getPower(skirmishAIId, unitId);
+	snapshot->beingBuilt     = skirmishAiCallback_Unit_isBeingBuilt(skirmishAIId, unitId);
+	snapshot->neutral        = skirmishAiCallback_Unit_isNeutral(skirmishAIId, unitId);
+	snapshot->buildingFacing = skirmishAiCallback_Unit_getBuildingFacing(skirmishAIId, unitId);
+
+	skirmishAiCallback_Unit_getPos(skirmishAIId, unitId, snapshot->pos);
+	skirmishAiCallback_Unit_getVel(skirmishAIId, unitId, snapshot->vel);
+}
+
+void skirmishAiCallback_setDeadUnit(int skirmishAIId, const SSkirmishAIUnitSnapshot* snapshot) {
+
+	skirmishAIId_hasDeadUnit[skirmishAIId] = (snapshot != NULL);
+
+	if (snapshot != NULL) {
+		skirmishAIId_deadUnit[skirmishAIId] = *snapshot;
+	}
+}
+
@@ -668,6 +668,16 @@ EXPORT(int              ) skirmishAiCallback_getTeamUnits(int skirmishAIId, int*
 
 EXPORT(int              ) skirmishAiCallback_getSelectedUnits(int skirmishAIId, int* unitIds, int unitIds_sizeMax);
 
+EXPORT(int              ) skirmishAiCallback_getUnitsPositions(int skirmishAIId, int* unitIds, int unitIds_size, float* positions_AposF3, int positions_AposF3_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_getUnitsVelocities(int skirmishAIId, int* unitIds, int unitIds_size, float* velocities_AposF3, int velocities_AposF3_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_getUnitsHealths(int skirmishAIId, int* unitIds, int unitIds_size, float* healths, int healths_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_getUnitsDefs(int skirmishAIId, int* unitIds, int unitIds_size, int* unitDefIds, int unitDefIds_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_getUnitsTeams(int skirmishAIId, int* unitIds, int unitIds_size, int* teams, int teams_sizeMax);
+
 EXPORT(int              ) skirmishAiCallback_Unit_getDef(int skirmishAIId, int unitId);
 
 EXPORT(int              ) skirmishAiCallback_Unit_getModParams(int skirmishAIId, int unitId);
@@ -1298,6 +1308,40 @@ SSkirmishAICallback* skirmishAiCallback_getInstanceFor(int skirmishAIId, int tea
  */
 void skirmishAiCallback_release(int skirmishAIId);
 
+/**
+ * What a unit looked like when it was destroyed. Threaded Skirmish AIs handle
+ * the event after the unit is gone; while they do, the Unit_* getters return
+ * these values for it.
+ */
+struct SSkirmishAIUnitSnapshot {
+	int unitId;
+	int def;
+	int team;
+	int allyTeam;
+	float pos[3];
+	float vel[3];
+	float health;
+	float maxHealth;
+	float experience;
+	float speed;
+	float power;
+	bool beingBuilt;
+	bool neutral;
+	int buildingFacing;
+};
+
+/**
+ * Fills <snapshot> with what the AI can currently see of the unit;
+ * call on the engine thread, while the unit still exists.
+ */
+void skirmishAiCallback_snapshotUnit(int skirmishAIId, int unitId, SSkirmishAIUnitSnapshot* snapshot);
+
+/**
+ * Sets (copies) the destroyed unit the AI is told about, NULL when done.
+ * @see skirmishAiCallback_snapshotUnit
+ */
+void skirmishAiCallback_setDeadUnit(int skirmishAIId, const SSkirmishAIUnitSnapshot* snapshot);
+
 #endif // defined __cplusplus && !defined BUILDING_AI
 
 #endif // S_SKIRMISH_AI_CALLBACK_IMPL_H
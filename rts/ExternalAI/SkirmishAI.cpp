@@ -6,6 +6,7 @@
 #include "IAILibraryManager.h"
 #include "SkirmishAILibrary.h"
 #include "SkirmishAIHandler.h"
+#include "SkirmishAIThread.h"
 #include "System/TimeProfiler.h"
 #include "System/Util.h"
 
@@ -52,7 +53,17 @@ void CSkirmishAI::Dieing() {
 
 int CSkirmishAI::HandleEvent(int topic, const void* data) const {
 
+	// the profiler is not thread-safe, events handled on the
+	// Skirmish AI thread are timed by CSkirmishAIThread instead
+	if ((skirmishAIThread != NULL) && skirmishAIThread->IsCurrentThread())
+		return DispatchEvent(topic, data);
+
 	SCOPED_TIMER(timerName.c_str());
+	return DispatchEvent(topic, data);
+}
+
+int CSkirmishAI::DispatchEvent(int topic, const void* data) const {
+
 	if (!dieing || (topic == EVENT_RELEASE)) {
 		return library->HandleEvent(skirmishAIId, topic, data);
 	} else {
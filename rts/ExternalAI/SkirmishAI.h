@@ -42,6 +42,9 @@ public:
 	 */
 	void Dieing();
 
+private:
+	int DispatchEvent(int topic, const void* data) const;
+
 private:
 	int skirmishAIId;
 	const SkirmishAIKey key;
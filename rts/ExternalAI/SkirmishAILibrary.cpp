@@ -4,6 +4,7 @@
 
 #include "ExternalAI/IAILibraryManager.h"
 #include "ExternalAI/SkirmishAIHandler.h"
+#include "ExternalAI/SkirmishAIThread.h"
 #include "ExternalAI/AIInterfaceKey.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "System/Log/ILog.h"
@@ -91,9 +92,17 @@ bool CSkirmishAILibrary::Release(int skirmishAIId) const
 
 int CSkirmishAILibrary::HandleEvent(int skirmishAIId, int topic, const void* data) const
 {
-	skirmishAIHandler.SetCurrentAIID(skirmishAIId);
+	// the Skirmish AI thread must not touch the engine-side current AI
+	// ID, it is set there for each order and Invoke request instead
+	const bool onAIThread = ((skirmishAIThread != NULL) && skirmishAIThread->IsCurrentThread());
+
+	if (!onAIThread)
+		skirmishAIHandler.SetCurrentAIID(skirmishAIId);
+
 	int ret = sSAI.handleEvent(skirmishAIId, topic, data);
-	skirmishAIHandler.SetCurrentAIID(MAX_AIS);
+
+	if (!onAIThread)
+		skirmishAIHandler.SetCurrentAIID(MAX_AIS);
 
 	if (ret != 0) {
 		// event handling failed!
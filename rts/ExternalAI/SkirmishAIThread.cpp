@@ -0,0 +1,415 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <exception>
+
+#include "SkirmishAIThread.h"
+#include "System/Platform/Threading.h"
+
+CSkirmishAIThread* skirmishAIThread = NULL;
+
+
+
+CSkirmishAIThread::CSkirmishAIThread(int maxLag)
+	: thread(NULL)
+	, maxLag(maxLag)
+	, invoked(NULL)
+	, worldOwner(OWNER_NONE)
+	, engineWaiting(false)
+	, workerDepth(0)
+	, engineDepth(0)
+	, invoking(false)
+	, pauseDepth(0)
+	, running(false)
+	, runningFrame(0)
+	, latestFrame(0)
+	, quit(false)
+	, currentAIId(-1)
+{
+	// the worker reads <thread> (IsCurrentThread) only after taking the mutex
+	boost::mutex::scoped_lock lock(mutex);
+	thread = new boost::thread(boost::bind(&CSkirmishAIThread::Run, this));
+}
+
+CSkirmishAIThread::~CSkirmishAIThread()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		quit = true;
+		workerCond.notify_all();
+
+		// the event the worker is in may still need the engine
+		WaitForWorker(lock, &CSkirmishAIThread::IsBetweenEvents, 0);
+	}
+
+	thread->join();
+	delete thread;
+}
+
+
+
+void CSkirmishAIThread::QueueEvent(int skirmishAIId, int frame, const Func& event)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	events.push_back(QueuedFunc(skirmishAIId, frame, event));
+	workerCond.notify_all();
+}
+
+void CSkirmishAIThread::RemoveEvents(int skirmishAIId)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	std::deque<QueuedFunc> keptEvents;
+
+	for (std::deque<QueuedFunc>::const_iterator it = events.begin(); it != events.end(); ++it) {
+		if (it->skirmishAIId != skirmishAIId) {
+			keptEvents.push_back(*it);
+		}
+	}
+
+	events.swap(keptEvents);
+	failedAIs.erase(skirmishAIId);
+}
+
+
+
+void CSkirmishAIThread::LockWorld(int frame)
+{
+	if (engineDepth++ > 0)
+		return;
+
+	boost::mutex::scoped_lock lock(mutex);
+	latestFrame = frame;
+
+	// a paused worker does not catch up, Resume comes first
+	if (pauseDepth == 0 && !IsLagBelow(frame)) {
+		const int stallAIId = running? currentAIId: events.front().skirmishAIId;
+		const spring_time waitStart = spring_gettime();
+
+		WaitForWorker(lock, &CSkirmishAIThread::IsLagBelow, frame);
+
+		Stats& s = stats[stallAIId];
+		s.waitTime += (spring_gettime() - waitStart);
+		s.numStalls += 1;
+	}
+
+	TakeWorld(lock);
+}
+
+void CSkirmishAIThread::UnlockWorld()
+{
+	if (--engineDepth > 0)
+		return;
+
+	boost::mutex::scoped_lock lock(mutex);
+	worldOwner = OWNER_NONE;
+	workerCond.notify_all();
+}
+
+void CSkirmishAIThread::Pause()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	pauseDepth += 1;
+
+	// the worker is blocked in the middle of an event until we return
+	if (invoking)
+		return;
+
+	WaitForWorker(lock, &CSkirmishAIThread::IsBetweenEvents, 0);
+}
+
+void CSkirmishAIThread::Resume()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	pauseDepth -= 1;
+	workerCond.notify_all();
+}
+
+void CSkirmishAIThread::Flush()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (invoking || pauseDepth > 0)
+		return;
+
+	WaitForWorker(lock, &CSkirmishAIThread::IsDone, 0);
+}
+
+void CSkirmishAIThread::Poll()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (invoking)
+		return;
+
+	if (invoked != NULL) {
+		RunInvoked(lock);
+		return;
+	}
+
+	// worker is in a callback (or we hold the world already), the
+	// queued calls are run once the engine takes the world again
+	if (worldOwner != OWNER_NONE || queuedCalls.empty())
+		return;
+
+	worldOwner = OWNER_ENGINE;
+	engineDepth += 1;
+	RunQueuedCalls(lock);
+	engineDepth -= 1;
+	worldOwner = OWNER_NONE;
+	workerCond.notify_all();
+}
+
+
+
+bool CSkirmishAIThread::EnterWorld()
+{
+	if (!IsCurrentThread())
+		return false;
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (workerDepth++ > 0)
+		return true;
+
+	// also let the engine go first if it is waiting, it may be the one we lag behind
+	while (worldOwner != OWNER_NONE || engineWaiting) {
+		workerCond.wait(lock);
+	}
+
+	worldOwner = OWNER_WORKER;
+	return true;
+}
+
+void CSkirmishAIThread::LeaveWorld()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (--workerDepth > 0)
+		return;
+
+	worldOwner = OWNER_NONE;
+	engineCond.notify_all();
+}
+
+void CSkirmishAIThread::QueueCall(int skirmishAIId, const Func& func)
+{
+	if (!IsCurrentThread()) {
+		func();
+		return;
+	}
+
+	boost::mutex::scoped_lock lock(mutex);
+	queuedCalls.push_back(QueuedFunc(skirmishAIId, latestFrame, func));
+}
+
+void CSkirmishAIThread::Invoke(int skirmishAIId, const Func& func)
+{
+	if (!IsCurrentThread()) {
+		func();
+		return;
+	}
+
+	const QueuedFunc request(skirmishAIId, latestFrame, func);
+
+	boost::mutex::scoped_lock lock(mutex);
+	invoked = &request;
+	engineCond.notify_all();
+
+	while (invoked != NULL) {
+		workerCond.wait(lock);
+	}
+}
+
+
+
+void CSkirmishAIThread::WaitForWorker(boost::mutex::scoped_lock& lock, bool (CSkirmishAIThread::*cond)(int) const, int arg)
+{
+	// the worker can not finish its event without the world
+	const bool lendWorld = (worldOwner == OWNER_ENGINE);
+
+	if (lendWorld) {
+		worldOwner = OWNER_NONE;
+		workerCond.notify_all();
+	}
+
+	while (!(this->*cond)(arg)) {
+		if (invoked != NULL) {
+			RunInvoked(lock);
+			continue;
+		}
+
+		engineCond.wait(lock);
+	}
+
+	if (lendWorld) {
+		TakeWorld(lock);
+	}
+}
+
+void CSkirmishAIThread::TakeWorld(boost::mutex::scoped_lock& lock)
+{
+	if (worldOwner == OWNER_WORKER) {
+		const int waitAIId = currentAIId;
+		const spring_time waitStart = spring_gettime();
+
+		engineWaiting = true;
+
+		while (worldOwner == OWNER_WORKER) {
+			if (invoked != NULL) {
+				RunInvoked(lock);
+				continue;
+			}
+
+			engineCond.wait(lock);
+		}
+
+		engineWaiting = false;
+
+		if (waitAIId >= 0) {
+			stats[waitAIId].waitTime += (spring_gettime() - waitStart);
+		}
+	}
+
+	worldOwner = OWNER_ENGINE;
+	RunQueuedCalls(lock);
+}
+
+void CSkirmishAIThread::RunInvoked(boost::mutex::scoped_lock& lock)
+{
+	const QueuedFunc* request = invoked;
+
+	// the worker is blocked in Invoke until we reset <invoked>; code run
+	// from here must neither wait for it nor take the world (it has it)
+	invoking = true;
+	engineDepth += 1;
+
+	// calls queued before the request go first
+	RunQueuedCalls(lock);
+
+	lock.unlock();
+	request->func();
+	lock.lock();
+
+	engineDepth -= 1;
+	invoking = false;
+
+	invoked = NULL;
+	workerCond.notify_all();
+}
+
+void CSkirmishAIThread::RunQueuedCalls(boost::mutex::scoped_lock& lock)
+{
+	if (queuedCalls.empty())
+		return;
+
+	std::vector<QueuedFunc> calls;
+	calls.swap(queuedCalls);
+
+	lock.unlock();
+
+	for (std::vector<QueuedFunc>::const_iterator it = calls.begin(); it != calls.end(); ++it) {
+		it->func();
+	}
+
+	lock.lock();
+}
+
+bool CSkirmishAIThread::IsLagBelow(int frame) const
+{
+	// events are handled in the order they were raised,
+	// the one the worker is in (if any) is the oldest
+	if (running)
+		return ((frame - runningFrame) <= maxLag);
+	if (events.empty())
+		return true;
+
+	return ((frame - events.front().frame) <= maxLag);
+}
+
+
+
+void CSkirmishAIThread::GetStats(std::map<int, Stats>& s)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	s.clear();
+	s.swap(stats);
+}
+
+void CSkirmishAIThread::GetFailedAIs(std::vector< std::pair<int, std::string> >& failed)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	failed.clear();
+	failed.swap(newFailures);
+}
+
+
+
+void CSkirmishAIThread::Run()
+{
+	Threading::SetThreadName("skirmish-ais");
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	while (true) {
+		while (!quit && (events.empty() || pauseDepth > 0)) {
+			workerCond.wait(lock);
+		}
+
+		if (quit)
+			break;
+
+		const QueuedFunc event = events.front();
+		events.pop_front();
+
+		// AIs that threw are not sent any more events
+		if (failedAIs.find(event.skirmishAIId) != failedAIs.end())
+			continue;
+
+		Stats& s = stats[event.skirmishAIId];
+		s.maxLag = std::max(s.maxLag, latestFrame - event.frame);
+
+		running = true;
+		runningFrame = event.frame;
+		currentAIId = event.skirmishAIId;
+		lock.unlock();
+
+		const spring_time startTime = spring_gettime();
+		std::string error;
+		bool ok = false;
+
+		// exceptions can not be passed on to the engine thread, so
+		// they are reported there (GetFailedAIs) and the AI is killed
+		try {
+			event.func();
+			ok = true;
+		} catch (const std::exception& e) {
+			error = e.what();
+		} catch (const std::string& str) {
+			error = str;
+		} catch (const char* str) {
+			error = str;
+		} catch (...) {
+			error = "Unknown";
+		}
+
+		const spring_time busyTime = spring_gettime() - startTime;
+
+		lock.lock();
+		stats[currentAIId].busyTime += busyTime;
+
+		if (!ok) {
+			failedAIs.insert(currentAIId);
+			newFailures.push_back(std::make_pair(currentAIId, error));
+		}
+
+		// an exception may have skipped a LeaveWorld
+		if (worldOwner == OWNER_WORKER) {
+			worldOwner = OWNER_NONE;
+			workerDepth = 0;
+		}
+
+		running = false;
+		currentAIId = -1;
+		engineCond.notify_all();
+	}
+}
@@ -0,0 +1,206 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SKIRMISH_AI_THREAD_H
+#define SKIRMISH_AI_THREAD_H
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "System/Misc/SpringTime.h"
+
+/**
+ * Runs the events of all local Skirmish AIs on a worker thread.
+ *
+ * The engine queues the events as it raises them; the worker handles them
+ * in order, as fast as the AIs allow, so the AIs may lag behind the sim.
+ * Every call an AI makes into the engine holds the "world" (EnterWorld)
+ * for its duration, and the engine holds the world while it changes synced
+ * state (LockWorld, around each network message). A slow AI therefore only
+ * delays the engine for the length of a single callback; the engine only
+ * waits for a whole event when the oldest unhandled event is more than
+ * <maxLag> frames old.
+ *
+ * Calls the AIs make which have to run on the engine thread are either
+ * queued (QueueCall: unit orders, drawing) and run the next time the engine
+ * takes the world, or run synchronously (Invoke: everything that returns
+ * data), which blocks the AI until the engine takes the world or polls.
+ *
+ * AIs share a single worker: the callback implementation keeps static
+ * scratch state which is not safe to use from several threads at once.
+ * There must also be a single engine thread (no GML builds with a separate
+ * sim thread), the engine-side bookkeeping (engineDepth, invoking) is only
+ * ever touched from there.
+ */
+class CSkirmishAIThread : boost::noncopyable
+{
+public:
+	typedef boost::function<void()> Func;
+
+	/// per-AI numbers, collected since the last call to GetStats
+	struct Stats {
+		Stats(): busyTime(spring_notime), waitTime(spring_notime), numStalls(0), maxLag(0) {}
+
+		spring_time busyTime; ///< time the worker spent in this AI
+		spring_time waitTime; ///< time the engine had to wait for it
+		int numStalls;        ///< times the engine had to wait for it
+		int maxLag;           ///< largest age (in frames) of an event when it was handled
+	};
+
+	/// holds the world on the worker for its lifetime, no-op on any other thread
+	class WorldLock : boost::noncopyable {
+	public:
+		WorldLock(CSkirmishAIThread* t): thread((t != NULL && t->EnterWorld())? t: NULL) {}
+		~WorldLock() { if (thread != NULL) thread->LeaveWorld(); }
+	private:
+		CSkirmishAIThread* thread;
+	};
+
+	/// keeps the worker from starting new events for its lifetime (engine thread)
+	class ScopedPause : boost::noncopyable {
+	public:
+		ScopedPause(CSkirmishAIThread* t): thread(t) { if (thread != NULL) thread->Pause(); }
+		~ScopedPause() { if (thread != NULL) thread->Resume(); }
+	private:
+		CSkirmishAIThread* thread;
+	};
+
+public:
+	CSkirmishAIThread(int maxLag);
+	~CSkirmishAIThread();
+
+	/// queue an event raised in <frame>
+	void QueueEvent(int skirmishAIId, int frame, const Func& event);
+	/// drop queued events of an AI that is being destroyed
+	void RemoveEvents(int skirmishAIId);
+
+	/**
+	 * engine thread: take the world before changing synced state in <frame>,
+	 * waits for the callback the worker is in (if any) and for the worker
+	 * to catch up if it lags more than <maxLag> frames; reentrant
+	 */
+	void LockWorld(int frame);
+	void UnlockWorld();
+
+	/**
+	 * engine thread: wait until the worker is between events and keep it
+	 * there until Resume; the world is lent to the worker meanwhile if the
+	 * engine holds it. Does not wait if called from a request the worker
+	 * is blocked on. Nests.
+	 */
+	void Pause();
+	void Resume();
+	/// engine thread: wait until all queued events are handled
+	void Flush();
+	/// engine thread: run the calls and requests the worker queued, if any
+	void Poll();
+
+	bool IsCurrentThread() const { return (boost::this_thread::get_id() == thread->get_id()); }
+
+	/// worker thread: wait for and hold the world, reentrant
+	/// @return false (and does nothing) if not called on the worker
+	bool EnterWorld();
+	void LeaveWorld();
+
+	/// worker thread: run func on the engine thread the next time it takes the world
+	/// (right away on any other thread)
+	void QueueCall(int skirmishAIId, const Func& func);
+
+	/// worker thread: run func on the engine thread and wait for it
+	/// (right away on any other thread)
+	void Invoke(int skirmishAIId, const Func& func);
+
+	template<typename R> R Invoke(int skirmishAIId, const boost::function<R()>& func) {
+		R ret = R();
+		Invoke(skirmishAIId, boost::bind(&CSkirmishAIThread::AssignResult<R>, &ret, func));
+		return ret;
+	}
+
+	/// @return skirmishAIId of the AI running on the worker, or -1
+	int GetCurrentAIID() const { return currentAIId; }
+
+	/// engine thread: collects per-AI stats since the last call
+	void GetStats(std::map<int, Stats>& stats);
+
+	/**
+	 * engine thread: AIs that threw out of an event since the last call,
+	 * with the exception text; they get no more events until RemoveEvents
+	 */
+	void GetFailedAIs(std::vector< std::pair<int, std::string> >& failed);
+
+private:
+	struct QueuedFunc {
+		QueuedFunc(int id, int f, const Func& fn): skirmishAIId(id), frame(f), func(fn) {}
+
+		int skirmishAIId;
+		int frame;
+		Func func;
+	};
+
+	enum WorldOwner {
+		OWNER_NONE,
+		OWNER_ENGINE,
+		OWNER_WORKER
+	};
+
+	template<typename R> static void AssignResult(R* ret, const boost::function<R()>& func) { *ret = func(); }
+
+	void Run();
+
+	/// engine thread: wait (servicing requests) until (this->*cond)(arg) holds
+	void WaitForWorker(boost::mutex::scoped_lock& lock, bool (CSkirmishAIThread::*cond)(int) const, int arg);
+	/// engine thread: take the world from the worker and run the queued calls
+	void TakeWorld(boost::mutex::scoped_lock& lock);
+	/// engine thread: run the queued calls and the pending request, worker is blocked on it
+	void RunInvoked(boost::mutex::scoped_lock& lock);
+	/// engine thread: run the queued calls
+	void RunQueuedCalls(boost::mutex::scoped_lock& lock);
+
+	bool IsBetweenEvents(int) const { return !running; }
+	bool IsDone(int) const { return (!running && events.empty()); }
+	bool IsLagBelow(int frame) const;
+
+private:
+	boost::thread* thread;
+	boost::mutex mutex;
+	boost::condition_variable workerCond; ///< wakes the worker
+	boost::condition_variable engineCond; ///< wakes the engine thread
+
+	const int maxLag;
+
+	std::deque<QueuedFunc> events;
+	std::vector<QueuedFunc> queuedCalls;
+
+	const QueuedFunc* invoked; ///< pending Invoke, or NULL
+
+	WorldOwner worldOwner;
+	bool engineWaiting; ///< engine wants the world, worker must not take it again
+	int workerDepth;    ///< worker only
+	int engineDepth;    ///< engine thread only
+	bool invoking;      ///< engine thread only, runs <invoked>
+	int pauseDepth;
+
+	bool running;     ///< worker is in an event
+	int runningFrame; ///< frame the current event was raised in
+	int latestFrame;  ///< last frame passed to LockWorld
+	bool quit;
+
+	int currentAIId;
+
+	std::map<int, Stats> stats;
+	std::set<int> failedAIs;
+	std::vector< std::pair<int, std::string> > newFailures;
+};
+
+/// NULL unless Skirmish AIs run threaded, owned by the CEngineOutHandler
+extern CSkirmishAIThread* skirmishAIThread;
+
+#endif // SKIRMISH_AI_THREAD_H
@@ -9,12 +9,15 @@
 #include "System/Util.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
+#include "Sim/Units/CommandAI/Command.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "ExternalAI/AICallback.h"
 #include "ExternalAI/AICheats.h"
 #include "ExternalAI/SkirmishAI.h"
 #include "ExternalAI/EngineOutHandler.h"
 #include "ExternalAI/SkirmishAIHandler.h"
+#include "ExternalAI/SkirmishAIThread.h"
 #include "ExternalAI/SkirmishAILibraryInfo.h"
 #include "ExternalAI/SkirmishAIData.h"
 #include "ExternalAI/SSkirmishAICallbackImpl.h"
@@ -290,22 +293,71 @@ void CSkirmishAIWrapper::Save(std::ostream* save_s)
 	}
 }
 
+bool CSkirmishAIWrapper::DeferEvent(const boost::function<void()>& event) {
+
+	if ((skirmishAIThread == NULL) || skirmishAIThread->IsCurrentThread())
+		return false;
+
+	skirmishAIThread->QueueEvent(skirmishAIId, gs->frameNum, event);
+	return true;
+}
+
+static void SendChatMessageCopy(CSkirmishAIWrapper* wrapper, const std::string& msg, int fromPlayerId) {
+	wrapper->SendChatMessage(msg.c_str(), fromPlayerId);
+}
+
+/// the unit is gone by the time the Skirmish AI thread gets to the event,
+/// the AI is shown what it could see of it when it was destroyed instead
+static void SendDestroyedEvent(
+	CSkirmishAIWrapper* wrapper,
+	void (CSkirmishAIWrapper::*event)(int, int),
+	int skirmishAIId,
+	const SSkirmishAIUnitSnapshot& snapshot,
+	int attackerUnitId
+) {
+	skirmishAiCallback_setDeadUnit(skirmishAIId, &snapshot);
+	(wrapper->*event)(snapshot.unitId, attackerUnitId);
+	skirmishAiCallback_setDeadUnit(skirmishAIId, NULL);
+}
+
+bool CSkirmishAIWrapper::DeferDestroyedEvent(void (CSkirmishAIWrapper::*event)(int, int), int unitId, int attackerUnitId) {
+
+	if ((skirmishAIThread == NULL) || skirmishAIThread->IsCurrentThread())
+		return false;
+
+	SSkirmishAIUnitSnapshot snapshot;
+	skirmishAiCallback_snapshotUnit(skirmishAIId, unitId, &snapshot);
+
+	return DeferEvent(boost::bind(&SendDestroyedEvent, this, event, skirmishAIId, snapshot, attackerUnitId));
+}
+
 void CSkirmishAIWrapper::UnitIdle(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitIdle, this, unitId)))
+		return;
+
 	SUnitIdleEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_UNIT_IDLE, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitCreated(int unitId, int builderId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitCreated, this, unitId, builderId)))
+		return;
+
 	SUnitCreatedEvent evtData = {unitId, builderId};
 	ai->HandleEvent(EVENT_UNIT_CREATED, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitFinished(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitFinished, this, unitId)))
+		return;
+
 	SUnitFinishedEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_UNIT_FINISHED, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitDestroyed(int unitId, int attackerUnitId) {
+	if (DeferDestroyedEvent(&CSkirmishAIWrapper::UnitDestroyed, unitId, attackerUnitId))
+		return;
 
 	SUnitDestroyedEvent evtData = {unitId, attackerUnitId};
 	ai->HandleEvent(EVENT_UNIT_DESTROYED, &evtData);
@@ -313,6 +365,8 @@ void CSkirmishAIWrapper::UnitDestroyed(int unitId, int attackerUnitId) {
 
 void CSkirmishAIWrapper::UnitDamaged(int unitId, int attackerUnitId,
 		float damage, const float3& dir, int weaponDefId, bool paralyzer) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitDamaged, this, unitId, attackerUnitId, damage, dir, weaponDefId, paralyzer)))
+		return;
 
 	SUnitDamagedEvent evtData = {unitId, attackerUnitId, damage,
 			new float[3], weaponDefId, paralyzer};
@@ -322,58 +376,90 @@ void CSkirmishAIWrapper::UnitDamaged(int unitId, int attackerUnitId,
 }
 
 void CSkirmishAIWrapper::UnitMoveFailed(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitMoveFailed, this, unitId)))
+		return;
+
 	SUnitMoveFailedEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_UNIT_MOVE_FAILED, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitGiven(int unitId, int oldTeam, int newTeam) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitGiven, this, unitId, oldTeam, newTeam)))
+		return;
+
 	SUnitGivenEvent evtData = {unitId, oldTeam, newTeam};
 	ai->HandleEvent(EVENT_UNIT_GIVEN, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitCaptured(int unitId, int oldTeam, int newTeam) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::UnitCaptured, this, unitId, oldTeam, newTeam)))
+		return;
+
 	SUnitCapturedEvent evtData = {unitId, oldTeam, newTeam};
 	ai->HandleEvent(EVENT_UNIT_CAPTURED, &evtData);
 }
 
 
 void CSkirmishAIWrapper::EnemyCreated(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyCreated, this, unitId)))
+		return;
+
 	SEnemyCreatedEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_ENEMY_CREATED, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyFinished(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyFinished, this, unitId)))
+		return;
+
 	SEnemyFinishedEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_ENEMY_FINISHED, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyEnterLOS(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyEnterLOS, this, unitId)))
+		return;
+
 	SEnemyEnterLOSEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_ENEMY_ENTER_LOS, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyLeaveLOS(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyLeaveLOS, this, unitId)))
+		return;
+
 	SEnemyLeaveLOSEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_ENEMY_LEAVE_LOS, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyEnterRadar(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyEnterRadar, this, unitId)))
+		return;
+
 	SEnemyEnterRadarEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_ENEMY_ENTER_RADAR, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyLeaveRadar(int unitId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyLeaveRadar, this, unitId)))
+		return;
+
 	SEnemyLeaveRadarEvent evtData = {unitId};
 	ai->HandleEvent(EVENT_ENEMY_LEAVE_RADAR, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyDestroyed(int enemyUnitId, int attackerUnitId) {
+	if (DeferDestroyedEvent(&CSkirmishAIWrapper::EnemyDestroyed, enemyUnitId, attackerUnitId))
+		return;
+
 	SEnemyDestroyedEvent evtData = {enemyUnitId, attackerUnitId};
 	ai->HandleEvent(EVENT_ENEMY_DESTROYED, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyDamaged(int enemyUnitId, int attackerUnitId,
 		float damage, const float3& dir, int weaponDefId, bool paralyzer) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::EnemyDamaged, this, enemyUnitId, attackerUnitId, damage, dir, weaponDefId, paralyzer)))
+		return;
 
 	SEnemyDamagedEvent evtData = {enemyUnitId, attackerUnitId, damage,
 			new float[3], weaponDefId, paralyzer};
@@ -383,11 +469,17 @@ void CSkirmishAIWrapper::EnemyDamaged(int enemyUnitId, int attackerUnitId,
 }
 
 void CSkirmishAIWrapper::Update(int frame) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::Update, this, frame)))
+		return;
+
 	SUpdateEvent evtData = {frame};
 	ai->HandleEvent(EVENT_UPDATE, &evtData);
 }
 
 void CSkirmishAIWrapper::SendChatMessage(const char* msg, int fromPlayerId) {
+	if (DeferEvent(boost::bind(&SendChatMessageCopy, this, std::string(msg), fromPlayerId)))
+		return;
+
 	SMessageEvent evtData = {fromPlayerId, msg};
 	ai->HandleEvent(EVENT_MESSAGE, &evtData);
 }
@@ -398,6 +490,9 @@ void CSkirmishAIWrapper::SendLuaMessage(const char* inData, const char** outData
 }
 
 void CSkirmishAIWrapper::WeaponFired(int unitId, int weaponDefId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::WeaponFired, this, unitId, weaponDefId)))
+		return;
+
 	SWeaponFiredEvent evtData = {unitId, weaponDefId};
 	ai->HandleEvent(EVENT_WEAPON_FIRED, &evtData);
 }
@@ -407,6 +502,9 @@ void CSkirmishAIWrapper::PlayerCommandGiven(
 	const Command& c,
 	int playerId
 ) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::PlayerCommandGiven, this, playerSelectedUnits, c, playerId)))
+		return;
+
 	const int cCommandId = extractAICommandTopic(&c, unitHandler->MaxUnits());
 	int* unitIds = new int[playerSelectedUnits.size()];
 
@@ -420,12 +518,17 @@ void CSkirmishAIWrapper::PlayerCommandGiven(
 }
 
 void CSkirmishAIWrapper::CommandFinished(int unitId, int commandId, int commandTopicId) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::CommandFinished, this, unitId, commandId, commandTopicId)))
+		return;
+
 	SCommandFinishedEvent evtData = {unitId, commandId, commandTopicId};
 	ai->HandleEvent(EVENT_COMMAND_FINISHED, &evtData);
 }
 
 void CSkirmishAIWrapper::SeismicPing(int allyTeam, int unitId,
 		const float3& pos, float strength) {
+	if (DeferEvent(boost::bind(&CSkirmishAIWrapper::SeismicPing, this, allyTeam, unitId, pos, strength)))
+		return;
 
 	SSeismicPingEvent evtData = {new float[3], strength};
 	pos.copyInto(evtData.pos_posF3);
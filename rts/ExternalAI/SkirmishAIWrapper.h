@@ -9,6 +9,7 @@
 
 #include <map>
 #include <string>
+#include <boost/function.hpp>
 
 class CAICallback;
 class CAICheats;
@@ -84,6 +85,16 @@ public:
 
 private:
 	bool LoadSkirmishAI(bool postLoad);
+	/**
+	 * Queues an event for the Skirmish AI thread if AIs run threaded.
+	 * @return false if the event has to be sent right away
+	 */
+	bool DeferEvent(const boost::function<void()>& event);
+	/**
+	 * Like DeferEvent, for UnitDestroyed and EnemyDestroyed: snapshots the
+	 * unit first, the AI is sent the event once it is gone.
+	 */
+	bool DeferDestroyedEvent(void (CSkirmishAIWrapper::*event)(int, int), int unitId, int attackerUnitId);
 
 
 	int skirmishAIId;
@@ -25,7 +25,8 @@ bool DummyVideoCapturing::IsCapturing() const {
 void DummyVideoCapturing::StartCapturing() {
 
 	LOG_L(L_WARNING, "Creating a video is not supported by this engine build.");
-	LOG_L(L_WARNING, "(requires: OS=Win32 / Compiler=MinGW / \"#define AVI_CAPTURING\")");
+	LOG_L(L_WARNING, "(requires: OS=Win32 / Compiler=MinGW / \"#define AVI_CAPTURING\"");
+	LOG_L(L_WARNING, " or OS=Linux / \"#define RAW_CAPTURING\")");
 	LOG_L(L_WARNING, "Please use an external frame-grabbing/-capturing application.");
 }
 
@@ -353,6 +353,7 @@ CGame::~CGame()
 	CColorMap::DeleteColormaps();
 
 	IVideoCapturing::FreeInstance();
+	FlushScreenshots();
 
 	CLuaGaia::FreeHandler();
 	CLuaRules::FreeHandler();
@@ -731,6 +732,12 @@ void CGame::LoadFinalize()
 	eventHandler.GamePreload();
 	pathManager->UpdateFull(); // mapfeatures are not in written pathcaches, so we need to repath those & other stuff done by Lua
 
+	if (configHandler->GetBool("snd_preload")) {
+		// sounds of unit- and weapondefs were queued for decoding while loading
+		loadscreen->SetLoadMessage("Decoding Sounds");
+		sound->WaitForSoundBuffers();
+	}
+
 	loadscreen->SetLoadMessage("Finalizing");
 
 	if (CBenchmark::enabled) {
@@ -1049,6 +1056,19 @@ bool CGame::UpdateUnsynced()
 			// TODO call only when camera changed
 			sound->UpdateListener(camera->GetPos(), camera->forward, camera->up, deltaSec);
 
+			{
+				// per-state Lua allocation counts
+				std::vector<SLuaAllocStats> luaAllocStats;
+				spring_lua_alloc_get_state_stats(&luaAllocStats, true);
+
+				for (size_t n = 0; n < luaAllocStats.size(); n++) {
+					if (luaAllocStats[n].name.empty())
+						continue;
+
+					profiler.AddCounter("Lua::" + luaAllocStats[n].name + " allocs", luaAllocStats[n].numAllocs);
+				}
+			}
+
 			profiler.Update();
 		}
 	}
@@ -1112,6 +1132,9 @@ bool CGame::Draw() {
 	const bool doDrawWorld = hideInterface || !minimap->GetMaximized() || minimap->GetMinimized();
 	const spring_time currentTimePreDraw = spring_gettime();
 
+	// a threaded Skirmish AI may be blocked on a request
+	eoh->PollAIs();
+
 	eventHandler.DrawGenesis();
 
 	if (!globalRendering->active) {
@@ -1257,6 +1280,19 @@ bool CGame::Draw() {
 		spring_lua_alloc_get_stats(&allocedBytes);
 		font->glFormat(0.03f, 0.15f, 0.7f, DBG_FONT_FLAGS, "Lua allocated memory: %.1fMB", allocedBytes/1024.f/1024.f);
 
+		std::vector<SLuaAllocStats> luaAllocStats;
+		spring_lua_alloc_get_state_stats(&luaAllocStats, false);
+
+		for (size_t n = 0, line = 0; n < luaAllocStats.size(); n++) {
+			const SLuaAllocStats& s = luaAllocStats[n];
+
+			if (s.name.empty() || s.peakAllocedBytes == 0)
+				continue;
+
+			font->glFormat(0.03f, 0.18f + (line++) * 0.02f, 0.6f, DBG_FONT_FLAGS, "  %s: %.1fMB (peak %.1fMB, pooled %.1fMB, failed %u)",
+				s.name.c_str(), s.allocedBytes/1024.f/1024.f, s.peakAllocedBytes/1024.f/1024.f, s.pooledBytes/1024.f/1024.f, s.numFailed);
+		}
+
 		font->End();
 	}
 
@@ -1331,10 +1367,13 @@ bool CGame::Draw() {
 	glLoadIdentity();
 
 	videoCapturing->RenderFrame();
+	UpdateScreenshots();
 
 	SetDrawMode(gameNotDrawing);
 	CTeamHighlight::Disable();
 
+	eoh->PollAIs();
+
 	const spring_time currentTimePostDraw = spring_gettime();
 	gu->avgDrawFrameTime = mix(gu->avgDrawFrameTime, spring_tomsecs(currentTimePostDraw - currentTimePreDraw), 0.05f);
 
@@ -5,16 +5,27 @@
 
 #if       defined AVI_CAPTURING
 #include "AviVideoCapturing.h"
+#elif     defined RAW_CAPTURING
+#include "RawVideoCapturing.h"
 #else  // defined AVI_CAPTURING
 #include "DummyVideoCapturing.h"
 #endif // defined AVI_CAPTURING
 
+#include "System/Config/ConfigHandler.h"
+
 #include <cstdlib> // for NULL
 
+CONFIG(int, VideoCapturingReadBuffers)
+	.defaultValue(3)
+	.minimumValue(1)
+	.description("Number of frames the video capturer reads back asynchronously, each frame is waited for this many frames minus one after it was drawn. 1 reads synchronously.");
+
 IVideoCapturing* IVideoCapturing::GetInstance()
 {
 #if       defined AVI_CAPTURING
 	static AviVideoCapturing instance;
+#elif     defined RAW_CAPTURING
+	static RawVideoCapturing instance;
 #else  // defined AVI_CAPTURING
 	static DummyVideoCapturing instance;
 #endif // defined AVI_CAPTURING
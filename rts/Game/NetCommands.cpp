@@ -119,6 +119,9 @@ void CGame::ClientReadNet()
 	const float msgProcTimeLimit = (GML::SimEnabled() && GML::MultiThreadSim()) ? (1000.0f / gu->minFPS) :
 		Clamp(simDrawRatio * gu->avgSimFrameTime, 5.0f, 1000.0f / gu->minFPS);
 
+	// let a threaded Skirmish AI blocked on a request carry on
+	eoh->PollAIs();
+
 	// really process the messages
 	while (true) {
 		const float msgProcTimeSpent = spring_tomsecs(spring_gettime() - msgProcStartTime);
@@ -138,6 +141,10 @@ void CGame::ClientReadNet()
 		const unsigned dataLength = packet->length;
 		const unsigned char packetCode = inbuf[0];
 
+		// messages change synced state, keep threaded Skirmish AIs
+		// out of the engine until this one is processed
+		const CScopedAIWorldLock aiWorldLock;
+
 		switch (packetCode) {
 			case NETMSG_QUIT: {
 				try {
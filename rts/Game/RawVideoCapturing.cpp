@@ -0,0 +1,241 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#if       defined RAW_CAPTURING
+#include "RawVideoCapturing.h"
+
+#include "Rendering/GlobalRendering.h"
+#include "Rendering/GL/AsyncPixelReader.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Log/ILog.h"
+#include "System/Util.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/Platform/Threading.h"
+
+#include <boost/bind.hpp>
+#include <cstring>
+
+/// frames that can wait for the writer thread before RenderFrame blocks
+static const unsigned int NUM_FRAME_BUFFERS = 10;
+
+
+RawVideoCapturing::RawVideoCapturing()
+	: capturing(false)
+	, file(NULL)
+	, videoSizeX(0)
+	, videoSizeY(0)
+	, numFrames(0)
+	, pixelReader(NULL)
+	, writerThread(NULL)
+	, quitWriter(false)
+	, writeError(false) {
+}
+
+RawVideoCapturing::~RawVideoCapturing() {
+	// write the frames that are still buffered (game left while capturing)
+	StopCapturing();
+}
+
+
+bool RawVideoCapturing::IsCapturingSupported() const {
+	return true;
+}
+
+bool RawVideoCapturing::IsCapturing() const {
+	return capturing;
+}
+
+
+void RawVideoCapturing::StopCapturing() {
+
+	if (!IsCapturing())
+		return;
+
+	capturing = false;
+
+	// frames still in flight are written too
+	while (pixelReader->GetNumQueued() > 0) {
+		if (!PassOldestFrame())
+			break;
+	}
+
+	{
+		boost::mutex::scoped_lock lock(writerMutex);
+		quitWriter = true;
+		writerCondition.notify_all();
+	}
+
+	writerThread->join();
+	SafeDelete(writerThread);
+	SafeDelete(pixelReader);
+
+	fclose(file);
+	file = NULL;
+
+	while (!freeFrameBuffers.empty()) {
+		delete[] freeFrameBuffers.front();
+		freeFrameBuffers.pop_front();
+	}
+	while (!frameBuffers.empty()) {
+		delete[] frameBuffers.front();
+		frameBuffers.pop_front();
+	}
+
+	if (writeError) {
+		LOG_L(L_ERROR, "Could not write all frames to %s (disk full?)", fileName.c_str());
+	}
+
+	LOG("Finished writing %u frames to %s, encode with e.g.:", numFrames, fileName.c_str());
+	LOG("  ffmpeg -f rawvideo -pixel_format bgra -video_size %ix%i -framerate %i -i %s video.mkv",
+			videoSizeX, videoSizeY, GAME_SPEED, fileName.c_str());
+}
+
+
+void RawVideoCapturing::StartCapturing() {
+
+	if (IsCapturing()) {
+		LOG_L(L_WARNING, "Video capturing is already running.");
+		return;
+	}
+
+	// Find a file to capture to
+	const size_t MAX_NUM_VIDEOS = 1000;
+	size_t vi;
+	for (vi = 0; vi < MAX_NUM_VIDEOS; ++vi) {
+		fileName = std::string("video") + IntToString(vi) + ".raw";
+		CFileHandler ifs(fileName);
+		if (!ifs.FileExists()) {
+			break;
+		}
+	}
+
+	if (vi == MAX_NUM_VIDEOS) {
+		LOG_L(L_ERROR, "You have too many videos on disc already, please move, rename or delete some.");
+		LOG_L(L_ERROR, "Not creating video!");
+		return;
+	}
+
+	const std::string filePath = dataDirsAccess.LocateFile(fileName, FileQueryFlags::WRITE);
+
+	if ((file = fopen(filePath.c_str(), "wb")) == NULL) {
+		LOG_L(L_ERROR, "Could not open %s for writing, not creating video!", filePath.c_str());
+		return;
+	}
+
+	videoSizeX = (globalRendering->viewSizeX / 4) * 4;
+	videoSizeY = (globalRendering->viewSizeY / 4) * 4;
+	numFrames = 0;
+
+	pixelReader = new CAsyncPixelReader(videoSizeX, videoSizeY, GL_BGRA, configHandler->GetInt("VideoCapturingReadBuffers"));
+
+	for (unsigned int i = 0; i < NUM_FRAME_BUFFERS; i++) {
+		freeFrameBuffers.push_back(new unsigned char[pixelReader->GetFrameSize()]);
+	}
+
+	quitWriter = false;
+	writeError = false;
+	writerThread = new boost::thread(boost::bind(&RawVideoCapturing::WriterThreadProc, this));
+
+	capturing = true;
+
+	LOG("Recording raw video (BGRA, %i fps) to %s size %i x %i",
+			GAME_SPEED, fileName.c_str(), videoSizeX, videoSizeY);
+}
+
+
+void RawVideoCapturing::RenderFrame() {
+
+	if (!IsCapturing())
+		return;
+
+	globalRendering->lastFrameTime = 1.0f / GAME_SPEED;
+
+	pixelReader->QueueRead();
+
+	// the oldest read is VideoCapturingReadBuffers-1 frames old by now
+	// (with a single buffer it is this frame's), pass it to the writer
+	if (pixelReader->IsFull() && !PassOldestFrame()) {
+		StopCapturing();
+	}
+}
+
+
+bool RawVideoCapturing::PassOldestFrame() {
+
+	unsigned char* frame = NULL;
+
+	{
+		boost::mutex::scoped_lock lock(writerMutex);
+		while (!writeError && freeFrameBuffers.empty()) {
+			writerCondition.wait(lock);
+		}
+		if (writeError) {
+			return false;
+		}
+		frame = freeFrameBuffers.front();
+		freeFrameBuffers.pop_front();
+	}
+
+	const unsigned char* pixels = pixelReader->MapOldest();
+	if (pixels != NULL) {
+		memcpy(frame, pixels, pixelReader->GetFrameSize());
+	} else {
+		memset(frame, 0, pixelReader->GetFrameSize());
+	}
+	pixelReader->UnmapOldest();
+
+	{
+		boost::mutex::scoped_lock lock(writerMutex);
+		frameBuffers.push_back(frame);
+		writerCondition.notify_all();
+	}
+
+	numFrames++;
+	return true;
+}
+
+
+void RawVideoCapturing::WriterThreadProc() {
+
+	Threading::SetThreadName("raw-recorder");
+
+	const unsigned int rowSize = pixelReader->GetRowSize();
+	unsigned char* frame = NULL;
+
+	while (true) {
+		{
+			boost::mutex::scoped_lock lock(writerMutex);
+			if (frame != NULL) {
+				freeFrameBuffers.push_back(frame);
+				frame = NULL;
+				writerCondition.notify_all();
+			}
+			while (!quitWriter && frameBuffers.empty()) {
+				writerCondition.wait(lock);
+			}
+			if (frameBuffers.empty()) {
+				// quitWriter is set and everything is written
+				break;
+			}
+			frame = frameBuffers.front();
+			frameBuffers.pop_front();
+		}
+
+		if (writeError)
+			continue;
+
+		// GL rows are bottom-up, write them top-down
+		for (int y = videoSizeY - 1; y >= 0; --y) {
+			if (fwrite(frame + y * rowSize, videoSizeX * 4, 1, file) != 1) {
+				boost::mutex::scoped_lock lock(writerMutex);
+				writeError = true;
+				writerCondition.notify_all();
+				break;
+			}
+		}
+	}
+}
+
+#endif // defined RAW_CAPTURING
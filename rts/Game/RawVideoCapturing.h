@@ -0,0 +1,72 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _RAW_VIDEO_CAPTURING_H
+#define _RAW_VIDEO_CAPTURING_H
+
+#if       defined RAW_CAPTURING
+
+#include "IVideoCapturing.h"
+
+#include <cstdio>
+#include <list>
+#include <string>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+class CAsyncPixelReader;
+
+
+/**
+ * Dumps every drawn frame losslessly as headerless BGRA (top-down rows)
+ * into a single file, which can be encoded afterwards by an external tool
+ * (the command line is logged when capturing stops).
+ * Frames are read back asynchronously and written by a separate thread.
+ */
+class RawVideoCapturing : public IVideoCapturing {
+
+	friend class IVideoCapturing;
+
+	RawVideoCapturing();
+	virtual ~RawVideoCapturing();
+
+public:
+	virtual bool IsCapturingSupported() const;
+
+	virtual bool IsCapturing() const;
+	virtual void StartCapturing();
+	virtual void StopCapturing();
+
+	virtual void RenderFrame();
+
+private:
+	/// moves the oldest read frame to the writer thread, false on write errors
+	bool PassOldestFrame();
+	void WriterThreadProc();
+
+private:
+	bool capturing;
+
+	std::string fileName;
+	FILE* file;
+
+	int videoSizeX;
+	int videoSizeY;
+	unsigned int numFrames;
+
+	CAsyncPixelReader* pixelReader;
+
+	boost::thread* writerThread;
+	boost::mutex writerMutex;
+	boost::condition writerCondition;
+
+	volatile bool quitWriter;
+	volatile bool writeError;
+
+	std::list<unsigned char*> freeFrameBuffers;
+	std::list<unsigned char*> frameBuffers;
+};
+
+#endif // defined RAW_CAPTURING
+
+#endif // _RAW_VIDEO_CAPTURING_H
@@ -142,6 +142,20 @@ public:
 };
 
 
+class ParallelMoveTypesActionExecutor : public ISyncedActionExecutor {
+public:
+	ParallelMoveTypesActionExecutor() : ISyncedActionExecutor("ParallelMoveTypes",
+			"Enables/Disables precomputing parts of the unit movement updates"
+			" (obstacle avoidance) on worker threads", true) {}
+
+	bool Execute(const SyncedAction& action) const {
+		SetBoolArg(unitHandler->parallelMoveTypeUpdate, action.GetArgs());
+		LogSystemStatus("Parallel movetype updates", unitHandler->parallelMoveTypeUpdate);
+		return true;
+	}
+};
+
+
 class GiveActionExecutor : public ISyncedActionExecutor {
 public:
 	GiveActionExecutor() : ISyncedActionExecutor("Give",
@@ -500,6 +514,7 @@ void SyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new GodModeActionExecutor());
 	AddActionExecutor(new GlobalLosActionExecutor());
 	AddActionExecutor(new NoCostActionExecutor());
+	AddActionExecutor(new ParallelMoveTypesActionExecutor());
 	AddActionExecutor(new GiveActionExecutor());
 	AddActionExecutor(new DestroyActionExecutor());
 	AddActionExecutor(new NoSpectatorChatActionExecutor());
@@ -72,6 +72,10 @@ CONFIG(int, MiniMapDrawCommands)
 
 CONFIG(bool, MiniMapDrawProjectiles).defaultValue(true);
 CONFIG(bool, SimpleMiniMapColors).defaultValue(false);
+CONFIG(bool, MiniMapRenderToTexture)
+	.defaultValue(true)
+	.safemodeValue(false)
+	.description("Render the minimap ground into a cached texture that is only redrawn when the heightmap, LOS or draw-mode change.");
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -93,7 +97,14 @@ CMiniMap::CMiniMap()
   mouseResize(false),
   slaveDrawMode(false),
   showButtons(false),
-  useIcons(true)
+  useIcons(true),
+  renderToTexture(false),
+  groundCacheTex(0),
+  groundCacheSizeX(0),
+  groundCacheSizeY(0),
+  groundCacheMapRevision(0),
+  groundCacheInfoRevision(0),
+  groundCacheDrawMode(-1)
  {
 	lastWindowSizeX = globalRendering->viewSizeX;
 	lastWindowSizeY = globalRendering->viewSizeY;
@@ -120,6 +131,7 @@ CMiniMap::CMiniMap()
 	drawCommands = configHandler->GetInt("MiniMapDrawCommands");
 	drawProjectiles = configHandler->GetBool("MiniMapDrawProjectiles");
 	simpleColors = configHandler->GetBool("SimpleMiniMapColors");
+	renderToTexture = configHandler->GetBool("MiniMapRenderToTexture") && groundCacheFBO.IsValid();
 
 	myColor[0]    = (unsigned char)(0.2f * 255);
 	myColor[1]    = (unsigned char)(0.9f * 255);
@@ -198,6 +210,8 @@ CMiniMap::~CMiniMap()
 {
 	glDeleteLists(circleLists, circleListsCount);
 	glDeleteTextures(1, &buttonsTexture);
+
+	FreeGroundCache();
 }
 
 
@@ -902,6 +916,122 @@ void CMiniMap::Draw()
 }
 
 
+void CMiniMap::FreeGroundCache()
+{
+	if (groundCacheTex == 0)
+		return;
+
+	if (groundCacheFBO.IsValid()) {
+		// FBO::Unbind would bind the default framebuffer, we may be inside a Lua one
+		GLint prevFBO = 0;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &prevFBO);
+
+		groundCacheFBO.Bind();
+		groundCacheFBO.DetachAll();
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, prevFBO);
+	}
+
+	glDeleteTextures(1, &groundCacheTex);
+
+	groundCacheTex = 0;
+	groundCacheSizeX = 0;
+	groundCacheSizeY = 0;
+}
+
+
+bool CMiniMap::UpdateGroundCache()
+{
+	if (!renderToTexture)
+		return false;
+	if (width <= 0 || height <= 0)
+		return false;
+
+	const CBaseGroundDrawer* gd = readmap->GetGroundDrawer();
+
+	const unsigned int mapRevision = readmap->GetMinimapRevision();
+	const int drawMode = gd->DrawExtraTex()? int(gd->drawMode): int(CBaseGroundDrawer::drawNormal);
+	// the info-texture only shows up in the cache while an extra-tex mode is active
+	const unsigned int infoRevision = gd->DrawExtraTex()? gd->infoTexRevision: 0;
+
+	bool redraw =
+		(mapRevision != groundCacheMapRevision) ||
+		(infoRevision != groundCacheInfoRevision) ||
+		(drawMode != groundCacheDrawMode);
+
+	// gl.DrawMiniMap may be called with a Lua FBO bound (gl.RenderToTexture,
+	// gl.ActiveFBO), it has to be bound again after the cache is updated
+	GLint prevFBO = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &prevFBO);
+
+	if (groundCacheTex == 0 || groundCacheSizeX != width || groundCacheSizeY != height) {
+		FreeGroundCache();
+
+		glGenTextures(1, &groundCacheTex);
+		glBindTexture(GL_TEXTURE_2D, groundCacheTex);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		groundCacheFBO.Bind();
+		groundCacheFBO.AttachTexture(groundCacheTex);
+		const bool status = groundCacheFBO.CheckStatus("MINIMAP");
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, prevFBO);
+
+		if (!status) {
+			// fall back to drawing the map layers directly every frame
+			FreeGroundCache();
+			renderToTexture = false;
+			return false;
+		}
+
+		groundCacheFBO.reloadOnAltTab = true;
+		groundCacheSizeX = width;
+		groundCacheSizeY = height;
+
+		redraw = true;
+	}
+
+	if (!redraw)
+		return true;
+
+	groundCacheMapRevision = mapRevision;
+	groundCacheInfoRevision = infoRevision;
+	groundCacheDrawMode = drawMode;
+
+	groundCacheFBO.Bind();
+	glPushAttrib(GL_VIEWPORT_BIT | GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
+	glViewport(0, 0, groundCacheSizeX, groundCacheSizeY);
+	glDisable(GL_BLEND);
+
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0.0f, 1.0f, 0.0f, 1.0f, -1.0f, 1.0f);
+	glMatrixMode(GL_TEXTURE);
+	glPushMatrix();
+	glLoadIdentity();
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	readmap->DrawMinimap();
+
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_TEXTURE);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+
+	glPopAttrib();
+	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, prevFBO);
+	return true;
+}
+
+
 void CMiniMap::DrawForReal(bool use_geo)
 {
 	SCOPED_TIMER("MiniMap::DrawForReal");
@@ -979,7 +1109,21 @@ void CMiniMap::DrawForReal(bool use_geo)
 
 	// draw the map
 	glDisable(GL_BLEND);
+	if (UpdateGroundCache()) {
+		glDisable(GL_ALPHA_TEST);
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, groundCacheTex);
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+		glBegin(GL_QUADS);
+			glTexCoord2f(0.0f, 0.0f); glVertex2f(0.0f, 0.0f);
+			glTexCoord2f(1.0f, 0.0f); glVertex2f(1.0f, 0.0f);
+			glTexCoord2f(1.0f, 1.0f); glVertex2f(1.0f, 1.0f);
+			glTexCoord2f(0.0f, 1.0f); glVertex2f(0.0f, 1.0f);
+		glEnd();
+		glDisable(GL_TEXTURE_2D);
+	} else {
 		readmap->DrawMinimap();
+	}
 	glEnable(GL_BLEND);
 
 	glMatrixMode(GL_TEXTURE);
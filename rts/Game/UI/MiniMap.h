@@ -7,6 +7,7 @@
 #include <string>
 #include <list>
 #include "InputReceiver.h"
+#include "Rendering/GL/FBO.h"
 #include "System/float3.h"
 
 class CUnit;
@@ -77,6 +78,8 @@ class CMiniMap : public CInputReceiver {
 		void DrawNotes();
 		void DrawButtons();
 		void DrawMinimizedButton();
+		bool UpdateGroundCache();
+		void FreeGroundCache();
 		#if 0
 		void DrawUnit(const CUnit* unit);
 		#endif
@@ -146,6 +149,21 @@ class CMiniMap : public CInputReceiver {
 		unsigned char enemyColor[4];
 
 		unsigned int buttonsTexture;
+
+		/**
+		 * the map layers (shading, minimap, info-texture) are rendered into
+		 * <groundCacheTex> at minimap resolution and only redrawn when one of
+		 * the revision keys or the minimap size changes
+		 */
+		bool renderToTexture;
+		FBO groundCacheFBO;
+		unsigned int groundCacheTex;
+		int groundCacheSizeX;
+		int groundCacheSizeY;
+		unsigned int groundCacheMapRevision;
+		unsigned int groundCacheInfoRevision;
+		int groundCacheDrawMode;
+
 		unsigned int circleLists; // 8 - 256 divs
 		static const int circleListsCount = 6;
 
@@ -21,6 +21,9 @@ void ProfileDrawer::SetEnabled(bool enable)
 		std::map<std::string, CTimeProfiler::TimeRecord>::iterator pi;
 		for (pi = profiler.profile.begin(); pi != profiler.profile.end(); ++pi)
 			(*pi).second.peak = 0.0f;
+		std::map<std::string, CTimeProfiler::CounterRecord>::iterator ci;
+		for (ci = profiler.counters.begin(); ci != profiler.counters.end(); ++ci)
+			(*ci).second.peak = 0;
 	} else {
 		ProfileDrawer* tmpInstance = instance;
 		instance = NULL;
@@ -110,6 +113,35 @@ void ProfileDrawer::Draw()
 	}
 	glPopMatrix();
 
+	// draw the counters (value summed over the last 500ms and its peak) below the timers
+	if (!profiler.counters.empty()) {
+		const float cnt_end_y = end_y - profiler.profile.size() * 0.024f - 0.02f;
+
+		glColor4f(0.0f, 0.0f, 0.5f, 0.5f);
+		glBegin(GL_TRIANGLE_STRIP);
+		glVertex3f(start_x, cnt_end_y,                                       0);
+		glVertex3f(end_x,   cnt_end_y,                                       0);
+		glVertex3f(start_x, cnt_end_y-profiler.counters.size()*0.024f-0.01f, 0);
+		glVertex3f(end_x,   cnt_end_y-profiler.counters.size()*0.024f-0.01f, 0);
+		glEnd();
+
+		std::map<std::string, CTimeProfiler::CounterRecord>::const_iterator ci;
+
+		int y = 0;
+		font->Begin();
+		for (ci = profiler.counters.begin(); ci != profiler.counters.end(); ++ci, ++y) {
+			const float fStartY = cnt_end_y - (end_y - start_y) - y * 0.024f;
+			float fStartX = start_x + 0.005f + 0.015f + 0.005f + 0.09f + 0.04f;
+
+			font->glFormat(fStartX, fStartY, 0.7f, FONT_BASELINE | FONT_SCALE | FONT_NORM | FONT_RIGHT, "%d", ci->second.last);
+			fStartX += 0.04f;
+			font->glFormat(fStartX, fStartY, 0.7f, FONT_BASELINE | FONT_SCALE | FONT_NORM | FONT_RIGHT, "%d", ci->second.peak);
+			fStartX += 0.01f;
+			font->glFormat(fStartX, fStartY, 0.7f, FONT_BASELINE | FONT_SCALE | FONT_NORM, "%s", ci->first.c_str());
+		}
+		font->End();
+	}
+
 	// draw the graph
 	for (pi = profiler.profile.begin(); pi != profiler.profile.end(); ++pi) {
 		if (!pi->second.showGraph) {
@@ -29,6 +29,7 @@
 #include "ExternalAI/IAILibraryManager.h"
 #include "ExternalAI/SkirmishAIHandler.h"
 #include "Map/BaseGroundDrawer.h"
+#include "Map/Ground.h"
 #include "Map/MetalMap.h"
 #include "Map/ReadMap.h"
 #include "Map/SMF/SMFGroundDrawer.h"
@@ -52,6 +53,8 @@
 #include "Rendering/VerticalSync.h"
 #include "Lua/LuaOpenGL.h"
 #include "Lua/LuaUI.h"
+#include "Lua/LuaUtils.h"
+#include "lib/lua/include/LuaInclude.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Units/Scripts/UnitScript.h"
 #include "Sim/Units/Groups/GroupHandler.h"
@@ -439,7 +442,7 @@ public:
 class RoamActionExecutor : public IUnsyncedActionExecutor {
 public:
 	RoamActionExecutor() : IUnsyncedActionExecutor("roam",
-			"Disables/Enables ROAM mesh rendering: 0=off, 1=on") {}
+			"Disables/Enables ROAM mesh rendering: 0=off, 1=on, 2=chunked geomipmapping") {}
 
 	bool Execute(const UnsyncedAction& action) const {
 		CSMFGroundDrawer* smfGD = dynamic_cast<CSMFGroundDrawer*>(readmap->GetGroundDrawer());
@@ -452,7 +455,7 @@ public:
 			sscanf((action.GetArgs()).c_str(), "%i %i", &useRoam, &roamMode);
 
 			smfGD->SwitchMeshDrawer(useRoam);
-			if (useRoam && roamMode >= 0) {
+			if (useRoam == SMF_MESHDRAWER_ROAM && roamMode >= 0) {
 				Patch::SwitchRenderMode(roamMode);
 			}
 		} else {
@@ -530,6 +533,21 @@ public:
 
 
 
+class InstancedUnitRenderingActionExecutor : public IUnsyncedActionExecutor {
+public:
+	InstancedUnitRenderingActionExecutor() : IUnsyncedActionExecutor("InstancedUnitRendering",
+			"Enable/Disable drawing opaque S3O units in instanced batches") {}
+
+	bool Execute(const UnsyncedAction& action) const {
+		SetBoolArg(unitDrawer->useInstancing, action.GetArgs());
+		configHandler->Set("InstancedUnitRendering", unitDrawer->useInstancing);
+		LogSystemStatus("Instanced unit rendering", unitDrawer->useInstancing);
+		return true;
+	}
+};
+
+
+
 class AdvMapShadingActionExecutor : public IUnsyncedActionExecutor {
 public:
 	AdvMapShadingActionExecutor() : IUnsyncedActionExecutor("AdvMapShading",
@@ -2942,6 +2960,170 @@ public:
 
 
 
+class GroundColBenchmarkActionExecutor : public IUnsyncedActionExecutor {
+public:
+	GroundColBenchmarkActionExecutor() : IUnsyncedActionExecutor("GroundColBenchmark",
+			"Measures synced ray- and trajectory-vs-ground tests per second for"
+			" typical weapon ranges, with and without the max-height mipmaps") {}
+
+	bool Execute(const UnsyncedAction& action) const {
+		const int numRays = action.GetArgs().empty()? 100000: std::max(1, atoi(action.GetArgs().c_str()));
+		const float ranges[] = {250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f};
+
+		std::vector<float3> starts(numRays);
+		std::vector<float3> dirs(numRays);
+		std::vector<float> results[2];
+
+		for (unsigned int r = 0; r < (sizeof(ranges) / sizeof(ranges[0])); r++) {
+			const float range = ranges[r];
+
+			// rays from muzzle height towards a target on the ground, as
+			// fired by (or tested for) ground units; the unsynced RNG is
+			// used so running this can not desync
+			for (int n = 0; n < numRays; n++) {
+				const float3 start(gu->RandFloat() * float3::maxxpos, 0.0f, gu->RandFloat() * float3::maxzpos);
+				const float angle = gu->RandFloat() * 2.0f * PI;
+
+				float3 end = start + float3(math::cos(angle), 0.0f, math::sin(angle)) * range;
+				end.ClampInMap();
+
+				starts[n] = start + UpVector * (ground->GetHeightReal(start.x, start.z) + 20.0f);
+				dirs[n] = (end + UpVector * (ground->GetHeightReal(end.x, end.z) + 10.0f)) - starts[n];
+			}
+
+			float raysPerSec[2] = {0.0f, 0.0f};
+			float trajPerSec[2] = {0.0f, 0.0f};
+
+			for (int m = 0; m < 2; m++) {
+				results[m].clear();
+				results[m].reserve(numRays * 2);
+
+				spring_time t0 = spring_gettime();
+
+				for (int n = 0; n < numRays; n++) {
+					results[m].push_back(ground->LineGroundColBenchmark(starts[n], starts[n] + dirs[n], (m == 1)));
+				}
+
+				spring_time t1 = spring_gettime();
+
+				for (int n = 0; n < numRays; n++) {
+					const float3 flatDir = float3(dirs[n].x, 0.0f, dirs[n].z).SafeNormalize();
+					const float flatLength = dirs[n].Length2D();
+
+					// lobbed shot reaching its apex halfway (linear and
+					// quadratic terms as used by ballistic weapons)
+					const float linear = 0.5f + (n & 3) * 0.25f;
+					const float quadratic = -linear / std::max(1.0f, flatLength);
+
+					results[m].push_back(ground->TrajectoryGroundColBenchmark(starts[n], flatDir, flatLength, linear, quadratic, (m == 1)));
+				}
+
+				spring_time t2 = spring_gettime();
+
+				raysPerSec[m] = numRays / std::max(0.001f, (t1 - t0).toSecsf());
+				trajPerSec[m] = numRays / std::max(0.001f, (t2 - t1).toSecsf());
+			}
+
+			int mismatches = 0;
+
+			for (size_t n = 0; n < results[0].size(); n++) {
+				mismatches += (results[0][n] != results[1][n]);
+			}
+
+			LOG("[GroundColBenchmark] range %4.0f: LineGroundCol %.0f rays/s (squares) %.0f rays/s (mips), TrajectoryGroundCol %.0f/s (squares) %.0f/s (mips), %d mismatches",
+				range, raysPerSec[0], raysPerSec[1], trajPerSec[0], trajPerSec[1], mismatches);
+		}
+
+		return true;
+	}
+};
+
+
+
+class LuaPackBenchmarkActionExecutor : public IUnsyncedActionExecutor {
+public:
+	LuaPackBenchmarkActionExecutor() : IUnsyncedActionExecutor("LuaPackBenchmark",
+			"Measures synced-to-unsynced messages per second and their size"
+			" when copied between Lua states as DataDump trees and as packed"
+			" buffers") {}
+
+	bool Execute(const UnsyncedAction& action) const {
+		const int numIters = action.GetArgs().empty()? 1000: std::max(1, atoi(action.GetArgs().c_str()));
+
+		lua_State* src = LUA_OPEN();
+		lua_State* dst = LUA_OPEN();
+
+		// a typical gadget message: a table of per-unit records
+		// with many repeated keys and a few repeated strings
+		const char* msgSrc =
+			"local units = {}\n"
+			"for i = 1, 200 do\n"
+			"  units[i] = {id = i, name = 'unit' .. (i % 8), pos = {i * 8, 100, i * 16}, health = 0.5, stunned = false}\n"
+			"end\n"
+			"return 'unitStates', units\n";
+
+		if (luaL_dostring(src, msgSrc) != 0) {
+			LOG_L(L_ERROR, "[LuaPackBenchmark] %s", lua_tostring(src, -1));
+			LUA_CLOSE(dst);
+			LUA_CLOSE(src);
+			return true;
+		}
+
+		const int numArgs = lua_gettop(src);
+
+		std::vector<LuaUtils::DataDump> dump;
+		LuaUtils::PackedData packed;
+
+		spring_time t0 = spring_gettime();
+
+		for (int n = 0; n < numIters; n++) {
+			dump.clear();
+			LuaUtils::Backup(dump, src, numArgs);
+			LuaUtils::Restore(dump, dst);
+			lua_settop(dst, 0);
+		}
+
+		spring_time t1 = spring_gettime();
+
+		for (int n = 0; n < numIters; n++) {
+			LuaUtils::Pack(packed, src, numArgs);
+			LuaUtils::Unpack(packed, dst);
+			lua_settop(dst, 0);
+		}
+
+		spring_time t2 = spring_gettime();
+
+		size_t dumpBytes = 0;
+		size_t dumpNodes = 0;
+
+		for (size_t n = 0; n < dump.size(); n++) {
+			GetDumpSize(dump[n], &dumpBytes, &dumpNodes);
+		}
+
+		LUA_CLOSE(dst);
+		LUA_CLOSE(src);
+
+		LOG("[LuaPackBenchmark] DataDump: %.0f msgs/s, %u bytes in %u nodes",
+			numIters / std::max(0.001f, (t1 - t0).toSecsf()), unsigned(dumpBytes), unsigned(dumpNodes));
+		LOG("[LuaPackBenchmark] PackedData: %.0f msgs/s, %u bytes in 1 buffer",
+			numIters / std::max(0.001f, (t2 - t1).toSecsf()), unsigned(packed.GetNumBytes()));
+		return true;
+	}
+
+private:
+	static void GetDumpSize(const LuaUtils::DataDump& dd, size_t* numBytes, size_t* numNodes) {
+		*numBytes += (sizeof(dd) + dd.str.size());
+		*numNodes += 1;
+
+		for (size_t n = 0; n < dd.table.size(); n++) {
+			GetDumpSize(dd.table[n].first, numBytes, numNodes);
+			GetDumpSize(dd.table[n].second, numBytes, numNodes);
+		}
+	}
+};
+
+
+
 class GiveActionExecutor : public IUnsyncedActionExecutor {
 public:
 	GiveActionExecutor() : IUnsyncedActionExecutor("Give",
@@ -3302,6 +3484,7 @@ void UnsyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new RoamActionExecutor());
 	AddActionExecutor(new WaterActionExecutor());
 	AddActionExecutor(new AdvModelShadingActionExecutor());
+	AddActionExecutor(new InstancedUnitRenderingActionExecutor());
 	AddActionExecutor(new AdvMapShadingActionExecutor());
 	AddActionExecutor(new SayActionExecutor());
 	AddActionExecutor(new SayPrivateActionExecutor());
@@ -3443,6 +3626,8 @@ void UnsyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new CrashActionExecutor());
 	AddActionExecutor(new ExceptionActionExecutor());
 	AddActionExecutor(new DivByZeroActionExecutor());
+	AddActionExecutor(new GroundColBenchmarkActionExecutor());
+	AddActionExecutor(new LuaPackBenchmarkActionExecutor());
 	AddActionExecutor(new GiveActionExecutor());
 	AddActionExecutor(new DestroyActionExecutor());
 	AddActionExecutor(new SendActionExecutor());
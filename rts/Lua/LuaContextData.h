@@ -9,7 +9,7 @@
 #include "LuaTextures.h"
 #include "LuaFBOs.h"
 #include "LuaRBOs.h"
-//FIXME#include "LuaVBOs.h"
+#include "LuaVBOs.h"
 #include "LuaDisplayLists.h"
 #include "System/EventClient.h"
 #include "System/Log/ILog.h"
@@ -29,7 +29,7 @@ struct luaContextData {
 	//FIXME		LuaArrays arrays;
 	LuaShaders shaders;
 	LuaTextures textures;
-	//FIXME		LuaVBOs vbos;
+	LuaVBOs vbos;
 	LuaFBOs fbos;
 	LuaRBOs rbos;
 	CLuaDisplayLists displayLists;
@@ -82,6 +82,8 @@ inline void CheckDrawingEnabled(lua_State* L, const char* caller)
 		luaL_error(L, "%s(): OpenGL calls can only be used in Draw() "
 		              "call-ins, or while creating display lists", caller);
 	}
+
+	LuaOpenGL::FlushBatch();
 }
 
 
@@ -125,6 +127,8 @@ void LuaFBOs::FBO::Free(lua_State* L)
 
 int LuaFBOs::meta_gc(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	FBO* fbo = static_cast<FBO*>(luaL_checkudata(L, 1, "FBO"));
 	fbo->Free(L);
 	return 0;
@@ -149,6 +153,8 @@ int LuaFBOs::meta_index(lua_State* L)
 
 int LuaFBOs::meta_newindex(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	FBO* fbo = static_cast<FBO*>(luaL_checkudata(L, 1, "FBO"));
 	if (fbo->luaRef == LUA_NOREF) {
 		return 0;
@@ -367,6 +373,8 @@ bool LuaFBOs::ApplyDrawBuffers(lua_State* L, int index)
 
 int LuaFBOs::CreateFBO(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	FBO fbo;
 	fbo.Init(L);
 
@@ -435,6 +443,8 @@ int LuaFBOs::CreateFBO(lua_State* L)
 
 int LuaFBOs::DeleteFBO(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	if (lua_isnil(L, 1)) {
 		return 0;
 	}
@@ -520,6 +530,7 @@ int LuaFBOs::ActiveFBO(lua_State* L)
 	glBindFramebufferEXT(target, fbo->id);
 
 	const int error = lua_pcall(L, (args - funcIndex), 0, 0);
+	LuaOpenGL::FlushBatch();
 
 	glBindFramebufferEXT(target, currentFBO);
 	if (identities) {
@@ -540,6 +551,8 @@ int LuaFBOs::ActiveFBO(lua_State* L)
 
 int LuaFBOs::UnsafeSetFBO(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	//CheckDrawingEnabled(L, __FUNCTION__);
 
 	if (lua_isnil(L, 1)) {
@@ -562,6 +575,8 @@ int LuaFBOs::UnsafeSetFBO(lua_State* L)
 
 int LuaFBOs::BlitFBO(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	if (lua_israwnumber(L, 1)) {
 		const GLint x0Src = (GLint)luaL_checknumber(L, 1);
 		const GLint y0Src = (GLint)luaL_checknumber(L, 2);
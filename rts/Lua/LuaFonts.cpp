@@ -88,6 +88,8 @@ inline void CheckDrawingEnabled(lua_State* L, const char* caller)
 		luaL_error(L, "%s(): OpenGL calls can only be used in Draw() "
 		              "call-ins, or while creating display lists", caller);
 	}
+
+	LuaOpenGL::FlushBatch();
 }
 
 
@@ -121,6 +123,8 @@ static int ParseFloatArray(lua_State* L, int idx, float* array, int size)
 
 int LuaFonts::meta_gc(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	CglFont** font = (CglFont**)luaL_checkudata(L, 1, "Font");
 	delete *font;
 	*font = NULL;
@@ -192,6 +196,8 @@ int LuaFonts::meta_index(lua_State* L)
 
 int LuaFonts::LoadFont(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	const string fileName   = luaL_checkstring(L, 1);
 	const int size          = luaL_optint(L, 2, 14);
 	const int outlineWidth  = luaL_optint(L, 3, 2);
@@ -213,6 +219,8 @@ int LuaFonts::LoadFont(lua_State* L)
 
 int LuaFonts::DeleteFont(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	return meta_gc(L);
 }
 
@@ -46,6 +46,16 @@
 
 #include <string>
 
+CONFIG(int, LuaStateMemoryLimit)
+	.defaultValue(256)
+	.minimumValue(16)
+	.description("Maximum memory (in MB) each Lua state (per LuaUI, LuaRules, LuaGaia, ...) may allocate.")
+;
+CONFIG(bool, LuaPooledAllocator)
+	.defaultValue(true)
+	.description("Serve small Lua allocations from per-state size-class pools instead of the system allocator.")
+;
+
 
 bool CLuaHandle::devMode = false;
 bool CLuaHandle::modUICtrl = true;
@@ -76,10 +86,13 @@ CLuaHandle::CLuaHandle(const string& _name, int _order, bool _userMode)
 	UpdateThreading();
 
 	SetSynced(false, true);
+	const size_t maxAllocedBytes = size_t(configHandler->GetInt("LuaStateMemoryLimit")) * 1024 * 1024;
+	const bool usePooledAlloc = configHandler->GetBool("LuaPooledAllocator");
+
 	D_Sim.owner = this;
-	L_Sim = LUA_OPEN(&D_Sim, GetUserMode(), true);
+	L_Sim = LUA_OPEN(&D_Sim, GetUserMode(), true, spring_lua_alloc_create((_name + "::Sim").c_str(), maxAllocedBytes, usePooledAlloc));
 	D_Draw.owner = this;
-	L_Draw = LUA_OPEN(&D_Draw, GetUserMode(), false);
+	L_Draw = LUA_OPEN(&D_Draw, GetUserMode(), false, spring_lua_alloc_create((_name + "::Draw").c_str(), maxAllocedBytes, usePooledAlloc));
 
 	// needed for engine traceback
 	PushTracebackFuncToRegistry(L_Sim);
@@ -94,14 +107,6 @@ CLuaHandle::~CLuaHandle()
 	// free the lua state
 	KillLua();
 
-	for(int i = 0; i < delayedCallsFromSynced.size(); ++i) {
-		DelayDataDump& ddp = delayedCallsFromSynced[i];
-		for(int d = 0; d < ddp.data.size(); ++d) {
-			LuaUtils::ShallowDataDump& sdd = ddp.data[d];
-			if(sdd.type == LUA_TSTRING)
-				delete sdd.data.str;
-		}
-	}
 	delayedCallsFromSynced.clear();
 }
 
@@ -277,11 +282,11 @@ void CLuaHandle::DelayRecvFromSynced(lua_State* srcState, int args) {
 		lua_rawget(srcState, LUA_GLOBALSINDEX);
 
 		if (lua_istable(srcState, -1))
-			LuaUtils::Backup(ddmp.dump, srcState, 1);
+			LuaUtils::Pack(ddmp.dump, srcState, 1);
 		lua_pop(srcState, 1);
 	}
 
-	LuaUtils::ShallowBackup(ddmp.data, srcState, args);
+	LuaUtils::Pack(ddmp.data, srcState, args);
 
 	GML_STDMUTEX_LOCK(scall);
 
@@ -351,7 +356,7 @@ bool CLuaHandle::ExecuteCallsFromSynced(bool forced) {
 
 #if (LUA_MT_OPT & LUA_STATE)
 		if (!ddp.xcall) {
-			if (CopyExportTable() && ddp.dump.size() > 0) {
+			if (CopyExportTable() && !ddp.dump.empty()) {
 				HSTR_PUSH(L, "UNSYNCED");
 				lua_rawget(L, LUA_REGISTRYINDEX);
 
@@ -362,7 +367,7 @@ bool CLuaHandle::ExecuteCallsFromSynced(bool forced) {
 					lua_rawget(L, -2);
 					if (lua_istable(L, -1)) {
 						HSTR_PUSH(L, "EXPORT");
-						LuaUtils::Restore(ddp.dump, L);
+						LuaUtils::Unpack(ddp.dump, L);
 						lua_rawset(L, -3);
 					}
 					lua_pop(L, 2);
@@ -372,7 +377,7 @@ bool CLuaHandle::ExecuteCallsFromSynced(bool forced) {
 
 			int ddsize = ddp.data.size();
 			if (ddsize > 0) {
-				LuaUtils::ShallowRestore(ddp.data, L);
+				LuaUtils::Unpack(ddp.data, L);
 				lua_checkstack(L, 2);
 				RecvFromSynced(L, ddsize);
 			}
@@ -380,23 +385,17 @@ bool CLuaHandle::ExecuteCallsFromSynced(bool forced) {
 		else
 #endif // (LUA_MT_OPT & LUA_STATE)
 		{
-			if (ddp.data.size() == 1) {
-				LuaUtils::ShallowDataDump sdd = ddp.data[0];
-				if (sdd.type == LUA_TSTRING) {
-					const LuaHashString funcHash(*sdd.data.str);
-					delete sdd.data.str;
-					if (funcHash.GetGlobalFunc(L)) {
-						const int top = lua_gettop(L) - 1;
+			const LuaHashString funcHash(ddp.funcName);
+			if (funcHash.GetGlobalFunc(L)) {
+				const int top = lua_gettop(L) - 1;
 
-						LuaUtils::Restore(ddp.dump, L);
+				LuaUtils::Unpack(ddp.dump, L);
 
-						lua_State* L_Prev = ForceUnsyncedState();
-						RunCallIn(funcHash, ddp.dump.size(), LUA_MULTRET);
-						RestoreState(L_Prev);
+				lua_State* L_Prev = ForceUnsyncedState();
+				RunCallIn(funcHash, ddp.dump.size(), LUA_MULTRET);
+				RestoreState(L_Prev);
 
-						lua_settop(L, top);
-					}
-				}
+				lua_settop(L, top);
 			}
 		}
 	}
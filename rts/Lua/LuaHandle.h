@@ -39,6 +39,7 @@ struct LuaHashString;
 struct lua_State;
 class LuaRBOs;
 class LuaFBOs;
+class LuaVBOs;
 class LuaTextures;
 class LuaShaders;
 class CLuaDisplayLists;
@@ -107,7 +108,7 @@ class CLuaHandle : public CEventClient
 //FIXME		LuaArrays& GetArrays(const lua_State* L = NULL) { return GET_CONTEXT_DATA(arrays); }
 		LuaShaders& GetShaders(const lua_State* L = NULL) { return GET_CONTEXT_DATA(shaders); }
 		LuaTextures& GetTextures(const lua_State* L = NULL) { return GET_CONTEXT_DATA(textures); }
-//FIXME		LuaVBOs& GetVBOs(const lua_State* L = NULL) { return GET_CONTEXT_DATA(vbos); }
+		LuaVBOs& GetVBOs(const lua_State* L = NULL) { return GET_CONTEXT_DATA(vbos); }
 		LuaFBOs& GetFBOs(const lua_State* L = NULL) { return GET_CONTEXT_DATA(fbos); }
 		LuaRBOs& GetRBOs(const lua_State* L = NULL) { return GET_CONTEXT_DATA(rbos); }
 		CLuaDisplayLists& GetDisplayLists(const lua_State* L = NULL) { return GET_CONTEXT_DATA(displayLists); }
@@ -266,8 +267,9 @@ class CLuaHandle : public CEventClient
 		}
 
 		struct DelayDataDump {
-			std::vector<LuaUtils::ShallowDataDump> data;
-			std::vector<LuaUtils::DataDump> dump;
+			LuaUtils::PackedData data; ///< SendToUnsynced arguments
+			LuaUtils::PackedData dump; ///< EXPORT table, or the xcall arguments
+			std::string funcName;      ///< xcall target
 			bool xcall;
 		};
 
@@ -372,7 +374,7 @@ class CLuaHandle : public CEventClient
 //FIXME		static LuaArrays& GetActiveArrays(lua_State* L)   { return GET_HANDLE_CONTEXT_DATA(arrays); }
 		static inline LuaShaders& GetActiveShaders(lua_State* L)  { return GET_HANDLE_CONTEXT_DATA(shaders); }
 		static inline LuaTextures& GetActiveTextures(lua_State* L) { return GET_HANDLE_CONTEXT_DATA(textures); }
-//FIXME		static LuaVBOs& GetActiveVBOs(lua_State* L)     { return GET_HANDLE_CONTEXT_DATA(vbos); }
+		static inline LuaVBOs& GetActiveVBOs(lua_State* L) { return GET_HANDLE_CONTEXT_DATA(vbos); }
 		static inline LuaFBOs& GetActiveFBOs(lua_State* L) { return GET_HANDLE_CONTEXT_DATA(fbos); }
 		static inline LuaRBOs& GetActiveRBOs(lua_State* L)     { return GET_HANDLE_CONTEXT_DATA(rbos); }
 		static inline CLuaDisplayLists& GetActiveDisplayLists(lua_State* L) { return GET_HANDLE_CONTEXT_DATA(displayLists); }
@@ -24,10 +24,11 @@
 #include "LuaHashString.h"
 #include "LuaShaders.h"
 #include "LuaTextures.h"
-//FIXME#include "LuaVBOs.h"
+#include "LuaVBOs.h"
 #include "LuaFBOs.h"
 #include "LuaRBOs.h"
 #include "LuaFonts.h"
+#include "LuaOpenGLBatch.h"
 #include "LuaOpenGLUtils.h"
 #include "LuaDisplayLists.h"
 #include "Game/Camera.h"
@@ -80,6 +81,8 @@ CONFIG(bool, LuaShaders).defaultValue(true).safemodeValue(false);
 
 static const int MAX_TEXTURE_UNITS = 32;
 
+static LuaOpenGLBatch immediateBatch;
+
 /******************************************************************************/
 /******************************************************************************/
 
@@ -201,6 +204,7 @@ bool LuaOpenGL::PushEntries(lua_State* L)
 	}
 
 	REGISTER_LUA_CFUNC(Texture);
+	REGISTER_LUA_CFUNC(PrefetchTexture);
 	REGISTER_LUA_CFUNC(CreateTexture);
 	REGISTER_LUA_CFUNC(DeleteTexture);
 	REGISTER_LUA_CFUNC(TextureInfo);
@@ -308,7 +312,7 @@ bool LuaOpenGL::PushEntries(lua_State* L)
 
 	LuaFonts::PushEntries(L);
 
-//FIXME		LuaVBOs::PushEntries(L);
+	LuaVBOs::PushEntries(L);
 
 	return true;
 }
@@ -440,6 +444,7 @@ void LuaOpenGL::EnableCommon(DrawMode mode)
 void LuaOpenGL::DisableCommon(DrawMode mode)
 {
 	assert(drawMode == mode);
+	FlushBatch();
 	// FIXME  --  not needed by shadow or minimap
 	glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, GL_SINGLE_COLOR);
 	drawMode = DRAW_NONE;
@@ -971,7 +976,7 @@ void LuaOpenGL::ResetMiniMapMatrices()
 /******************************************************************************/
 
 
-inline void LuaOpenGL::CheckDrawingEnabled(lua_State* L, const char* caller)
+inline void LuaOpenGL::CheckBatchDrawingEnabled(lua_State* L, const char* caller)
 {
 	if (!IsDrawingEnabled(L)) {
 		luaL_error(L, "%s(): OpenGL calls can only be used in Draw() "
@@ -980,6 +985,21 @@ inline void LuaOpenGL::CheckDrawingEnabled(lua_State* L, const char* caller)
 }
 
 
+inline void LuaOpenGL::CheckDrawingEnabled(lua_State* L, const char* caller)
+{
+	CheckBatchDrawingEnabled(L, caller);
+
+	// every non-batched call is a state boundary
+	immediateBatch.Interrupt();
+}
+
+
+void LuaOpenGL::FlushBatch()
+{
+	immediateBatch.Interrupt();
+}
+
+
 static int ParseFloatArray(lua_State* L, float* array, int size)
 {
 	if (!lua_istable(L, -1)) {
@@ -1012,6 +1032,8 @@ int LuaOpenGL::HasExtension(lua_State* L)
 
 int LuaOpenGL::GetNumber(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	const GLenum pname = (GLenum) luaL_checknumber(L, 1);
 	const GLuint count = (GLuint) luaL_optnumber(L, 2, 1);
 	if (count > 64) {
@@ -1456,6 +1478,8 @@ int LuaOpenGL::UnitMultMatrix(lua_State* L)
 
 int LuaOpenGL::UnitPiece(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	CUnit* unit = ParseUnit(L, __FUNCTION__, 1);
 	if (unit == NULL) {
 		return 0;
@@ -1721,6 +1745,7 @@ int LuaOpenGL::DrawFuncAtUnit(lua_State* L)
 	glPushMatrix();
 	glTranslatef(pos.x, pos.y, pos.z);
 	const int error = lua_pcall(L, (args - 3), 0, 0);
+	immediateBatch.Interrupt();
 	glPopMatrix();
 
 	if (error != 0) {
@@ -1979,7 +2004,7 @@ int LuaOpenGL::Shape(lua_State* L)
 
 int LuaOpenGL::BeginEnd(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 	if ((args < 2) || !lua_isnumber(L, 1) || !lua_isfunction(L, 2)) {
@@ -1991,10 +2016,20 @@ int LuaOpenGL::BeginEnd(lua_State* L)
 		WorkaroundATIPointSizeBug();
 	}
 
+	int error = 0;
+
 	// call the function
-	glBegin(primMode);
-	const int error = lua_pcall(L, (args - 2), 0, 0);
-	glEnd();
+	if (!immediateBatch.InBeginEnd()) {
+		immediateBatch.Begin(primMode);
+		error = lua_pcall(L, (args - 2), 0, 0);
+		immediateBatch.End();
+	} else {
+		// nested blocks are invalid GL, issue them like before
+		immediateBatch.Interrupt();
+		glBegin(primMode);
+		error = lua_pcall(L, (args - 2), 0, 0);
+		glEnd();
+	}
 
 	if (error != 0) {
 		LOG_L(L_ERROR, "gl.BeginEnd: error(%i) = %s",
@@ -2009,7 +2044,7 @@ int LuaOpenGL::BeginEnd(lua_State* L)
 
 int LuaOpenGL::Vertex(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 
@@ -2029,16 +2064,17 @@ int LuaOpenGL::Vertex(lua_State* L)
 		const float y = lua_tofloat(L, -1);
 		lua_rawgeti(L, 1, 3);
 		if (!lua_isnumber(L, -1)) {
-			glVertex2f(x, y);
+			immediateBatch.Vertex(x, y, 0.0f);
 			return 0;
 		}
 		const float z = lua_tofloat(L, -1);
 		lua_rawgeti(L, 1, 4);
 		if (!lua_isnumber(L, -1)) {
-			glVertex3f(x, y, z);
+			immediateBatch.Vertex(x, y, z);
 			return 0;
 		}
 		const float w = lua_tofloat(L, -1);
+		immediateBatch.Interrupt();
 		glVertex4f(x, y, z, w);
 		return 0;
 	}
@@ -2050,7 +2086,7 @@ int LuaOpenGL::Vertex(lua_State* L)
 		const float x = lua_tofloat(L, 1);
 		const float y = lua_tofloat(L, 2);
 		const float z = lua_tofloat(L, 3);
-		glVertex3f(x, y, z);
+		immediateBatch.Vertex(x, y, z);
 	}
 	else if (args == 2) {
 		if (!lua_isnumber(L, 1) || !lua_isnumber(L, 2)) {
@@ -2058,7 +2094,7 @@ int LuaOpenGL::Vertex(lua_State* L)
 		}
 		const float x = lua_tofloat(L, 1);
 		const float y = lua_tofloat(L, 2);
-		glVertex2f(x, y);
+		immediateBatch.Vertex(x, y, 0.0f);
 	}
 	else if (args == 4) {
 		if (!lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
@@ -2069,6 +2105,7 @@ int LuaOpenGL::Vertex(lua_State* L)
 		const float y = lua_tofloat(L, 2);
 		const float z = lua_tofloat(L, 3);
 		const float w = lua_tofloat(L, 4);
+		immediateBatch.Interrupt();
 		glVertex4f(x, y, z, w);
 	}
 	else {
@@ -2081,7 +2118,7 @@ int LuaOpenGL::Vertex(lua_State* L)
 
 int LuaOpenGL::Normal(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 
@@ -2104,7 +2141,8 @@ int LuaOpenGL::Normal(lua_State* L)
 			luaL_error(L, "Bad data passed to gl.Normal()");
 		}
 		const float z = lua_tofloat(L, -1);
-		glNormal3f(x, y, z);
+		const float normal[3] = {x, y, z};
+		immediateBatch.Normal(normal);
 		return 0;
 	}
 
@@ -2114,21 +2152,22 @@ int LuaOpenGL::Normal(lua_State* L)
 	const float x = lua_tofloat(L, 1);
 	const float y = lua_tofloat(L, 2);
 	const float z = lua_tofloat(L, 3);
-	glNormal3f(x, y, z);
+	const float normal[3] = {x, y, z};
+	immediateBatch.Normal(normal);
 	return 0;
 }
 
 
 int LuaOpenGL::TexCoord(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 
 	if (args == 1) {
 		if (lua_isnumber(L, 1)) {
 			const float x = lua_tofloat(L, 1);
-			glTexCoord1f(x);
+			immediateBatch.TexCoord(x, 0.0f);
 			return 0;
 		}
 		if (!lua_istable(L, 1)) {
@@ -2141,22 +2180,24 @@ int LuaOpenGL::TexCoord(lua_State* L)
 		const float x = lua_tofloat(L, -1);
 		lua_rawgeti(L, 1, 2);
 		if (!lua_isnumber(L, -1)) {
-			glTexCoord1f(x);
+			immediateBatch.TexCoord(x, 0.0f);
 			return 0;
 		}
 		const float y = lua_tofloat(L, -1);
 		lua_rawgeti(L, 1, 3);
 		if (!lua_isnumber(L, -1)) {
-			glTexCoord2f(x, y);
+			immediateBatch.TexCoord(x, y);
 			return 0;
 		}
 		const float z = lua_tofloat(L, -1);
 		lua_rawgeti(L, 1, 4);
 		if (!lua_isnumber(L, -1)) {
+			immediateBatch.Interrupt();
 			glTexCoord3f(x, y, z);
 			return 0;
 		}
 		const float w = lua_tofloat(L, -1);
+		immediateBatch.Interrupt();
 		glTexCoord4f(x, y, z, w);
 		return 0;
 	}
@@ -2167,7 +2208,7 @@ int LuaOpenGL::TexCoord(lua_State* L)
 		}
 		const float x = lua_tofloat(L, 1);
 		const float y = lua_tofloat(L, 2);
-		glTexCoord2f(x, y);
+		immediateBatch.TexCoord(x, y);
 	}
 	else if (args == 3) {
 		if (!lua_isnumber(L, 1) || !lua_isnumber(L, 2) || !lua_isnumber(L, 3)) {
@@ -2176,6 +2217,7 @@ int LuaOpenGL::TexCoord(lua_State* L)
 		const float x = lua_tofloat(L, 1);
 		const float y = lua_tofloat(L, 2);
 		const float z = lua_tofloat(L, 3);
+		immediateBatch.Interrupt();
 		glTexCoord3f(x, y, z);
 	}
 	else if (args == 4) {
@@ -2187,6 +2229,7 @@ int LuaOpenGL::TexCoord(lua_State* L)
 		const float y = lua_tofloat(L, 2);
 		const float z = lua_tofloat(L, 3);
 		const float w = lua_tofloat(L, 4);
+		immediateBatch.Interrupt();
 		glTexCoord4f(x, y, z, w);
 	}
 	else {
@@ -2344,7 +2387,7 @@ int LuaOpenGL::EdgeFlag(lua_State* L)
 
 int LuaOpenGL::Rect(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 	if ((args != 4) ||
@@ -2357,14 +2400,49 @@ int LuaOpenGL::Rect(lua_State* L)
 	const float x2 = lua_tofloat(L, 3);
 	const float y2 = lua_tofloat(L, 4);
 
-	glRectf(x1, y1, x2, y2);
+	if (immediateBatch.InBeginEnd()) {
+		immediateBatch.Interrupt();
+		glRectf(x1, y1, x2, y2);
+		return 0;
+	}
+
+	immediateBatch.Begin(GL_QUADS);
+	immediateBatch.Vertex(x1, y1, 0.0f);
+	immediateBatch.Vertex(x2, y1, 0.0f);
+	immediateBatch.Vertex(x2, y2, 0.0f);
+	immediateBatch.Vertex(x1, y2, 0.0f);
+	immediateBatch.End();
 	return 0;
 }
 
 
+static void DrawTexRect(float x1, float y1, float x2, float y2,
+                        float s1, float t1, float s2, float t2)
+{
+	if (immediateBatch.InBeginEnd()) {
+		immediateBatch.Interrupt();
+		glBegin(GL_QUADS); {
+			glTexCoord2f(s1, t1); glVertex2f(x1, y1);
+			glTexCoord2f(s2, t1); glVertex2f(x2, y1);
+			glTexCoord2f(s2, t2); glVertex2f(x2, y2);
+			glTexCoord2f(s1, t2); glVertex2f(x1, y2);
+		}
+		glEnd();
+		return;
+	}
+
+	immediateBatch.Begin(GL_QUADS);
+	immediateBatch.TexCoord(s1, t1); immediateBatch.Vertex(x1, y1, 0.0f);
+	immediateBatch.TexCoord(s2, t1); immediateBatch.Vertex(x2, y1, 0.0f);
+	immediateBatch.TexCoord(s2, t2); immediateBatch.Vertex(x2, y2, 0.0f);
+	immediateBatch.TexCoord(s1, t2); immediateBatch.Vertex(x1, y2, 0.0f);
+	immediateBatch.End();
+}
+
+
 int LuaOpenGL::TexRect(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 	if ((args < 4) ||
@@ -2395,13 +2473,7 @@ int LuaOpenGL::TexRect(lua_State* L)
 			t1 = 0.0f;
 			t2 = 1.0f;
 		}
-		glBegin(GL_QUADS); {
-			glTexCoord2f(s1, t1); glVertex2f(x1, y1);
-			glTexCoord2f(s2, t1); glVertex2f(x2, y1);
-			glTexCoord2f(s2, t2); glVertex2f(x2, y2);
-			glTexCoord2f(s1, t2); glVertex2f(x1, y2);
-		}
-		glEnd();
+		DrawTexRect(x1, y1, x2, y2, s1, t1, s2, t2);
 		return 0;
 	}
 
@@ -2414,13 +2486,7 @@ int LuaOpenGL::TexRect(lua_State* L)
 	const float t1 = lua_tofloat(L, 6);
 	const float s2 = lua_tofloat(L, 7);
 	const float t2 = lua_tofloat(L, 8);
-	glBegin(GL_QUADS); {
-		glTexCoord2f(s1, t1); glVertex2f(x1, y1);
-		glTexCoord2f(s2, t1); glVertex2f(x2, y1);
-		glTexCoord2f(s2, t2); glVertex2f(x2, y2);
-		glTexCoord2f(s1, t2); glVertex2f(x1, y2);
-	}
-	glEnd();
+	DrawTexRect(x1, y1, x2, y2, s1, t1, s2, t2);
 
 	return 0;
 }
@@ -2430,7 +2496,7 @@ int LuaOpenGL::TexRect(lua_State* L)
 
 int LuaOpenGL::Color(lua_State* L)
 {
-	CheckDrawingEnabled(L, __FUNCTION__);
+	CheckBatchDrawingEnabled(L, __FUNCTION__);
 
 	const int args = lua_gettop(L); // number of arguments
 	if (args < 1) {
@@ -2471,7 +2537,7 @@ int LuaOpenGL::Color(lua_State* L)
 		luaL_error(L, "Incorrect arguments to gl.Color()");
 	}
 
-	glColor4fv(color);
+	immediateBatch.Color(color);
 
 	return 0;
 }
@@ -3167,6 +3233,8 @@ int LuaOpenGL::LineStipple(lua_State* L)
 
 int LuaOpenGL::LineWidth(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	const int args = lua_gettop(L); // number of arguments
 	if ((args != 1) || !lua_isnumber(L, 1)) {
 		luaL_error(L, "Incorrect arguments to gl.LineWidth()");
@@ -3178,6 +3246,8 @@ int LuaOpenGL::LineWidth(lua_State* L)
 
 int LuaOpenGL::PointSize(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	const int args = lua_gettop(L); // number of arguments
 	if ((args != 1) || !lua_isnumber(L, 1)) {
 		luaL_error(L, "Incorrect arguments to gl.PointSize()");
@@ -3189,6 +3259,8 @@ int LuaOpenGL::PointSize(lua_State* L)
 
 int LuaOpenGL::PointSprite(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	const int args = lua_gettop(L); // number of arguments
 	if ((args < 1) || !lua_isboolean(L, 1)) {
 		luaL_error(L, "Incorrect arguments to gl.PointSprite()");
@@ -3218,6 +3290,8 @@ int LuaOpenGL::PointSprite(lua_State* L)
 
 int LuaOpenGL::PointParameter(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	GLfloat atten[3];
 	atten[0] = (GLfloat)luaL_checknumber(L, 1);
 	atten[1] = (GLfloat)luaL_checknumber(L, 2);
@@ -3516,6 +3590,8 @@ int LuaOpenGL::Texture(lua_State* L)
 
 int LuaOpenGL::CreateTexture(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	LuaTextures::Texture tex;
 	tex.xsize = (GLsizei)luaL_checknumber(L, 1);
 	tex.ysize = (GLsizei)luaL_checknumber(L, 2);
@@ -3568,8 +3644,24 @@ int LuaOpenGL::CreateTexture(lua_State* L)
 }
 
 
+int LuaOpenGL::PrefetchTexture(lua_State* L)
+{
+	const string texture = luaL_checkstring(L, 1);
+
+	// only named image files are decoded ahead, not the special textures
+	if (texture.empty() || strchr("#^!$%", texture[0]) != NULL) {
+		return 0;
+	}
+
+	CNamedTextures::Prefetch(texture);
+	return 0;
+}
+
+
 int LuaOpenGL::DeleteTexture(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	if (lua_isnil(L, 1)) {
 		return 0;
 	}
@@ -3591,6 +3683,8 @@ int LuaOpenGL::DeleteTexture(lua_State* L)
 // FIXME: obsolete
 int LuaOpenGL::DeleteTextureFBO(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	if (lua_isnil(L, 1)) {
 		return 0;
 	}
@@ -3654,6 +3748,8 @@ static bool PushUnitTextureInfo(lua_State* L, const string& texture)
 
 int LuaOpenGL::TextureInfo(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	const int args = lua_gettop(L); // number of arguments
 	if ((args != 1) || !lua_isstring(L, 1)) {
 		luaL_error(L, "Incorrect arguments to gl.TextureInfo()");
@@ -3834,6 +3930,7 @@ int LuaOpenGL::RenderToTexture(lua_State* L)
 	glMatrixMode(GL_MODELVIEW);  glPushMatrix(); glLoadIdentity();
 
 	const int error = lua_pcall(L, lua_gettop(L) - 2, 0, 0);
+	immediateBatch.Interrupt();
 
 	glMatrixMode(GL_PROJECTION); glPopMatrix();
 	glMatrixMode(GL_MODELVIEW);  glPopMatrix();
@@ -3854,6 +3951,8 @@ int LuaOpenGL::RenderToTexture(lua_State* L)
 int LuaOpenGL::GenerateMipmap(lua_State* L)
 {
 	//CheckDrawingEnabled(L, __FUNCTION__);
+	FlushBatchIfDrawing(L);
+
 	const string& texStr = luaL_checkstring(L, 1);
 	if (texStr[0] != LuaTextures::prefix) { // '!'
 		return 0;
@@ -3889,6 +3988,7 @@ int LuaOpenGL::ActiveTexture(lua_State* L)
 	// call the function
 	glActiveTexture(GL_TEXTURE0 + texNum);
 	const int error = lua_pcall(L, (args - 2), 0, 0);
+	immediateBatch.Interrupt();
 	glActiveTexture(GL_TEXTURE0);
 
 	if (error != 0) {
@@ -4439,6 +4539,7 @@ int LuaOpenGL::PushPopMatrix(lua_State* L)
 
 	const int args = lua_gettop(L); // number of arguments
 	const int error = lua_pcall(L, (args - arg), 0, 0);
+	immediateBatch.Interrupt();
 
 	if (arg == 1) {
 		glPopMatrix();
@@ -4557,6 +4658,7 @@ int LuaOpenGL::UnsafeState(lua_State* L)
 
 	reverse ? glDisable(state) : glEnable(state);
 	const int error = lua_pcall(L, lua_gettop(L) - funcLoc, 0, 0);
+	immediateBatch.Interrupt();
 	reverse ? glEnable(state) : glDisable(state);
 
 	if (error != 0) {
@@ -4595,6 +4697,7 @@ int LuaOpenGL::CreateList(lua_State* L)
 	const int error = lua_pcall(L, (args - 1), 0, 0);
 	MatrixStateData matData = L->lcd->GetMatrixState();
 	L->lcd->PopMatrixState(prevMSD, false);
+	immediateBatch.Interrupt();
 	glEndList();
 
 	if (error != 0) {
@@ -4637,6 +4740,8 @@ int LuaOpenGL::CallList(lua_State* L)
 
 int LuaOpenGL::DeleteList(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	if (lua_isnil(L, 1)) {
 		return 0;
 	}
@@ -4723,6 +4828,8 @@ static void PushPixelData(lua_State* L, int fSize, const float*& data)
 
 int LuaOpenGL::ReadPixels(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	const GLint x = luaL_checkint(L, 1);
 	const GLint y = luaL_checkint(L, 2);
 	const GLint w = luaL_checkint(L, 3);
@@ -4791,6 +4898,8 @@ int LuaOpenGL::ReadPixels(lua_State* L)
 
 int LuaOpenGL::SaveImage(lua_State* L)
 {
+	FlushBatchIfDrawing(L);
+
 	if (!CLuaHandle::CheckModUICtrl(L)) {
 		return 0;
 	}
@@ -4894,6 +5003,7 @@ int LuaOpenGL::RunQuery(lua_State* L)
 	running = true;
 	glBeginQuery(GL_SAMPLES_PASSED, q);
 	const int error = lua_pcall(L, (args - 2), 0, 0);
+	immediateBatch.Interrupt();
 	glEndQuery(GL_SAMPLES_PASSED);
 	running = false;
 
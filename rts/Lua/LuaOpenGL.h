@@ -32,7 +32,24 @@ class LuaOpenGL {
 		static bool PushEntries(lua_State* L);
 
 		static bool IsDrawingEnabled(lua_State* L) { return GET_HANDLE_CONTEXT_DATA(drawingEnabled); }
-		static void SetDrawingEnabled(lua_State* L, bool value) { GET_HANDLE_CONTEXT_DATA(drawingEnabled) = value; }
+		static void SetDrawingEnabled(lua_State* L, bool value) {
+			// batched vertices must not outlive the call-in that recorded them
+			if (IsDrawingEnabled(L))
+				FlushBatch();
+
+			GET_HANDLE_CONTEXT_DATA(drawingEnabled) = value;
+		}
+
+		/// draws whatever the immediate-mode batch has recorded so far
+		static void FlushBatch();
+		/**
+		 * for the calls that do not require drawing to be enabled but change
+		 * state or read back, the batch is always empty outside of drawing
+		 */
+		static void FlushBatchIfDrawing(lua_State* L) {
+			if (IsDrawingEnabled(L))
+				FlushBatch();
+		}
 
 		static bool CanUseShaders() { return canUseShaders; }
 
@@ -114,6 +131,8 @@ class LuaOpenGL {
 
 	private:
 		static void CheckDrawingEnabled(lua_State* L, const char* caller);
+		/// same check for the calls that are recorded by the batch (no state boundary)
+		static void CheckBatchDrawingEnabled(lua_State* L, const char* caller);
 
 	private:
 		static int HasExtension(lua_State* L);
@@ -172,6 +191,7 @@ class LuaOpenGL {
 		static int PointParameter(lua_State* L);
 
 		static int Texture(lua_State* L);
+		static int PrefetchTexture(lua_State* L);
 		static int CreateTexture(lua_State* L);
 		static int DeleteTexture(lua_State* L);
 		static int DeleteTextureFBO(lua_State* L);
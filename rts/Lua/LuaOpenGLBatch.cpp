@@ -0,0 +1,290 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+
+#include "LuaOpenGLBatch.h"
+
+#include <algorithm>
+#include <cassert>
+
+// recorded vertices are drawn once this many have accumulated at a block end
+static const size_t MAX_BATCH_VERTICES = 1 << 16;
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+LuaOpenGLBatch::LuaOpenGLBatch()
+	: primMode(GL_QUADS)
+	, blockState(BLOCK_NONE)
+	, blockStart(0)
+	, useColors(false)
+	, useNormals(false)
+	, useTexCoords(false)
+	, colorKnown(false)
+	, normalKnown(false)
+	, texCoordKnown(false)
+{
+	curColor[0] = curColor[1] = curColor[2] = curColor[3] = 1.0f;
+	curNormal[0] = curNormal[2] = 0.0f; curNormal[1] = 1.0f;
+	curTexCoord[0] = curTexCoord[1] = 0.0f;
+}
+
+
+int LuaOpenGLBatch::GetPrimitiveSize(GLenum primMode)
+{
+	// only primitives that are independent of each other can be merged
+	switch (primMode) {
+		case GL_POINTS:    { return 1; }
+		case GL_LINES:     { return 2; }
+		case GL_TRIANGLES: { return 3; }
+		case GL_QUADS:     { return 4; }
+		default: {} break;
+	}
+
+	return 0;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+void LuaOpenGLBatch::Begin(GLenum mode)
+{
+	assert(!InBeginEnd());
+
+	if (!vertices.empty() && ((mode != primMode) || (GetPrimitiveSize(mode) == 0))) {
+		Flush();
+	}
+
+	primMode = mode;
+	blockState = BLOCK_RECORD;
+	blockStart = vertices.size();
+}
+
+
+void LuaOpenGLBatch::End()
+{
+	assert(InBeginEnd());
+
+	if (blockState == BLOCK_PASSTHROUGH) {
+		glEnd();
+		blockState = BLOCK_NONE;
+		return;
+	}
+
+	blockState = BLOCK_NONE;
+
+	const int primSize = GetPrimitiveSize(primMode);
+
+	if (primSize == 0) {
+		Flush();
+		return;
+	}
+
+	// drop an incomplete trailing primitive, glEnd would do the same
+	const size_t numBlockVerts = vertices.size() - blockStart;
+	vertices.resize(vertices.size() - (numBlockVerts % primSize));
+	blockStart = vertices.size();
+
+	if (vertices.size() >= MAX_BATCH_VERTICES) {
+		Flush();
+	}
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+void LuaOpenGLBatch::Vertex(float x, float y, float z)
+{
+	if (blockState != BLOCK_RECORD) {
+		// a stray vertex outside of any block is ignored by GL, but keep the order
+		if (blockState == BLOCK_NONE) {
+			Interrupt();
+		}
+		glVertex3f(x, y, z);
+		return;
+	}
+
+	if (vertices.empty()) {
+		// attributes not set since the last state boundary stay with GL
+		useColors    = colorKnown;
+		useNormals   = normalKnown;
+		useTexCoords = texCoordKnown;
+	}
+
+	BatchVertex v;
+	v.pos[0] = x;
+	v.pos[1] = y;
+	v.pos[2] = z;
+	std::copy(curNormal, curNormal + 3, v.normal);
+	std::copy(curTexCoord, curTexCoord + 2, v.texCoord);
+	std::copy(curColor, curColor + 4, v.color);
+
+	vertices.push_back(v);
+}
+
+
+bool LuaOpenGLBatch::PrepareAttribChange(bool recorded)
+{
+	if (blockState == BLOCK_PASSTHROUGH)
+		return true;
+	if (vertices.empty())
+		return true;
+	// pending vertices carry their own value, it becomes current after they are drawn
+	if (recorded)
+		return false;
+
+	// pending vertices use the GL current value, which is about to change
+	if (HasOpenBlockVertices()) {
+		Passthrough();
+	} else {
+		Flush();
+	}
+
+	return true;
+}
+
+
+void LuaOpenGLBatch::Color(const float* c)
+{
+	const bool apply = PrepareAttribChange(useColors);
+
+	std::copy(c, c + 4, curColor);
+	colorKnown = true;
+
+	if (apply) {
+		glColor4fv(curColor);
+	}
+}
+
+
+void LuaOpenGLBatch::Normal(const float* n)
+{
+	const bool apply = PrepareAttribChange(useNormals);
+
+	std::copy(n, n + 3, curNormal);
+	normalKnown = true;
+
+	if (apply) {
+		glNormal3fv(curNormal);
+	}
+}
+
+
+void LuaOpenGLBatch::TexCoord(float s, float t)
+{
+	const bool apply = PrepareAttribChange(useTexCoords);
+
+	curTexCoord[0] = s;
+	curTexCoord[1] = t;
+	texCoordKnown = true;
+
+	if (apply) {
+		glTexCoord2fv(curTexCoord);
+	}
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+void LuaOpenGLBatch::Interrupt()
+{
+	if (IsRecording()) {
+		// anything called inside an open block ends up between glBegin and glEnd, as before
+		Passthrough();
+	} else {
+		Flush();
+	}
+
+	colorKnown = false;
+	normalKnown = false;
+	texCoordKnown = false;
+}
+
+
+void LuaOpenGLBatch::Passthrough()
+{
+	assert(IsRecording());
+
+	// the merged blocks in front of this one are still drawn as a batch
+	DrawVertices(0, blockStart);
+
+	glBegin(primMode);
+
+	for (size_t n = blockStart; n < vertices.size(); n++) {
+		const BatchVertex& v = vertices[n];
+
+		if (useColors)    { glColor4fv(v.color);       }
+		if (useNormals)   { glNormal3fv(v.normal);     }
+		if (useTexCoords) { glTexCoord2fv(v.texCoord); }
+
+		glVertex3fv(v.pos);
+	}
+
+	RestoreCurrentAttribs();
+
+	vertices.clear();
+	blockStart = 0;
+	blockState = BLOCK_PASSTHROUGH;
+}
+
+
+void LuaOpenGLBatch::Flush()
+{
+	assert(!HasOpenBlockVertices());
+
+	if (vertices.empty())
+		return;
+
+	DrawVertices(0, vertices.size());
+	RestoreCurrentAttribs();
+
+	vertices.clear();
+	blockStart = 0;
+}
+
+
+void LuaOpenGLBatch::DrawVertices(size_t first, size_t count) const
+{
+	if (count == 0)
+		return;
+
+	const BatchVertex* v = &vertices[first];
+	const GLsizei stride = sizeof(BatchVertex);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, stride, v->pos);
+
+	if (useColors) {
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(4, GL_FLOAT, stride, v->color);
+	}
+	if (useNormals) {
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, stride, v->normal);
+	}
+	if (useTexCoords) {
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, stride, v->texCoord);
+	}
+
+	glDrawArrays(primMode, 0, count);
+
+	if (useTexCoords) { glDisableClientState(GL_TEXTURE_COORD_ARRAY); }
+	if (useNormals)   { glDisableClientState(GL_NORMAL_ARRAY);        }
+	if (useColors)    { glDisableClientState(GL_COLOR_ARRAY);         }
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+
+void LuaOpenGLBatch::RestoreCurrentAttribs() const
+{
+	// the current values are undefined after drawing with arrays,
+	// leave them as the immediate-mode calls would have
+	if (colorKnown)    { glColor4fv(curColor);       }
+	if (normalKnown)   { glNormal3fv(curNormal);     }
+	if (texCoordKnown) { glTexCoord2fv(curTexCoord); }
+}
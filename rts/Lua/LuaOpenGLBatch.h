@@ -0,0 +1,95 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_OPENGL_BATCH_H
+#define LUA_OPENGL_BATCH_H
+
+#include <vector>
+
+#include "Rendering/GL/myGL.h"
+
+
+/**
+ * Records the immediate-mode calls made by gl.BeginEnd blocks, gl.Rect and
+ * gl.TexRect into client-side vertex arrays instead of issuing them one at a
+ * time. Consecutive blocks of independent primitives (points, lines, triangles,
+ * quads) are merged and drawn with a single glDrawArrays when the next state
+ * boundary (any other Lua GL call) is reached.
+ *
+ * Vertex attributes are only recorded per vertex when their current value is
+ * known to the batch (set through gl.Color, gl.Normal or gl.TexCoord since the
+ * last state boundary), otherwise the GL current value is left to apply. Calls
+ * the batch can not record (e.g. gl.MultiTexCoord) switch the open block back
+ * to plain glBegin / glEnd.
+ */
+class LuaOpenGLBatch {
+	public:
+		LuaOpenGLBatch();
+
+		void Begin(GLenum primMode);
+		void End();
+
+		/// true while inside a gl.BeginEnd block (recorded or not)
+		bool InBeginEnd() const { return (blockState != BLOCK_NONE); }
+		bool IsRecording() const { return (blockState == BLOCK_RECORD); }
+
+		void Vertex(float x, float y, float z);
+		void Color(const float* c);
+		void Normal(const float* n);
+		void TexCoord(float s, float t);
+
+		/**
+		 * called at state boundaries: draws the recorded vertices (or
+		 * switches an open block to immediate mode) and forgets about
+		 * the current attribute values
+		 */
+		void Interrupt();
+
+		/// reinstates glBegin for the open block, replaying what was recorded so far
+		void Passthrough();
+
+		void Flush();
+
+	private:
+		struct BatchVertex {
+			float pos[3];
+			float normal[3];
+			float texCoord[2];
+			float color[4];
+		};
+
+		enum BlockState {
+			BLOCK_NONE,
+			BLOCK_RECORD,
+			BLOCK_PASSTHROUGH
+		};
+
+		static int GetPrimitiveSize(GLenum primMode);
+
+		bool HasOpenBlockVertices() const { return (IsRecording() && vertices.size() > blockStart); }
+		void DrawVertices(size_t first, size_t count) const;
+		void RestoreCurrentAttribs() const;
+		/// called by the attribute setters before the current value changes
+		bool PrepareAttribChange(bool recorded);
+
+	private:
+		std::vector<BatchVertex> vertices;
+
+		GLenum primMode;
+		BlockState blockState;
+		/// index of the first vertex of the open gl.BeginEnd block
+		size_t blockStart;
+
+		bool useColors;
+		bool useNormals;
+		bool useTexCoords;
+
+		bool colorKnown;
+		bool normalKnown;
+		bool texCoordKnown;
+
+		float curColor[4];
+		float curNormal[3];
+		float curTexCoord[2];
+};
+
+#endif /* LUA_OPENGL_BATCH_H */
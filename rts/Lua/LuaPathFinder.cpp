@@ -5,6 +5,7 @@
 #include "LuaInclude.h"
 #include "LuaHandle.h"
 #include "LuaUtils.h"
+#include "ExternalAI/EngineOutHandler.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 
@@ -69,7 +70,12 @@ int LuaPathFinder::PushPathNodes(lua_State* L, const int pathID)
 	vector<float3> points;
 	vector<int>    starts;
 
-	pathManager->GetPathWayPoints(pathID, points, starts);
+	{
+		// threaded Skirmish AIs use the path manager as well, the
+		// lock keeps them out while (unsynced) Lua code calls it
+		const CScopedAIWorldLock aiWorldLock;
+		pathManager->GetPathWayPoints(pathID, points, starts);
+	}
 
 	const int pointCount = points.size();
 	const int startCount = starts.size();
@@ -125,6 +131,7 @@ static int path_next(lua_State* L)
 	const float minDist = luaL_optfloat(L, 5, 0.0f);
 
 	const bool synced = CLuaHandle::GetHandleSynced(L);
+	const CScopedAIWorldLock aiWorldLock;
 	const float3 point = pathManager->NextWayPoint(NULL, pathID, 0, callerPos, minDist, synced);
 
 	if ((point.x == -1.0f) &&
@@ -180,6 +187,7 @@ static int path_gc(lua_State* L)
 	if (pathID == 0) {
 		return 0;
 	}
+	const CScopedAIWorldLock aiWorldLock;
 	pathManager->DeletePath(*idPtr);
 	*idPtr = 0;
 	return 0;
@@ -230,6 +238,7 @@ int LuaPathFinder::RequestPath(lua_State* L)
 	const float radius = luaL_optfloat(L, 8, 8.0f);
 
 	const bool synced = CLuaHandle::GetHandleSynced(L);
+	const CScopedAIWorldLock aiWorldLock;
 	const int pathID = pathManager->RequestPath(NULL, moveDef, start, end, radius, synced);
 
 	if (pathID == 0) {
@@ -278,6 +287,7 @@ int LuaPathFinder::FreePathNodeCostsArray(lua_State* L)
 {
 	const unsigned int array = luaL_checkint(L, 1);
 	const bool synced = CLuaHandle::GetHandleSynced(L);
+	const CScopedAIWorldLock aiWorldLock;
 
 	std::map<unsigned int, NodeCostOverlay>& map = synced?
 		costArrayMapSynced:
@@ -319,6 +329,7 @@ int LuaPathFinder::SetPathNodeCosts(lua_State* L)
 	}
 
 	// set the active cost-overlay to <overlay>
+	const CScopedAIWorldLock aiWorldLock;
 	lua_pushboolean(L, pathManager->SetNodeExtraCosts(&overlay.costs[0], overlay.sizex, overlay.sizez, synced));
 	return 1;
 }
@@ -336,6 +347,7 @@ int LuaPathFinder::SetPathNodeCost(lua_State* L)
 	const unsigned int index = luaL_checkint(L, 2);
 	const float cost = luaL_checkfloat(L, 3);
 	const bool synced = CLuaHandle::GetHandleSynced(L);
+	const CScopedAIWorldLock aiWorldLock;
 
 	std::map<unsigned int, NodeCostOverlay>& map = synced?
 		costArrayMapSynced:
@@ -364,6 +376,7 @@ int LuaPathFinder::GetPathNodeCost(lua_State* L)
 	const bool synced = CLuaHandle::GetHandleSynced(L);
 
 	// reads from overlay if PathNodeStateBuffer::extraCosts != NULL
+	const CScopedAIWorldLock aiWorldLock;
 	const float cost = pathManager->GetNodeExtraCost(hmx, hmz, synced);
 
 	lua_pushnumber(L, cost);
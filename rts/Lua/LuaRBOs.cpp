@@ -7,6 +7,7 @@
 
 #include "LuaHandle.h"
 #include "LuaHashString.h"
+#include "LuaOpenGL.h"
 #include "LuaUtils.h"
 
 
@@ -98,6 +99,8 @@ void LuaRBOs::RBO::Free(lua_State *L)
 
 int LuaRBOs::meta_gc(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	RBO* rbo = static_cast<RBO*>(luaL_checkudata(L, 1, "RBO"));
 	rbo->Free(L);
 	return 0;
@@ -179,6 +182,8 @@ int LuaRBOs::CreateRBO(lua_State* L)
 
 int LuaRBOs::DeleteRBO(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	if (lua_isnil(L, 1)) {
 		return 0;
 	}
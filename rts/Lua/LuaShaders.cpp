@@ -82,6 +82,8 @@ inline void CheckDrawingEnabled(lua_State* L, const char* caller)
 		luaL_error(L, "%s(): OpenGL calls can only be used in Draw() "
 		              "call-ins, or while creating display lists", caller);
 	}
+
+	LuaOpenGL::FlushBatch();
 }
 
 
@@ -392,6 +394,8 @@ static void ApplyGeometryParameters(lua_State* L, int table, GLuint prog)
 
 int LuaShaders::CreateShader(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	const int args = lua_gettop(L);
 	if ((args != 1) || !lua_istable(L, 1)) {
 		luaL_error(L, "Incorrect arguments to gl.CreateShader()");
@@ -474,6 +478,8 @@ int LuaShaders::CreateShader(lua_State* L)
 
 int LuaShaders::DeleteShader(lua_State* L)
 {
+	LuaOpenGL::FlushBatchIfDrawing(L);
+
 	if (lua_isnil(L, 1)) {
 		return 0;
 	}
@@ -530,6 +536,7 @@ int LuaShaders::ActiveShader(lua_State* L)
 	glUseProgram(progName);
 	activeShaderDepth++;
 	const int error = lua_pcall(L, lua_gettop(L) - 2, 0, 0);
+	LuaOpenGL::FlushBatch();
 	activeShaderDepth--;
 	glUseProgram(currentProgram);
 
@@ -48,6 +48,7 @@
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitDef.h"
 #include "Sim/Units/UnitHandler.h"
+#include "Sim/Units/VisibleUnitIndex.h"
 #include "Sim/Units/UnitDefHandler.h"
 #include "Sim/Units/UnitLoader.h"
 #include "Sim/Units/Scripts/CobInstance.h"
@@ -66,6 +67,7 @@
 #include "System/FileSystem/VFSHandler.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/Util.h"
+#include "lib/gml/gmlcnf.h"
 
 #include <set>
 #include <list>
@@ -210,6 +212,10 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 	REGISTER_LUA_CFUNC(GetUnitDirection);
 	REGISTER_LUA_CFUNC(GetUnitHeading);
 	REGISTER_LUA_CFUNC(GetUnitVelocity);
+	REGISTER_LUA_CFUNC(GetUnitsPositions);
+	REGISTER_LUA_CFUNC(GetUnitsVelocities);
+	REGISTER_LUA_CFUNC(GetUnitsHealths);
+	REGISTER_LUA_CFUNC(GetUnitsStates);
 	REGISTER_LUA_CFUNC(GetUnitBuildFacing);
 	REGISTER_LUA_CFUNC(GetUnitIsBuilding);
 	REGISTER_LUA_CFUNC(GetUnitCurrentBuildPower);
@@ -1528,14 +1534,47 @@ int LuaSyncedRead::GetAllUnits(lua_State* L)
 			lua_pushnumber(L, (*uit)->id);
 			lua_rawseti(L, -2, ++count);
 		}
-	} else {
+	} else if (GML::SimEnabled()) {
+		// the sim thread changes the team sets and the visible-unit
+		// index concurrently, only the unit list is safe to walk here
 		lua_newtable(L);
 		for (uit = unitHandler->activeUnits.begin(); uit != unitHandler->activeUnits.end(); ++uit) {
 			if (IsUnitVisible(L, *uit)) {
-				count++;
-				lua_pushnumber(L, count);
 				lua_pushnumber(L, (*uit)->id);
-				lua_rawset(L, -3);
+				lua_rawseti(L, -2, ++count);
+			}
+		}
+	} else {
+		lua_newtable(L);
+
+		const int readAllyTeam = CLuaHandle::GetHandleReadAllyTeam(L);
+
+		if (readAllyTeam < 0)
+			return 1;
+
+		// own units, then all units seen in LOS or radar (the same
+		// units IsUnitVisible accepts, without visiting the others)
+		for (int t = 0; t < teamHandler->ActiveTeams(); t++) {
+			if (teamHandler->AllyTeam(t) != readAllyTeam)
+				continue;
+
+			const CUnitSet& units = teamHandler->Team(t)->units;
+
+			for (CUnitSet::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
+				lua_pushnumber(L, (*ui)->id);
+				lua_rawseti(L, -2, ++count);
+			}
+		}
+
+		for (int at = 0; at < teamHandler->ActiveAllyTeams(); at++) {
+			if (at == readAllyTeam)
+				continue;
+
+			const std::vector<CUnit*>& units = visibleUnitIndex->GetUnits(readAllyTeam, at, CVisibleUnitIndex::VIS_ANY);
+
+			for (std::vector<CUnit*>::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
+				lua_pushnumber(L, (*ui)->id);
+				lua_rawseti(L, -2, ++count);
 			}
 		}
 	}
@@ -2936,6 +2975,250 @@ int LuaSyncedRead::GetUnitVelocity(lua_State* L)
 }
 
 
+/******************************************************************************/
+//
+//  Bulk unit queries
+//
+//  Spring.GetUnits*(unitIDs [, out]) write <stride> values per entry of the
+//  unitIDs array into one flat array (the values for unitIDs[i] start at
+//  out[(i - 1) * stride + 1]) and return it plus the number of units that
+//  passed the same access check as the single-unit variant; the values of
+//  the others are nil. Passing the previous result as <out> avoids creating
+//  a new table every call, entries past the last unit's values are set to
+//  nil so a reused table never holds stale values of a larger result.
+//
+//  GetUnitsPositions(unitIDs [, out [, midPos]]) takes the extra <midPos>
+//  flag of GetUnitPosition: if true, the units' mid-positions are returned
+//  (out may be nil to pass it without reusing a table).
+//
+
+static int ParseBulkUnitsArgs(lua_State* L, const char* caller, int stride, bool* reusedOut)
+{
+	if (!lua_istable(L, 1)) {
+		luaL_error(L, "Incorrect arguments to %s(unitIDs [, out])", caller);
+	}
+
+	const int numUnits = lua_objlen(L, 1);
+
+	// checked before pushing, a new table could end up at index 2 itself
+	*reusedOut = lua_istable(L, 2);
+
+	if (*reusedOut) {
+		lua_pushvalue(L, 2);
+	} else {
+		lua_createtable(L, numUnits * stride, 0);
+	}
+
+	return numUnits;
+}
+
+
+/// only needed for a table passed in as <out>, a new one has no stale values
+static void ClearStaleBulkValues(lua_State* L, int numValues)
+{
+	// the array part may contain holes (units that failed the check), so
+	// walk the whole table instead of stopping at the first nil entry
+	for (lua_pushnil(L); lua_next(L, -2) != 0; lua_pop(L, 1)) {
+		if (lua_type(L, -2) != LUA_TNUMBER || lua_tonumber(L, -2) <= numValues)
+			continue;
+
+		// assigning nil to an existing field is allowed during traversal
+		lua_pushvalue(L, -2);
+		lua_pushnil(L);
+		lua_rawset(L, -5);
+	}
+}
+
+
+static inline CUnit* ParseBulkUnit(lua_State* L, int index)
+{
+	lua_rawgeti(L, 1, index);
+	CUnit* unit = ParseRawUnit(L, NULL, -1);
+	lua_pop(L, 1);
+	return unit;
+}
+
+
+static inline void SetBulkValue(lua_State* L, int index, float value)
+{
+	lua_pushnumber(L, value);
+	lua_rawseti(L, -2, index);
+}
+
+
+static inline void SetBulkValue(lua_State* L, int index, bool value)
+{
+	lua_pushboolean(L, value);
+	lua_rawseti(L, -2, index);
+}
+
+
+static inline void ClearBulkValues(lua_State* L, int index, int count)
+{
+	for (int n = 0; n < count; n++) {
+		lua_pushnil(L);
+		lua_rawseti(L, -2, index + n);
+	}
+}
+
+
+int LuaSyncedRead::GetUnitsPositions(lua_State* L)
+{
+	const int stride = 3;
+	bool reusedOut = false;
+	const int numUnits = ParseBulkUnitsArgs(L, __FUNCTION__, stride, &reusedOut);
+	const bool midPos = (lua_isboolean(L, 3) && lua_toboolean(L, 3));
+	const int readAllyTeam = CLuaHandle::GetHandleReadAllyTeam(L);
+
+	int count = 0;
+
+	for (int i = 0; i < numUnits; i++) {
+		const CUnit* unit = ParseBulkUnit(L, i + 1);
+		const int base = i * stride + 1;
+
+		if (unit == NULL || !IsUnitVisible(L, unit)) {
+			ClearBulkValues(L, base, stride);
+			continue;
+		}
+
+		float3 pos = midPos? float3(unit->midPos): float3(unit->pos);
+
+		if (!IsAllyUnit(L, unit)) {
+			pos += CGameHelper::GetUnitErrorPos(unit, readAllyTeam);
+			pos -= unit->midPos;
+		}
+
+		SetBulkValue(L, base    , pos.x);
+		SetBulkValue(L, base + 1, pos.y);
+		SetBulkValue(L, base + 2, pos.z);
+		count++;
+	}
+
+	if (reusedOut) {
+		ClearStaleBulkValues(L, numUnits * stride);
+	}
+
+	lua_pushnumber(L, count);
+	return 2;
+}
+
+
+int LuaSyncedRead::GetUnitsVelocities(lua_State* L)
+{
+	const int stride = 3;
+	bool reusedOut = false;
+	const int numUnits = ParseBulkUnitsArgs(L, __FUNCTION__, stride, &reusedOut);
+
+	int count = 0;
+
+	for (int i = 0; i < numUnits; i++) {
+		const CUnit* unit = ParseBulkUnit(L, i + 1);
+		const int base = i * stride + 1;
+
+		if (unit == NULL || !IsUnitInLos(L, unit)) {
+			ClearBulkValues(L, base, stride);
+			continue;
+		}
+
+		SetBulkValue(L, base    , unit->speed.x);
+		SetBulkValue(L, base + 1, unit->speed.y);
+		SetBulkValue(L, base + 2, unit->speed.z);
+		count++;
+	}
+
+	if (reusedOut) {
+		ClearStaleBulkValues(L, numUnits * stride);
+	}
+
+	lua_pushnumber(L, count);
+	return 2;
+}
+
+
+int LuaSyncedRead::GetUnitsHealths(lua_State* L)
+{
+	const int stride = 5;
+	bool reusedOut = false;
+	const int numUnits = ParseBulkUnitsArgs(L, __FUNCTION__, stride, &reusedOut);
+
+	int count = 0;
+
+	for (int i = 0; i < numUnits; i++) {
+		const CUnit* unit = ParseBulkUnit(L, i + 1);
+		const int base = i * stride + 1;
+
+		if (unit == NULL || !IsUnitInLos(L, unit)) {
+			ClearBulkValues(L, base, stride);
+			continue;
+		}
+
+		// same rules as GetUnitHealth
+		const UnitDef* ud = unit->unitDef;
+		const bool enemyUnit = IsEnemyUnit(L, unit);
+
+		if (ud->hideDamage && enemyUnit) {
+			ClearBulkValues(L, base, 3);
+		} else if (!enemyUnit || (ud->decoyDef == NULL)) {
+			SetBulkValue(L, base    , unit->health);
+			SetBulkValue(L, base + 1, unit->maxHealth);
+			SetBulkValue(L, base + 2, unit->paralyzeDamage);
+		} else {
+			const float scale = (ud->decoyDef->health / ud->health);
+			SetBulkValue(L, base    , scale * unit->health);
+			SetBulkValue(L, base + 1, scale * unit->maxHealth);
+			SetBulkValue(L, base + 2, scale * unit->paralyzeDamage);
+		}
+
+		SetBulkValue(L, base + 3, unit->captureProgress);
+		SetBulkValue(L, base + 4, unit->buildProgress);
+		count++;
+	}
+
+	if (reusedOut) {
+		ClearStaleBulkValues(L, numUnits * stride);
+	}
+
+	lua_pushnumber(L, count);
+	return 2;
+}
+
+
+int LuaSyncedRead::GetUnitsStates(lua_State* L)
+{
+	const int stride = 6;
+	bool reusedOut = false;
+	const int numUnits = ParseBulkUnitsArgs(L, __FUNCTION__, stride, &reusedOut);
+
+	int count = 0;
+
+	for (int i = 0; i < numUnits; i++) {
+		const CUnit* unit = ParseBulkUnit(L, i + 1);
+		const int base = i * stride + 1;
+
+		if (unit == NULL || !IsAllyUnit(L, unit)) {
+			ClearBulkValues(L, base, stride);
+			continue;
+		}
+
+		// the common (non-aircraft) fields of GetUnitStates, in its order
+		SetBulkValue(L, base    , float(unit->fireState));
+		SetBulkValue(L, base + 1, float(unit->moveState));
+		SetBulkValue(L, base + 2, unit->commandAI->repeatOrders);
+		SetBulkValue(L, base + 3, unit->wantCloak);
+		SetBulkValue(L, base + 4, unit->activated);
+		SetBulkValue(L, base + 5, unit->useHighTrajectory);
+		count++;
+	}
+
+	if (reusedOut) {
+		ClearStaleBulkValues(L, numUnits * stride);
+	}
+
+	lua_pushnumber(L, count);
+	return 2;
+}
+
+
 int LuaSyncedRead::GetUnitBuildFacing(lua_State* L)
 {
 	CUnit* unit = ParseInLosUnit(L, __FUNCTION__, 1);
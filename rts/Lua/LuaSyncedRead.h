@@ -117,6 +117,10 @@ class LuaSyncedRead {
 		static int GetUnitDirection(lua_State* L);
 		static int GetUnitHeading(lua_State* L);
 		static int GetUnitVelocity(lua_State* L);
+		static int GetUnitsPositions(lua_State* L);
+		static int GetUnitsVelocities(lua_State* L);
+		static int GetUnitsHealths(lua_State* L);
+		static int GetUnitsStates(lua_State* L);
 		static int GetUnitBuildFacing(lua_State* L);
 		static int GetUnitIsBuilding(lua_State* L);
 		static int GetUnitCurrentBuildPower(lua_State* L);
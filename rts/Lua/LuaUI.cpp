@@ -851,14 +851,7 @@ int CLuaUI::UnsyncedXCall(lua_State* srcState, const string& funcName)
 		if (srcState != L) {
 			DelayDataDump ddmp;
 
-			LuaUtils::ShallowDataDump sdd;
-			sdd.type = LUA_TSTRING;
-			sdd.data.str = new std::string;
-			*sdd.data.str = funcName;
-
-			ddmp.data.push_back(sdd);
-
-			LuaUtils::Backup(ddmp.dump, srcState, lua_gettop(srcState));
+			LuaUtils::Pack(ddmp.dump, srcState, lua_gettop(srcState));
 
 			lua_settop(srcState, 0);
 
@@ -867,8 +860,8 @@ int CLuaUI::UnsyncedXCall(lua_State* srcState, const string& funcName)
 			delayedCallsFromSynced.push_back(DelayDataDump());
 
 			DelayDataDump &ddb = delayedCallsFromSynced.back();
-			ddb.data.swap(ddmp.data);
 			ddb.dump.swap(ddmp.dump);
+			ddb.funcName = funcName;
 			ddb.xcall = true;
 
 			return 0;
@@ -7,6 +7,7 @@
 #include <zlib.h>
 #include <boost/cstdint.hpp>
 #include <string.h>
+#include <cassert>
 
 
 #include "LuaUtils.h"
@@ -253,87 +254,271 @@ int LuaUtils::Restore(const std::vector<LuaUtils::DataDump> &backup, lua_State*
 }
 
 
-int LuaUtils::ShallowBackup(std::vector<LuaUtils::ShallowDataDump> &backup, lua_State* src, int count) {
-	const int srcTop = lua_gettop(src);
-	if (srcTop < count)
-		return 0;
-
-	const int startIndex = (srcTop - count + 1);
-	const int endIndex   = srcTop;
-
-	for(int i = startIndex; i <= endIndex; ++i) {
-		const int type = lua_type(src, i);
-		ShallowDataDump sdd;
-		sdd.type = type;
-		switch (type) {
+/******************************************************************************/
+/******************************************************************************/
+//
+//  PackedData
+//
+//  value   := NIL | FALSE | TRUE | NUMBER <lua_Number>
+//           | STRING <varint len> <bytes> | STRING_REF <varint index>
+//           | TABLE <uint32 narr> <uint32 nrec> (<key value> <value>)*
+//  (narr and nrec are patched in after the table was written; pairs whose
+//  key can not be packed are skipped, tables nested too deep become nil)
+//
+
+enum {
+	PACKED_NIL = 0,
+	PACKED_FALSE,
+	PACKED_TRUE,
+	PACKED_NUMBER,
+	PACKED_STRING,
+	PACKED_STRING_REF,
+	PACKED_TABLE,
+};
+
+
+class CDataPacker {
+public:
+	CDataPacker(std::vector<unsigned char>& _buffer): buffer(_buffer), stringSlots(64, -1) {}
+
+	void PackValue(lua_State* src, int index, int depth) {
+		switch (lua_type(src, index)) {
 			case LUA_TBOOLEAN: {
-				sdd.data.bol = lua_toboolean(src, i);
-				break;
-			}
+				buffer.push_back(lua_toboolean(src, index)? PACKED_TRUE: PACKED_FALSE);
+			} break;
 			case LUA_TNUMBER: {
-				sdd.data.num = lua_tonumber(src, i);
-				break;
-			}
+				const lua_Number num = lua_tonumber(src, index);
+				buffer.push_back(PACKED_NUMBER);
+				Write(&num, sizeof(num));
+			} break;
 			case LUA_TSTRING: {
-				size_t len = 0;
-				const char* data = lua_tolstring(src, i, &len);
-				sdd.data.str = new std::string;
-				if (len > 0) {
-					sdd.data.str->resize(len);
-					memcpy(&(*sdd.data.str)[0], data, len);
-				}
-				break;
-			}
-			case LUA_TNIL: {
-				break;
-			}
+				PackString(src, index);
+			} break;
+			case LUA_TTABLE: {
+				PackTable(src, index, depth);
+			} break;
 			default: {
-				LOG_L(L_WARNING, "ShallowBackup: Invalid type for argument %d", i);
-				break; // nil
-			}
+				buffer.push_back(PACKED_NIL);
+			} break;
 		}
-		backup.push_back(sdd);
 	}
 
-	return count;
-}
+private:
+	void Write(const void* data, size_t size) {
+		const size_t pos = buffer.size();
+		buffer.resize(pos + size);
+		memcpy(&buffer[pos], data, size);
+	}
 
+	void WriteVarInt(boost::uint32_t value) {
+		while (value >= 0x80) {
+			buffer.push_back((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		buffer.push_back(value);
+	}
 
-int LuaUtils::ShallowRestore(const std::vector<LuaUtils::ShallowDataDump> &backup, lua_State* dst) {
-	int count = backup.size();
-	lua_checkstack(dst, count);
+	void PackString(lua_State* src, int index) {
+		size_t len = 0;
+		const char* str = lua_tolstring(src, index, &len);
 
-	for (int d = 0; d < count; ++d) {
-		const ShallowDataDump &sdd = backup[d];
-		switch (sdd.type) {
-			case LUA_TBOOLEAN: {
-				lua_pushboolean(dst, sdd.data.bol);
-				break;
-			}
-			case LUA_TNUMBER: {
-				lua_pushnumber(dst, sdd.data.num);
-				break;
+		// strings are interned by Lua, so equal strings share their address
+		const size_t mask = stringSlots.size() - 1;
+		size_t slot = (reinterpret_cast<size_t>(str) >> 4) & mask;
+
+		for (; stringSlots[slot] >= 0; slot = (slot + 1) & mask) {
+			if (strings[stringSlots[slot]] == str) {
+				buffer.push_back(PACKED_STRING_REF);
+				WriteVarInt(stringSlots[slot]);
+				return;
 			}
-			case LUA_TSTRING: {
-				lua_pushlstring(dst, sdd.data.str->c_str(), sdd.data.str->size());
-				delete sdd.data.str;
-				break;
+		}
+
+		stringSlots[slot] = strings.size();
+		strings.push_back(str);
+
+		buffer.push_back(PACKED_STRING);
+		WriteVarInt(len);
+		Write(str, len);
+
+		if ((strings.size() * 2) > stringSlots.size()) {
+			Rehash(stringSlots.size() * 2);
+		}
+	}
+
+	void PackTable(lua_State* src, int index, int depth) {
+		if (depth++ > maxDepth) {
+			buffer.push_back(PACKED_NIL);
+			return;
+		}
+
+		buffer.push_back(PACKED_TABLE);
+
+		const size_t sizesPos = buffer.size();
+		boost::uint32_t sizes[2] = {0, 0};
+		Write(sizes, sizeof(sizes));
+
+		const int table = PosLuaIndex(src, index);
+
+		for (lua_pushnil(src); lua_next(src, table) != 0; lua_pop(src, 1)) {
+			const int keyType = lua_type(src, -2);
+
+			if (keyType != LUA_TBOOLEAN && keyType != LUA_TNUMBER && keyType != LUA_TSTRING && keyType != LUA_TTABLE)
+				continue;
+			if (keyType == LUA_TTABLE && depth > maxDepth)
+				continue;
+
+			// only a hint for lua_createtable
+			if (keyType == LUA_TNUMBER && lua_tonumber(src, -2) >= 1.0f) {
+				sizes[0]++;
+			} else {
+				sizes[1]++;
 			}
-			case LUA_TNIL: {
-				lua_pushnil(dst);
-				break;
+
+			PackValue(src, -2, depth);
+			PackValue(src, -1, depth);
+		}
+
+		memcpy(&buffer[sizesPos], sizes, sizeof(sizes));
+	}
+
+	void Rehash(size_t numSlots) {
+		// probing masks the hash, the size must stay a power of two
+		assert((numSlots & (numSlots - 1)) == 0);
+
+		stringSlots.clear();
+		stringSlots.resize(numSlots, -1);
+
+		const size_t mask = stringSlots.size() - 1;
+
+		for (size_t n = 0; n < strings.size(); n++) {
+			size_t slot = (reinterpret_cast<size_t>(strings[n]) >> 4) & mask;
+
+			while (stringSlots[slot] >= 0) {
+				slot = (slot + 1) & mask;
 			}
+
+			stringSlots[slot] = n;
+		}
+	}
+
+private:
+	std::vector<unsigned char>& buffer;
+
+	std::vector<const char*> strings;
+	std::vector<int> stringSlots; ///< open-addressing table of indices into strings, power-of-two sized
+};
+
+
+class CDataUnpacker {
+public:
+	CDataUnpacker(const std::vector<unsigned char>& _buffer): buffer(_buffer), pos(0) {}
+
+	void UnpackValue(lua_State* dst) {
+		switch (buffer[pos++]) {
+			case PACKED_FALSE: {
+				lua_pushboolean(dst, false);
+			} break;
+			case PACKED_TRUE: {
+				lua_pushboolean(dst, true);
+			} break;
+			case PACKED_NUMBER: {
+				lua_Number num;
+				Read(&num, sizeof(num));
+				lua_pushnumber(dst, num);
+			} break;
+			case PACKED_STRING: {
+				const size_t len = ReadVarInt();
+				const char* str = reinterpret_cast<const char*>(&buffer[0] + pos);
+
+				strings.push_back(std::pair<size_t, size_t>(pos, len));
+				lua_pushlstring(dst, str, len);
+				pos += len;
+			} break;
+			case PACKED_STRING_REF: {
+				const std::pair<size_t, size_t>& s = strings[ReadVarInt()];
+				lua_pushlstring(dst, reinterpret_cast<const char*>(&buffer[0] + s.first), s.second);
+			} break;
+			case PACKED_TABLE: {
+				boost::uint32_t sizes[2];
+				Read(sizes, sizeof(sizes));
+
+				lua_checkstack(dst, 3);
+				lua_createtable(dst, sizes[0], sizes[1]);
+
+				for (boost::uint32_t n = 0; n < (sizes[0] + sizes[1]); n++) {
+					UnpackValue(dst); // key
+					UnpackValue(dst); // value
+					lua_rawset(dst, -3);
+				}
+			} break;
 			default: {
 				lua_pushnil(dst);
-				LOG_L(L_WARNING, "ShallowRestore: Invalid type for argument %d", d + 1);
-				break; // unhandled type
-			}
+			} break;
 		}
 	}
 
+private:
+	void Read(void* data, size_t size) {
+		memcpy(data, &buffer[pos], size);
+		pos += size;
+	}
+
+	boost::uint32_t ReadVarInt() {
+		boost::uint32_t value = 0;
+
+		for (int shift = 0; ; shift += 7) {
+			const unsigned char byte = buffer[pos++];
+			value |= (boost::uint32_t(byte & 0x7F) << shift);
+
+			if ((byte & 0x80) == 0)
+				break;
+		}
+
+		return value;
+	}
+
+private:
+	const std::vector<unsigned char>& buffer;
+	size_t pos;
+
+	std::vector< std::pair<size_t, size_t> > strings; ///< (offset, length) of each PACKED_STRING read so far
+};
+
+
+int LuaUtils::Pack(PackedData& packed, lua_State* src, int count)
+{
+	const int srcTop = lua_gettop(src);
+	if (srcTop < count)
+		return 0;
+
+	packed.clear();
+
+	CDataPacker packer(packed.buffer);
+
+	for (int i = (srcTop - count + 1); i <= srcTop; i++) {
+		packer.PackValue(src, i, 0);
+	}
+
+	packed.count = count;
 	return count;
 }
 
+
+int LuaUtils::Unpack(const PackedData& packed, lua_State* dst)
+{
+	lua_checkstack(dst, packed.count);
+
+	CDataUnpacker unpacker(packed.buffer);
+
+	for (int i = 0; i < packed.count; i++) {
+		unpacker.UnpackValue(dst);
+	}
+
+	return packed.count;
+}
+
+
 /******************************************************************************/
 /******************************************************************************/
 
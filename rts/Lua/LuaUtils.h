@@ -28,22 +28,41 @@ class LuaUtils {
 			bool bol;
 			std::vector<std::pair<DataDump, DataDump> > table;
 		};
-		struct ShallowDataDump {
-			int type;
-			union {
-				std::string *str;
-				float num;
-				bool bol;
-			} data;
+
+		/**
+		 * Values (nil, booleans, numbers, strings and tables of these)
+		 * serialized into a single buffer, used to hand data from one
+		 * lua_State to another that runs on a different thread. Every
+		 * distinct string is stored once, repeats refer back to it.
+		 */
+		class PackedData {
+		public:
+			PackedData() : count(0) {}
+
+			void clear() { buffer.clear(); count = 0; }
+			void swap(PackedData& pd) { buffer.swap(pd.buffer); std::swap(count, pd.count); }
+
+			bool empty() const { return (count == 0); }
+			/// number of top-level values
+			int size() const { return count; }
+			size_t GetNumBytes() const { return buffer.size(); }
+
+		private:
+			friend class LuaUtils;
+
+			std::vector<unsigned char> buffer;
+			int count;
 		};
 
 		static int Backup(std::vector<DataDump> &backup, lua_State* src, int count);
 
 		static int Restore(const std::vector<DataDump> &backup, lua_State* dst);
 
-		static int ShallowBackup(std::vector<ShallowDataDump> &backup, lua_State* src, int count);
+		/// replaces the contents of packed by the top <count> values of src
+		static int Pack(PackedData& packed, lua_State* src, int count);
 
-		static int ShallowRestore(const std::vector<ShallowDataDump> &backup, lua_State* dst);
+		/// pushes all values of packed onto dst
+		static int Unpack(const PackedData& packed, lua_State* dst);
 
 		static int CopyData(lua_State* dst, lua_State* src, int count);
 
@@ -0,0 +1,372 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+
+#include "LuaVBOs.h"
+
+#include "LuaInclude.h"
+
+#include "LuaHandle.h"
+#include "LuaHashString.h"
+#include "LuaOpenGL.h"
+#include "LuaUtils.h"
+
+#include "Rendering/GL/VBO.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+
+struct VBOVertex {
+	float pos[3];
+	float normal[3];
+	float texCoord[2];
+	float color[4];
+};
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+LuaVBOs::LuaVBOs()
+{
+}
+
+
+LuaVBOs::~LuaVBOs()
+{
+	set<VBO*>::const_iterator it;
+	for (it = vbos.begin(); it != vbos.end(); ++it) {
+		const VBO* vbo = *it;
+		delete vbo->buffer;
+	}
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+bool LuaVBOs::PushEntries(lua_State* L)
+{
+	CreateMetatable(L);
+
+#define REGISTER_LUA_CFUNC(x) \
+	lua_pushstring(L, #x);      \
+	lua_pushcfunction(L, x);    \
+	lua_rawset(L, -3)
+
+	REGISTER_LUA_CFUNC(CreateVBO);
+	REGISTER_LUA_CFUNC(UpdateVBO);
+	REGISTER_LUA_CFUNC(DrawVBO);
+	REGISTER_LUA_CFUNC(DeleteVBO);
+
+	return true;
+}
+
+
+bool LuaVBOs::CreateMetatable(lua_State* L)
+{
+	luaL_newmetatable(L, "VBO");
+	HSTR_PUSH_CFUNC(L, "__gc",        meta_gc);
+	HSTR_PUSH_CFUNC(L, "__index",     meta_index);
+	HSTR_PUSH_CFUNC(L, "__newindex",  meta_newindex);
+	lua_pop(L, 1);
+	return true;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+inline void CheckDrawingEnabled(lua_State* L, const char* caller)
+{
+	if (!LuaOpenGL::IsDrawingEnabled(L)) {
+		luaL_error(L, "%s(): OpenGL calls can only be used in Draw() "
+		              "call-ins, or while creating display lists", caller);
+	}
+
+	LuaOpenGL::FlushBatch();
+}
+
+
+/**
+ * parses an array of gl.Shape-style vertex tables ({v = {x, y, z}, n = {...},
+ * t = {s, t}, c = {r, g, b, a}}), attributes a vertex does not specify take
+ * the gl.Shape defaults
+ */
+static void ParseVertices(lua_State* L, const char* caller, int table, std::vector<VBOVertex>& verts,
+                          bool& hasNormals, bool& hasTexCoords, bool& hasColors)
+{
+	for (int i = 1; lua_rawgeti(L, table, i), lua_istable(L, -1); lua_pop(L, 1), i++) {
+		const int row = lua_gettop(L);
+
+		VBOVertex v;
+		std::memset(&v, 0, sizeof(VBOVertex));
+		v.normal[1] = 1.0f;
+		v.color[0] = v.color[1] = v.color[2] = v.color[3] = 1.0f;
+
+		bool hasVert = false;
+
+		for (lua_pushnil(L); lua_next(L, row) != 0; lua_pop(L, 1)) {
+			if (!lua_istable(L, -1) || !lua_israwstring(L, -2)) {
+				luaL_error(L, "%s(): bad vertex data row", caller);
+			}
+
+			const std::string key = lua_tostring(L, -2);
+
+			if ((key == "v") || (key == "vertex")) {
+				if (LuaUtils::ParseFloatArray(L, -1, v.pos, 3) < 2) {
+					luaL_error(L, "%s(): bad vertex array", caller);
+				}
+				hasVert = true;
+			}
+			else if ((key == "n") || (key == "normal")) {
+				if (LuaUtils::ParseFloatArray(L, -1, v.normal, 3) != 3) {
+					luaL_error(L, "%s(): bad normal array", caller);
+				}
+				hasNormals = true;
+			}
+			else if ((key == "t") || (key == "texcoord")) {
+				if (LuaUtils::ParseFloatArray(L, -1, v.texCoord, 2) != 2) {
+					luaL_error(L, "%s(): bad texcoord array", caller);
+				}
+				hasTexCoords = true;
+			}
+			else if ((key == "c") || (key == "color")) {
+				LuaUtils::ParseFloatArray(L, -1, v.color, 4);
+				hasColors = true;
+			}
+		}
+
+		if (!hasVert) {
+			luaL_error(L, "%s(): vertex %d has no position", caller, i);
+		}
+
+		verts.push_back(v);
+	}
+
+	lua_pop(L, 1);
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+const LuaVBOs::VBO* LuaVBOs::GetLuaVBO(lua_State* L, int index)
+{
+	return static_cast<VBO*>(LuaUtils::GetUserData(L, index, "VBO"));
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+void LuaVBOs::VBO::Init()
+{
+	buffer       = NULL;
+	primType     = GL_TRIANGLES;
+	numVerts     = 0;
+	hasNormals   = false;
+	hasTexCoords = false;
+	hasColors    = false;
+}
+
+
+void LuaVBOs::VBO::Free(lua_State* L)
+{
+	if (buffer == NULL) {
+		return;
+	}
+
+	delete buffer;
+	buffer = NULL;
+
+	CLuaHandle::GetActiveVBOs(L).vbos.erase(this);
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+int LuaVBOs::meta_gc(lua_State* L)
+{
+	VBO* vbo = static_cast<VBO*>(luaL_checkudata(L, 1, "VBO"));
+	vbo->Free(L);
+	return 0;
+}
+
+
+int LuaVBOs::meta_index(lua_State* L)
+{
+	const VBO* vbo = static_cast<VBO*>(luaL_checkudata(L, 1, "VBO"));
+	const std::string key = luaL_checkstring(L, 2);
+	if (key == "valid") {
+		lua_pushboolean(L, vbo->buffer != NULL);
+	}
+	else if (key == "type")      { lua_pushnumber(L, vbo->primType);      }
+	else if (key == "count")     { lua_pushnumber(L, vbo->numVerts);      }
+	else if (key == "normals")   { lua_pushboolean(L, vbo->hasNormals);   }
+	else if (key == "texcoords") { lua_pushboolean(L, vbo->hasTexCoords); }
+	else if (key == "colors")    { lua_pushboolean(L, vbo->hasColors);    }
+	else {
+		return 0;
+	}
+	return 1;
+}
+
+
+int LuaVBOs::meta_newindex(lua_State* L)
+{
+	return 0;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+int LuaVBOs::CreateVBO(lua_State* L)
+{
+	const GLenum primType = (GLenum)luaL_checkint(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	const GLenum usage = (GLenum)luaL_optint(L, 3, GL_STATIC_DRAW);
+
+	VBO vbo;
+	vbo.Init();
+	vbo.primType = primType;
+
+	std::vector<VBOVertex> verts;
+	ParseVertices(L, __FUNCTION__, 2, verts, vbo.hasNormals, vbo.hasTexCoords, vbo.hasColors);
+
+	if (verts.empty()) {
+		return 0;
+	}
+
+	vbo.numVerts = verts.size();
+	vbo.buffer = new ::VBO(GL_ARRAY_BUFFER);
+	vbo.buffer->Bind(GL_ARRAY_BUFFER);
+	vbo.buffer->Resize(verts.size() * sizeof(VBOVertex), usage, &verts[0]);
+	vbo.buffer->Unbind();
+
+	VBO* vboPtr = static_cast<VBO*>(lua_newuserdata(L, sizeof(VBO)));
+	*vboPtr = vbo;
+
+	luaL_getmetatable(L, "VBO");
+	lua_setmetatable(L, -2);
+
+	CLuaHandle::GetActiveVBOs(L).vbos.insert(vboPtr);
+
+	return 1;
+}
+
+
+int LuaVBOs::UpdateVBO(lua_State* L)
+{
+	VBO* vbo = static_cast<VBO*>(luaL_checkudata(L, 1, "VBO"));
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	if (vbo->buffer == NULL) {
+		return 0;
+	}
+
+	const int first = luaL_optint(L, 3, 1) - 1;
+
+	std::vector<VBOVertex> verts;
+	ParseVertices(L, __FUNCTION__, 2, verts, vbo->hasNormals, vbo->hasTexCoords, vbo->hasColors);
+
+	if ((first < 0) || ((first + verts.size()) > size_t(vbo->numVerts))) {
+		luaL_error(L, "%s(): vertices %d to %d are out of range", __FUNCTION__, first + 1, first + int(verts.size()));
+	}
+	if (verts.empty()) {
+		return 0;
+	}
+
+	const GLsizeiptr size = verts.size() * sizeof(VBOVertex);
+
+	vbo->buffer->Bind(GL_ARRAY_BUFFER);
+	GLubyte* mem = vbo->buffer->MapBuffer(first * sizeof(VBOVertex), size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+	if (mem != NULL) {
+		std::memcpy(mem, &verts[0], size);
+	}
+	vbo->buffer->UnmapBuffer();
+	vbo->buffer->Unbind();
+
+	return 0;
+}
+
+
+int LuaVBOs::DrawVBO(lua_State* L)
+{
+	CheckDrawingEnabled(L, __FUNCTION__);
+
+	const VBO* vbo = static_cast<VBO*>(luaL_checkudata(L, 1, "VBO"));
+
+	if (vbo->buffer == NULL) {
+		return 0;
+	}
+
+	const int first = std::max(0, luaL_optint(L, 2, 1) - 1);
+	const int count = std::min(luaL_optint(L, 3, vbo->numVerts - first), vbo->numVerts - first);
+
+	if (count <= 0) {
+		return 0;
+	}
+
+	const ::VBO* buffer = vbo->buffer;
+	const GLsizei stride = sizeof(VBOVertex);
+	const bool hasAttribs = (vbo->hasNormals || vbo->hasTexCoords || vbo->hasColors);
+
+	// the current attributes are undefined after drawing with arrays
+	if (hasAttribs) {
+		glPushAttrib(GL_CURRENT_BIT);
+	}
+
+	buffer->Bind(GL_ARRAY_BUFFER);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, stride, buffer->GetPtr(offsetof(VBOVertex, pos)));
+
+	if (vbo->hasNormals) {
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, stride, buffer->GetPtr(offsetof(VBOVertex, normal)));
+	}
+	if (vbo->hasTexCoords) {
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, stride, buffer->GetPtr(offsetof(VBOVertex, texCoord)));
+	}
+	if (vbo->hasColors) {
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(4, GL_FLOAT, stride, buffer->GetPtr(offsetof(VBOVertex, color)));
+	}
+
+	glDrawArrays(vbo->primType, first, count);
+
+	if (vbo->hasColors)    { glDisableClientState(GL_COLOR_ARRAY);         }
+	if (vbo->hasTexCoords) { glDisableClientState(GL_TEXTURE_COORD_ARRAY); }
+	if (vbo->hasNormals)   { glDisableClientState(GL_NORMAL_ARRAY);        }
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	buffer->Unbind();
+
+	if (hasAttribs) {
+		glPopAttrib();
+	}
+
+	return 0;
+}
+
+
+int LuaVBOs::DeleteVBO(lua_State* L)
+{
+	if (lua_isnil(L, 1)) {
+		return 0;
+	}
+	VBO* vbo = static_cast<VBO*>(luaL_checkudata(L, 1, "VBO"));
+	vbo->Free(L);
+	return 0;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
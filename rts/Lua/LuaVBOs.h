@@ -0,0 +1,64 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_VBOS_H
+#define LUA_VBOS_H
+
+#include <set>
+using std::set;
+
+#include "Rendering/GL/myGL.h"
+
+class VBO;
+struct lua_State;
+
+
+/**
+ * Retained vertex buffers for Lua, filled once (or partially updated) from
+ * gl.Shape-style vertex tables and drawn with a single call, as a replacement
+ * for display lists that only contain geometry.
+ */
+class LuaVBOs {
+	public:
+		LuaVBOs();
+		~LuaVBOs();
+
+		static bool PushEntries(lua_State* L);
+
+		struct VBO;
+		static const VBO* GetLuaVBO(lua_State* L, int index);
+
+	public:
+		struct VBO {
+			void Init();
+			void Free(lua_State* L);
+
+			::VBO* buffer;
+
+			GLenum primType;
+			GLsizei numVerts;
+
+			bool hasNormals;
+			bool hasTexCoords;
+			bool hasColors;
+		};
+
+	private:
+		set<VBO*> vbos;
+
+	private: // helpers
+		static bool CreateMetatable(lua_State* L);
+
+	private: // metatable methods
+		static int meta_gc(lua_State* L);
+		static int meta_index(lua_State* L);
+		static int meta_newindex(lua_State* L);
+
+	private: // call-outs
+		static int CreateVBO(lua_State* L);
+		static int UpdateVBO(lua_State* L);
+		static int DrawVBO(lua_State* L);
+		static int DeleteVBO(lua_State* L);
+};
+
+
+#endif /* LUA_VBOS_H */
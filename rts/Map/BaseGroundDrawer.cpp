@@ -34,6 +34,7 @@ CBaseGroundDrawer::CBaseGroundDrawer()
 
 	infoTexAlpha = 0.25f;
 	infoTex = 0;
+	infoTexRevision = 0;
 
 	drawMode = drawNormal;
 	drawLineOfSight = false;
@@ -478,6 +479,7 @@ bool CBaseGroundDrawer::UpdateExtraTexture()
 
 			highResInfoTex = highResInfoTexWanted;
 			updateTextureState = 0;
+			infoTexRevision++;
 			return true;
 		}
 
@@ -490,6 +492,7 @@ bool CBaseGroundDrawer::UpdateExtraTexture()
 		extraTexPBO.Unbind(false);
 
 		updateTextureState=0;
+		infoTexRevision++;
 		return true;
 	}
 
@@ -87,6 +87,8 @@ public:
 	int updateTextureState;
 
 	GLuint infoTex;
+	/// incremented on every upload of infoTex
+	unsigned int infoTexRevision;
 	PBO extraTexPBO;
 	bool highResInfoTex;
 	bool highResInfoTexWanted;
@@ -42,6 +42,9 @@ CBasicMapDamage::CBasicMapDamage()
 
 	mapHardness = mapInfo->map.hardness;
 
+	// a single rectangle may cover the entire map
+	recalcRects.maxAreaPerRect = gs->mapx * gs->mapy;
+
 	disabled = false;
 }
 
@@ -250,10 +253,25 @@ void CBasicMapDamage::Update()
 			}
 		}
 		if (e->ttl == 0) {
-			RecalcArea(x1 - 2, x2 + 2, y1 - 2, y2 + 2);
+			recalcRects.push_back(SRectangle(x1 - 2, y1 - 2, x2 + 2, y2 + 2));
 		}
 	}
 
+	if (!recalcRects.empty()) {
+		// the derived maps only depend on the final heights, so
+		// recalculating the merged areas once gives the same result
+		recalcRects.Optimize();
+
+		profiler.AddCounter("MapDamage::RecalcArea rects", recalcRects.size());
+		profiler.AddCounter("MapDamage::RecalcArea area", recalcRects.GetTotalArea());
+
+		for (CRectangleOptimizer::iterator ri = recalcRects.begin(); ri != recalcRects.end(); ++ri) {
+			RecalcArea(ri->x1, ri->x2, ri->z1, ri->z2);
+		}
+
+		recalcRects.clear();
+	}
+
 	while (!explosions.empty() && explosions.front()->ttl == 0) {
 		delete explosions.front();
 		explosions.pop_front();
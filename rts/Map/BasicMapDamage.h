@@ -4,6 +4,7 @@
 #define _BASIC_MAP_DAMAGE_H
 
 #include "MapDamage.h"
+#include "System/Misc/RectangleOptimizer.h"
 
 #include <deque>
 #include <vector>
@@ -46,6 +47,13 @@ private:
 
 	std::deque<Explo*> explosions;
 
+	/**
+	 * Areas of the explosions that finished during the current Update(),
+	 * merged so that overlapping craters (eg. from a salvo) recalculate
+	 * their derived maps, pathing and features only once per frame.
+	 */
+	CRectangleOptimizer recalcRects;
+
 	struct RelosSquare {
 		int x;
 		int y;
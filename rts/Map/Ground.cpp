@@ -213,7 +213,108 @@ inline static bool ClampInMapHeight(float3& from, float3& to)
 }
 
 
+// a ray segment (or the part of it inside some cell) whose lowest point
+// is more than this above the cell's max-height can not hit any face in
+// the cell (covers rounding in LineGroundSquareCol's containment tests)
+static const float MAX_HEIGHT_MIPS_EPS = 1.0f;
+
+struct MaxHeightMipsRay {
+	const float* hm;
+	const float3* nm;
+
+	float3 from;
+	float3 to;
+	float3 dir; // to - from, not normalized
+};
+
+/**
+ * Tests the ray against the max-height texel (mip, cx, cz) and if the ray's
+ * part [t0, t1] inside it is not provably above terrain recurses into the
+ * (up to four) children that part crosses, in ray order; at mip 0 the faces
+ * of square (cx, cz) are tested, so hits are the same as when visiting all
+ * squares along the ray.
+ */
+static float LineGroundColMaxHeightMip(const MaxHeightMipsRay& ray, const int mip, const int cx, const int cz, const float t0, const float t1)
+{
+	const float* maxHeights = readmap->GetMaxHeightMapSynced(mip);
+
+	const float ry0 = ray.from.y + ray.dir.y * t0;
+	const float ry1 = ray.from.y + ray.dir.y * t1;
+
+	if (std::min(ry0, ry1) > (maxHeights[cz * readmap->GetMaxHeightMapSizeX(mip) + cx] + MAX_HEIGHT_MIPS_EPS))
+		return -2.0f;
+
+	if (mip == 0)
+		return LineGroundSquareCol(ray.hm, ray.nm, ray.from, ray.to, cx, cz);
+
+	const int cmip = mip - 1;
+	const int cmipSizeX = readmap->GetMaxHeightMapSizeX(cmip);
+	const int cmipSizeZ = readmap->GetMaxHeightMapSizeZ(cmip);
+
+	// planes splitting this texel into its children
+	const float xm = (((cx * 2 + 1) << cmip) * SQUARE_SIZE);
+	const float zm = (((cz * 2 + 1) << cmip) * SQUARE_SIZE);
+
+	// ray parameters at which the planes are crossed (-1 if never)
+	float tx = (ray.dir.x != 0.0f)? ((xm - ray.from.x) / ray.dir.x): -1.0f;
+	float tz = (ray.dir.z != 0.0f)? ((zm - ray.from.z) / ray.dir.z): -1.0f;
+
+	// child (side of each plane) the ray is in at t0
+	int sx = (ray.dir.x > 0.0f)? (t0 >= tx): ((ray.dir.x < 0.0f)? (t0 < tx): (ray.from.x >= xm));
+	int sz = (ray.dir.z > 0.0f)? (t0 >= tz): ((ray.dir.z < 0.0f)? (t0 < tz): (ray.from.z >= zm));
+
+	for (float ta = t0; ; ) {
+		float tb = t1;
+
+		bool crossX = false;
+		bool crossZ = false;
+
+		if (tx > ta && tx < tb) { tb = tx; crossX = true; }
+		if (tz > ta && tz < tb) { tb = tz; crossX = false; crossZ = true; }
+		if (tz > ta && tz == tb) { crossZ = true; }
+
+		const int ccx = cx * 2 + sx;
+		const int ccz = cz * 2 + sz;
+
+		if (ccx < cmipSizeX && ccz < cmipSizeZ) {
+			const float ret = LineGroundColMaxHeightMip(ray, cmip, ccx, ccz, ta, tb);
+
+			if (ret >= 0.0f)
+				return ret;
+		}
+
+		if (!crossX && !crossZ)
+			break;
+
+		if (crossX) { sx ^= 1; tx = -1.0f; }
+		if (crossZ) { sz ^= 1; tz = -1.0f; }
+
+		ta = tb;
+	}
+
+	return -2.0f;
+}
+
+static float LineGroundColMaxHeightMips(const float* hm, const float3* nm, const float3& from, const float3& to)
+{
+	MaxHeightMipsRay ray;
+	ray.hm = hm;
+	ray.nm = nm;
+	ray.from = from;
+	ray.to = to;
+	ray.dir = to - from;
+
+	// start at the single texel covering the whole map
+	return LineGroundColMaxHeightMip(ray, readmap->GetNumMaxHeightMaps() - 1, 0, 0, 0.0f, 1.0f);
+}
+
+
 float CGround::LineGroundCol(float3 from, float3 to, bool synced) const
+{
+	return LineGroundCol(from, to, synced, true);
+}
+
+float CGround::LineGroundCol(float3 from, float3 to, bool synced, bool useMaxHeightMips) const
 {
 	const float* hm  = readmap->GetCornerHeightMap(synced);
 	const float3* nm = readmap->GetFaceNormals(synced);
@@ -250,6 +351,20 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced) const
 		}
 	}
 
+	const float ret = (synced && useMaxHeightMips)?
+		LineGroundColMaxHeightMips(hm, nm, from, to):
+		LineGroundColSquares(hm, nm, from, to);
+
+	if (ret >= 0.0f) {
+		return (ret + skippedDist);
+	}
+
+	return -1.0f;
+}
+
+
+float CGround::LineGroundColSquares(const float* hm, const float3* nm, const float3& from, const float3& to) const
+{
 	const float dx = to.x - from.x;
 	const float dz = to.z - from.z;
 	const int dirx = (dx > 0.0f) ? 1 : -1;
@@ -273,7 +388,7 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced) const
 		const float ret = LineGroundSquareCol(hm, nm,  from, to,  fsx, fsz);
 
 		if (ret >= 0.0f) {
-			return (ret + skippedDist);
+			return ret;
 		}
 	} else if (fsx == tsx) {
 		// ray is parallel to z-axis
@@ -283,7 +398,7 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced) const
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  fsx, zp);
 
 			if (ret >= 0.0f) {
-				return (ret + skippedDist);
+				return ret;
 			}
 
 			keepgoing = (zp != tsz);
@@ -298,7 +413,7 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced) const
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  xp, fsz);
 
 			if (ret >= 0.0f) {
-				return (ret + skippedDist);
+				return ret;
 			}
 
 			keepgoing = (xp != tsx);
@@ -336,7 +451,7 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced) const
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  curx, curz);
 
 			if (ret >= 0.0f) {
-				return (ret + skippedDist);
+				return ret;
 			}
 
 			// check if we reached the end already and need to stop the loop
@@ -497,6 +612,11 @@ float3 CGround::GetSmoothNormal(float x, float y, bool synced) const
 }
 
 float CGround::TrajectoryGroundCol(float3 from, const float3& flatdir, float length, float linear, float quadratic) const
+{
+	return TrajectoryGroundCol(from, flatdir, length, linear, quadratic, true);
+}
+
+float CGround::TrajectoryGroundCol(float3 from, const float3& flatdir, float length, float linear, float quadratic, bool useMaxHeightMips) const
 {
 	float3 dir(flatdir.x, linear, flatdir.z);
 
@@ -510,7 +630,22 @@ float CGround::TrajectoryGroundCol(float3 from, const float3& flatdir, float len
 	const float near = length * std::max(0.0f, near_far.first);
 	const float far  = length * std::min(1.0f, near_far.second);
 
+	// samples before <skipEnd> are known to be above terrain, no skip
+	// is attempted for samples before <noSkipEnd> (the last attempt's
+	// smallest texel already reached down to the trajectory there)
+	float skipEnd = near;
+	float noSkipEnd = near;
+
 	for (float l = near; l < far; l += SQUARE_SIZE) {
+		if (l < skipEnd)
+			continue;
+
+		if (useMaxHeightMips && l >= noSkipEnd) {
+			if ((skipEnd = TrajectorySkipEnd(from, dir, quadratic, l, far, &noSkipEnd)) > l) {
+				continue;
+			}
+		}
+
 		float3 pos(from + dir*l);
 		pos.y += quadratic * l * l;
 
@@ -521,3 +656,71 @@ float CGround::TrajectoryGroundCol(float3 from, const float3& flatdir, float len
 
 	return -1.0f;
 }
+
+
+/**
+ * Finds how far the trajectory sampled at <l> stays above terrain, using
+ * the largest max-height texel around the sample that it provably clears.
+ * Returns the sample distance up to which no height lookups are needed
+ * (<= l if none can be skipped), see TrajectoryGroundCol.
+ */
+float CGround::TrajectorySkipEnd(const float3& from, const float3& dir, float quadratic, float l, float far, float* noSkipEnd) const
+{
+	// smallest texel worth testing is 4x4 squares (4 samples)
+	static const int minSkipMip = 2;
+
+	// samples closer than this to a texel border are not skipped,
+	// they might round into the neighboring texel's squares
+	static const float skipMargin = 1.0f;
+
+	const float3 pos = from + dir * l;
+
+	const int sx = Clamp(int(pos.x) / SQUARE_SIZE, 0, gs->mapxm1);
+	const int sz = Clamp(int(pos.z) / SQUARE_SIZE, 0, gs->mapym1);
+
+	float skipEnd = l;
+
+	for (int mip = minSkipMip; mip < readmap->GetNumMaxHeightMaps(); mip++) {
+		const int cx = sx >> mip;
+		const int cz = sz >> mip;
+
+		// distance at which the flat path leaves the texel
+		float lx = far;
+		float lz = far;
+
+		if (dir.x > 0.0f) { lx = (((cx + 1) << mip) * SQUARE_SIZE - from.x) / dir.x; }
+		if (dir.x < 0.0f) { lx = (((cx    ) << mip) * SQUARE_SIZE - from.x) / dir.x; }
+		if (dir.z > 0.0f) { lz = (((cz + 1) << mip) * SQUARE_SIZE - from.z) / dir.z; }
+		if (dir.z < 0.0f) { lz = (((cz    ) << mip) * SQUARE_SIZE - from.z) / dir.z; }
+
+		const float lexit = std::min(far, std::min(lx, lz));
+
+		// lowest point of the trajectory in [l, lexit]; the parabola can
+		// only dip below both ends if it opens upward (quadratic > 0)
+		float miny = std::min(
+			from.y + dir.y * l     + quadratic * l     * l,
+			from.y + dir.y * lexit + quadratic * lexit * lexit);
+
+		if (quadratic > 0.0f) {
+			const float lv = -dir.y / (2.0f * quadratic);
+
+			if (lv > l && lv < lexit) {
+				miny = std::min(miny, from.y + dir.y * lv + quadratic * lv * lv);
+			}
+		}
+
+		const float* maxHeights = readmap->GetMaxHeightMapSynced(mip);
+
+		if (miny <= (maxHeights[cz * readmap->GetMaxHeightMapSizeX(mip) + cx] + MAX_HEIGHT_MIPS_EPS)) {
+			// larger texels contain this one, they can not be cleared either
+			if (mip == minSkipMip)
+				*noSkipEnd = lexit;
+
+			break;
+		}
+
+		skipEnd = lexit - skipMargin;
+	}
+
+	return skipEnd;
+}
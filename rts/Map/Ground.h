@@ -36,7 +36,20 @@ public:
 		return std::max(0, std::min(gs->mapxm1, (int(pos.x) / SQUARE_SIZE))) +
 			std::max(0, std::min(gs->mapym1, (int(pos.z) / SQUARE_SIZE))) * gs->mapx;
 	};
+
+	/// for benchmarking only: synced tests with or without the max-height mipmaps
+	float LineGroundColBenchmark(const float3& from, const float3& to, bool useMaxHeightMips) const {
+		return LineGroundCol(from, to, true, useMaxHeightMips);
+	}
+	float TrajectoryGroundColBenchmark(const float3& from, const float3& flatdir, float length, float linear, float quadratic, bool useMaxHeightMips) const {
+		return TrajectoryGroundCol(from, flatdir, length, linear, quadratic, useMaxHeightMips);
+	}
+
 private:
+	float LineGroundCol(float3 from, float3 to, bool synced, bool useMaxHeightMips) const;
+	float TrajectoryGroundCol(float3 from, const float3& flatdir, float length, float linear, float quadratic, bool useMaxHeightMips) const;
+	float LineGroundColSquares(const float* hm, const float3* nm, const float3& from, const float3& to) const;
+	float TrajectorySkipEnd(const float3& from, const float3& dir, float quadratic, float l, float far, float* noSkipEnd) const;
 
 	void CheckColSquare(CProjectile* p, int x, int y);
 };
@@ -33,6 +33,12 @@
 // assigned to in CGame::CGame ("readmap = CReadMap::LoadMap(mapname)")
 CReadMap* readmap = NULL;
 
+// derived-map updates spanning fewer rows than this stay on the calling
+// thread, for small (eg. single crater) rectangles the OpenMP fork/join
+// costs more than it saves; every cell is written by exactly one row so
+// the results do not depend on the number of threads
+static const int MIN_PARALLEL_UPDATE_ROWS = 32;
+
 #ifdef USE_UNSYNCED_HEIGHTMAP
 	#define	HEIGHTMAP_DIGESTS CR_MEMBER(syncedHeightMapDigests), \
 					CR_MEMBER(unsyncedHeightMapDigests),
@@ -55,6 +61,7 @@ CR_REG_METADATA(CReadMap, (
 	CR_MEMBER(originalHeightMap),
 	CR_IGNORED(centerHeightMap),
 	CR_IGNORED(mipCenterHeightMaps),
+	CR_IGNORED(maxHeightMaps),
 	//CR_MEMBER(mipPointerHeightMaps),
 	CR_IGNORED(visVertexNormals),
 	CR_IGNORED(faceNormalsSynced),
@@ -143,6 +150,7 @@ CReadMap::CReadMap()
 	, currMinHeight(0.0f)
 	, currMaxHeight(0.0f)
 	, mapChecksum(0)
+	, minimapRevision(0)
 	, heightMapSyncedPtr(NULL)
 	, heightMapUnsyncedPtr(NULL)
 {
@@ -189,6 +197,9 @@ void CReadMap::Initialize()
 			reqMemFootPrintKB += ((((gs->mapx >> i) * (gs->mapy >> i)) * sizeof(float)) / 1024);
 		}
 
+		// maxHeightMaps[i] (all levels together are about 4/3 of the first)
+		reqMemFootPrintKB += ((((gs->mapx * gs->mapy * 4) / 3) * sizeof(float)) / 1024);
+
 		sprintf(loadMsg, fmtString, reqMemFootPrintKB / 1024);
 		loadscreen->SetLoadMessage(loadMsg);
 	}
@@ -212,6 +223,14 @@ void CReadMap::Initialize()
 		mipPointerHeightMaps[i] = &mipCenterHeightMaps[i - 1][0];
 	}
 
+	// one level per halving until a single texel covers the whole map
+	maxHeightMaps.resize(1, std::vector<float>(gs->mapx * gs->mapy));
+
+	while ((GetMaxHeightMapSizeX(maxHeightMaps.size() - 1) * GetMaxHeightMapSizeZ(maxHeightMaps.size() - 1)) > 1) {
+		const unsigned int i = maxHeightMaps.size();
+		maxHeightMaps.push_back(std::vector<float>(GetMaxHeightMapSizeX(i) * GetMaxHeightMapSizeZ(i)));
+	}
+
 	slopeMap.resize(gs->hmapx * gs->hmapy);
 	visVertexNormals.resize(gs->mapxp1 * gs->mapyp1);
 
@@ -292,9 +311,15 @@ void CReadMap::UpdateDraw()
 	}
 	// unsyncedHeightMapUpdatesTemp is now guaranteed empty
 
+	int updatedArea = 0;
+
 	for (ushmuIt = ushmu.begin(); ushmuIt != ushmu.end(); ++ushmuIt) {
 		UpdateHeightMapUnsynced(*ushmuIt);
+		updatedArea += ushmuIt->GetArea();
 	}
+
+	profiler.AddCounter("ReadMap::UpdateDraw rects", ushmu.size());
+	profiler.AddCounter("ReadMap::UpdateDraw area", updatedArea);
 	for (ushmuIt = ushmu.begin(); ushmuIt != ushmu.end(); ++ushmuIt) {
 		eventHandler.UnsyncedHeightMapUpdate(*ushmuIt);
 	}
@@ -315,6 +340,7 @@ void CReadMap::UpdateHeightMapSynced(SRectangle rect, bool initialize)
 
 	UpdateCenterHeightmap(rect);
 	UpdateMipHeightmaps(rect);
+	UpdateMaxHeightmaps(rect);
 	UpdateFaceNormals(rect);
 	UpdateSlopemap(rect); // must happen after UpdateFaceNormals()!
 
@@ -351,7 +377,10 @@ void CReadMap::UpdateCenterHeightmap(const SRectangle& rect)
 {
 	const float* heightmapSynced = GetCornerHeightMapSynced();
 
-	for (int y = rect.z1; y <= rect.z2; y++) {
+	int y;
+	Threading::OMPCheck();
+	#pragma omp parallel for private(y) if ((rect.z2 - rect.z1) >= MIN_PARALLEL_UPDATE_ROWS)
+	for (y = rect.z1; y <= rect.z2; y++) {
 		for (int x = rect.x1; x <= rect.x2; x++) {
 			const int idxTL = (y    ) * gs->mapxp1 + x;
 			const int idxTR = (y    ) * gs->mapxp1 + x + 1;
@@ -378,8 +407,11 @@ void CReadMap::UpdateMipHeightmaps(const SRectangle& rect)
 		const int ex = (rect.x2 >> i);
 		const int sy = (rect.z1 >> i) & (~1);
 		const int ey = (rect.z2 >> i);
-		
-		for (int y = sy; y < ey; y += 2) {
+
+		int y;
+		Threading::OMPCheck();
+		#pragma omp parallel for private(y) if ((ey - sy) >= MIN_PARALLEL_UPDATE_ROWS)
+		for (y = sy; y < ey; y += 2) {
 			for (int x = sx; x < ex; x += 2) {
 				const float height =
 					mipPointerHeightMaps[i][(x    ) + (y    ) * hmapx] +
@@ -393,6 +425,52 @@ void CReadMap::UpdateMipHeightmaps(const SRectangle& rect)
 }
 
 
+void CReadMap::UpdateMaxHeightmaps(const SRectangle& rect)
+{
+	const float* heightmapSynced = GetCornerHeightMapSynced();
+
+	int y;
+	Threading::OMPCheck();
+	#pragma omp parallel for private(y) if ((rect.z2 - rect.z1) >= MIN_PARALLEL_UPDATE_ROWS)
+	for (y = rect.z1; y <= rect.z2; y++) {
+		for (int x = rect.x1; x <= rect.x2; x++) {
+			const int idxTL = (y    ) * gs->mapxp1 + x;
+			const int idxBL = (y + 1) * gs->mapxp1 + x;
+
+			const float height = std::max(
+				std::max(heightmapSynced[idxTL], heightmapSynced[idxTL + 1]),
+				std::max(heightmapSynced[idxBL], heightmapSynced[idxBL + 1]));
+			maxHeightMaps[0][y * gs->mapx + x] = height;
+		}
+	}
+
+	for (unsigned int i = 1; i < maxHeightMaps.size(); i++) {
+		const float* src = &maxHeightMaps[i - 1][0];
+		      float* dst = &maxHeightMaps[i    ][0];
+
+		const int srcSizeX = GetMaxHeightMapSizeX(i - 1);
+		const int srcSizeZ = GetMaxHeightMapSizeZ(i - 1);
+		const int dstSizeX = GetMaxHeightMapSizeX(i);
+
+		// levels depend on the previous one, only the rows within a level are independent
+		Threading::OMPCheck();
+		#pragma omp parallel for private(y) if (((rect.z2 - rect.z1) >> i) >= MIN_PARALLEL_UPDATE_ROWS)
+		for (y = (rect.z1 >> i); y <= (rect.z2 >> i); y++) {
+			for (int x = (rect.x1 >> i); x <= (rect.x2 >> i); x++) {
+				// odd-sized levels have cells with only one child along an axis
+				const int x0 = x * 2, x1 = std::min(x0 + 1, srcSizeX - 1);
+				const int y0 = y * 2, y1 = std::min(y0 + 1, srcSizeZ - 1);
+
+				const float height = std::max(
+					std::max(src[y0 * srcSizeX + x0], src[y0 * srcSizeX + x1]),
+					std::max(src[y1 * srcSizeX + x0], src[y1 * srcSizeX + x1]));
+				dst[y * dstSizeX + x] = height;
+			}
+		}
+	}
+}
+
+
 void CReadMap::UpdateFaceNormals(const SRectangle& rect)
 {
 	const float* heightmapSynced = GetCornerHeightMapSynced();
@@ -464,8 +542,11 @@ void CReadMap::UpdateSlopemap(const SRectangle& rect)
 	const int ex = std::min(gs->hmapx - 1, (rect.x2 / 2) + 1);
 	const int sy = std::max(0, (rect.z1 / 2) - 1);
 	const int ey = std::min(gs->hmapy - 1, (rect.z2 / 2) + 1);
-	
-	for (int y = sy; y <= ey; y++) {
+
+	int y;
+	Threading::OMPCheck();
+	#pragma omp parallel for private(y) if ((ey - sy) >= MIN_PARALLEL_UPDATE_ROWS)
+	for (y = sy; y <= ey; y++) {
 		for (int x = sx; x <= ex; x++) {
 			const int idx0 = (y*2    ) * (gs->mapx) + x*2;
 			const int idx1 = (y*2 + 1) * (gs->mapx) + x*2;
@@ -90,6 +90,8 @@ public:
 
 	/// Draws the minimap in a quad (with extends: (0,0)-(1,1))
 	virtual void DrawMinimap() const = 0;
+	/// changes whenever the output of DrawMinimap (not counting the info-texture) changes
+	unsigned int GetMinimapRevision() const { return minimapRevision; }
 
 	/// Feature creation
 	virtual int GetNumFeatures() = 0;
@@ -121,6 +123,11 @@ public:
 	const float* GetOriginalHeightMapSynced() const { return &originalHeightMap[0]; }
 	const float* GetCenterHeightMapSynced() const { return &centerHeightMap[0]; }
 	const float* GetMIPHeightMapSynced(unsigned int mip) const { return mipPointerHeightMaps[mip]; }
+	const float* GetMaxHeightMapSynced(unsigned int mip) const { return &maxHeightMaps[mip][0]; }
+	int GetNumMaxHeightMaps() const { return maxHeightMaps.size(); }
+	/// size of a max-heightmap level is the full size divided by 2^mip, rounded up
+	int GetMaxHeightMapSizeX(unsigned int mip) const { return (((gs->mapx - 1) >> mip) + 1); }
+	int GetMaxHeightMapSizeZ(unsigned int mip) const { return (((gs->mapy - 1) >> mip) + 1); }
 	const float* GetSlopeMapSynced() const { return &slopeMap[0]; }
 	const unsigned char* GetTypeMapSynced() const { return &typeMap[0]; }
 	      unsigned char* GetTypeMapSynced()       { return &typeMap[0]; }
@@ -169,9 +176,13 @@ public:
 
 	unsigned int mapChecksum;
 
+protected:
+	unsigned int minimapRevision;
+
 private:
 	void UpdateCenterHeightmap(const SRectangle& rect);
 	void UpdateMipHeightmaps(const SRectangle& rect);
+	void UpdateMaxHeightmaps(const SRectangle& rect);
 	void UpdateFaceNormals(const SRectangle& rect);
 	void UpdateSlopemap(const SRectangle& rect);
 	
@@ -193,6 +204,15 @@ protected:
 	 */
 	std::vector< float* > mipPointerHeightMaps;
 
+	/**
+	 * max-height pyramid, maxHeightMaps[0] holds the highest of the four
+	 * corner heights of each square (so no point of its two faces is above
+	 * it), every texel of maxHeightMaps[n+1] the maximum of its (up to) 2x2
+	 * children in maxHeightMaps[n]; the last level is a single texel
+	 * [SYNCED, updates on terrain deformation]
+	 */
+	std::vector< std::vector<float> > maxHeightMaps;
+
 	std::vector<float3> visVertexNormals;      //< size:  (mapx + 1) * (mapy + 1), contains one vertex normal per corner-heightmap pixel [UNSYNCED]
 	std::vector<float3> faceNormalsSynced;     //< size: 2*mapx      *  mapy     , contains 2 normals per quad -> triangle strip [SYNCED]
 	std::vector<float3> faceNormalsUnsynced;   //< size: 2*mapx      *  mapy     , contains 2 normals per quad -> triangle strip [UNSYNCED]
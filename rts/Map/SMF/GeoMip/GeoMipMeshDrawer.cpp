@@ -0,0 +1,432 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "GeoMipMeshDrawer.h"
+#include "Game/Camera.h"
+#include "Map/ReadMap.h"
+#include "Map/SMF/SMFReadMap.h"
+#include "Map/SMF/SMFGroundDrawer.h"
+#include "Rendering/GL/myGL.h"
+#include "Rendering/GL/VBO.h"
+#include "Rendering/GL/VertexArray.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "System/EventHandler.h"
+#include "System/myMath.h"
+#include "System/Rectangle.h"
+#include "System/Log/ILog.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+
+const int CGeoMipMeshDrawer::CHUNK_SIZE;
+const int CGeoMipMeshDrawer::CHUNK_VERTS;
+const int CGeoMipMeshDrawer::NUM_LODS;
+
+
+class CChunkInViewChecker : public CReadMap::IQuadDrawer
+{
+public:
+	std::vector<CGeoMipMeshDrawer::MeshChunk>* chunks;
+	int numChunksX;
+
+	void DrawQuad(int x, int y) {
+		(*chunks)[x + y * numChunksX].visible = true;
+	}
+};
+
+
+
+// ---------------------------------------------------------------------
+// Ctor
+//
+CGeoMipMeshDrawer::CGeoMipMeshDrawer(CSMFReadMap* rm, CSMFGroundDrawer* gd)
+	: CEventClient("[CGeoMipMeshDrawer]", 271989, false)
+	, smfReadMap(rm)
+	, smfGroundDrawer(gd)
+	, indexBuffer(NULL)
+{
+	assert(CHUNK_SIZE == CSMFReadMap::bigSquareSize);
+
+	eventHandler.AddClient(this);
+
+	numChunksX = gs->mapx / CHUNK_SIZE;
+	numChunksZ = gs->mapy / CHUNK_SIZE;
+
+	chunks.resize(numChunksX * numChunksZ);
+
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			chunk.vertexBuffer = new VBO(GL_ARRAY_BUFFER);
+			chunk.vertexBuffer->Bind(GL_ARRAY_BUFFER);
+			chunk.vertexBuffer->Resize(CHUNK_VERTS * CHUNK_VERTS * sizeof(float3), GL_STATIC_DRAW);
+			chunk.vertexBuffer->Unbind();
+
+			UploadVertices(cx, cz, 0, CHUNK_SIZE);
+		}
+	}
+
+	GenerateIndices();
+}
+
+CGeoMipMeshDrawer::~CGeoMipMeshDrawer()
+{
+	eventHandler.RemoveClient(this);
+
+	for (std::vector<MeshChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+		delete it->vertexBuffer;
+	}
+
+	delete indexBuffer;
+}
+
+
+
+/**
+ * Builds the index lists of all LOD levels and edge-flag combinations
+ * into one shared buffer. On an edge whose neighbor is one level coarser
+ * every odd vertex is collapsed onto the previous even one, so the edge
+ * only uses vertices the neighbor also has (no T-junction cracks).
+ */
+void CGeoMipMeshDrawer::GenerateIndices()
+{
+	std::vector<unsigned short> indices;
+
+	for (int lod = 0; lod < NUM_LODS; ++lod) {
+		const int step = 1 << lod;
+		const int step2 = step * 2;
+
+		// a coarser neighbor only exists if this is not the coarsest level
+		const bool canStitch = (step2 <= CHUNK_SIZE);
+
+		for (int edgeFlags = 0; edgeFlags < NUM_EDGE_COMBOS; ++edgeFlags) {
+			IndexRange& range = indexRanges[lod][edgeFlags];
+			range.offset = indices.size();
+
+			for (int z = 0; z < CHUNK_SIZE; z += step) {
+				for (int x = 0; x < CHUNK_SIZE; x += step) {
+					int vx[4] = {x, x + step, x + step, x       };
+					int vz[4] = {z, z,        z + step, z + step};
+					int vi[4];
+
+					for (int v = 0; v < 4; ++v) {
+						if (canStitch) {
+							if ((vx[v] ==          0) && (edgeFlags & EDGE_NEG_X) && (vz[v] % step2) != 0) { vz[v] -= step; }
+							if ((vx[v] == CHUNK_SIZE) && (edgeFlags & EDGE_POS_X) && (vz[v] % step2) != 0) { vz[v] -= step; }
+							if ((vz[v] ==          0) && (edgeFlags & EDGE_NEG_Z) && (vx[v] % step2) != 0) { vx[v] -= step; }
+							if ((vz[v] == CHUNK_SIZE) && (edgeFlags & EDGE_POS_Z) && (vx[v] % step2) != 0) { vx[v] -= step; }
+						}
+
+						vi[v] = vz[v] * CHUNK_VERTS + vx[v];
+					}
+
+					// a = 0, b = 1, c = 2, d = 3; wound (a, c, b) and
+					// (a, d, c) so the front faces point upwards
+					static const int tris[2][3] = {{0, 2, 1}, {0, 3, 2}};
+
+					for (int t = 0; t < 2; ++t) {
+						const int i0 = vi[tris[t][0]];
+						const int i1 = vi[tris[t][1]];
+						const int i2 = vi[tris[t][2]];
+
+						// drop triangles collapsed by the stitching
+						if (i0 == i1 || i1 == i2 || i2 == i0)
+							continue;
+
+						indices.push_back(i0);
+						indices.push_back(i1);
+						indices.push_back(i2);
+					}
+				}
+			}
+
+			range.count = indices.size() - range.offset;
+		}
+	}
+
+	indexBuffer = new VBO(GL_ELEMENT_ARRAY_BUFFER);
+	indexBuffer->Bind(GL_ELEMENT_ARRAY_BUFFER);
+	indexBuffer->Resize(indices.size() * sizeof(unsigned short), GL_STATIC_DRAW, &indices[0]);
+	indexBuffer->Unbind();
+
+	LOG("[GeoMipMeshDrawer] %d chunks, %u KB of indices", numChunksX * numChunksZ, (unsigned int) ((indices.size() * sizeof(unsigned short)) >> 10));
+}
+
+
+void CGeoMipMeshDrawer::UploadVertices(int cx, int cz, int minZ, int maxZ)
+{
+	const float* hmap = readmap->GetCornerHeightMapUnsynced();
+
+	MeshChunk& chunk = chunks[cz * numChunksX + cx];
+	VBO* vbo = chunk.vertexBuffer;
+
+	const int numRows = maxZ - minZ + 1;
+	const int rowSize = CHUNK_VERTS * sizeof(float3);
+
+	// synchronized (no GL_MAP_UNSYNCHRONIZED_BIT), the GPU
+	// might still be reading the old heights of this frame
+	vbo->Bind(GL_ARRAY_BUFFER);
+	float3* verts = reinterpret_cast<float3*>(vbo->MapBuffer(minZ * rowSize, numRows * rowSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+
+	if (verts != NULL) {
+		for (int z = minZ; z <= maxZ; ++z) {
+			const int wz = cz * CHUNK_SIZE + z;
+
+			for (int x = 0; x < CHUNK_VERTS; ++x) {
+				const int wx = cx * CHUNK_SIZE + x;
+
+				*(verts++) = float3(wx * SQUARE_SIZE, hmap[wz * gs->mapxp1 + wx], wz * SQUARE_SIZE);
+			}
+		}
+	}
+
+	vbo->UnmapBuffer();
+	vbo->Unbind();
+}
+
+
+
+// ---------------------------------------------------------------------
+// Update
+//
+void CGeoMipMeshDrawer::Update()
+{
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			if (!chunk.IsDirty())
+				continue;
+
+			UploadVertices(cx, cz, chunk.dirtyMinZ, chunk.dirtyMaxZ);
+
+			chunk.dirtyMinZ = CHUNK_VERTS;
+			chunk.dirtyMaxZ = -1;
+		}
+	}
+
+	// all passes (including the shadow pass, see GetGroundDetail)
+	// must draw the same mesh, so the levels are only picked here
+	UpdateLODs(cam2);
+}
+
+
+void CGeoMipMeshDrawer::UpdateLODs(const CCamera* cam)
+{
+	const float3& camPos = cam->GetPos();
+	const float chunkWorldSize = CHUNK_SIZE * SQUARE_SIZE;
+	const float baseDist = std::max(1, smfGroundDrawer->GetGroundDetail()) * SQUARE_SIZE * 2.0f;
+
+	// level by distance to the closest point of each chunk
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			const float3 closest(
+				Clamp(camPos.x, cx * chunkWorldSize, (cx + 1) * chunkWorldSize),
+				Clamp(camPos.y, readmap->currMinHeight, readmap->currMaxHeight),
+				Clamp(camPos.z, cz * chunkWorldSize, (cz + 1) * chunkWorldSize)
+			);
+
+			const float dist = (closest - camPos).Length();
+
+			float lodDist = baseDist;
+			chunk.lod = 0;
+
+			while ((dist > lodDist) && (chunk.lod < (NUM_LODS - 1))) {
+				lodDist *= 2.0f;
+				chunk.lod += 1;
+			}
+		}
+	}
+
+	// limit the level difference between edge-neighbors to one so the
+	// stitched index lists always match (two-pass distance transform)
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			int& lod = chunks[cz * numChunksX + cx].lod;
+
+			if (cx > 0) { lod = std::min(lod, chunks[cz * numChunksX + cx - 1].lod + 1); }
+			if (cz > 0) { lod = std::min(lod, chunks[(cz - 1) * numChunksX + cx].lod + 1); }
+		}
+	}
+	for (int cz = numChunksZ - 1; cz >= 0; --cz) {
+		for (int cx = numChunksX - 1; cx >= 0; --cx) {
+			int& lod = chunks[cz * numChunksX + cx].lod;
+
+			if (cx < (numChunksX - 1)) { lod = std::min(lod, chunks[cz * numChunksX + cx + 1].lod + 1); }
+			if (cz < (numChunksZ - 1)) { lod = std::min(lod, chunks[(cz + 1) * numChunksX + cx].lod + 1); }
+		}
+	}
+
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			chunk.edgeFlags = 0;
+
+			if (cx >                0 && chunks[cz * numChunksX + cx - 1].lod > chunk.lod) { chunk.edgeFlags |= EDGE_NEG_X; }
+			if (cx < (numChunksX - 1) && chunks[cz * numChunksX + cx + 1].lod > chunk.lod) { chunk.edgeFlags |= EDGE_POS_X; }
+			if (cz >                0 && chunks[(cz - 1) * numChunksX + cx].lod > chunk.lod) { chunk.edgeFlags |= EDGE_NEG_Z; }
+			if (cz < (numChunksZ - 1) && chunks[(cz + 1) * numChunksX + cx].lod > chunk.lod) { chunk.edgeFlags |= EDGE_POS_Z; }
+		}
+	}
+}
+
+
+void CGeoMipMeshDrawer::UpdateVisibility(CCamera* cam)
+{
+	static CChunkInViewChecker checker;
+	checker.chunks     = &chunks;
+	checker.numChunksX = numChunksX;
+
+	for (std::vector<MeshChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+		it->visible = false;
+	}
+
+	readmap->GridVisibility(cam, CHUNK_SIZE, 1e9, &checker, INT_MAX);
+}
+
+
+
+// ---------------------------------------------------------------------
+// Render Mesh
+//
+void CGeoMipMeshDrawer::DrawMesh(const DrawPass::e& drawPass)
+{
+	const bool inShadowPass = (drawPass == DrawPass::Shadow);
+
+	CCamera* cam = (inShadowPass)? camera: cam2;
+	UpdateVisibility(cam);
+
+	indexBuffer->Bind(GL_ELEMENT_ARRAY_BUFFER);
+	glEnableClientState(GL_VERTEX_ARRAY);
+
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			const MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			if (!chunk.visible)
+				continue;
+
+			if (!inShadowPass)
+				smfGroundDrawer->SetupBigSquare(cx, cz);
+
+			const IndexRange& range = indexRanges[chunk.lod][chunk.edgeFlags];
+
+			chunk.vertexBuffer->Bind(GL_ARRAY_BUFFER);
+			glVertexPointer(3, GL_FLOAT, 0, chunk.vertexBuffer->GetPtr());
+			glDrawRangeElements(GL_TRIANGLES, 0, CHUNK_VERTS * CHUNK_VERTS - 1, range.count, GL_UNSIGNED_SHORT, indexBuffer->GetPtr(range.offset * sizeof(unsigned short)));
+			chunk.vertexBuffer->Unbind();
+		}
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	indexBuffer->Unbind();
+}
+
+
+void CGeoMipMeshDrawer::DrawBorderMesh(const DrawPass::e& drawPass)
+{
+	const bool inShadowPass = (drawPass == DrawPass::Shadow);
+
+	for (int cz = 0; cz < numChunksZ; ++cz) {
+		for (int cx = 0; cx < numChunksX; ++cx) {
+			const bool negX = (cx == 0), posX = (cx == (numChunksX - 1));
+			const bool negZ = (cz == 0), posZ = (cz == (numChunksZ - 1));
+
+			if (!(negX || posX || negZ || posZ))
+				continue;
+
+			const MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			if (!chunk.visible)
+				continue;
+
+			if (!inShadowPass)
+				smfGroundDrawer->SetupBigSquare(cx, cz);
+
+			// map-edges have no neighbor, so they always use the chunk's own step
+			const int step = 1 << chunk.lod;
+			const int x0 = cx * CHUNK_SIZE;
+			const int z0 = cz * CHUNK_SIZE;
+
+			CVertexArray* va = GetVertexArray();
+			va->Initialize();
+
+			if (negX) DrawBorderEdge(va, x0,              z0,              0, 1, step, false);
+			if (posX) DrawBorderEdge(va, x0 + CHUNK_SIZE, z0,              0, 1, step, true);
+			if (negZ) DrawBorderEdge(va, x0,              z0,              1, 0, step, true);
+			if (posZ) DrawBorderEdge(va, x0,              z0 + CHUNK_SIZE, 1, 0, step, false);
+
+			va->DrawArrayC(GL_TRIANGLES);
+		}
+	}
+}
+
+
+/**
+ * Adds a skirt from the heightmap down to y=-400 along one map-edge of a
+ * chunk, fading out towards the bottom. <flip> reverses the winding for
+ * the edges whose outward side is on the right of the walking direction.
+ */
+void CGeoMipMeshDrawer::DrawBorderEdge(CVertexArray* va, int x0, int z0, int dx, int dz, int step, bool flip) const
+{
+	static const unsigned char white[] = {255, 255, 255, 255};
+	static const unsigned char trans[] = {255, 255, 255,   0};
+
+	const float* hmap = readmap->GetCornerHeightMapUnsynced();
+
+	va->EnlargeArrays((CHUNK_SIZE / step) * 6, 0, VA_SIZE_C);
+
+	for (int i = 0; i < CHUNK_SIZE; i += step) {
+		const int xa = x0 + dx * i, xb = xa + dx * step;
+		const int za = z0 + dz * i, zb = za + dz * step;
+
+		const float3 t0(xa * SQUARE_SIZE, hmap[za * gs->mapxp1 + xa], za * SQUARE_SIZE);
+		const float3 t1(xb * SQUARE_SIZE, hmap[zb * gs->mapxp1 + xb], zb * SQUARE_SIZE);
+		const float3 b0(t0.x, -400.0f, t0.z);
+		const float3 b1(t1.x, -400.0f, t1.z);
+
+		if (!flip) {
+			va->AddVertexQC(t0, white); va->AddVertexQC(b0, trans); va->AddVertexQC(t1, white);
+			va->AddVertexQC(t1, white); va->AddVertexQC(b0, trans); va->AddVertexQC(b1, trans);
+		} else {
+			va->AddVertexQC(t1, white); va->AddVertexQC(b1, trans); va->AddVertexQC(t0, white);
+			va->AddVertexQC(t0, white); va->AddVertexQC(b1, trans); va->AddVertexQC(b0, trans);
+		}
+	}
+}
+
+
+
+// ---------------------------------------------------------------------
+// UnsyncedHeightMapUpdate event
+//
+void CGeoMipMeshDrawer::UnsyncedHeightMapUpdate(const SRectangle& rect)
+{
+	const int margin = 2;
+
+	// rect is inclusive, in heightmap vertices
+	const int xa = std::max(rect.x1 - margin,       0), xb = std::min(rect.x2 + margin, gs->mapx);
+	const int za = std::max(rect.z1 - margin,       0), zb = std::min(rect.z2 + margin, gs->mapy);
+
+	// vertices on a chunk boundary are shared by both chunks
+	const int cxStart = std::max((xa + CHUNK_SIZE - 1) / CHUNK_SIZE - 1,           0);
+	const int cxEnd   = std::min( xb                   / CHUNK_SIZE,     numChunksX - 1);
+	const int czStart = std::max((za + CHUNK_SIZE - 1) / CHUNK_SIZE - 1,           0);
+	const int czEnd   = std::min( zb                   / CHUNK_SIZE,     numChunksZ - 1);
+
+	for (int cz = czStart; cz <= czEnd; ++cz) {
+		for (int cx = cxStart; cx <= cxEnd; ++cx) {
+			MeshChunk& chunk = chunks[cz * numChunksX + cx];
+
+			// rows are re-uploaded whole, only the z-range is tracked
+			chunk.dirtyMinZ = std::min(chunk.dirtyMinZ, std::max(za - cz * CHUNK_SIZE, 0));
+			chunk.dirtyMaxZ = std::max(chunk.dirtyMaxZ, std::min(zb - cz * CHUNK_SIZE, int(CHUNK_SIZE)));
+		}
+	}
+}
@@ -0,0 +1,118 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _GEOMIP_MESH_DRAWER_H_
+#define _GEOMIP_MESH_DRAWER_H_
+
+#include "Map/SMF/IMeshDrawer.h"
+#include "System/EventClient.h"
+#include <vector>
+
+class CSMFReadMap;
+class CSMFGroundDrawer;
+class CCamera;
+class CVertexArray;
+class VBO;
+
+
+/**
+ * Map mesh drawer implementation
+ *
+ * Splits the map into fixed-size chunks (one per big ground-texture square)
+ * whose vertices live in static VBOs that are only re-uploaded when a height
+ * map update touches them. Each chunk is drawn with one of a set of index
+ * lists that are precomputed for every LOD level and every combination of
+ * coarser neighbors (to stitch the shared edges), so no per-frame CPU work
+ * besides picking the LOD level is required.
+ */
+class CGeoMipMeshDrawer : public IMeshDrawer, public CEventClient
+{
+public:
+	// CEventClient interface
+	bool WantsEvent(const std::string& eventName) {
+		return (eventName == "UnsyncedHeightMapUpdate");
+	}
+	bool GetFullRead() const { return true; }
+	int  GetReadAllyTeam() const { return AllAccessTeam; }
+
+	void UnsyncedHeightMapUpdate(const SRectangle& rect);
+
+public:
+	CGeoMipMeshDrawer(CSMFReadMap* rm, CSMFGroundDrawer* gd);
+	~CGeoMipMeshDrawer();
+
+	void Update();
+
+	void DrawMesh(const DrawPass::e& drawPass);
+	void DrawBorderMesh(const DrawPass::e& drawPass);
+
+public:
+	/// in heightmap squares, must equal CSMFReadMap::bigSquareSize
+	static const int CHUNK_SIZE = 128;
+	static const int CHUNK_VERTS = CHUNK_SIZE + 1;
+	/// level L uses a vertex step of (1 << L) squares
+	static const int NUM_LODS = 8;
+
+	/// set in a chunk's edge-flags when the neighbor on that side is coarser
+	enum {
+		EDGE_NEG_X = 1,
+		EDGE_POS_X = 2,
+		EDGE_NEG_Z = 4,
+		EDGE_POS_Z = 8,
+		NUM_EDGE_COMBOS = 16
+	};
+
+private:
+	struct MeshChunk {
+		MeshChunk()
+			: vertexBuffer(NULL)
+			, lod(0)
+			, edgeFlags(0)
+			, visible(false)
+			, dirtyMinZ(CHUNK_VERTS)
+			, dirtyMaxZ(-1)
+		{}
+
+		bool IsDirty() const { return (dirtyMinZ <= dirtyMaxZ); }
+
+		VBO* vertexBuffer;
+
+		int lod;
+		int edgeFlags;
+
+		bool visible;
+
+		/// range of vertex rows (in chunk space) that need re-uploading
+		int dirtyMinZ;
+		int dirtyMaxZ;
+	};
+
+	struct IndexRange {
+		IndexRange(): offset(0), count(0) {}
+
+		unsigned int offset;
+		unsigned int count;
+	};
+
+	void GenerateIndices();
+	void UploadVertices(int cx, int cz, int minZ, int maxZ);
+	void UpdateLODs(const CCamera* cam);
+	void UpdateVisibility(CCamera* cam);
+	void DrawBorderEdge(CVertexArray* va, int x0, int z0, int dx, int dz, int step, bool flip) const;
+
+private:
+	CSMFReadMap* smfReadMap;
+	CSMFGroundDrawer* smfGroundDrawer;
+
+	int numChunksX;
+	int numChunksZ;
+
+	std::vector<MeshChunk> chunks;
+
+	/// all index lists, one range per (lod, edge-flags) combination
+	VBO* indexBuffer;
+	IndexRange indexRanges[NUM_LODS][NUM_EDGE_COMBOS];
+
+	friend class CChunkInViewChecker;
+};
+
+#endif // _GEOMIP_MESH_DRAWER_H_
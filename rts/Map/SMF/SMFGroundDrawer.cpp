@@ -7,6 +7,7 @@
 #include "Game/Camera.h"
 #include "Map/MapInfo.h"
 #include "Map/ReadMap.h"
+#include "Map/SMF/GeoMip/GeoMipMeshDrawer.h"
 #include "Map/SMF/Legacy/LegacyMeshDrawer.h"
 #include "Map/SMF/ROAM/RoamMeshDrawer.h"
 #include "Rendering/Env/IGroundDecalDrawer.h"
@@ -35,7 +36,10 @@ CONFIG(bool, AdvMapShading).defaultValue(true).safemodeValue(false);
 CONFIG(int, ROAM)
 	.defaultValue(Patch::VBO)
 	.safemodeValue(Patch::DL)
-	.description("Use ROAM for terrain mesh rendering. 1=VBO mode, 2=DL mode, 3=VA mode");
+	.description("Use ROAM for terrain mesh rendering. 1=VBO mode, 2=DL mode, 3=VA mode, 4=no ROAM but chunked geomipmapping (VBOs)");
+
+// value of the ROAM configvar that selects CGeoMipMeshDrawer
+static const int ROAM_CONFIG_GEOMIP = 4;
 
 
 CSMFGroundDrawer::CSMFGroundDrawer(CSMFReadMap* rm)
@@ -43,7 +47,13 @@ CSMFGroundDrawer::CSMFGroundDrawer(CSMFReadMap* rm)
 	, meshDrawer(NULL)
 {
 	groundTextures = new CSMFGroundTextures(smfMap);
-	meshDrawer = SwitchMeshDrawer((!!configHandler->GetInt("ROAM")) ? SMF_MESHDRAWER_ROAM : SMF_MESHDRAWER_LEGACY);
+	const int roamConfig = configHandler->GetInt("ROAM");
+
+	if (roamConfig == ROAM_CONFIG_GEOMIP) {
+		meshDrawer = SwitchMeshDrawer(SMF_MESHDRAWER_GEOMIP);
+	} else {
+		meshDrawer = SwitchMeshDrawer((!!roamConfig) ? SMF_MESHDRAWER_ROAM : SMF_MESHDRAWER_LEGACY);
+	}
 
 	smfRenderStateSSP = ISMFRenderState::GetInstance(globalRendering->haveARB, globalRendering->haveGLSL);
 	smfRenderStateFFP = ISMFRenderState::GetInstance(                   false,                     false);
@@ -83,7 +93,9 @@ CSMFGroundDrawer::CSMFGroundDrawer(CSMFReadMap* rm)
 CSMFGroundDrawer::~CSMFGroundDrawer()
 {
 	// if ROAM _was_ enabled, the configvar is written in CRoamMeshDrawer's dtor
-	if (dynamic_cast<CRoamMeshDrawer*>(meshDrawer) == NULL)
+	if (dynamic_cast<CGeoMipMeshDrawer*>(meshDrawer) != NULL)
+		configHandler->Set("ROAM", ROAM_CONFIG_GEOMIP);
+	else if (dynamic_cast<CRoamMeshDrawer*>(meshDrawer) == NULL)
 		configHandler->Set("ROAM", 0);
 	configHandler->Set("GroundDetail", groundDetail);
 
@@ -104,7 +116,12 @@ CSMFGroundDrawer::~CSMFGroundDrawer()
 
 IMeshDrawer* CSMFGroundDrawer::SwitchMeshDrawer(int mode)
 {
-	const int curMode = (dynamic_cast<CRoamMeshDrawer*>(meshDrawer) ? SMF_MESHDRAWER_ROAM : SMF_MESHDRAWER_LEGACY);
+	int curMode = SMF_MESHDRAWER_LEGACY;
+
+	if (dynamic_cast<CRoamMeshDrawer*>(meshDrawer) != NULL)
+		curMode = SMF_MESHDRAWER_ROAM;
+	if (dynamic_cast<CGeoMipMeshDrawer*>(meshDrawer) != NULL)
+		curMode = SMF_MESHDRAWER_GEOMIP;
 
 	// mode == -1: toggle modes
 	if (mode < 0) {
@@ -122,6 +139,10 @@ IMeshDrawer* CSMFGroundDrawer::SwitchMeshDrawer(int mode)
 			LOG("Switching to Legacy Mesh Rendering");
 			meshDrawer = new CLegacyMeshDrawer(smfMap, this);
 			break;
+		case SMF_MESHDRAWER_GEOMIP:
+			LOG("Switching to GeoMip Mesh Rendering");
+			meshDrawer = new CGeoMipMeshDrawer(smfMap, this);
+			break;
 		default:
 			LOG("Switching to ROAM Mesh Rendering");
 			meshDrawer = new CRoamMeshDrawer(smfMap, this);
@@ -13,6 +13,7 @@ struct ISMFRenderState;
 enum {
 	SMF_MESHDRAWER_LEGACY = 0,
 	SMF_MESHDRAWER_ROAM,
+	SMF_MESHDRAWER_GEOMIP,
 	SMF_MESHDRAWER_LAST,
 };
 
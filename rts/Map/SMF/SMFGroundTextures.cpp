@@ -20,6 +20,7 @@
 #include "Game/GameSetup.h"
 #include "Game/LoadScreen.h"
 #include "System/Exceptions.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/FastMath.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
@@ -27,6 +28,9 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/Platform/Threading.h"
 
+#include <algorithm>
+#include <boost/bind.hpp>
+
 using std::sprintf;
 
 #define LOG_SECTION_SMF_GROUND_TEXTURES "CSMFGroundTextures"
@@ -39,8 +43,27 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_SMF_GROUND_TEXTURES)
 #define LOG_SECTION_CURRENT LOG_SECTION_SMF_GROUND_TEXTURES
 
 
-CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm): smfMap(rm)
+CONFIG(int, GroundTexturesMemoryBudget)
+	.defaultValue(256)
+	.minimumValue(0)
+	.maximumValue(2047)
+	.description("Maximum size in MB of the resident SMF ground textures (0 = unlimited). Squares that have not been drawn recently are reduced to their lowest detail first.");
+
+/// texture bytes that may be uploaded per frame by DrawUpdate (4 squares at full detail)
+static const unsigned int MAX_UPLOAD_BYTES_PER_FRAME = 2 * 1024 * 1024;
+
+
+CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm)
+	: smfMap(rm)
+	, residentBytes(0)
+	, memoryBudget(configHandler->GetInt("GroundTexturesMemoryBudget") * 1024 * 1024)
+	, prepareThread(NULL)
+	, busySquareIdx(-1)
+	, busyLevel(-1)
+	, quitPrepareThread(false)
 {
+	memset(&stats, 0, sizeof(stats));
+
 	// TODO refactor: put reading code in CSMFFile and keep error-handling/progress reporting here
 	      CSMFMapFile& file = smfMap->GetFile();
 	const SMFHeader& header = file.GetHeader();
@@ -189,11 +212,14 @@ CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm): smfMap(rm)
 			square->textureID      = 0;
 			square->lastBoundFrame = 1;
 			square->luaTexture     = false;
+			square->pendingLevel   = -1;
 
 			LoadSquareTexture(x, y, 3);
 		}
 	}
 
+	prepareThread = new boost::thread(boost::bind(&CSMFGroundTextures::PrepareThreadProc, this));
+
 
 	ScopedOnceTimer timer("CSMFGroundTextures::ConvolveHeightMap");
 
@@ -257,11 +283,28 @@ CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm): smfMap(rm)
 
 CSMFGroundTextures::~CSMFGroundTextures()
 {
+	{
+		boost::mutex::scoped_lock lock(prepareMutex);
+		quitPrepareThread = true;
+		prepareCondition.notify_all();
+	}
+
+	prepareThread->join();
+	delete prepareThread;
+
+	for (std::list<PreparedSquare*>::iterator it = preparedSquares.begin(); it != preparedSquares.end(); ++it) {
+		delete *it;
+	}
+
 	for (int i = 0; i < smfMap->numBigTexX * smfMap->numBigTexY; ++i) {
 		if (!squares[i].luaTexture) {
 			glDeleteTextures(1, &squares[i].textureID);
 		}
 	}
+
+	LOG("[%s] %u square requests (%u misses), %u uploads (%u discarded), %u evictions, latency avg %.1fms max %.1fms",
+		__FUNCTION__, stats.numRequests, stats.numMisses, stats.numUploads, stats.numDiscarded, stats.numEvictions,
+		stats.sumLatencyMs / std::max(1u, stats.numUploads), stats.maxLatencyMs);
 }
 
 
@@ -284,11 +327,17 @@ inline bool CSMFGroundTextures::TexSquareInView(int btx, int bty) const
 
 void CSMFGroundTextures::DrawUpdate()
 {
+	UploadPreparedSquares();
+
 	// screen-diagonal number of pixels
 	const float vsxSq = globalRendering->viewSizeX * globalRendering->viewSizeX;
 	const float vsySq = globalRendering->viewSizeY * globalRendering->viewSizeY;
 	const float vdiag = fastmath::apxsqrt(vsxSq + vsySq);
 
+	const spring_time now = spring_gettime();
+
+	std::vector<SquareRequest> requests;
+
 	for (int y = 0; y < smfMap->numBigTexY; ++y) {
 		float dz = cam2->GetPos().z - (y * smfMap->bigSquareSize * SQUARE_SIZE);
 		dz -= (SQUARE_SIZE << 6);
@@ -302,11 +351,20 @@ void CSMFGroundTextures::DrawUpdate()
 				continue;
 			}
 
+			if (square->textureID == 0) {
+				// Lua texture was reset, the lowest mip-level is cheap
+				// enough to extract right away (also see EvictSquares)
+				LoadSquareTexture(x, y, 3);
+			}
+
 			if (!TexSquareInView(x, y)) {
+				// drop the result of any request still in flight
+				square->pendingLevel = -1;
+
 				if ((square->texLevel < 3) && (globalRendering->drawFrame - square->lastBoundFrame > 120)) {
 					// `unload` texture (load lowest mip-map) if
 					// the square wasn't visible for 120 vframes
-					glDeleteTextures(1, &square->textureID);
+					FreeSquareTexture(square);
 					LoadSquareTexture(x, y, 3);
 				}
 				continue;
@@ -363,9 +421,222 @@ void CSMFGroundTextures::DrawUpdate()
 				wantedLevel--;
 
 			if (square->texLevel != wantedLevel) {
-				glDeleteTextures(1, &square->textureID);
-				LoadSquareTexture(x, y, wantedLevel);
+				requests.push_back(SquareRequest(y * smfMap->numBigTexX + x, wantedLevel, dist));
+			} else {
+				square->pendingLevel = -1;
+			}
+		}
+	}
+
+	// closest squares get the memory budget first
+	std::sort(requests.begin(), requests.end(), SquareRequest::IsCloser);
+
+	unsigned int projectedBytes = residentBytes;
+	bool canEvict = true;
+
+	std::vector<SquareRequest> admitted;
+	admitted.reserve(requests.size());
+
+	for (std::vector<SquareRequest>::const_iterator it = requests.begin(); it != requests.end(); ++it) {
+		GroundSquare* square = &squares[it->squareIdx];
+
+		const unsigned int oldBytes = GetSquareTexBytes(smfMap->bigTexSize, square->texLevel);
+		const unsigned int newBytes = GetSquareTexBytes(smfMap->bigTexSize, it->level);
+
+		if (memoryBudget > 0 && newBytes > oldBytes) {
+			if (projectedBytes + (newBytes - oldBytes) > memoryBudget && canEvict) {
+				const unsigned int freedBytes = EvictSquares(projectedBytes + (newBytes - oldBytes) - memoryBudget);
+
+				projectedBytes -= std::min(projectedBytes, freedBytes);
+				canEvict = (freedBytes > 0);
+			}
+			if (projectedBytes + (newBytes - oldBytes) > memoryBudget) {
+				// keep the current level until something becomes evictable
+				square->pendingLevel = -1;
+				continue;
 			}
+
+			projectedBytes += (newBytes - oldBytes);
+		}
+
+		if (square->pendingLevel != it->level) {
+			square->pendingLevel = it->level;
+			square->requestTime = now;
+
+			// squares are only requested while in view, so
+			// a request for more detail than is resident
+			// means the square is being drawn too blurry
+			stats.numRequests++;
+			stats.numMisses += (it->level < int(square->texLevel));
+		}
+
+		admitted.push_back(*it);
+	}
+
+	QueueSquareRequests(admitted);
+}
+
+
+/**
+ * Replaces the request queue with the current set of wanted squares,
+ * so stale requests are dropped and priorities follow the camera.
+ */
+void CSMFGroundTextures::QueueSquareRequests(const std::vector<SquareRequest>& requests)
+{
+	boost::mutex::scoped_lock lock(prepareMutex);
+
+	requestQueue = std::priority_queue<SquareRequest>();
+
+	for (std::vector<SquareRequest>::const_iterator it = requests.begin(); it != requests.end(); ++it) {
+		// being extracted right now
+		if (it->squareIdx == busySquareIdx && it->level == busyLevel)
+			continue;
+
+		// extracted, but not uploaded yet
+		bool prepared = false;
+
+		for (std::list<PreparedSquare*>::const_iterator pit = preparedSquares.begin(); pit != preparedSquares.end(); ++pit) {
+			prepared |= ((*pit)->squareIdx == it->squareIdx && (*pit)->level == it->level);
+		}
+
+		if (!prepared) {
+			requestQueue.push(*it);
+		}
+	}
+
+	if (!requestQueue.empty()) {
+		prepareCondition.notify_all();
+	}
+}
+
+
+void CSMFGroundTextures::UploadPreparedSquares()
+{
+	std::list<PreparedSquare*> uploads;
+
+	{
+		boost::mutex::scoped_lock lock(prepareMutex);
+
+		unsigned int numBytes = 0;
+
+		while (!preparedSquares.empty() && numBytes < MAX_UPLOAD_BYTES_PER_FRAME) {
+			numBytes += preparedSquares.front()->data.size();
+			uploads.splice(uploads.end(), preparedSquares, preparedSquares.begin());
+		}
+	}
+
+	const spring_time now = spring_gettime();
+
+	for (std::list<PreparedSquare*>::iterator it = uploads.begin(); it != uploads.end(); ++it) {
+		PreparedSquare* ps = *it;
+		GroundSquare* square = &squares[ps->squareIdx];
+
+		if (square->luaTexture || square->pendingLevel != ps->level) {
+			// no longer wanted (went out of view, camera moved on, ...)
+			stats.numDiscarded++;
+		} else {
+			const float latencyMs = (now - square->requestTime).toMilliSecsf();
+
+			FreeSquareTexture(square);
+			CreateSquareTexture(square, ps->level, &ps->data[0]);
+
+			square->pendingLevel = -1;
+
+			stats.numUploads++;
+			stats.sumLatencyMs += latencyMs;
+			stats.maxLatencyMs = std::max(stats.maxLatencyMs, latencyMs);
+		}
+
+		delete ps;
+	}
+}
+
+
+/**
+ * Reduces the least recently drawn squares to the lowest mip-level until
+ * at least <numBytes> are freed. Squares drawn in the last frame are kept,
+ * and so are squares with a pending request: their upload was admitted
+ * against the bytes of their current level, which eviction would change.
+ * @return number of bytes freed
+ */
+unsigned int CSMFGroundTextures::EvictSquares(unsigned int numBytes)
+{
+	std::vector< std::pair<unsigned int, int> > candidates;
+
+	for (int i = 0; i < int(squares.size()); ++i) {
+		const GroundSquare& square = squares[i];
+
+		if (square.luaTexture || square.texLevel >= 3)
+			continue;
+		if ((globalRendering->drawFrame - square.lastBoundFrame) <= 1)
+			continue;
+		if (square.pendingLevel >= 0)
+			continue;
+
+		candidates.push_back(std::make_pair(square.lastBoundFrame, i));
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	unsigned int freedBytes = 0;
+
+	for (unsigned int n = 0; n < candidates.size() && freedBytes < numBytes; ++n) {
+		const int i = candidates[n].second;
+		GroundSquare* square = &squares[i];
+
+		freedBytes += GetSquareTexBytes(smfMap->bigTexSize, square->texLevel);
+		freedBytes -= GetSquareTexBytes(smfMap->bigTexSize, 3);
+
+		// the lowest level is small enough to extract synchronously
+		FreeSquareTexture(square);
+		LoadSquareTexture(i % smfMap->numBigTexX, i / smfMap->numBigTexX, 3);
+
+		stats.numEvictions++;
+	}
+
+	return freedBytes;
+}
+
+
+void CSMFGroundTextures::PrepareThreadProc()
+{
+	Threading::SetThreadName("groundtex");
+
+	while (true) {
+		int squareIdx = -1;
+		int level = -1;
+
+		{
+			boost::mutex::scoped_lock lock(prepareMutex);
+
+			busySquareIdx = -1;
+			busyLevel = -1;
+
+			while (!quitPrepareThread && requestQueue.empty()) {
+				prepareCondition.wait(lock);
+			}
+			if (quitPrepareThread)
+				break;
+
+			squareIdx = requestQueue.top().squareIdx;
+			level = requestQueue.top().level;
+			requestQueue.pop();
+
+			busySquareIdx = squareIdx;
+			busyLevel = level;
+		}
+
+		// tiles and tileMap are read-only after loading
+		PreparedSquare* ps = new PreparedSquare();
+		ps->squareIdx = squareIdx;
+		ps->level = level;
+		ps->data.resize(GetSquareTexBytes(smfMap->bigTexSize, level));
+
+		ExtractSquareTiles(squareIdx % smfMap->numBigTexX, squareIdx / smfMap->numBigTexX, level, (GLint*) &ps->data[0]);
+
+		{
+			boost::mutex::scoped_lock lock(prepareMutex);
+			preparedSquares.push_back(ps);
 		}
 	}
 }
@@ -381,11 +652,12 @@ bool CSMFGroundTextures::SetSquareLuaTexture(int texSquareX, int texSquareY, int
 	if (texID != 0) {
 		if (!square->luaTexture) {
 			// only delete textures managed by us
-			glDeleteTextures(1, &square->textureID);
+			FreeSquareTexture(square);
 		}
 
 		square->textureID = texID;
 		square->luaTexture = true;
+		square->pendingLevel = -1;
 	} else {
 		if (square->luaTexture) {
 			// default texture will be loaded by the next
@@ -466,19 +738,27 @@ void CSMFGroundTextures::ExtractSquareTiles(
 
 void CSMFGroundTextures::LoadSquareTexture(int x, int y, int level)
 {
-	static const GLenum ttarget = GL_TEXTURE_2D;
-
-	const int mipSqSize = smfMap->bigTexSize >> level;
-	const int numSqBytes = (mipSqSize * mipSqSize) / 2;
-
-	GroundSquare* square = &squares[y * smfMap->numBigTexX + x];
-	square->texLevel = level;
+	const int numSqBytes = GetSquareTexBytes(smfMap->bigTexSize, level);
 
 	pbo.Bind();
 	pbo.Resize(numSqBytes);
 	ExtractSquareTiles(x, y, level, (GLint*) pbo.MapBuffer());
 	pbo.UnmapBuffer();
 
+	CreateSquareTexture(&squares[y * smfMap->numBigTexX + x], level, pbo.GetPtr());
+	pbo.Unbind();
+}
+
+void CSMFGroundTextures::CreateSquareTexture(GroundSquare* square, int level, const GLvoid* data)
+{
+	static const GLenum ttarget = GL_TEXTURE_2D;
+
+	const int mipSqSize = smfMap->bigTexSize >> level;
+	const int numSqBytes = GetSquareTexBytes(smfMap->bigTexSize, level);
+
+	square->texLevel = level;
+	residentBytes += numSqBytes;
+
 	glGenTextures(1, &square->textureID);
 	glBindTexture(ttarget, square->textureID);
 	glTexParameteri(ttarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -498,8 +778,17 @@ void CSMFGroundTextures::LoadSquareTexture(int x, int y, int level)
 		glTexParameterf(ttarget, GL_TEXTURE_PRIORITY, 0.5f);
 	}
 
-	glCompressedTexImage2D(ttarget, 0, texformat, mipSqSize, mipSqSize, 0, numSqBytes, pbo.GetPtr());
-	pbo.Unbind();
+	glCompressedTexImage2D(ttarget, 0, texformat, mipSqSize, mipSqSize, 0, numSqBytes, data);
+}
+
+void CSMFGroundTextures::FreeSquareTexture(GroundSquare* square)
+{
+	if (square->textureID == 0)
+		return;
+
+	glDeleteTextures(1, &square->textureID);
+	residentBytes -= GetSquareTexBytes(smfMap->bigTexSize, square->texLevel);
+	square->textureID = 0;
 }
 
 void CSMFGroundTextures::BindSquareTexture(int texSquareX, int texSquareY)
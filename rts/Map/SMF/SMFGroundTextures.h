@@ -5,6 +5,14 @@
 
 #include "Map/BaseGroundTextures.h"
 #include "Rendering/GL/PBO.h"
+#include "System/Misc/SpringTime.h"
+
+#include <list>
+#include <queue>
+#include <vector>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
 
 class CSMFReadMap;
 
@@ -20,18 +28,52 @@ public:
 	void BindSquareTexture(int texSquareX, int texSquareY);
 
 protected:
-	void ExtractSquareTiles(const int texSquareX, const int texSquareY, const int mipLevel, GLint* tileBuf) const;
-	void LoadSquareTexture(int x, int y, int level);
-
-	CSMFReadMap* smfMap;
-
 	struct GroundSquare {
 		unsigned int texLevel;
 		unsigned int textureID;
 		unsigned int lastBoundFrame;
 		bool luaTexture;
+
+		/// level requested from the prepare-thread, -1 if none
+		int pendingLevel;
+		spring_time requestTime;
+	};
+
+	/// a square (index) whose tiles the prepare-thread should extract
+	struct SquareRequest {
+		SquareRequest(int idx, int lvl, float prio): squareIdx(idx), level(lvl), priority(prio) {}
+
+		/// top of the queue is the request with the smallest camera distance
+		bool operator < (const SquareRequest& r) const { return (priority > r.priority); }
+		static bool IsCloser(const SquareRequest& a, const SquareRequest& b) { return (a.priority < b.priority); }
+
+		int squareIdx;
+		int level;
+		float priority;
+	};
+
+	struct PreparedSquare {
+		int squareIdx;
+		int level;
+		std::vector<char> data;
 	};
 
+	void ExtractSquareTiles(const int texSquareX, const int texSquareY, const int mipLevel, GLint* tileBuf) const;
+	void LoadSquareTexture(int x, int y, int level);
+	void CreateSquareTexture(GroundSquare* square, int level, const GLvoid* data);
+	void FreeSquareTexture(GroundSquare* square);
+
+	void UploadPreparedSquares();
+	void QueueSquareRequests(const std::vector<SquareRequest>& requests);
+	unsigned int EvictSquares(unsigned int numBytes);
+	void PrepareThreadProc();
+
+	static unsigned int GetSquareTexBytes(int bigTexSize, int level) {
+		return (((bigTexSize >> level) * (bigTexSize >> level)) / 2);
+	}
+
+	CSMFReadMap* smfMap;
+
 	std::vector<GroundSquare> squares;
 
 	std::vector<int> tileMap;
@@ -46,6 +88,33 @@ protected:
 	PBO pbo;
 	int texformat;
 
+	/// bytes of all resident (non-Lua) square textures
+	unsigned int residentBytes;
+	/// 0 means unlimited
+	unsigned int memoryBudget;
+
+	struct Stats {
+		unsigned int numRequests;
+		unsigned int numMisses;
+		unsigned int numUploads;
+		unsigned int numDiscarded;
+		unsigned int numEvictions;
+		float sumLatencyMs;
+		float maxLatencyMs;
+	} stats;
+
+	// shared with the prepare-thread, guarded by prepareMutex
+	boost::thread* prepareThread;
+	boost::mutex prepareMutex;
+	boost::condition prepareCondition;
+
+	std::priority_queue<SquareRequest> requestQueue;
+	std::list<PreparedSquare*> preparedSquares;
+
+	int busySquareIdx;
+	int busyLevel;
+	bool quitPrepareThread;
+
 	inline bool TexSquareInView(int, int) const;
 };
 
@@ -12,6 +12,7 @@
 #include "Rendering/Env/ISky.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/Textures/Bitmap.h"
+#include "Rendering/Textures/BitmapLoader.h"
 #include "System/bitops.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/EventHandler.h"
@@ -53,6 +54,7 @@ CSMFReadMap::CSMFReadMap(std::string mapname)
 	haveSpecularTexture = !(mapInfo->smf.specularTexName.empty());
 	haveSplatTexture = (!mapInfo->smf.splatDetailTexName.empty() && !mapInfo->smf.splatDistrTexName.empty());
 
+	QueueTextures();
 	ParseHeader();
 	LoadHeightMap();
 	CReadMap::Initialize();
@@ -172,6 +174,27 @@ void CSMFReadMap::InitializeWaterHeightColors()
 }
 
 
+void CSMFReadMap::QueueTextures()
+{
+	// decoded on worker threads while the heightmap and minimap are loaded,
+	// every texture queued here has to be taken by one of the Create* calls
+	if (haveSpecularTexture) {
+		bitmapLoader->Queue(mapInfo->smf.specularTexName);
+		bitmapLoader->Queue(mapInfo->smf.skyReflectModTexName);
+		bitmapLoader->Queue(mapInfo->smf.detailNormalTexName);
+		bitmapLoader->Queue(mapInfo->smf.lightEmissionTexName);
+		bitmapLoader->Queue(mapInfo->smf.parallaxHeightTexName);
+	}
+	if (haveSplatTexture) {
+		bitmapLoader->Queue(mapInfo->smf.splatDetailTexName);
+		bitmapLoader->Queue(mapInfo->smf.splatDistrTexName);
+	}
+
+	bitmapLoader->Queue(mapInfo->smf.grassShadingTexName);
+	bitmapLoader->Queue(mapInfo->smf.detailTexName);
+}
+
+
 void CSMFReadMap::CreateSpecularTex()
 {
 	if (!haveSpecularTexture) {
@@ -184,7 +207,7 @@ void CSMFReadMap::CreateSpecularTex()
 	CBitmap lightEmissionTexBM;
 	CBitmap parallaxHeightTexBM;
 
-	if (!specularTexBM.Load(mapInfo->smf.specularTexName)) {
+	if (!bitmapLoader->Load(mapInfo->smf.specularTexName, specularTexBM)) {
 		// maps wants specular lighting, but no moderation
 		specularTexBM.channels = 4;
 		specularTexBM.Alloc(1, 1);
@@ -197,19 +220,19 @@ void CSMFReadMap::CreateSpecularTex()
 	specularTex = specularTexBM.CreateTexture(false);
 
 	// no default 1x1 textures for these
-	if (skyReflectModTexBM.Load(mapInfo->smf.skyReflectModTexName)) {
+	if (bitmapLoader->Load(mapInfo->smf.skyReflectModTexName, skyReflectModTexBM)) {
 		skyReflectModTex = skyReflectModTexBM.CreateTexture(false);
 	}
 
-	if (detailNormalTexBM.Load(mapInfo->smf.detailNormalTexName)) {
+	if (bitmapLoader->Load(mapInfo->smf.detailNormalTexName, detailNormalTexBM)) {
 		detailNormalTex = detailNormalTexBM.CreateTexture(false);
 	}
 
-	if (lightEmissionTexBM.Load(mapInfo->smf.lightEmissionTexName)) {
+	if (bitmapLoader->Load(mapInfo->smf.lightEmissionTexName, lightEmissionTexBM)) {
 		lightEmissionTex = lightEmissionTexBM.CreateTexture(false);
 	}
 
-	if (parallaxHeightTexBM.Load(mapInfo->smf.parallaxHeightTexName)) {
+	if (bitmapLoader->Load(mapInfo->smf.parallaxHeightTexName, parallaxHeightTexBM)) {
 		parallaxHeightTex = parallaxHeightTexBM.CreateTexture(false);
 	}
 }
@@ -225,7 +248,7 @@ void CSMFReadMap::CreateSplatDetailTextures()
 
 	// if the map supplies an intensity- AND a distribution-texture for
 	// detail-splat blending, the regular detail-texture is not used
-	if (!splatDetailTexBM.Load(mapInfo->smf.splatDetailTexName)) {
+	if (!bitmapLoader->Load(mapInfo->smf.splatDetailTexName, splatDetailTexBM)) {
 		// default detail-texture should be all-grey
 		splatDetailTexBM.channels = 4;
 		splatDetailTexBM.Alloc(1, 1);
@@ -235,7 +258,7 @@ void CSMFReadMap::CreateSplatDetailTextures()
 		splatDetailTexBM.mem[3] = 127;
 	}
 
-	if (!splatDistrTexBM.Load(mapInfo->smf.splatDistrTexName)) {
+	if (!bitmapLoader->Load(mapInfo->smf.splatDistrTexName, splatDistrTexBM)) {
 		splatDistrTexBM.channels = 4;
 		splatDistrTexBM.Alloc(1, 1);
 		splatDistrTexBM.mem[0] = 255;
@@ -254,7 +277,7 @@ void CSMFReadMap::CreateGrassTex()
 	grassShadingTex = minimapTex;
 
 	CBitmap grassShadingTexBM;
-	if (grassShadingTexBM.Load(mapInfo->smf.grassShadingTexName)) {
+	if (bitmapLoader->Load(mapInfo->smf.grassShadingTexName, grassShadingTexBM)) {
 		grassShadingTex = grassShadingTexBM.CreateTexture(true);
 	}
 }
@@ -263,7 +286,7 @@ void CSMFReadMap::CreateGrassTex()
 void CSMFReadMap::CreateDetailTex()
 {
 	CBitmap detailTexBM;
-	if (!detailTexBM.Load(mapInfo->smf.detailTexName)) {
+	if (!bitmapLoader->Load(mapInfo->smf.detailTexName, detailTexBM)) {
 		throw content_error("Could not load detail texture from file " + mapInfo->smf.detailTexName);
 	}
 
@@ -554,6 +577,7 @@ void CSMFReadMap::UpdateShadingTexture(const SRectangle& update)
 		// redefine the texture subregion
 		glBindTexture(GL_TEXTURE_2D, shadingTex);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, x1, y1, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+		minimapRevision++;
 	}
 }
 
@@ -671,6 +695,7 @@ void CSMFReadMap::UpdateShadingTexture()
 		//FIXME use FBO and blend slowly new and old? (this way update rate could reduced even more -> saves CPU time)
 		glBindTexture(GL_TEXTURE_2D, shadingTex);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, &shadingTexBuffer[0]);
+		minimapRevision++;
 		return;
 	}
 
@@ -72,6 +72,7 @@ private:
 	void LoadHeightMap();
 	void LoadMinimap();
 	void InitializeWaterHeightColors();
+	void QueueTextures();
 	void CreateSpecularTex();
 	void CreateSplatDetailTextures();
 	void CreateGrassTex();
@@ -5,7 +5,9 @@
 
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/GL/myGL.h"
+#include "Rendering/GL/AsyncPixelReader.h"
 #include "Game/GameVersion.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 #include "System/SpringApp.h"
 #include "System/Platform/Threading.h"
@@ -14,6 +16,7 @@
 
 #include <boost/bind.hpp>
 #include <cassert>
+#include <cstring>
 
 #if defined(_WIN32) && !defined(__MINGW32__)
 #pragma message("Adding library: vfw32.lib")
@@ -89,6 +92,7 @@ CAVIGenerator::CAVIGenerator(const std::string& fileName, int videoSizeX, int vi
 							quitAVIgen(false),
 							AVIThread(0),
 							readBuf(NULL),
+							pixelReader(NULL),
 							m_lFrame(0),
 							m_pAVIFile(NULL),
 							m_pStream(NULL),
@@ -140,6 +144,10 @@ CAVIGenerator::~CAVIGenerator() {
 	delete [] readBuf;
 	readBuf = 0;
 
+	// frames still in flight are dropped, like the ones in imageBuffers
+	delete pixelReader;
+	pixelReader = NULL;
+
 
 	ReleaseAVICompressionEngine();
 	LOG("Finished writing avi file %s", fileName.c_str());
@@ -344,6 +352,10 @@ bool CAVIGenerator::InitEngine() {
 		freeImageBuffers.push_back(tmpBuf);
 	}
 
+	// width is a multiple of 4, so BGR rows are not padded
+	pixelReader = new CAsyncPixelReader(bitmapInfo.biWidth, bitmapInfo.biHeight, GL_BGR_EXT, configHandler->GetInt("VideoCapturingReadBuffers"));
+	assert(pixelReader->GetFrameSize() == bitmapInfo.biSizeImage);
+
 	HWND mainWindow = FindWindow(NULL, ("Spring " + SpringVersion::GetFull()).c_str());
 	if (globalRendering->fullScreen) {
 		ShowWindow(mainWindow, SW_SHOWMINNOACTIVE);
@@ -379,26 +391,39 @@ HRESULT CAVIGenerator::AddFrame(unsigned char* pixelData){
 
 bool CAVIGenerator::readOpenglPixelDataThreaded() {
 
-	while (true) {
-		boost::mutex::scoped_lock lock(AVIMutex);
-		if (quitAVIgen) {
-			return false;
-		} else if (readBuf != NULL) {
+	pixelReader->QueueRead();
+
+	// the oldest read is VideoCapturingReadBuffers-1 frames old by now
+	// (with a single buffer it is this frame's), hand it to the encoder
+	// thread to make room for the next frame's read
+	if (pixelReader->IsFull()) {
+		{
+			boost::mutex::scoped_lock lock(AVIMutex);
+			while (!quitAVIgen && freeImageBuffers.empty()) {
+				AVICondition.wait(lock);
+			}
+			if (quitAVIgen) {
+				return false;
+			}
+			readBuf = freeImageBuffers.front();
+			freeImageBuffers.pop_front();
+		}
+
+		const unsigned char* pixels = pixelReader->MapOldest();
+		if (pixels != NULL) {
+			memcpy(readBuf, pixels, bitmapInfo.biSizeImage);
+		}
+		pixelReader->UnmapOldest();
+
+		{
+			boost::mutex::scoped_lock lock(AVIMutex);
 			imageBuffers.push_back(readBuf);
 			readBuf = NULL;
 			AVICondition.notify_all();
 		}
-		if (freeImageBuffers.empty()) {
-			AVICondition.wait(lock);
-		} else {
-			readBuf = freeImageBuffers.front();
-			freeImageBuffers.pop_front();
-			break;
-		}
 	}
 
-	glReadPixels(0, 0, bitmapInfo.biWidth, bitmapInfo.biHeight, GL_BGR_EXT, GL_UNSIGNED_BYTE, readBuf);
-	return true;
+	return !quitAVIgen;
 }
 
 
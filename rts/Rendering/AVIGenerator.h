@@ -16,6 +16,7 @@
 #include <string>
 #include <list>
 
+class CAsyncPixelReader;
 
 class CAVIGenerator : boost::noncopyable {
 public:
@@ -57,6 +58,8 @@ private:
 
 	unsigned char* readBuf;
 
+	/// ring of PBOs the frames are read into
+	CAsyncPixelReader* pixelReader;
 
 
 	bool initVFW();
@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include "ExternalAI/EngineOutHandler.h"
 #include "Game/GameHelper.h"
 #include "Game/GlobalUnsynced.h"
 #include "Game/UI/GuiHandler.h"
@@ -53,8 +54,10 @@ DefaultPathDrawer::DefaultPathDrawer(): IPathDrawer() {
 }
 
 void DefaultPathDrawer::DrawAll() const {
-	// CPathManager is not thread-safe
+	// CPathManager is not thread-safe (threaded Skirmish AIs request paths too)
 	if (!GML::SimEnabled() && enabled && (gs->cheatEnabled || gu->spectating)) {
+		const CScopedAIWorldLock aiWorldLock;
+
 		glPushAttrib(GL_ENABLE_BIT);
 
 		Draw();
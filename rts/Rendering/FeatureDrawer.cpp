@@ -108,6 +108,7 @@ void CFeatureDrawer::RenderFeatureCreated(const CFeature* feature)
 		UpdateDrawQuad(f);
 
 		unsortedFeatures.insert(f);
+		featureCuller.AddObject(f->id, f->drawMidPos, f->drawRadius);
 	}
 }
 
@@ -117,6 +118,7 @@ void CFeatureDrawer::RenderFeatureDestroyed(const CFeature* feature)
 
 	if (f->def->drawType == DRAWTYPE_MODEL) {
 		unsortedFeatures.erase(f);
+		featureCuller.RemoveObject(f->id);
 	}
 
 	if (f->drawQuad >= 0) {
@@ -174,8 +176,14 @@ void CFeatureDrawer::Update()
 		GML_RECMUTEX_LOCK(feat); // Update
 
 		for (std::set<CFeature*>::iterator fsi = unsortedFeatures.begin(); fsi != unsortedFeatures.end(); ++fsi) {
-			UpdateDrawPos(*fsi);
+			CFeature* f = *fsi;
+
+			UpdateDrawPos(f);
+			featureCuller.SetObject(f->id, f->drawMidPos, f->drawRadius);
 		}
+
+		// LOS is still tested per feature (there are no LOS events for them)
+		featureCuller.Cull(CObjectCuller::CULL_SET_MAIN, camera, 0.0f, -1, 0);
 	}
 }
 
@@ -196,6 +204,12 @@ void CFeatureDrawer::Draw()
 
 	GML_RECMUTEX_LOCK(feat); // Draw
 
+	// reflection and refraction passes use their own camera
+	// (the result is also used by the DrawFadeFeatures call)
+	if (GetCullSet() == CObjectCuller::CULL_SET_WATER) {
+		featureCuller.Cull(CObjectCuller::CULL_SET_WATER, camera, 0.0f, -1, 0);
+	}
+
 	CBaseGroundDrawer* gd = readmap->GetGroundDrawer();
 
 	if (gd->DrawExtraTex()) {
@@ -314,9 +328,22 @@ void CFeatureDrawer::DrawFeatureStatBars(const CFeature* feature)
 }
 #endif
 
+unsigned int CFeatureDrawer::GetCullSet() const
+{
+	if (water->IsDrawReflection() || water->IsDrawRefraction())
+		return CObjectCuller::CULL_SET_WATER;
+
+	return CObjectCuller::CULL_SET_MAIN;
+}
+
+bool CFeatureDrawer::InView(const CFeature* f) const
+{
+	return featureCuller.IsVisible(GetCullSet(), f->id, CObjectCuller::CULL_FLAG_VIEW);
+}
+
 bool CFeatureDrawer::DrawFeatureNow(const CFeature* feature, float alpha)
 {
-	if (!camera->InView(feature->drawMidPos, feature->drawRadius)) { return false; }
+	if (!InView(feature)) { return false; }
 	if (!feature->IsInLosForAllyTeam(gu->myAllyTeam) && !gu->spectatingFullView) { return false; }
 
 	const float sqDist = (feature->pos - camera->GetPos()).SqLength();
@@ -546,12 +573,12 @@ public:
 
 					if (sqDist < sqFadeDistB) {
 						cloakedModelRenderers[MDL_TYPE(f)]->DelFeature(f);
-						if (camera->InView(f->drawMidPos, f->drawRadius))
+						if (featureDrawer->InView(f))
 							opaqueModelRenderers[MDL_TYPE(f)]->AddFeature(f);
 					} else if (sqDist < sqFadeDistE) {
 						const float falpha = 1.0f - (sqDist - sqFadeDistB) / (sqFadeDistE - sqFadeDistB);
 						opaqueModelRenderers[MDL_TYPE(f)]->DelFeature(f);
-						if (camera->InView(f->drawMidPos, f->drawRadius))
+						if (featureDrawer->InView(f))
 							cloakedModelRenderers[MDL_TYPE(f)]->AddFeature(f, falpha);
 					}
 				} else {
@@ -8,6 +8,7 @@
 #include "System/creg/creg_cond.h"
 #include "System/EventClient.h"
 #include "Rendering/Models/WorldObjectModelRenderer.h"
+#include "Rendering/ObjectCuller.h"
 
 class CFeature;
 class IWorldObjectModelRenderer;
@@ -65,10 +66,16 @@ private:
 	void DrawFadeFeaturesSet(FeatureSet&, int);
 	void GetVisibleFeatures(int, bool drawFar);
 
+	unsigned int GetCullSet() const;
+	bool InView(const CFeature* f) const;
+
 	void PostLoad();
 
 	std::set<CFeature*> unsortedFeatures;
 
+	/// draw-positions of <unsortedFeatures>, culled once per pass
+	CObjectCuller featureCuller;
+
 	struct DrawQuad {
 		CR_DECLARE_STRUCT(DrawQuad);
 		std::set<CFeature*> features;
@@ -0,0 +1,91 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "AsyncPixelReader.h"
+#include "VBO.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+CAsyncPixelReader::CAsyncPixelReader(int _sizeX, int _sizeY, GLenum _format, unsigned int numBuffers)
+	: sizeX(_sizeX)
+	, sizeY(_sizeY)
+	, format(_format)
+	, oldest(0)
+	, numQueued(0)
+	, mapped(false)
+{
+	const unsigned int bytesPerPixel = (format == GL_RGB || format == GL_BGR)? 3: 4;
+
+	// rows are padded to GL_PACK_ALIGNMENT (default 4)
+	rowSize   = ((sizeX * bytesPerPixel) + 3) & ~3;
+	frameSize = rowSize * sizeY;
+
+	buffers.resize(std::max(numBuffers, 1u), NULL);
+
+	for (unsigned int n = 0; n < buffers.size(); n++) {
+		buffers[n] = new VBO(GL_PIXEL_PACK_BUFFER);
+		buffers[n]->Bind(GL_PIXEL_PACK_BUFFER);
+		buffers[n]->Resize(frameSize, GL_STREAM_READ);
+		buffers[n]->Unbind();
+	}
+}
+
+CAsyncPixelReader::~CAsyncPixelReader()
+{
+	if (mapped) {
+		UnmapOldest();
+	}
+
+	for (unsigned int n = 0; n < buffers.size(); n++) {
+		delete buffers[n];
+	}
+}
+
+
+void CAsyncPixelReader::QueueRead()
+{
+	assert(!IsFull());
+
+	VBO* pbo = buffers[(oldest + numQueued) % buffers.size()];
+
+	// with a bound pack-buffer the last argument is an offset into it
+	pbo->Bind(GL_PIXEL_PACK_BUFFER);
+	glReadPixels(0, 0, sizeX, sizeY, format, GL_UNSIGNED_BYTE, const_cast<GLvoid*>(pbo->GetPtr()));
+	pbo->Unbind();
+
+	numQueued++;
+}
+
+
+const unsigned char* CAsyncPixelReader::MapOldest()
+{
+	assert(!mapped);
+
+	if (numQueued == 0)
+		return NULL;
+
+	VBO* pbo = buffers[oldest];
+
+	// NOTE:
+	//   GL_READ_ONLY would be converted to an unsynchronized map,
+	//   which can return the pixels before the transfer finished
+	pbo->Bind(GL_PIXEL_PACK_BUFFER);
+	mapped = true;
+
+	return pbo->MapBuffer(0, frameSize, GL_MAP_READ_BIT);
+}
+
+void CAsyncPixelReader::UnmapOldest()
+{
+	assert(mapped);
+
+	VBO* pbo = buffers[oldest];
+
+	pbo->UnmapBuffer();
+	pbo->Unbind();
+	mapped = false;
+
+	oldest = (oldest + 1) % buffers.size();
+	numQueued--;
+}
@@ -0,0 +1,70 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef ASYNC_PIXEL_READER_H
+#define ASYNC_PIXEL_READER_H
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "myGL.h"
+
+class VBO;
+
+/**
+ * @brief CAsyncPixelReader
+ *
+ * Reads the framebuffer into a ring of pixel-pack buffers, so that
+ * glReadPixels returns immediately and the copy happens on the GPU
+ * while the next frames are drawn. The pixels of a read are mapped
+ * once the ring is full, i.e. (numBuffers - 1) frames later, which is
+ * normally long after the transfer has finished.
+ *
+ * Falls back to synchronous reads into client memory if PBOs are not
+ * supported (same interface, just no overlap).
+ */
+class CAsyncPixelReader : boost::noncopyable
+{
+public:
+	/**
+	 * @param format GL_RGB, GL_BGR, GL_RGBA or GL_BGRA (GL_UNSIGNED_BYTE components)
+	 * @param numBuffers number of frames that can be in flight
+	 */
+	CAsyncPixelReader(int sizeX, int sizeY, GLenum format, unsigned int numBuffers);
+	~CAsyncPixelReader();
+
+	/// starts reading the lower-left sizeX * sizeY pixels of the current read-buffer (ring must not be full)
+	void QueueRead();
+
+	/**
+	 * Waits for the oldest queued read and maps its pixels.
+	 * Rows are bottom-up and GetRowSize() bytes (4-byte aligned) apart.
+	 * @return NULL if no read is queued
+	 */
+	const unsigned char* MapOldest();
+	/// releases the pixels returned by MapOldest and frees their slot
+	void UnmapOldest();
+
+	bool IsFull() const { return (numQueued == buffers.size()); }
+	unsigned int GetNumQueued() const { return numQueued; }
+
+	int GetSizeX() const { return sizeX; }
+	int GetSizeY() const { return sizeY; }
+	unsigned int GetRowSize() const { return rowSize; }
+	unsigned int GetFrameSize() const { return frameSize; }
+
+private:
+	int sizeX;
+	int sizeY;
+	GLenum format;
+
+	unsigned int rowSize;
+	unsigned int frameSize;
+
+	std::vector<VBO*> buffers;
+
+	unsigned int oldest;
+	unsigned int numQueued;
+	bool mapped;
+};
+
+#endif // ASYNC_PIXEL_READER_H
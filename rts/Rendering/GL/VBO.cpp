@@ -38,7 +38,7 @@ bool VBO::IsPBOSupported()
 
 bool VBO::IsSupported() const
 {
-	if (defTarget == GL_PIXEL_UNPACK_BUFFER) {
+	if (defTarget == GL_PIXEL_UNPACK_BUFFER || defTarget == GL_PIXEL_PACK_BUFFER) {
 		return IsPBOSupported();
 	} else {
 		return IsVBOSupported();
@@ -3,6 +3,16 @@
 #include <cstring>
 
 #include "VertexArray.h"
+#include "VBO.h"
+#include "System/Platform/Threading.h"
+
+// vertices of every draw are appended to this buffer until it is full, then it
+// gets orphaned; earlier draws still read the old storage so nothing stalls
+#define STREAM_BUFFER_SIZE (4 * 1024 * 1024)
+
+static VBO* streamBuffer = NULL;
+static unsigned int streamBufferPos = 0;
+static bool streamBufferBound = false;
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -39,6 +49,78 @@ bool CVertexArray::IsReady() const
 	return true;
 }
 
+
+void CVertexArray::InitStreamBuffer()
+{
+	// GML queues GL calls, but would write the mapped memory right away
+	if (GML::Enabled() || !VBO::IsVBOSupported())
+		return;
+
+	streamBuffer = new VBO(GL_ARRAY_BUFFER);
+	streamBuffer->Bind(GL_ARRAY_BUFFER);
+	streamBuffer->Resize(STREAM_BUFFER_SIZE, GL_STREAM_DRAW);
+	streamBuffer->Unbind();
+	streamBufferPos = 0;
+}
+
+void CVertexArray::FreeStreamBuffer()
+{
+	delete streamBuffer;
+	streamBuffer = NULL;
+}
+
+
+/**
+ * Copies the vertices into the stream buffer and leaves it bound,
+ * returns the base address to pass to the gl*Pointer functions
+ * (<drawArray> itself if the vertices are drawn from client memory)
+ */
+const float* CVertexArray::BindDrawArray() const
+{
+	const unsigned int numBytes = drawIndex() * sizeof(float);
+
+	if (streamBuffer == NULL || numBytes > STREAM_BUFFER_SIZE)
+		return drawArray;
+	if (!Threading::IsMainThread())
+		return drawArray;
+
+	streamBuffer->Bind(GL_ARRAY_BUFFER);
+
+	if ((streamBufferPos + numBytes) > STREAM_BUFFER_SIZE) {
+		streamBuffer->Resize(STREAM_BUFFER_SIZE, GL_STREAM_DRAW);
+		streamBufferPos = 0;
+	}
+
+	// unsynchronized: this range was not written since the last orphaning
+	GLubyte* mem = streamBuffer->MapBuffer(streamBufferPos, numBytes, GL_WRITE_ONLY);
+
+	if (mem == NULL) {
+		streamBuffer->UnmapBuffer();
+		streamBuffer->Unbind();
+		return drawArray;
+	}
+
+	memcpy(mem, drawArray, numBytes);
+	streamBuffer->UnmapBuffer();
+
+	const float* base = reinterpret_cast<const float*>(streamBuffer->GetPtr(streamBufferPos));
+
+	// keep every draw's vertices 64-byte aligned
+	streamBufferPos += ((numBytes + 63) & ~63);
+	streamBufferBound = true;
+
+	return base;
+}
+
+void CVertexArray::UnbindDrawArray() const
+{
+	if (!streamBufferBound)
+		return;
+
+	streamBuffer->Unbind();
+	streamBufferBound = false;
+}
+
 void CVertexArray::EndStrip()
 {
 	if ((char*)stripArrayPos > ((char*)stripArraySize - 4 * sizeof(unsigned int))) {
@@ -196,10 +278,15 @@ void CVertexArray::DrawArray0(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
+	glVertexPointer(3, GL_FLOAT, stride, base);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_VERTEX_ARRAY);
+
+	UnbindDrawArray();
 }
 
 void CVertexArray::DrawArray2d0(const int drawType, unsigned int stride)
@@ -208,10 +295,15 @@ void CVertexArray::DrawArray2d0(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
+	glVertexPointer(2, GL_FLOAT, stride, base);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_VERTEX_ARRAY);
+
+	UnbindDrawArray();
 }
 
 void CVertexArray::DrawArrayN(const int drawType, unsigned int stride)
@@ -220,13 +312,18 @@ void CVertexArray::DrawArrayN(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glNormalPointer(GL_FLOAT, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, base);
+	glNormalPointer(GL_FLOAT, stride, base + 3);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_NORMAL_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
@@ -236,13 +333,18 @@ void CVertexArray::DrawArrayC(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glColorPointer(4, GL_UNSIGNED_BYTE, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, base);
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, base + 3);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
@@ -252,13 +354,18 @@ void CVertexArray::DrawArrayT(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, base);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 3);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
@@ -268,13 +375,18 @@ void CVertexArray::DrawArray2dT(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 2);
+	glVertexPointer(2, GL_FLOAT, stride, base);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 2);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
@@ -284,16 +396,21 @@ void CVertexArray::DrawArray2dTC(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 2);
-	glColorPointer(4, GL_UNSIGNED_BYTE, stride, drawArray + 4);
+	glVertexPointer(2, GL_FLOAT, stride, base);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 2);
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, base + 4);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
@@ -319,13 +436,16 @@ void CVertexArray::DrawArrayT2(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, base);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 3);
 
 	glClientActiveTextureARB(GL_TEXTURE1_ARB);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 5);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 5);
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glClientActiveTextureARB(GL_TEXTURE0_ARB);
 	DrawArrays(drawType, stride);
@@ -335,6 +455,8 @@ void CVertexArray::DrawArrayT2(const int drawType, unsigned int stride)
 
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
@@ -344,18 +466,23 @@ void CVertexArray::DrawArrayTN(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
 
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
-	glNormalPointer(GL_FLOAT, stride, drawArray + 5);
+	glVertexPointer(3, GL_FLOAT, stride, base);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 3);
+	glNormalPointer(GL_FLOAT, stride, base + 5);
 	DrawArrays(drawType, stride);
 
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_NORMAL_ARRAY);
+
+	UnbindDrawArray();
 }
 
 void CVertexArray::DrawArrayTNT(const int drawType, unsigned int stride)
@@ -365,6 +492,9 @@ void CVertexArray::DrawArrayTNT(const int drawType, unsigned int stride)
 
 	CheckEndStrip();
 
+	const float* base = BindDrawArray();
+
+
 	#define SET_ENABLE_ACTIVE_TEX(texUnit)            \
 		glClientActiveTexture(texUnit);               \
 		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -375,13 +505,13 @@ void CVertexArray::DrawArrayTNT(const int drawType, unsigned int stride)
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
 
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE0); glTexCoordPointer(2, GL_FLOAT, stride, drawArray +  3);
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE1); glTexCoordPointer(2, GL_FLOAT, stride, drawArray +  3); // FIXME? (format-specific)
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE5); glTexCoordPointer(3, GL_FLOAT, stride, drawArray +  8);
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE6); glTexCoordPointer(3, GL_FLOAT, stride, drawArray + 11);
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE0); glTexCoordPointer(2, GL_FLOAT, stride, base +  3);
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE1); glTexCoordPointer(2, GL_FLOAT, stride, base +  3); // FIXME? (format-specific)
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE5); glTexCoordPointer(3, GL_FLOAT, stride, base +  8);
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE6); glTexCoordPointer(3, GL_FLOAT, stride, base + 11);
 
-	glVertexPointer(3, GL_FLOAT, stride, drawArray + 0);
-	glNormalPointer(GL_FLOAT, stride, drawArray + 5);
+	glVertexPointer(3, GL_FLOAT, stride, base + 0);
+	glNormalPointer(GL_FLOAT, stride, base + 5);
 
 	DrawArrays(drawType, stride);
 
@@ -395,6 +525,8 @@ void CVertexArray::DrawArrayTNT(const int drawType, unsigned int stride)
 
 	#undef SET_ENABLE_ACTIVE_TEX
 	#undef SET_DISABLE_ACTIVE_TEX
+
+	UnbindDrawArray();
 }
 
 
@@ -404,16 +536,21 @@ void CVertexArray::DrawArrayTC(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* base = BindDrawArray();
+
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
-	glColorPointer(4, GL_UNSIGNED_BYTE, stride, drawArray + 5);
+	glVertexPointer(3, GL_FLOAT, stride, base);
+	glTexCoordPointer(2, GL_FLOAT, stride, base + 3);
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, base + 5);
 	DrawArrays(drawType, stride);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
+
+	UnbindDrawArray();
 }
 
 
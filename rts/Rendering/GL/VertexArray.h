@@ -68,6 +68,7 @@ public:
 	inline void AddVertexQC(const float3& p, const unsigned char* c);
 	inline void AddVertexQT(const float3& p, float tx, float ty);
 	inline void AddVertex2dQT(float x, float y, float tx, float ty);
+	inline void AddVertex2dQTC(float x, float y, float tx, float ty, const unsigned char* c);
 	inline void AddVertexQTN(const float3& p, float tx, float ty, const float3& n);
 	inline void AddVertexQTNT(const float3& p, float tx, float ty, const float3& n, const float3& st, const float3& tt);
 	inline void AddVertexQTC(const float3& p, float tx, float ty, const unsigned char* c);
@@ -79,6 +80,11 @@ public:
 
 	bool IsReady() const;
 	inline unsigned int drawIndex() const;
+
+	/// create / free the buffer all DrawArray* calls stream their vertices through
+	static void InitStreamBuffer();
+	static void FreeStreamBuffer();
+
 	inline void EnlargeArrays(const unsigned int vertexes, const unsigned int strips, const unsigned int stripsize = VA_SIZE_0);
 
 	float* drawArray;
@@ -92,6 +98,9 @@ public:
 	unsigned int maxVertices;
 
 protected:
+	const float* BindDrawArray() const;
+	void UnbindDrawArray() const;
+
 	void DrawArrays(const GLenum mode, const unsigned int stride);
 	void DrawArraysCallback(const GLenum mode, const unsigned int stride, StripCallback callback, void* data);
 	inline void CheckEnlargeDrawArray();
@@ -117,6 +117,15 @@ void CVertexArray::AddVertex2dQT(float x, float y, float tx, float ty) {
 	*drawArrayPos++ = ty;
 }
 
+void CVertexArray::AddVertex2dQTC(float x, float y, float tx, float ty, const unsigned char* col) {
+	ASSERT_SIZE(VA_SIZE_2DTC)
+	*drawArrayPos++ = x;
+	*drawArrayPos++ = y;
+	*drawArrayPos++ = tx;
+	*drawArrayPos++ = ty;
+	*drawArrayPos++ = *(reinterpret_cast<const float*>(col));
+}
+
 
 
 void CVertexArray::AddVertex0(const float3& pos) {
@@ -379,11 +379,15 @@ void LoadExtensions()
 
 	vertexArray1 = new CVertexArray;
 	vertexArray2 = new CVertexArray;
+
+	CVertexArray::InitStreamBuffer();
 }
 
 
 void UnloadExtensions()
 {
+	CVertexArray::FreeStreamBuffer();
+
 	delete vertexArray1;
 	delete vertexArray2;
 	vertexArray1 = NULL;
@@ -81,6 +81,7 @@ CR_REG_METADATA(CGlobalRendering, (
 	CR_IGNORED(supportNPOTs),
 	CR_IGNORED(support24bitDepthBuffers),
 	CR_IGNORED(supportRestartPrimitive),
+	CR_IGNORED(supportInstancing),
 	CR_IGNORED(haveARB),
 	CR_IGNORED(haveGLSL),
 	CR_IGNORED(maxSmoothPointSize),
@@ -152,6 +153,7 @@ CGlobalRendering::CGlobalRendering()
 	, supportNPOTs(false)
 	, support24bitDepthBuffers(false)
 	, supportRestartPrimitive(false)
+	, supportInstancing(false)
 	, haveARB(false)
 	, haveGLSL(false)
 	, maxSmoothPointSize(1.0f)
@@ -225,6 +227,9 @@ void CGlobalRendering::PostInit() {
 #ifdef GLEW_NV_primitive_restart
 	supportRestartPrimitive = !!(GLEW_NV_primitive_restart);
 #endif
+#if defined(GLEW_ARB_draw_instanced) && defined(GLEW_ARB_instanced_arrays)
+	supportInstancing = (GLEW_ARB_draw_instanced && GLEW_ARB_instanced_arrays);
+#endif
 
 	// maximum 2D texture size
 	{
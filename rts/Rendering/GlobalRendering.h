@@ -196,6 +196,14 @@ public:
 
 	bool supportRestartPrimitive;
 
+	/**
+	 * @brief supportInstancing
+	 *
+	 * if glDrawElementsInstanced and per-instance vertex attributes
+	 * (ARB_draw_instanced and ARB_instanced_arrays) are available
+	 */
+	bool supportInstancing;
+
 	/**
 	 * Shader capabilities
 	 */
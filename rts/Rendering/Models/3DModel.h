@@ -53,6 +53,9 @@ struct S3DModelPiece {
 	virtual void Shatter(float, int, int, const float3&, const float3&) const {}
 
 	void DrawStatic() const;
+	/// draws the geometry once per instance, with the per-instance
+	/// attributes set up by the caller (not supported by all types)
+	virtual void DrawInstances(unsigned int numInstances) const {}
 
 	void SetCollisionVolume(CollisionVolume* cv) { colvol = cv; }
 	const CollisionVolume* GetCollisionVolume() const { return colvol; }
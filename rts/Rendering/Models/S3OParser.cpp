@@ -164,7 +164,24 @@ void SS3OPiece::DrawForList() const
 {
 	if (isEmpty)
 		return;
-	
+
+	EnableVertexArrays();
+	DrawElements(0);
+	DisableVertexArrays();
+}
+
+void SS3OPiece::DrawInstances(unsigned int numInstances) const
+{
+	if (isEmpty || numInstances == 0)
+		return;
+
+	EnableVertexArrays();
+	DrawElements(numInstances);
+	DisableVertexArrays();
+}
+
+void SS3OPiece::EnableVertexArrays() const
+{
 	vboAttributes.Bind(GL_ARRAY_BUFFER);
 		glEnableClientState(GL_VERTEX_ARRAY);
 		glVertexPointer(3, GL_FLOAT, sizeof(SS3OVertex), vboAttributes.GetPtr(offsetof(SS3OVertex, pos)));
@@ -188,11 +205,32 @@ void SS3OPiece::DrawForList() const
 		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 		glTexCoordPointer(3, GL_FLOAT, sizeof(SS3OVertex), vboAttributes.GetPtr(offsetof(SS3OVertex, tTangent)));
 	vboAttributes.Unbind();
+}
+
+void SS3OPiece::DisableVertexArrays() const
+{
+	glClientActiveTexture(GL_TEXTURE6);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glClientActiveTexture(GL_TEXTURE5);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glClientActiveTexture(GL_TEXTURE1);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glClientActiveTexture(GL_TEXTURE0);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+}
 
+void SS3OPiece::DrawElements(unsigned int numInstances) const
+{
 	vboIndices.Bind(GL_ELEMENT_ARRAY_BUFFER);
 	switch (primitiveType) {
 		case S3O_PRIMTYPE_TRIANGLES: {
-			glDrawRangeElements(GL_TRIANGLES, 0, vertices.size() - 1, vertexDrawIndices.size(), GL_UNSIGNED_INT, vboIndices.GetPtr());
+			DrawRangeElements(GL_TRIANGLES, numInstances);
 		} break;
 		case S3O_PRIMTYPE_TRIANGLE_STRIP: {
 			#ifdef GLEW_NV_primitive_restart
@@ -203,7 +241,7 @@ void SS3OPiece::DrawForList() const
 			}
 			#endif
 
-			glDrawRangeElements(GL_TRIANGLE_STRIP, 0, vertices.size() - 1, vertexDrawIndices.size(), GL_UNSIGNED_INT, vboIndices.GetPtr());
+			DrawRangeElements(GL_TRIANGLE_STRIP, numInstances);
 
 			#ifdef GLEW_NV_primitive_restart
 			if (globalRendering->supportRestartPrimitive) {
@@ -212,25 +250,20 @@ void SS3OPiece::DrawForList() const
 			#endif
 		} break;
 		case S3O_PRIMTYPE_QUADS: {
-			glDrawRangeElements(GL_QUADS, 0, vertices.size() - 1, vertexDrawIndices.size(), GL_UNSIGNED_INT, vboIndices.GetPtr());
+			DrawRangeElements(GL_QUADS, numInstances);
 		} break;
 	}
 	vboIndices.Unbind();
+}
 
-	glClientActiveTexture(GL_TEXTURE6);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glClientActiveTexture(GL_TEXTURE5);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glClientActiveTexture(GL_TEXTURE1);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glClientActiveTexture(GL_TEXTURE0);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_NORMAL_ARRAY);
+void SS3OPiece::DrawRangeElements(GLenum mode, unsigned int numInstances) const
+{
+	if (numInstances == 0) {
+		glDrawRangeElements(mode, 0, vertices.size() - 1, vertexDrawIndices.size(), GL_UNSIGNED_INT, vboIndices.GetPtr());
+	} else {
+		// the per-instance attributes have to be set up by the caller
+		glDrawElementsInstancedARB(mode, vertexDrawIndices.size(), GL_UNSIGNED_INT, vboIndices.GetPtr(), numInstances);
+	}
 }
 
 void SS3OPiece::SetMinMaxExtends()
@@ -21,6 +21,7 @@ struct SS3OPiece: public S3DModelPiece {
 
 	void UploadGeometryVBOs();
 	void DrawForList() const;
+	void DrawInstances(unsigned int numInstances) const;
 
 	void SetVertexCount(unsigned int n) { vertices.resize(n); }
 	void SetVertexDrawIndexCount(unsigned int n) { vertexDrawIndices.resize(n); }
@@ -40,6 +41,12 @@ struct SS3OPiece: public S3DModelPiece {
 
 	int primitiveType;
 
+private:
+	void EnableVertexArrays() const;
+	void DisableVertexArrays() const;
+	void DrawElements(unsigned int numInstances) const;
+	void DrawRangeElements(GLenum mode, unsigned int numInstances) const;
+
 private:
 	std::vector<SS3OVertex> vertices;
 	std::vector<unsigned int> vertexDrawIndices;
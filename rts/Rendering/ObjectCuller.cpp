@@ -0,0 +1,236 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ObjectCuller.h"
+#include "Game/Camera.h"
+#include "Rendering/GlobalRendering.h"
+#include "System/myMath.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifndef DEDICATED_NOSSE
+#include <xmmintrin.h>
+#endif
+
+// no plane-distance can be smaller than this, so padding slots always fail
+static const float PAD_RADIUS = -1e30f;
+
+
+void CObjectCuller::Reserve(unsigned int count)
+{
+	if (count <= posX.size())
+		return;
+
+	const unsigned int paddedCount = ((std::max(count, (unsigned int) posX.size() * 2) + 3) / 4) * 4;
+
+	posX.resize(paddedCount, 0.0f);
+	posY.resize(paddedCount, 0.0f);
+	posZ.resize(paddedCount, 0.0f);
+	radii.resize(paddedCount, PAD_RADIUS);
+	slotIDs.resize(paddedCount, -1);
+
+	for (unsigned int a = 0; a < losStatus.size(); a++) {
+		losStatus[a].resize(paddedCount, 0);
+	}
+}
+
+
+void CObjectCuller::AddObject(int id, const float3& pos, float radius)
+{
+	assert(id >= 0);
+
+	if (GetSlot(id) >= 0) {
+		SetObject(id, pos, radius);
+		return;
+	}
+
+	if (id >= int(idSlots.size()))
+		idSlots.resize(id + 1, -1);
+
+	Reserve(numObjects + 1);
+
+	const unsigned int slot = numObjects++;
+
+	idSlots[id] = slot;
+	slotIDs[slot] = id;
+
+	for (unsigned int a = 0; a < losStatus.size(); a++) {
+		losStatus[a][slot] = 0;
+	}
+	for (unsigned int s = 0; s < CULL_SET_COUNT; s++) {
+		if (slot < cullFlags[s].size()) {
+			cullFlags[s][slot] = 0;
+		}
+	}
+
+	SetObject(id, pos, radius);
+}
+
+void CObjectCuller::RemoveObject(int id)
+{
+	const int slot = GetSlot(id);
+
+	if (slot < 0)
+		return;
+
+	const unsigned int lastSlot = --numObjects;
+
+	if (slot != int(lastSlot)) {
+		posX[slot]  = posX[lastSlot];
+		posY[slot]  = posY[lastSlot];
+		posZ[slot]  = posZ[lastSlot];
+		radii[slot] = radii[lastSlot];
+
+		slotIDs[slot] = slotIDs[lastSlot];
+		idSlots[slotIDs[slot]] = slot;
+
+		for (unsigned int a = 0; a < losStatus.size(); a++) {
+			losStatus[a][slot] = losStatus[a][lastSlot];
+		}
+
+		// keep the results of the last Cull valid for the moved object
+		for (unsigned int s = 0; s < CULL_SET_COUNT; s++) {
+			std::vector<unsigned char>& flags = cullFlags[s];
+
+			if (slot < int(flags.size())) {
+				flags[slot] = (lastSlot < flags.size())? flags[lastSlot]: 0;
+			}
+		}
+	}
+
+	posX[lastSlot]  = 0.0f;
+	posY[lastSlot]  = 0.0f;
+	posZ[lastSlot]  = 0.0f;
+	radii[lastSlot] = PAD_RADIUS;
+
+	slotIDs[lastSlot] = -1;
+	idSlots[id] = -1;
+}
+
+void CObjectCuller::SetObject(int id, const float3& pos, float radius)
+{
+	const int slot = GetSlot(id);
+
+	if (slot < 0)
+		return;
+
+	posX[slot]  = pos.x;
+	posY[slot]  = pos.y;
+	posZ[slot]  = pos.z;
+	radii[slot] = radius;
+}
+
+void CObjectCuller::SetLosStatus(int id, int allyTeam, unsigned short status)
+{
+	const int slot = GetSlot(id);
+
+	if (slot < 0 || allyTeam < 0)
+		return;
+
+	if (allyTeam >= int(losStatus.size()))
+		losStatus.resize(allyTeam + 1, std::vector<unsigned short>(posX.size(), 0));
+
+	losStatus[allyTeam][slot] = status;
+}
+
+
+
+void CObjectCuller::Cull(unsigned int cullSet, const CCamera* cam, float shadowMargin, int allyTeam, unsigned short losMask)
+{
+	assert(cullSet < CULL_SET_COUNT);
+
+	std::vector<unsigned char>& flags = cullFlags[cullSet];
+	flags.resize(posX.size());
+
+	if (numObjects == 0)
+		return;
+
+	// same tests as CCamera::InView(pos, radius), evaluated for four objects at once
+	const float3& camPos = cam->GetPos();
+	const float3* planes[4] = {
+		&cam->rgtFrustumSideDir,
+		&cam->lftFrustumSideDir,
+		&cam->botFrustumSideDir,
+		&cam->topFrustumSideDir,
+	};
+
+	const float maxSqDist = Square(globalRendering->viewRange);
+	const unsigned int numSlots = ((numObjects + 3) / 4) * 4;
+
+#ifndef DEDICATED_NOSSE
+	const __m128 cx = _mm_set1_ps(camPos.x);
+	const __m128 cy = _mm_set1_ps(camPos.y);
+	const __m128 cz = _mm_set1_ps(camPos.z);
+	const __m128 sqRange = _mm_set1_ps(maxSqDist);
+	const __m128 margin = _mm_set1_ps(shadowMargin);
+
+	__m128 px[4], py[4], pz[4];
+
+	for (unsigned int p = 0; p < 4; p++) {
+		px[p] = _mm_set1_ps(planes[p]->x);
+		py[p] = _mm_set1_ps(planes[p]->y);
+		pz[p] = _mm_set1_ps(planes[p]->z);
+	}
+
+	for (unsigned int i = 0; i < numSlots; i += 4) {
+		const __m128 tx = _mm_sub_ps(_mm_loadu_ps(&posX[i]), cx);
+		const __m128 ty = _mm_sub_ps(_mm_loadu_ps(&posY[i]), cy);
+		const __m128 tz = _mm_sub_ps(_mm_loadu_ps(&posZ[i]), cz);
+		const __m128 r0 = _mm_loadu_ps(&radii[i]);
+		const __m128 r1 = _mm_add_ps(r0, margin);
+
+		const __m128 sqDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+
+		__m128 inView   = _mm_cmple_ps(sqDist, sqRange);
+		__m128 inShadow = inView;
+
+		for (unsigned int p = 0; p < 4; p++) {
+			const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px[p]), _mm_mul_ps(ty, py[p])), _mm_mul_ps(tz, pz[p]));
+
+			inView   = _mm_and_ps(inView,   _mm_cmple_ps(d, r0));
+			inShadow = _mm_and_ps(inShadow, _mm_cmple_ps(d, r1));
+		}
+
+		const int viewMask   = _mm_movemask_ps(inView);
+		const int shadowMask = _mm_movemask_ps(inShadow);
+
+		for (unsigned int k = 0; k < 4; k++) {
+			flags[i + k] =
+				(((viewMask   >> k) & 1) * CULL_FLAG_VIEW  ) |
+				(((shadowMask >> k) & 1) * CULL_FLAG_SHADOW);
+		}
+	}
+#else
+	for (unsigned int i = 0; i < numSlots; i++) {
+		const float3 t = float3(posX[i], posY[i], posZ[i]) - camPos;
+
+		bool inView   = (t.SqLength() <= maxSqDist);
+		bool inShadow = inView;
+
+		for (unsigned int p = 0; p < 4; p++) {
+			const float d = t.dot(*planes[p]);
+
+			inView   = inView   && (d <= radii[i]);
+			inShadow = inShadow && (d <= (radii[i] + shadowMargin));
+		}
+
+		flags[i] = (inView * CULL_FLAG_VIEW) | (inShadow * CULL_FLAG_SHADOW);
+	}
+#endif
+
+	if (allyTeam < 0)
+		return;
+
+	if (allyTeam >= int(losStatus.size())) {
+		std::fill(flags.begin(), flags.end(), 0);
+		return;
+	}
+
+	const std::vector<unsigned short>& los = losStatus[allyTeam];
+
+	for (unsigned int i = 0; i < numObjects; i++) {
+		if ((los[i] & losMask) == 0) {
+			flags[i] = 0;
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef OBJECT_CULLER_H
+#define OBJECT_CULLER_H
+
+#include <vector>
+#include "System/float3.h"
+
+class CCamera;
+
+/**
+ * Keeps the draw-positions, radii and per-allyteam LOS status of a
+ * set of world-objects (units or features) in packed arrays so that
+ * all of them can be culled against a camera in one (SSE) pass per
+ * frame, instead of calling CCamera::InView once per object in each
+ * draw-pass.
+ *
+ * Objects are addressed by their (unit or feature) id, slots are kept
+ * dense by moving the last object into the hole left by a removal.
+ */
+class CObjectCuller
+{
+public:
+	enum {
+		CULL_SET_MAIN  = 0, ///< main camera, culled in Update
+		CULL_SET_WATER = 1, ///< reflection / refraction camera
+		CULL_SET_COUNT = 2,
+	};
+	enum {
+		CULL_FLAG_VIEW   = 1, ///< inside the camera frustum
+		CULL_FLAG_SHADOW = 2, ///< inside the frustum grown by the shadow margin
+	};
+
+	CObjectCuller(): numObjects(0) {}
+
+	void AddObject(int id, const float3& pos, float radius);
+	void RemoveObject(int id);
+	void SetObject(int id, const float3& pos, float radius);
+	void SetLosStatus(int id, int allyTeam, unsigned short status);
+
+	/**
+	 * Recalculates the flags of <cullSet> for every object.
+	 * @param shadowMargin extra radius used for CULL_FLAG_SHADOW
+	 * @param allyTeam if non-negative, objects whose LOS status for
+	 *   this allyteam has no bits of <losMask> set get no flags at all
+	 */
+	void Cull(unsigned int cullSet, const CCamera* cam, float shadowMargin, int allyTeam, unsigned short losMask);
+
+	/// objects added after the last Cull are never visible
+	bool IsVisible(unsigned int cullSet, int id, unsigned char flag) const {
+		if (id < 0 || id >= int(idSlots.size()))
+			return false;
+
+		const int slot = idSlots[id];
+		const std::vector<unsigned char>& flags = cullFlags[cullSet];
+
+		return (slot >= 0 && slot < int(flags.size()) && (flags[slot] & flag) != 0);
+	}
+
+	unsigned int GetNumObjects() const { return numObjects; }
+
+private:
+	int GetSlot(int id) const { return ((id >= 0 && id < int(idSlots.size()))? idSlots[id]: -1); }
+	void Reserve(unsigned int count);
+
+private:
+	unsigned int numObjects;
+
+	// SoA layout, padded to a multiple of 4 so the SSE
+	// loop needs no tail; padding slots are never in view
+	std::vector<float> posX;
+	std::vector<float> posY;
+	std::vector<float> posZ;
+	std::vector<float> radii;
+
+	std::vector<int> slotIDs; ///< slot -> object id
+	std::vector<int> idSlots; ///< object id -> slot (or -1)
+
+	std::vector< std::vector<unsigned short> > losStatus; ///< [allyTeam][slot]
+	std::vector<unsigned char> cullFlags[CULL_SET_COUNT]; ///< [cullSet][slot]
+};
+
+#endif // OBJECT_CULLER_H
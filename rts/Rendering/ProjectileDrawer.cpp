@@ -35,7 +35,14 @@
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
+#include "System/OpenMP_cond.h"
 #include "System/Util.h"
+#include "System/Platform/Threading.h"
+
+#include <cstring>
+
+// below this many particles, vertices are generated on the main thread only
+#define MIN_PARALLEL_PARTICLES 2048
 
 
 
@@ -231,6 +238,7 @@ CProjectileDrawer::CProjectileDrawer(): CEventClient("[CProjectileDrawer]", 1234
 
 	perlinTexObjects = 0;
 	drawPerlinTex = false;
+	numParticleChunks = 0;
 
 	if (perlinFB.IsValid()) {
 		// we never refresh the full texture (just the perlin part). So we need to reload it then.
@@ -267,6 +275,12 @@ CProjectileDrawer::~CProjectileDrawer() {
 
 	modelRenderers.clear();
 	renderProjectiles.clear();
+
+	for (unsigned int n = 0; n < particleArrays.size(); n++) {
+		delete particleArrays[n];
+	}
+
+	particleArrays.clear();
 }
 
 
@@ -431,6 +445,13 @@ void CProjectileDrawer::DrawProjectilesSet(std::set<CProjectile*>& projectiles,
 	}
 }
 
+void CProjectileDrawer::DrawProjectilesSet(std::vector<CProjectile*>& projectiles, bool drawReflection, bool drawRefraction)
+{
+	for (std::vector<CProjectile*>::iterator it = projectiles.begin(); it != projectiles.end(); ++it) {
+		DrawProjectile(*it, drawReflection, drawRefraction);
+	}
+}
+
 void CProjectileDrawer::DrawProjectile(CProjectile* pro, bool drawReflection, bool drawRefraction)
 {
 	const CUnit* owner = pro->owner();
@@ -468,7 +489,169 @@ void CProjectileDrawer::DrawProjectile(CProjectile* pro, bool drawReflection, bo
 	DrawProjectileModel(pro, false);
 
 	pro->tempdist = pro->pos.dot(camera->forward);
-	zSortedProjectiles.insert(pro);
+	zSortedProjectiles.push_back(pro);
+}
+
+void CProjectileDrawer::SortProjectiles()
+{
+	const unsigned int numProjectiles = zSortedProjectiles.size();
+
+	if (numProjectiles < 2)
+		return;
+
+	float minDist = zSortedProjectiles[0]->tempdist;
+	float maxDist = minDist;
+
+	for (unsigned int i = 1; i < numProjectiles; i++) {
+		minDist = std::min(minDist, zSortedProjectiles[i]->tempdist);
+		maxDist = std::max(maxDist, zSortedProjectiles[i]->tempdist);
+	}
+
+	// quantize the depth to 16 bits, farthest projectiles get the smallest keys
+	const float scale = (maxDist > minDist)? (65535.0f / (maxDist - minDist)): 0.0f;
+
+	zSortKeys.resize(numProjectiles);
+	zSortKeysBuffer.resize(numProjectiles);
+	zSortBuffer.resize(numProjectiles);
+
+	for (unsigned int i = 0; i < numProjectiles; i++) {
+		zSortKeys[i] = (unsigned short) ((maxDist - zSortedProjectiles[i]->tempdist) * scale);
+	}
+
+	// two stable counting-sort passes, one per byte of the key
+	for (unsigned int shift = 0; shift < 16; shift += 8) {
+		unsigned int offsets[256] = {0};
+
+		for (unsigned int i = 0; i < numProjectiles; i++) {
+			offsets[(zSortKeys[i] >> shift) & 0xFF]++;
+		}
+		for (unsigned int n = 0, sum = 0; n < 256; n++) {
+			const unsigned int count = offsets[n];
+			offsets[n] = sum;
+			sum += count;
+		}
+		for (unsigned int i = 0; i < numProjectiles; i++) {
+			const unsigned int j = offsets[(zSortKeys[i] >> shift) & 0xFF]++;
+
+			zSortBuffer[j] = zSortedProjectiles[i];
+			zSortKeysBuffer[j] = zSortKeys[i];
+		}
+
+		zSortedProjectiles.swap(zSortBuffer);
+		zSortKeys.swap(zSortKeysBuffer);
+	}
+}
+
+
+static void AppendVertices(CVertexArray* dst, const CVertexArray* src, unsigned int begin, unsigned int end)
+{
+	if (end <= begin)
+		return;
+
+	const unsigned int count = end - begin;
+
+	dst->EnlargeArrays(count, 0, 1);
+	memcpy(dst->drawArrayPos, src->drawArray + begin, count * sizeof(float));
+	dst->drawArrayPos += count;
+}
+
+void CProjectileDrawer::DrawParticles()
+{
+	const unsigned int numProjectiles = zSortedProjectiles.size();
+
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+
+	int numThreads = 1;
+#ifdef _OPENMP
+	if (numProjectiles >= MIN_PARALLEL_PARTICLES) {
+		numThreads = std::min(omp_get_max_threads(), int(CProjectileVertexArray::MAX_THREADS));
+	}
+#endif
+
+	if (numThreads <= 1) {
+		CProjectile::va = va;
+
+		for (unsigned int i = 0; i < numProjectiles; i++) {
+			zSortedProjectiles[i]->Draw();
+		}
+
+		return;
+	}
+
+	while (particleArrays.size() < (unsigned int) numThreads) {
+		particleArrays.push_back(new CVertexArray());
+	}
+
+	particleBreaks.resize(numThreads);
+	numParticleChunks = 1;
+
+	// every thread fills its own array with a contiguous
+	// range of the sorted projectiles, which keeps the
+	// back-to-front order when the arrays are joined
+	Threading::OMPCheck();
+	#pragma omp parallel num_threads(numThreads)
+	{
+	#ifdef _OPENMP
+		const int chunk = omp_get_thread_num();
+		const int numChunks = omp_get_num_threads();
+	#else
+		const int chunk = 0;
+		const int numChunks = 1;
+	#endif
+
+		if (chunk == 0) {
+			numParticleChunks = numChunks;
+		}
+
+		DrawParticleChunk(chunk, (numProjectiles * chunk) / numChunks, (numProjectiles * (chunk + 1)) / numChunks);
+	}
+
+	CProjectile::va = va;
+
+	for (int chunk = 0; chunk < numParticleChunks; chunk++) {
+		const CVertexArray* chunkArray = particleArrays[chunk];
+		const std::vector< std::pair<unsigned int, unsigned int> >& breaks = particleBreaks[chunk];
+
+		unsigned int chunkIdx = 0;
+
+		for (unsigned int n = 0; n < breaks.size(); n++) {
+			AppendVertices(va, chunkArray, chunkIdx, breaks[n].second);
+			chunkIdx = breaks[n].second;
+
+			// skipped by the worker, draw it here in its place
+			zSortedProjectiles[breaks[n].first]->Draw();
+		}
+
+		AppendVertices(va, chunkArray, chunkIdx, chunkArray->drawIndex());
+	}
+
+	// workers only set their own inArray flag, raise ours here
+	if (va->drawIndex() > 0) {
+		CProjectile::inArray = true;
+	}
+}
+
+void CProjectileDrawer::DrawParticleChunk(int chunk, unsigned int begin, unsigned int end)
+{
+	CVertexArray* va = particleArrays[chunk];
+	std::vector< std::pair<unsigned int, unsigned int> >& breaks = particleBreaks[chunk];
+
+	va->Initialize();
+	breaks.clear();
+
+	// CProjectile::va is per-thread, Draw() writes into this chunk's array
+	CProjectile::va = va;
+
+	for (unsigned int i = begin; i < end; i++) {
+		CProjectile* p = zSortedProjectiles[i];
+
+		if (p->IsDrawThreadSafe()) {
+			p->Draw();
+		} else {
+			breaks.push_back(std::make_pair(i, va->drawIndex()));
+		}
+	}
 }
 
 
@@ -492,6 +675,13 @@ void CProjectileDrawer::DrawProjectilesSetShadow(std::set<CProjectile*>& project
 	}
 }
 
+void CProjectileDrawer::DrawProjectilesSetShadow(std::vector<CProjectile*>& projectiles)
+{
+	for (std::vector<CProjectile*>::iterator it = projectiles.begin(); it != projectiles.end(); ++it) {
+		DrawProjectileShadow(*it);
+	}
+}
+
 void CProjectileDrawer::DrawProjectileShadow(CProjectile* p)
 {
 	const CUnit* owner = p->owner();
@@ -565,7 +755,7 @@ void CProjectileDrawer::DrawProjectilesMiniMap()
 		points->Initialize();
 		points->EnlargeArrays(renderProjectiles.size(), 0, VA_SIZE_C);
 
-		for (std::set<CProjectile*>::iterator it = renderProjectiles.begin(); it != renderProjectiles.end(); ++it) {
+		for (std::vector<CProjectile*>::iterator it = renderProjectiles.begin(); it != renderProjectiles.end(); ++it) {
 			CProjectile* p = *it;
 
 			const CUnit* owner = p->owner();
@@ -656,13 +846,10 @@ void CProjectileDrawer::Draw(bool drawReflection, bool drawRefraction) {
 
 		projectileHandler->currentParticles = 0;
 		CProjectile::inArray = false;
-		CProjectile::va = GetVertexArray();
-		CProjectile::va->Initialize();
 
 		// draw the particle effects
-		for (std::set<CProjectile*, ProjectileDistanceComparator>::iterator it = zSortedProjectiles.begin(); it != zSortedProjectiles.end(); ++it) {
-			(*it)->Draw();
-		}
+		SortProjectiles();
+		DrawParticles();
 	}
 
 	glEnable(GL_BLEND);
@@ -994,7 +1181,10 @@ void CProjectileDrawer::RenderProjectileCreated(const CProjectile* p)
 	if (p->model) {
 		modelRenderers[MDL_TYPE(p)]->AddProjectile(p);
 	} else {
-		renderProjectiles.insert(const_cast<CProjectile*>(p));
+		CProjectile* pro = const_cast<CProjectile*>(p);
+
+		pro->renderIndex = renderProjectiles.size();
+		renderProjectiles.push_back(pro);
 	}
 }
 
@@ -1003,6 +1193,12 @@ void CProjectileDrawer::RenderProjectileDestroyed(const CProjectile* const p)
 	if (p->model) {
 		modelRenderers[MDL_TYPE(p)]->DelProjectile(p);
 	} else {
-		renderProjectiles.erase(const_cast<CProjectile*>(p));
+		const unsigned int idx = p->renderIndex;
+
+		if (idx < renderProjectiles.size() && renderProjectiles[idx] == p) {
+			renderProjectiles[idx] = renderProjectiles.back();
+			renderProjectiles[idx]->renderIndex = idx;
+			renderProjectiles.pop_back();
+		}
 	}
 }
@@ -6,6 +6,7 @@
 #include "Rendering/GL/myGL.h"
 #include <list>
 #include <set>
+#include <vector>
 
 #include "lib/gml/ThreadSafeContainers.h"
 #include "Rendering/GL/FBO.h"
@@ -18,6 +19,7 @@ class CGroundFlash;
 struct FlyingPiece;
 class IWorldObjectModelRenderer;
 class LuaTable;
+class CVertexArray;
 
 
 typedef ThreadListSimRender<std::list<CGroundFlash*>, std::set<CGroundFlash*>, CGroundFlash*> GroundFlashContainer;
@@ -105,10 +107,15 @@ private:
 
 	void DrawProjectiles(int modelType, int numFlyingPieces, int* drawnPieces, bool drawReflection, bool drawRefraction);
 	void DrawProjectilesSet(std::set<CProjectile*>& projectiles, bool drawReflection, bool drawRefraction);
+	void DrawProjectilesSet(std::vector<CProjectile*>& projectiles, bool drawReflection, bool drawRefraction);
 	void DrawProjectile(CProjectile* projectile, bool drawReflection, bool drawRefraction);
 	void DrawProjectilesShadow(int modelType);
 	void DrawProjectileShadow(CProjectile* projectile);
 	void DrawProjectilesSetShadow(std::set<CProjectile*>& projectiles);
+	void DrawProjectilesSetShadow(std::vector<CProjectile*>& projectiles);
+	void SortProjectiles();
+	void DrawParticles();
+	void DrawParticleChunk(int chunk, unsigned int begin, unsigned int end);
 	void DrawFlyingPieces(int modelType, int numFlyingPieces, int* drawnPieces);
 
 	void UpdatePerlin();
@@ -120,16 +127,29 @@ private:
 	int perlinTexObjects;
 	bool drawPerlinTex;
 
-	/// projectiles without a model
-	std::set<CProjectile*> renderProjectiles;
+	/// projectiles without a model (unordered, see CProjectile::renderIndex)
+	std::vector<CProjectile*> renderProjectiles;
 	/// projectiles with a model
 	std::vector<IWorldObjectModelRenderer*> modelRenderers;
 
 	/**
-	 * z-sorted set of all projectiles; used to
-	 * render particle effects in back-to-front order
+	 * all projectiles visible this frame, radix-sorted on their
+	 * quantized depth by SortProjectiles; used to render particle
+	 * effects in back-to-front order
 	 */
-	std::set<CProjectile*, ProjectileDistanceComparator> zSortedProjectiles;
+	std::vector<CProjectile*> zSortedProjectiles;
+	std::vector<CProjectile*> zSortBuffer;
+	std::vector<unsigned short> zSortKeys;
+	std::vector<unsigned short> zSortKeysBuffer;
+
+	/**
+	 * one vertex array per emitting thread; each chunk also records
+	 * (projectile, vertex offset) pairs for the projectiles that must
+	 * be drawn on the main thread when the chunks are concatenated
+	 */
+	std::vector<CVertexArray*> particleArrays;
+	std::vector< std::vector< std::pair<unsigned int, unsigned int> > > particleBreaks;
+	int numParticleChunks;
 };
 
 extern CProjectileDrawer* projectileDrawer;
@@ -1,5 +1,6 @@
 #include <limits>
 
+#include "ExternalAI/EngineOutHandler.h"
 #include "Game/Camera.h"
 #include "Game/GlobalUnsynced.h"
 #include "Map/BaseGroundDrawer.h"
@@ -37,8 +38,10 @@ void QTPFSPathDrawer::DrawAll() const {
 	if (md == NULL)
 		return;
 
-	// QTPFS::PathManager is not thread-safe
+	// QTPFS::PathManager is not thread-safe (threaded Skirmish AIs request paths too)
 	if (!GML::SimEnabled() && enabled && (gs->cheatEnabled || gu->spectating)) {
+		const CScopedAIWorldLock aiWorldLock;
+
 		glPushAttrib(GL_ENABLE_BIT | GL_POLYGON_BIT);
 		glDisable(GL_TEXTURE_2D);
 		glDisable(GL_LIGHTING);
@@ -2,11 +2,14 @@
 
 #include "Screenshot.h"
 
+#include <cstring>
 #include <vector>
+#include <deque>
 #include <iomanip>
 #include <boost/thread.hpp>
 
 #include "Rendering/GL/myGL.h"
+#include "Rendering/GL/AsyncPixelReader.h"
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/Textures/Bitmap.h"
 #include "System/Config/ConfigHandler.h"
@@ -25,6 +28,7 @@ struct FunctionArgs
 	std::string filename;
 	int x;
 	int y;
+	unsigned int drawFrame; ///< when the pixels were read
 };
 
 class SaverThread
@@ -106,6 +110,59 @@ private:
 
 SaverThread screenshotThread;
 
+/// screenshots whose pixels are still being transferred
+static std::deque<FunctionArgs> pendingScreenshots;
+/// only exists while <pendingScreenshots> is not empty
+static CAsyncPixelReader* screenshotReader = NULL;
+
+
+static void SaveOldestScreenshot()
+{
+	FunctionArgs args = pendingScreenshots.front();
+	pendingScreenshots.pop_front();
+
+	// args.x is a multiple of 4, so rows are not padded
+	const unsigned char* pixels = screenshotReader->MapOldest();
+
+	args.buf = new boost::uint8_t[args.x * args.y * 4];
+
+	if (pixels != NULL) {
+		memcpy(args.buf, pixels, args.x * args.y * 4);
+	} else {
+		memset(args.buf, 0, args.x * args.y * 4);
+	}
+
+	screenshotReader->UnmapOldest();
+	screenshotThread.AddTask(args);
+}
+
+
+void UpdateScreenshots()
+{
+	while (!pendingScreenshots.empty()) {
+		// give the transfer one whole draw-frame to finish
+		if ((globalRendering->drawFrame - pendingScreenshots.front().drawFrame) < 2)
+			return;
+
+		SaveOldestScreenshot();
+	}
+
+	delete screenshotReader;
+	screenshotReader = NULL;
+}
+
+
+void FlushScreenshots()
+{
+	while (!pendingScreenshots.empty()) {
+		SaveOldestScreenshot();
+	}
+
+	delete screenshotReader;
+	screenshotReader = NULL;
+}
+
+
 void TakeScreenshot(std::string type)
 {
 	if (type.empty())
@@ -133,8 +190,21 @@ void TakeScreenshot(std::string type)
 			}
 		}
 
-		args.buf = new boost::uint8_t[args.x * args.y * 4];
-		glReadPixels(0, 0, args.x, args.y, GL_RGBA, GL_UNSIGNED_BYTE, args.buf);
-		screenshotThread.AddTask(args);
+		if (screenshotReader != NULL && (screenshotReader->GetSizeX() != args.x || screenshotReader->GetSizeY() != args.y)) {
+			FlushScreenshots();
+		}
+
+		if (screenshotReader == NULL) {
+			screenshotReader = new CAsyncPixelReader(args.x, args.y, GL_RGBA, 2);
+		}
+		if (screenshotReader->IsFull()) {
+			SaveOldestScreenshot();
+		}
+
+		// pixels are copied into args.buf by UpdateScreenshots
+		args.buf = NULL;
+		args.drawFrame = globalRendering->drawFrame;
+		screenshotReader->QueueRead();
+		pendingScreenshots.push_back(args);
 	}
 }
@@ -6,5 +6,9 @@
 #include <string>
 
 void TakeScreenshot(std::string type);
+/// hands screenshots whose pixels have arrived to the saver thread, call once per draw-frame
+void UpdateScreenshots();
+/// saves all pending screenshots right away and frees their pixel reader, call before the GL context goes
+void FlushScreenshots();
 
 #endif
@@ -424,6 +424,10 @@ namespace Shader {
 		uniformStates.push_back(UniformState(name));
 	}
 
+	int GLSLProgramObject::GetAttribLocation(const std::string& name) {
+		return glGetAttribLocation(objID, name.c_str());
+	}
+
 	void GLSLProgramObject::SetUniform1i(int idx, int   v0                              ) { assert(IsBound()); if (uniformStates[idx].Set(v0            )) glUniform1i(uniformLocs[idx], v0            ); }
 	void GLSLProgramObject::SetUniform2i(int idx, int   v0, int   v1                    ) { assert(IsBound()); if (uniformStates[idx].Set(v0, v1        )) glUniform2i(uniformLocs[idx], v0, v1        ); }
 	void GLSLProgramObject::SetUniform3i(int idx, int   v0, int   v1, int   v2          ) { assert(IsBound()); if (uniformStates[idx].Set(v0, v1, v2    )) glUniform3i(uniformLocs[idx], v0, v1, v2    ); }
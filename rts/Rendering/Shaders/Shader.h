@@ -76,6 +76,8 @@ namespace Shader {
 
 		virtual void SetUniformTarget(int) {}
 		virtual void SetUniformLocation(const std::string&) {}
+		/// @return location of a vertex attribute, or -1 if not active (GLSL only)
+		virtual int GetAttribLocation(const std::string&) { return -1; }
 
 		virtual void SetUniform1i(int idx, int   v0) = 0;
 		virtual void SetUniform2i(int idx, int   v0, int   v1) = 0;
@@ -204,6 +206,7 @@ namespace Shader {
 		void Reload(bool reloadFromDisk);
 
 		void SetUniformLocation(const std::string&);
+		int GetAttribLocation(const std::string&);
 
 		void SetUniform1i(int idx, int   v0);
 		void SetUniform2i(int idx, int   v0, int   v1);
@@ -194,6 +194,7 @@ void CShadowHandler::LoadShadowGenShaderProgs()
 			po->SetUniformLocation("cameraDirX");    // used by SHADOWGEN_PROGRAM_TREE_NEAR
 			po->SetUniformLocation("cameraDirY");    // used by SHADOWGEN_PROGRAM_TREE_NEAR
 			po->SetUniformLocation("treeOffset");    // used by SHADOWGEN_PROGRAM_TREE_NEAR
+			po->SetUniformLocation("instanced");     // used by SHADOWGEN_PROGRAM_MODEL
 			po->Validate();
 
 			shadowGenProgs[i] = po;
@@ -473,7 +474,7 @@ void CShadowHandler::CreateShadows()
 	if (globalRendering->haveGLSL) {
 		for (int i = 0; i < SHADOWGEN_PROGRAM_LAST; i++) {
 			shadowGenProgs[i]->Enable();
-			shadowGenProgs[i]->SetUniform4fv(0, &shadowTexProjCenter.x);
+			shadowGenProgs[i]->SetUniform4fv(SHADOWGEN_UNIFORM_SHADOWPARAMS, &shadowTexProjCenter.x);
 			shadowGenProgs[i]->Disable();
 		}
 	}
@@ -52,6 +52,15 @@ public:
 		SHADOWGEN_PROGRAM_LAST       = 5,
 	};
 
+	// uniform indices of the GLSL shadow-gen programs (SetUniformLocation order)
+	enum ShadowGenUniform {
+		SHADOWGEN_UNIFORM_SHADOWPARAMS = 0,
+		SHADOWGEN_UNIFORM_CAMERADIRX   = 1,
+		SHADOWGEN_UNIFORM_CAMERADIRY   = 2,
+		SHADOWGEN_UNIFORM_TREEOFFSET   = 3,
+		SHADOWGEN_UNIFORM_INSTANCED    = 4,
+	};
+
 	Shader::IProgramObject* GetShadowGenProg(ShadowGenProgram p) {
 		return shadowGenProgs[p];
 	}
@@ -1,9 +1,12 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <algorithm>
+#include <cstdlib>
 #include <ostream>
 #include <fstream>
 #include <string.h>
+#include <vector>
 #include <IL/il.h>
 //#include <IL/ilu.h>
 #include <SDL_video.h>
@@ -15,14 +18,17 @@
 #endif // !BITMAP_NO_OPENGL
 
 #include "Bitmap.h"
+#include "ImageDecoder.h"
 #include "Rendering/GlobalRendering.h"
 #include "System/bitops.h"
+#include "System/Util.h"
 #include "System/ScopedFPUSettings.h"
 #include "System/Log/ILog.h"
 #include "System/OpenMP_cond.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileSystem.h"
 
 
 boost::mutex devilMutex; // devil functions, whilst expensive, aren't thread-save
@@ -34,6 +40,23 @@ static const float blurkernel[9] = {
 };
 
 
+//////////////////////////////////////////////////////////////////////
+// PNG and TGA are decoded without devilMutex
+// (anything ImageDecoder does not handle is left to DevIL)
+//////////////////////////////////////////////////////////////////////
+
+static bool DecodeImage(const std::string& filename, const unsigned char* data, size_t size, ImageDecoder::DecodedImage& img)
+{
+	// TGA files have no signature, so they are recognized by their extension
+	if (ImageDecoder::DecodePNG(data, size, img))
+		return true;
+	if (StringToLower(FileSystem::GetExtension(filename)) == "tga")
+		return ImageDecoder::DecodeTGA(data, size, img);
+
+	return false;
+}
+
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -137,6 +160,20 @@ CBitmap& CBitmap::operator=(const CBitmap& bm)
 }
 
 
+void CBitmap::Swap(CBitmap& bm)
+{
+	std::swap(mem, bm.mem);
+	std::swap(xsize, bm.xsize);
+	std::swap(ysize, bm.ysize);
+	std::swap(channels, bm.channels);
+	std::swap(type, bm.type);
+#ifndef BITMAP_NO_OPENGL
+	std::swap(textype, bm.textype);
+	std::swap(ddsimage, bm.ddsimage);
+#endif // !BITMAP_NO_OPENGL
+}
+
+
 void CBitmap::Alloc(int w, int h)
 {
 	delete[] mem;
@@ -165,6 +202,12 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 	ScopedTimer timer("Textures::CBitmap::Load");
 #endif
 
+	return Decode(filename, defaultAlpha);
+}
+
+
+bool CBitmap::Decode(std::string const& filename, unsigned char defaultAlpha)
+{
 	bool noAlpha = true;
 
 	delete[] mem;
@@ -222,6 +265,30 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 	unsigned char* buffer = new unsigned char[file.FileSize() + 2];
 	file.Read(buffer, file.FileSize());
 
+	{
+		ImageDecoder::DecodedImage img;
+
+		if (DecodeImage(filename, buffer, file.FileSize(), img)) {
+			delete[] buffer;
+
+			xsize = img.xsize;
+			ysize = img.ysize;
+			mem = new unsigned char[xsize * ysize * 4];
+
+			const int numPixels = xsize * ysize;
+			const unsigned char* src = &img.pixels[0];
+
+			for (int i = 0; i < numPixels; ++i, src += img.channels) {
+				mem[i * 4 + 0] = src[0];
+				mem[i * 4 + 1] = src[(img.channels >= 3)? 1: 0];
+				mem[i * 4 + 2] = src[(img.channels >= 3)? 2: 0];
+				mem[i * 4 + 3] = (img.channels == 4)? src[3]: defaultAlpha;
+			}
+
+			return true;
+		}
+	}
+
 	boost::mutex::scoped_lock lck(devilMutex);
 	ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
 	ilEnable(IL_ORIGIN_SET);
@@ -280,6 +347,23 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 	unsigned char* buffer = new unsigned char[file.FileSize() + 1];
 	file.Read(buffer, file.FileSize());
 
+	{
+		ImageDecoder::DecodedImage img;
+
+		if (DecodeImage(filename, buffer, file.FileSize(), img) && img.channels == 1) {
+			delete[] buffer;
+
+			xsize = img.xsize;
+			ysize = img.ysize;
+
+			delete[] mem;
+			mem = NULL;
+			mem = new unsigned char[xsize * ysize];
+			memcpy(mem, &img.pixels[0], xsize * ysize);
+			return true;
+		}
+	}
+
 	boost::mutex::scoped_lock lck(devilMutex);
 	ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
 	ilEnable(IL_ORIGIN_SET);
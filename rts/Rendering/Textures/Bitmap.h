@@ -24,10 +24,18 @@ public:
 
 	virtual ~CBitmap();
 
+	/// exchanges the contents of both bitmaps without copying
+	void Swap(CBitmap& bm);
+
 	void Alloc(int w, int h);
 
 	/// Load data from a file on the VFS
 	bool Load(std::string const& filename, unsigned char defaultAlpha = 255);
+	/**
+	 * Same as Load, but without profiling, so it can be called by any thread.
+	 * PNG, TGA and DDS files are decoded without taking the DevIL mutex.
+	 */
+	bool Decode(std::string const& filename, unsigned char defaultAlpha = 255);
 	/// Load data from a gray-scale file on the VFS
 	bool LoadGrayscale(std::string const& filename);
 	bool Save(std::string const& filename, bool opaque = true) const;
@@ -0,0 +1,152 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "BitmapLoader.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "System/Platform/Threading.h"
+
+CBitmapLoader* bitmapLoader = NULL;
+
+
+CBitmapLoader::CBitmapLoader(int numThreads)
+	: quit(false)
+{
+	for (int i = 0; i < numThreads; ++i) {
+		threads.push_back(new boost::thread(boost::bind(&CBitmapLoader::Run, this)));
+	}
+}
+
+CBitmapLoader::~CBitmapLoader()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		quit = true;
+		workCond.notify_all();
+	}
+
+	for (std::vector<boost::thread*>::iterator it = threads.begin(); it != threads.end(); ++it) {
+		(*it)->join();
+		delete *it;
+	}
+
+	for (std::map<std::string, Job*>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+		delete it->second;
+	}
+}
+
+
+void CBitmapLoader::Queue(const std::string& filename)
+{
+	if (filename.empty())
+		return;
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (jobs.find(filename) != jobs.end())
+		return;
+
+	EvictJobs();
+
+	Job* job = new Job();
+	job->orderIt = jobOrder.insert(jobOrder.end(), filename);
+	jobs[filename] = job;
+	queuedFiles.push_back(filename);
+	workCond.notify_one();
+}
+
+bool CBitmapLoader::Load(const std::string& filename, CBitmap& bm)
+{
+	Job* job = NULL;
+
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		std::map<std::string, Job*>::iterator it = jobs.find(filename);
+
+		if (it != jobs.end()) {
+			job = it->second;
+			jobs.erase(it);
+			jobOrder.erase(job->orderIt);
+
+			if (job->started) {
+				while (!job->done) {
+					doneCond.wait(lock);
+				}
+			} else {
+				// no worker got to it, the queue entry is skipped
+				delete job;
+				job = NULL;
+			}
+		}
+	}
+
+	if (job == NULL)
+		return bm.Decode(filename);
+
+	const bool success = job->success;
+
+	bm.Swap(job->bitmap);
+	delete job;
+	return success;
+}
+
+
+void CBitmapLoader::EvictJobs()
+{
+	std::list<std::string>::iterator it = jobOrder.begin();
+
+	while (jobs.size() >= MAX_JOBS && it != jobOrder.end()) {
+		std::map<std::string, Job*>::iterator jit = jobs.find(*it);
+		Job* job = jit->second;
+
+		// a worker is still decoding it
+		if (job->started && !job->done) {
+			++it;
+			continue;
+		}
+
+		// the queue entry of a job that was not started is skipped
+		jobs.erase(jit);
+		it = jobOrder.erase(it);
+		delete job;
+	}
+}
+
+
+void CBitmapLoader::Run()
+{
+	Threading::SetThreadName("bitmap-loader");
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	while (true) {
+		while (!quit && queuedFiles.empty()) {
+			workCond.wait(lock);
+		}
+
+		if (quit)
+			break;
+
+		const std::string filename = queuedFiles.front();
+		queuedFiles.pop_front();
+
+		std::map<std::string, Job*>::iterator it = jobs.find(filename);
+
+		if (it == jobs.end() || it->second->started)
+			continue;
+
+		// Load waits for started jobs, so <job> stays valid
+		Job* job = it->second;
+		job->started = true;
+		lock.unlock();
+
+		const bool success = job->bitmap.Decode(filename);
+
+		lock.lock();
+		job->success = success;
+		job->done = true;
+		doneCond.notify_all();
+	}
+}
@@ -0,0 +1,81 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef BITMAP_LOADER_H
+#define BITMAP_LOADER_H
+
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "Bitmap.h"
+
+namespace boost {
+	class thread;
+};
+
+/**
+ * @brief Decodes image files on worker threads
+ *
+ * Code that knows which images it is going to need queues them up front,
+ * and later takes each one with Load, which only waits if the file is
+ * still being decoded. The GL upload (CBitmap::CreateTexture etc.) stays
+ * with the caller, on the render thread.
+ */
+class CBitmapLoader : boost::noncopyable
+{
+public:
+	CBitmapLoader(int numThreads);
+	~CBitmapLoader();
+
+	/// any thread: start decoding a file (nothing happens if it is queued already)
+	void Queue(const std::string& filename);
+
+	/**
+	 * Any thread: takes the decoded file, or decodes it right away if it was
+	 * not queued, no worker got to it yet or it was evicted. At most
+	 * MAX_JOBS files are kept, the oldest ones that were not taken are
+	 * dropped when more are queued.
+	 * @return the result of CBitmap::Load
+	 */
+	bool Load(const std::string& filename, CBitmap& bm);
+
+private:
+	static const size_t MAX_JOBS = 64;
+
+	struct Job {
+		Job(): started(false), done(false), success(false) {}
+
+		CBitmap bitmap;
+		/// position in jobOrder
+		std::list<std::string>::iterator orderIt;
+		bool started;
+		bool done;
+		bool success;
+	};
+
+	void Run();
+
+	/// drops the oldest jobs no worker is busy with until there is room for one more
+	void EvictJobs();
+
+private:
+	std::vector<boost::thread*> threads;
+	boost::mutex mutex;
+	boost::condition_variable workCond; ///< wakes the workers
+	boost::condition_variable doneCond; ///< wakes Load
+
+	std::map<std::string, Job*> jobs;
+	std::list<std::string> jobOrder; ///< files in <jobs>, oldest first
+	std::deque<std::string> queuedFiles;
+	bool quit;
+};
+
+/// created by SpringApp, shared by everything that loads textures
+extern CBitmapLoader* bitmapLoader;
+
+#endif // BITMAP_LOADER_H
@@ -0,0 +1,289 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ImageDecoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+
+static unsigned int ReadBE32(const unsigned char* p)
+{
+	return ((p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+}
+
+static int PaethPredictor(int a, int b, int c)
+{
+	const int p = a + b - c;
+	const int pa = std::abs(p - a);
+	const int pb = std::abs(p - b);
+	const int pc = std::abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return a;
+	if (pb <= pc)
+		return b;
+
+	return c;
+}
+
+
+bool ImageDecoder::DecodePNG(const unsigned char* data, size_t size, DecodedImage& img)
+{
+	static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+	if (size < 8 || memcmp(data, signature, 8) != 0)
+		return false;
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	int bitDepth = 0;
+	int colorType = -1;
+
+	std::vector<unsigned char> palette;
+	std::vector<unsigned char> idat;
+
+	for (size_t pos = 8; pos + 12 <= size; ) {
+		const unsigned int len = ReadBE32(data + pos);
+		const unsigned char* type = data + pos + 4;
+		const unsigned char* chunk = data + pos + 8;
+
+		if (len > size - pos - 12)
+			return false;
+
+		if (memcmp(type, "IHDR", 4) == 0) {
+			if (len < 13)
+				return false;
+
+			width     = ReadBE32(chunk);
+			height    = ReadBE32(chunk + 4);
+			bitDepth  = chunk[8];
+			colorType = chunk[9];
+
+			// unknown compression or filter methods, interlacing
+			if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0)
+				return false;
+		} else if (memcmp(type, "PLTE", 4) == 0) {
+			palette.assign(chunk, chunk + len);
+		} else if (memcmp(type, "tRNS", 4) == 0) {
+			return false;
+		} else if (memcmp(type, "IDAT", 4) == 0) {
+			idat.insert(idat.end(), chunk, chunk + len);
+		} else if (memcmp(type, "IEND", 4) == 0) {
+			break;
+		}
+
+		pos += (len + 12);
+	}
+
+	if (width == 0 || height == 0 || width > 32768 || height > 32768 || idat.empty())
+		return false;
+
+	int channels = 0;
+
+	switch (colorType) {
+		case 0: { channels = 1; } break;
+		case 2: { channels = 3; } break;
+		case 3: { channels = 1; } break; // palette index
+		case 6: { channels = 4; } break;
+		default: {
+			return false; // gray-alpha
+		}
+	}
+
+	if (colorType == 3) {
+		if (bitDepth != 1 && bitDepth != 2 && bitDepth != 4 && bitDepth != 8)
+			return false;
+		if (palette.empty() || (palette.size() % 3) != 0)
+			return false;
+	} else {
+		if (bitDepth != 8)
+			return false;
+	}
+
+	const size_t bitsPerPixel = channels * bitDepth;
+	const size_t stride = (width * bitsPerPixel + 7) / 8;
+	const size_t bpp = std::max(size_t(1), bitsPerPixel / 8);
+
+	// every row starts with its filter type
+	std::vector<unsigned char> raw(height * (stride + 1));
+	uLongf rawSize = raw.size();
+
+	if (uncompress(&raw[0], &rawSize, &idat[0], idat.size()) != Z_OK || rawSize != raw.size())
+		return false;
+
+	for (unsigned int y = 0; y < height; ++y) {
+		unsigned char* line = &raw[y * (stride + 1) + 1];
+		const unsigned char* prev = (y > 0)? (line - (stride + 1)): NULL;
+		const int filter = line[-1];
+
+		switch (filter) {
+			case 0: {
+			} break;
+			case 1: {
+				for (size_t i = bpp; i < stride; ++i)
+					line[i] += line[i - bpp];
+			} break;
+			case 2: {
+				if (prev == NULL)
+					break;
+				for (size_t i = 0; i < stride; ++i)
+					line[i] += prev[i];
+			} break;
+			case 3: {
+				for (size_t i = 0; i < stride; ++i) {
+					const int a = (i >= bpp)? line[i - bpp]: 0;
+					const int b = (prev != NULL)? prev[i]: 0;
+					line[i] += ((a + b) >> 1);
+				}
+			} break;
+			case 4: {
+				for (size_t i = 0; i < stride; ++i) {
+					const int a = (i >= bpp)? line[i - bpp]: 0;
+					const int b = (prev != NULL)? prev[i]: 0;
+					const int c = (prev != NULL && i >= bpp)? prev[i - bpp]: 0;
+					line[i] += PaethPredictor(a, b, c);
+				}
+			} break;
+			default: {
+				return false;
+			}
+		}
+	}
+
+	img.xsize = width;
+	img.ysize = height;
+
+	if (colorType != 3) {
+		img.channels = channels;
+		img.pixels.resize(size_t(width) * height * channels);
+
+		for (unsigned int y = 0; y < height; ++y) {
+			memcpy(&img.pixels[y * stride], &raw[y * (stride + 1) + 1], stride);
+		}
+
+		return true;
+	}
+
+	const size_t numColors = palette.size() / 3;
+	const int pixelsPerByte = 8 / bitDepth;
+	const int indexMask = (1 << bitDepth) - 1;
+
+	img.channels = 3;
+	img.pixels.resize(size_t(width) * height * 3);
+
+	for (unsigned int y = 0; y < height; ++y) {
+		const unsigned char* line = &raw[y * (stride + 1) + 1];
+
+		for (unsigned int x = 0; x < width; ++x) {
+			const int shift = 8 - bitDepth * ((x % pixelsPerByte) + 1);
+			const size_t index = (line[x / pixelsPerByte] >> shift) & indexMask;
+
+			if (index >= numColors)
+				return false;
+
+			memcpy(&img.pixels[(y * width + x) * 3], &palette[index * 3], 3);
+		}
+	}
+
+	return true;
+}
+
+bool ImageDecoder::DecodeTGA(const unsigned char* data, size_t size, DecodedImage& img)
+{
+	if (size < 18)
+		return false;
+
+	const int idLength     = data[0];
+	const int colorMapType = data[1];
+	const int imageType    = data[2];
+	const int width        = data[12] | (data[13] << 8);
+	const int height       = data[14] | (data[15] << 8);
+	const int bitsPerPixel = data[16];
+	const int descriptor   = data[17];
+
+	const bool gray = (imageType == 3 || imageType == 11);
+	const bool rle  = (imageType >= 9);
+
+	if (colorMapType != 0)
+		return false;
+	if (imageType != 2 && imageType != 3 && imageType != 10 && imageType != 11)
+		return false;
+	if (gray && bitsPerPixel != 8)
+		return false;
+	if (!gray && bitsPerPixel != 24 && bitsPerPixel != 32)
+		return false;
+	// right-to-left pixel order
+	if (width == 0 || height == 0 || (descriptor & 0x10) != 0)
+		return false;
+
+	const int channels = bitsPerPixel / 8;
+	const size_t numPixels = size_t(width) * height;
+	const unsigned char* src = data + 18 + idLength;
+	const unsigned char* end = data + size;
+
+	if (src > end)
+		return false;
+
+	img.pixels.resize(numPixels * channels);
+
+	if (!rle) {
+		if (size_t(end - src) < img.pixels.size())
+			return false;
+
+		memcpy(&img.pixels[0], src, img.pixels.size());
+	} else {
+		for (size_t n = 0; n < numPixels; ) {
+			if (src >= end)
+				return false;
+
+			const int packet = *(src++);
+			const size_t count = std::min(size_t(packet & 0x7F) + 1, numPixels - n);
+
+			if (packet & 0x80) {
+				if ((end - src) < channels)
+					return false;
+
+				for (size_t i = 0; i < count; ++i) {
+					memcpy(&img.pixels[(n + i) * channels], src, channels);
+				}
+
+				src += channels;
+			} else {
+				if (size_t(end - src) < (count * channels))
+					return false;
+
+				memcpy(&img.pixels[n * channels], src, count * channels);
+				src += (count * channels);
+			}
+
+			n += count;
+		}
+	}
+
+	// BGR(A) to RGB(A)
+	if (channels >= 3) {
+		for (size_t i = 0; i < numPixels; ++i) {
+			std::swap(img.pixels[i * channels + 0], img.pixels[i * channels + 2]);
+		}
+	}
+
+	// bottom row first unless the origin is in the upper left corner
+	if ((descriptor & 0x20) == 0) {
+		const size_t stride = width * channels;
+
+		for (int y = 0; y < (height / 2); ++y) {
+			std::swap_ranges(
+				img.pixels.begin() + y * stride,
+				img.pixels.begin() + (y + 1) * stride,
+				img.pixels.begin() + (height - 1 - y) * stride
+			);
+		}
+	}
+
+	img.xsize = width;
+	img.ysize = height;
+	img.channels = channels;
+	return true;
+}
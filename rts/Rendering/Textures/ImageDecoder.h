@@ -0,0 +1,30 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Decoders for the common image formats which do not need DevIL (and its
+ * mutex), so they can run on any thread. Anything they do not handle is
+ * left to DevIL by CBitmap.
+ */
+namespace ImageDecoder {
+	struct DecodedImage {
+		DecodedImage(): xsize(0), ysize(0), channels(0) {}
+
+		int xsize;
+		int ysize;
+		int channels; ///< 1 (grayscale), 3 (RGB) or 4 (RGBA)
+		std::vector<unsigned char> pixels; ///< top row first
+	};
+
+	/// 8 bit gray, RGB and RGBA, and paletted images without transparency
+	bool DecodePNG(const unsigned char* data, size_t size, DecodedImage& img);
+	/// uncompressed and RLE 8 bit gray, 24 bit RGB and 32 bit RGBA images
+	bool DecodeTGA(const unsigned char* data, size_t size, DecodedImage& img);
+};
+
+#endif // IMAGE_DECODER_H
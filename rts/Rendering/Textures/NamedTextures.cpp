@@ -9,6 +9,7 @@
 
 #include "Rendering/GL/myGL.h"
 #include "Bitmap.h"
+#include "BitmapLoader.h"
 #include "Rendering/GlobalRendering.h"
 #include "System/bitops.h"
 #include "System/TimeProfiler.h"
@@ -51,6 +52,21 @@ namespace CNamedTextures {
 
 	/******************************************************************************/
 
+	static std::string GetFileName(const std::string& texName)
+	{
+		//! strip off the qualifiers (see Load)
+		if (texName[0] != ':') {
+			return texName;
+		}
+
+		const size_t p = texName.find(':', 1);
+		if (p == std::string::npos) {
+			return "";
+		}
+		return texName.substr(p + 1);
+	}
+
+
 	static bool Load(const std::string& texName, unsigned int texID)
 	{
 		//! strip off the qualifiers
@@ -123,7 +139,7 @@ namespace CNamedTextures {
 		CBitmap bitmap;
 		TexInfo texInfo;
 
-		if (!bitmap.Load(filename)) {
+		if (!bitmapLoader->Load(filename, bitmap)) {
 			LOG_L(L_WARNING, "Couldn't find texture \"%s\"!", filename.c_str());
 			texMap[texName] = texInfo;
 			glBindTexture(GL_TEXTURE_2D, 0);
@@ -255,6 +271,22 @@ namespace CNamedTextures {
 	}
 
 
+	void Prefetch(const std::string& texName)
+	{
+		if (texName.empty()) {
+			return;
+		}
+
+		GML_STDMUTEX_LOCK(ntex); // Prefetch
+
+		if (texMap.find(texName) != texMap.end()) {
+			return;
+		}
+
+		bitmapLoader->Queue(GetFileName(texName));
+	}
+
+
 	void Update()
 	{
 		if (texWaiting.empty()) {
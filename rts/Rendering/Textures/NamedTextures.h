@@ -18,6 +18,11 @@ namespace CNamedTextures {
 	void Update();
 
 	bool Bind(const std::string& texName);
+	/**
+	 * Start decoding the image on a worker thread, so the first Bind()
+	 * only has to upload it. Images which never get bound stay in memory.
+	 */
+	void Prefetch(const std::string& texName);
 	bool Free(const std::string& texName);
 
 	struct TexInfo {
@@ -9,6 +9,7 @@
 #include "Rendering/UnitDrawer.h"
 #include "Rendering/Models/3DModel.h"
 #include "Rendering/Textures/Bitmap.h"
+#include "Rendering/Textures/BitmapLoader.h"
 #include "System/Util.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
@@ -77,6 +78,9 @@ int CS3OTextureHandler::LoadS3OTextureNow(const S3DModel* model)
 	CBitmap tex2bm;
 	S3oTex* tex = new S3oTex();
 
+	// decode the second texture on a worker while this thread does the first
+	bitmapLoader->Queue(model->tex2);
+
 	if (!tex1bm.Load(model->tex1)) {
 		if (!tex1bm.Load("unittextures/" + model->tex1)) {
 			LOG_L(L_WARNING, "[%s] could not load texture \"%s\" from model \"%s\"",
@@ -96,7 +100,7 @@ int CS3OTextureHandler::LoadS3OTextureNow(const S3DModel* model)
 	// being generated if it couldn't be loaded.
 	// Also many map features specify a tex2 but don't ship it with the map,
 	// so throwing here would cause maps to break.
-	if (!tex2bm.Load(model->tex2)) {
+	if (!bitmapLoader->Load(model->tex2, tex2bm)) {
 		if (!tex2bm.Load("unittextures/" + model->tex2)) {
 			tex2bm.channels = 4;
 			tex2bm.Alloc(1, 1);
@@ -33,6 +33,7 @@
 #include "Rendering/Textures/Bitmap.h"
 #include "Rendering/Textures/3DOTextureHandler.h"
 #include "Rendering/Textures/S3OTextureHandler.h"
+#include "Rendering/Models/3DModel.h"
 #include "Rendering/Models/WorldObjectModelRenderer.h"
 
 #include "Sim/Features/Feature.h"
@@ -58,6 +59,8 @@
 #include "System/TimeProfiler.h"
 #include "System/Util.h"
 
+#include <algorithm>
+
 #ifdef USE_GML
 #include "lib/gml/gmlsrv.h"
 extern gmlClientServer<void, int, CUnit*> *gmlProcessor;
@@ -65,14 +68,21 @@ extern gmlClientServer<void, int, CUnit*> *gmlProcessor;
 
 #define UNIT_SHADOW_ALPHA_MASKING
 
+// units this far outside the view frustum can still cast visible shadows
+#define UNIT_SHADOW_CULL_MARGIN 700.0f
+
 CUnitDrawer* unitDrawer;
 
+// spectators with full view see every unit regardless of LOS
+static inline int GetCullAllyTeam() { return (gu->spectatingFullView? -1: gu->myAllyTeam); }
+
 CONFIG(int, UnitLodDist).defaultValue(1000);
 CONFIG(int, UnitIconDist).defaultValue(10000);
 CONFIG(float, UnitTransparency).defaultValue(0.7f);
 CONFIG(bool, ShowHealthBars).defaultValue(true);
 CONFIG(bool, MultiThreadDrawUnit).defaultValue(true);
 CONFIG(bool, MultiThreadDrawUnitShadow).defaultValue(true);
+CONFIG(bool, InstancedUnitRendering).defaultValue(true);
 
 CONFIG(int, MaxDynamicModelLights)
 	.defaultValue(1)
@@ -92,6 +102,23 @@ inline static void SetUnitGlobalLODFactor(float value)
 	UNIT_GLOBAL_LOD_FACTOR = (value * camera->GetLPPScale());
 }
 
+/// sorts deferred units into (team, model) groups for DrawInstancedUnits
+struct InstancedUnitOrder {
+	InstancedUnitOrder(bool byTeam): byTeam(byTeam) {}
+
+	bool operator () (const CUnit* a, const CUnit* b) const {
+		if (byTeam && a->team != b->team)
+			return (a->team < b->team);
+
+		return (a->model < b->model);
+	}
+	bool SameGroup(const CUnit* a, const CUnit* b) const {
+		return ((!byTeam || a->team == b->team) && a->model == b->model);
+	}
+
+	bool byTeam;
+};
+
 static float GetLODFloat(const string& name)
 {
 	// NOTE: the inverse of the value is used
@@ -152,6 +179,10 @@ CUnitDrawer::CUnitDrawer(): CEventClient("[CUnitDrawer]", 271828, false)
 	multiThreadDrawUnitShadow = configHandler->GetBool("MultiThreadDrawUnitShadow");
 #endif
 
+	useInstancing = configHandler->GetBool("InstancedUnitRendering");
+	collectInstancedUnits = false;
+	cullSet = CObjectCuller::CULL_SET_MAIN;
+
 	// LH must be initialized before drawer-state is initialized
 	lightHandler.Init(2U, configHandler->GetInt("MaxDynamicModelLights"));
 
@@ -251,7 +282,14 @@ void CUnitDrawer::Update()
 
 			UpdateUnitIconState(unit);
 			UpdateUnitDrawPos(unit);
+
+			unitCuller.SetObject(unit->id, unit->drawMidPos, unit->drawRadius);
+			unitCuller.SetLosStatus(unit->id, gu->myAllyTeam, unit->losStatus[gu->myAllyTeam]);
 		}
+
+		// the main camera does not change between here and Draw,
+		// so cull everything once for the view and shadow passes
+		unitCuller.Cull(CObjectCuller::CULL_SET_MAIN, camera, UNIT_SHADOW_CULL_MARGIN, GetCullAllyTeam(), LOS_INLOS);
 	}
 
 	useDistToGroundForIcons = (camHandler->GetCurrentController()).GetUseDistToGroundForIcons();
@@ -315,41 +353,43 @@ inline void CUnitDrawer::DrawOpaqueUnit(CUnit* unit, const CUnit* excludeUnit, b
 	if (unit->noDraw) {
 		return;
 	}
-	if (!camera->InView(unit->drawMidPos, unit->drawRadius)) {
+	if (!unitCuller.IsVisible(cullSet, unit->id, CObjectCuller::CULL_FLAG_VIEW)) {
 		return;
 	}
 
-	if ((unit->losStatus[gu->myAllyTeam] & LOS_INLOS) || gu->spectatingFullView) {
-		if (drawReflection) {
-			float3 zeroPos;
+	if (drawReflection) {
+		float3 zeroPos;
 
-			if (unit->drawMidPos.y < 0.0f) {
-				zeroPos = unit->drawMidPos;
-			} else {
-				const float dif = unit->drawMidPos.y - camera->GetPos().y;
-				zeroPos =
-					camera->GetPos()  * (unit->drawMidPos.y / dif) +
-					unit->drawMidPos * (-camera->GetPos().y / dif);
-			}
-			if (ground->GetApproximateHeight(zeroPos.x, zeroPos.z, false) > unit->drawRadius) {
-				return;
-			}
+		if (unit->drawMidPos.y < 0.0f) {
+			zeroPos = unit->drawMidPos;
+		} else {
+			const float dif = unit->drawMidPos.y - camera->GetPos().y;
+			zeroPos =
+				camera->GetPos()  * (unit->drawMidPos.y / dif) +
+				unit->drawMidPos * (-camera->GetPos().y / dif);
 		}
-		else if (drawRefraction) {
-			if (unit->pos.y > 0.0f) {
-				return;
-			}
+		if (ground->GetApproximateHeight(zeroPos.x, zeroPos.z, false) > unit->drawRadius) {
+			return;
+		}
+	}
+	else if (drawRefraction) {
+		if (unit->pos.y > 0.0f) {
+			return;
 		}
+	}
 #ifdef USE_GML
-		else
-			unit->lastDrawFrame = gs->frameNum;
+	else
+		unit->lastDrawFrame = gs->frameNum;
 #endif
 
-		if (!unit->isIcon) {
-			if ((unit->pos).SqDistance(camera->GetPos()) > (unit->sqRadius * unitDrawDistSqr)) {
-				farTextureHandler->Queue(unit);
-			} else {
-				if (!DrawUnitLOD(unit)) {
+	if (!unit->isIcon) {
+		if ((unit->pos).SqDistance(camera->GetPos()) > (unit->sqRadius * unitDrawDistSqr)) {
+			farTextureHandler->Queue(unit);
+		} else {
+			if (!DrawUnitLOD(unit)) {
+				if (collectInstancedUnits && CanDrawInstanced(unit)) {
+					instancedUnits.push_back(unit);
+				} else {
 					SetTeamColour(unit->team);
 					DrawUnitNow(unit);
 				}
@@ -385,6 +425,12 @@ void CUnitDrawer::Draw(bool drawReflection, bool drawRefraction)
 	// lock on the bins
 	GML_RECMUTEX_LOCK(unit); // Draw
 
+	// reflection and refraction passes use their own camera
+	if (drawReflection || drawRefraction) {
+		cullSet = CObjectCuller::CULL_SET_WATER;
+		unitCuller.Cull(cullSet, camera, 0.0f, GetCullAllyTeam(), LOS_INLOS);
+	}
+
 #ifdef USE_GML
 	mt_drawReflection = drawReflection; // these member vars will be accessed by DrawOpaqueUnitMT
 	mt_drawRefraction = drawRefraction;
@@ -402,6 +448,8 @@ void CUnitDrawer::Draw(bool drawReflection, bool drawRefraction)
 	farTextureHandler->Draw();
 	DrawUnitIcons(drawReflection);
 
+	cullSet = CObjectCuller::CULL_SET_MAIN;
+
 	glDisable(GL_FOG);
 	glDisable(GL_ALPHA_TEST);
 	glDisable(GL_TEXTURE_2D);
@@ -419,6 +467,13 @@ void CUnitDrawer::DrawOpaqueUnits(int modelType, const CUnit* excludeUnit, bool
 	UnitBin::const_iterator unitBinIt;
 	UnitSet::const_iterator unitSetIt;
 
+	// S3O units drawn without Lua materials are deferred and drawn
+	// in instanced batches per bin if the bound shader supports it;
+	// reflection and refraction passes clip per unit and are not batched
+	const bool instancingPass = (useInstancing && modelType == MODELTYPE_S3O && !drawReflection && !drawRefraction);
+	const int instanceMatrixAttrib = instancingPass?
+		unitDrawerState->GetInstanceMatrixAttrib(): -1;
+
 	for (unitBinIt = unitBin.begin(); unitBinIt != unitBin.end(); ++unitBinIt) {
 		if (modelType != MODELTYPE_3DO) {
 			texturehandlerS3O->SetS3oTexture(unitBinIt->first);
@@ -436,9 +491,19 @@ void CUnitDrawer::DrawOpaqueUnits(int modelType, const CUnit* excludeUnit, bool
 		else
 #endif
 		{
+			collectInstancedUnits = (instanceMatrixAttrib >= 0);
+
 			for (unitSetIt = unitSet.begin(); unitSetIt != unitSet.end(); ++unitSetIt) {
 				DrawOpaqueUnit(*unitSetIt, excludeUnit, drawReflection, drawRefraction);
 			}
+
+			collectInstancedUnits = false;
+
+			if (!instancedUnits.empty()) {
+				unitDrawerState->SetInstancing(true);
+				DrawInstancedUnits(instanceMatrixAttrib, true);
+				unitDrawerState->SetInstancing(false);
+			}
 		}
 	}
 
@@ -447,6 +512,108 @@ void CUnitDrawer::DrawOpaqueUnits(int modelType, const CUnit* excludeUnit, bool
 	}
 }
 
+bool CUnitDrawer::CanDrawInstanced(const CUnit* unit) const
+{
+	if (unit->model->type != MODELTYPE_S3O)
+		return false;
+	// Lua LOD display-lists and Lua draw callins need the per-unit path
+	if (unit->lodCount > 0 || unit->luaDraw)
+		return false;
+	if (unit->beingBuilt && unit->unitDef->showNanoFrame)
+		return false;
+
+	return true;
+}
+
+void CUnitDrawer::DrawInstancedUnits(int instanceMatrixAttrib, bool setTeamColors)
+{
+	const InstancedUnitOrder order(setTeamColors);
+
+	std::sort(instancedUnits.begin(), instancedUnits.end(), order);
+
+	instanceMatrices.clear();
+	instancedBatches.clear();
+
+	// lay out the matrices piece-major per group, so that all
+	// visible copies of a piece are consecutive in the buffer
+	for (size_t i = 0, j = 0; i < instancedUnits.size(); i = j) {
+		for (j = i + 1; j < instancedUnits.size() && order.SameGroup(instancedUnits[i], instancedUnits[j]); j++) {}
+
+		unitMatrices.clear();
+
+		for (size_t k = i; k < j; k++) {
+			unitMatrices.push_back(instancedUnits[k]->GetTransformMatrix());
+		}
+
+		const LocalModel* groupModel = instancedUnits[i]->localModel;
+
+		for (unsigned int p = 0; p < groupModel->pieces.size(); p++) {
+			const S3DModelPiece* piece = groupModel->pieces[p]->original;
+
+			if (piece->isEmpty)
+				continue;
+
+			InstancedPieceBatch batch;
+			batch.team = instancedUnits[i]->team;
+			batch.piece = piece;
+			batch.firstInstance = instanceMatrices.size();
+
+			for (size_t k = i; k < j; k++) {
+				const LocalModelPiece* lmp = instancedUnits[k]->localModel->pieces[p];
+
+				if (!lmp->scriptSetVisible)
+					continue;
+
+				instanceMatrices.push_back(lmp->GetModelSpaceMatrix() * unitMatrices[k - i]);
+			}
+
+			batch.numInstances = instanceMatrices.size() - batch.firstInstance;
+
+			if (batch.numInstances > 0) {
+				instancedBatches.push_back(batch);
+			}
+		}
+	}
+
+	instancedUnits.clear();
+
+	if (instancedBatches.empty())
+		return;
+
+	// respecifying the whole buffer lets the driver orphan the old storage
+	instanceMatrixVBO.Bind(GL_ARRAY_BUFFER);
+	instanceMatrixVBO.Resize(instanceMatrices.size() * sizeof(CMatrix44f), GL_STREAM_DRAW, &instanceMatrices[0]);
+	instanceMatrixVBO.Unbind();
+
+	for (int c = 0; c < 4; c++) {
+		glEnableVertexAttribArray(instanceMatrixAttrib + c);
+		glVertexAttribDivisorARB(instanceMatrixAttrib + c, 1);
+	}
+
+	int curTeam = -1;
+
+	for (std::vector<InstancedPieceBatch>::const_iterator it = instancedBatches.begin(); it != instancedBatches.end(); ++it) {
+		if (setTeamColors && it->team != curTeam) {
+			SetTeamColour(curTeam = it->team);
+		}
+
+		// a mat4 attribute takes four consecutive locations, one per column
+		instanceMatrixVBO.Bind(GL_ARRAY_BUFFER);
+		for (int c = 0; c < 4; c++) {
+			const GLintptr offset = it->firstInstance * sizeof(CMatrix44f) + c * 4 * sizeof(float);
+			glVertexAttribPointer(instanceMatrixAttrib + c, 4, GL_FLOAT, GL_FALSE, sizeof(CMatrix44f), instanceMatrixVBO.GetPtr(offset));
+		}
+		instanceMatrixVBO.Unbind();
+
+		it->piece->DrawInstances(it->numInstances);
+	}
+
+	for (int c = 0; c < 4; c++) {
+		glVertexAttribDivisorARB(instanceMatrixAttrib + c, 0);
+		glDisableVertexAttribArray(instanceMatrixAttrib + c);
+	}
+}
+
 void CUnitDrawer::DrawOpaqueAIUnits()
 {
 	GML_STDMUTEX_LOCK(temp); // DrawOpaqueAIUnits
@@ -702,10 +869,8 @@ inline void CUnitDrawer::DrawOpaqueUnitShadow(CUnit* unit) {
 		#define POP_SHADOW_TEXTURE_STATE(model)
 	#endif
 
-	const bool unitInLOS = ((unit->losStatus[gu->myAllyTeam] & LOS_INLOS) || gu->spectatingFullView);
-
 	// FIXME: test against the shadow projection intersection
-	if (!(unitInLOS && camera->InView(unit->drawMidPos, unit->drawRadius + 700.0f))) {
+	if (!unitCuller.IsVisible(CObjectCuller::CULL_SET_MAIN, unit->id, CObjectCuller::CULL_FLAG_SHADOW)) {
 		return;
 	}
 
@@ -720,9 +885,13 @@ inline void CUnitDrawer::DrawOpaqueUnitShadow(CUnit* unit) {
 	GML_LODMUTEX_LOCK(unit); // DrawOpaqueUnitShadow
 
 	if (unit->lodCount <= 0) {
-		PUSH_SHADOW_TEXTURE_STATE(unit->model);
-		DrawUnitNow(unit);
-		POP_SHADOW_TEXTURE_STATE(unit->model);
+		if (collectInstancedUnits && CanDrawInstanced(unit)) {
+			instancedUnits.push_back(unit);
+		} else {
+			PUSH_SHADOW_TEXTURE_STATE(unit->model);
+			DrawUnitNow(unit);
+			POP_SHADOW_TEXTURE_STATE(unit->model);
+		}
 	} else {
 		LuaUnitMaterial& unitMat = unit->luaMats[LUAMAT_SHADOW];
 		const unsigned lod = CalcUnitLOD(unit, unitMat.GetLastLOD());
@@ -750,6 +919,13 @@ void CUnitDrawer::DrawOpaqueUnitsShadow(int modelType) {
 	UnitBin::const_iterator unitBinIt;
 	UnitSet::const_iterator unitSetIt;
 
+	Shader::IProgramObject* po =
+		shadowHandler->GetShadowGenProg(CShadowHandler::SHADOWGEN_PROGRAM_MODEL);
+
+	// only the GLSL shadow-gen program can draw instanced
+	const int instanceMatrixAttrib = (useInstancing && globalRendering->supportInstancing && modelType == MODELTYPE_S3O)?
+		po->GetAttribLocation("instanceMatrix"): -1;
+
 	for (unitBinIt = unitBin.begin(); unitBinIt != unitBin.end(); ++unitBinIt) {
 		const UnitSet& unitSet = unitBinIt->second;
 
@@ -764,9 +940,30 @@ void CUnitDrawer::DrawOpaqueUnitsShadow(int modelType) {
 		else
 #endif
 		{
+			collectInstancedUnits = (instanceMatrixAttrib >= 0);
+
 			for (unitSetIt = unitSet.begin(); unitSetIt != unitSet.end(); ++unitSetIt) {
 				DrawOpaqueUnitShadow(*unitSetIt);
 			}
+
+			collectInstancedUnits = false;
+
+			if (!instancedUnits.empty()) {
+				#ifdef UNIT_SHADOW_ALPHA_MASKING
+				glActiveTexture(GL_TEXTURE0);
+				glEnable(GL_TEXTURE_2D);
+				glBindTexture(GL_TEXTURE_2D, texturehandlerS3O->GetS3oTex(unitBinIt->first)->tex2);
+				#endif
+
+				po->SetUniform1i(CShadowHandler::SHADOWGEN_UNIFORM_INSTANCED, 1);
+				DrawInstancedUnits(instanceMatrixAttrib, false);
+				po->SetUniform1i(CShadowHandler::SHADOWGEN_UNIFORM_INSTANCED, 0);
+
+				#ifdef UNIT_SHADOW_ALPHA_MASKING
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glDisable(GL_TEXTURE_2D);
+				#endif
+			}
 		}
 	}
 }
@@ -2001,17 +2198,12 @@ void CUnitDrawer::DrawUnitMiniMapIcon(const CUnit* unit, CVertexArray* va) const
 //   the latter has been replaced by this, do the same for the former
 //   (mini-map icons and real-map radar icons are the same anyway)
 void CUnitDrawer::DrawUnitMiniMapIcons() const {
-	std::map<icon::CIconData*, std::set<const CUnit*> >::const_iterator iconIt;
-	std::set<const CUnit*>::const_iterator unitIt;
-
 	CVertexArray* va = GetVertexArray();
 
-	for (iconIt = unitsByIcon.begin(); iconIt != unitsByIcon.end(); ++iconIt) {
-		const icon::CIconData* icon = iconIt->first;
-		const std::set<const CUnit*>& units = iconIt->second;
+	for (std::vector<MiniMapIconBin>::const_iterator binIt = miniMapIconBins.begin(); binIt != miniMapIconBins.end(); ++binIt) {
+		const icon::CIconData* icon = binIt->icon;
+		const std::vector<const CUnit*>& units = binIt->units;
 
-		if (icon == NULL)
-			continue;
 		if (units.empty())
 			continue;
 
@@ -2019,9 +2211,9 @@ void CUnitDrawer::DrawUnitMiniMapIcons() const {
 		va->EnlargeArrays(units.size() * 4, 0, VA_SIZE_2DTC);
 		icon->BindTexture();
 
-		for (unitIt = units.begin(); unitIt != units.end(); ++unitIt) {
-			assert((*unitIt)->myIcon == icon);
-			DrawUnitMiniMapIcon(*unitIt, va);
+		for (unsigned int n = 0; n < units.size(); n++) {
+			assert(units[n]->myIcon == icon);
+			DrawUnitMiniMapIcon(units[n], va);
 		}
 
 		va->DrawArray2dTC(GL_QUADS);
@@ -2036,16 +2228,60 @@ void CUnitDrawer::UpdateUnitMiniMapIcon(const CUnit* unit, bool forced, bool kil
 
 	if (!killed) {
 		if ((oldIcon != newIcon) || forced) {
-			unitsByIcon[oldIcon].erase(u);
-			unitsByIcon[newIcon].insert(u);
+			DelUnitMiniMapIcon(u);
+			AddUnitMiniMapIcon(u, newIcon);
 		}
 	} else {
-		unitsByIcon[oldIcon].erase(u);
+		DelUnitMiniMapIcon(u);
 	}
 
 	u->myIcon = killed? NULL: newIcon;
 }
 
+void CUnitDrawer::AddUnitMiniMapIcon(const CUnit* unit, icon::CIconData* icon) {
+	if (icon == NULL)
+		return;
+
+	std::map<icon::CIconData*, unsigned int>::const_iterator it = miniMapIconBinIndices.find(icon);
+
+	unsigned int binIdx = miniMapIconBins.size();
+
+	if (it == miniMapIconBinIndices.end()) {
+		miniMapIconBins.push_back(MiniMapIconBin());
+		miniMapIconBins.back().icon = icon;
+		miniMapIconBinIndices[icon] = binIdx;
+	} else {
+		binIdx = it->second;
+	}
+
+	if (unit->id >= int(miniMapIconSlots.size()))
+		miniMapIconSlots.resize(unit->id + 1, std::make_pair(-1, -1));
+
+	std::vector<const CUnit*>& units = miniMapIconBins[binIdx].units;
+
+	miniMapIconSlots[unit->id] = std::make_pair(int(binIdx), int(units.size()));
+	units.push_back(unit);
+}
+
+void CUnitDrawer::DelUnitMiniMapIcon(const CUnit* unit) {
+	if (unit->id >= int(miniMapIconSlots.size()))
+		return;
+
+	const std::pair<int, int> slot = miniMapIconSlots[unit->id];
+
+	if (slot.first < 0)
+		return;
+
+	std::vector<const CUnit*>& units = miniMapIconBins[slot.first].units;
+	const CUnit* lastUnit = units.back();
+
+	units[slot.second] = lastUnit;
+	units.pop_back();
+
+	miniMapIconSlots[lastUnit->id].second = slot.second;
+	miniMapIconSlots[unit->id] = std::make_pair(-1, -1);
+}
+
 
 
 void CUnitDrawer::RenderUnitCreated(const CUnit* u, int cloaked) {
@@ -2069,6 +2305,12 @@ void CUnitDrawer::RenderUnitCreated(const CUnit* u, int cloaked) {
 
 	UpdateUnitMiniMapIcon(u, false, false);
 	unsortedUnits.insert(unit);
+
+	unitCuller.AddObject(u->id, u->drawMidPos, u->drawRadius);
+
+	for (unsigned int allyTeam = 0; allyTeam < u->losStatus.size(); allyTeam++) {
+		unitCuller.SetLosStatus(u->id, allyTeam, u->losStatus[allyTeam]);
+	}
 }
 
 
@@ -2105,6 +2347,7 @@ void CUnitDrawer::RenderUnitDestroyed(const CUnit* unit) {
 
 	unsortedUnits.erase(u);
 	liveGhostBuildings[MDL_TYPE(u)].erase(u);
+	unitCuller.RemoveObject(u->id);
 
 	// remove the icon for all ally-teams
 	for (std::vector<std::set<CUnit*> >::iterator it = unitRadarIcons.begin(); it != unitRadarIcons.end(); ++it) {
@@ -2138,6 +2381,8 @@ void CUnitDrawer::RenderUnitCloakChanged(const CUnit* unit, int cloaked) {
 void CUnitDrawer::RenderUnitLOSChanged(const CUnit* unit, int allyTeam, int newStatus) {
 	CUnit* u = const_cast<CUnit*>(unit);
 
+	unitCuller.SetLosStatus(u->id, allyTeam, newStatus);
+
 	if (newStatus & LOS_INLOS) {
 		if (allyTeam == gu->myAllyTeam) {
 			if (gameSetup->ghostedBuildings && unit->unitDef->IsImmobileUnit()) {
@@ -2245,13 +2490,14 @@ void CUnitDrawer::PlayerChanged(int playerNum) {
 	if (playerNum != gu->myPlayerNum)
 		return;
 
-	std::map<icon::CIconData*, std::set<const CUnit*> >::iterator iconIt;
 	std::set<CUnit*>::const_iterator unitIt;
 
-	for (iconIt = unitsByIcon.begin(); iconIt != unitsByIcon.end(); ++iconIt) {
-		(iconIt->second).clear();
+	for (unsigned int n = 0; n < miniMapIconBins.size(); n++) {
+		miniMapIconBins[n].units.clear();
 	}
 
+	std::fill(miniMapIconSlots.begin(), miniMapIconSlots.end(), std::make_pair(-1, -1));
+
 	for (unitIt = unsortedUnits.begin(); unitIt != unsortedUnits.end(); ++unitIt) {
 		// force an erase (no-op) followed by an insert
 		UpdateUnitMiniMapIcon(*unitIt, true, false);
@@ -11,6 +11,9 @@
 
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/LightHandler.h"
+#include "Rendering/GL/VBO.h"
+#include "Rendering/ObjectCuller.h"
+#include "System/Matrix44f.h"
 #include "System/EventClient.h"
 #include "lib/gml/ThreadSafeContainers.h"
 
@@ -24,6 +27,7 @@ struct BuildInfo;
 struct SolidObjectGroundDecal;
 struct GhostSolidObject;
 struct IUnitDrawerState;
+struct S3DModelPiece;
 
 namespace icon {
 	class CIconData;
@@ -131,6 +135,8 @@ private:
 	void DrawOpaqueUnitsShadow(int modelType);
 
 	void DrawOpaqueUnits(int modelType, const CUnit* excludeUnit, bool drawReflection, bool drawRefraction);
+	bool CanDrawInstanced(const CUnit* unit) const;
+	void DrawInstancedUnits(int instanceMatrixAttrib, bool setTeamColors);
 	void DrawOpaqueShaderUnits();
 	void DrawCloakedShaderUnits();
 	void DrawShadowShaderUnits();
@@ -142,6 +148,8 @@ private:
 	void DrawUnitIcons(bool drawReflection);
 	void DrawUnitMiniMapIcon(const CUnit* unit, CVertexArray* va) const;
 	void UpdateUnitMiniMapIcon(const CUnit* unit, bool forced, bool killed);
+	void AddUnitMiniMapIcon(const CUnit* unit, icon::CIconData* icon);
+	void DelUnitMiniMapIcon(const CUnit* unit);
 
 	// note: make these static?
 	void DrawUnitBeingBuilt(CUnit* unit);
@@ -169,6 +177,8 @@ public:
 public:
 	bool advShading;
 	bool advFade;
+	/// draw opaque S3O units in instanced batches where supported
+	bool useInstancing;
 
 	float LODScale;
 	float LODScaleShadow;
@@ -214,6 +224,11 @@ private:
 	 */
 	std::set<CUnit*> unsortedUnits;
 
+	/// draw-positions and LOS of <unsortedUnits>, culled once per pass
+	CObjectCuller unitCuller;
+	/// CObjectCuller::CULL_SET_* used by the current opaque pass
+	unsigned int cullSet;
+
 	/// buildings that were in LOS_PREVLOS when they died and not in LOS since
 	std::vector<std::set<GhostSolidObject*> > deadGhostBuildings;
 	/// buildings that left LOS but are still alive
@@ -225,7 +240,40 @@ private:
 #endif
 
 	std::vector<std::set<CUnit*> > unitRadarIcons;
-	std::map<icon::CIconData*, std::set<const CUnit*> > unitsByIcon;
+
+	/**
+	 * units packed per minimap icon (removal moves the last unit of a
+	 * bin into the hole), only changed by UpdateUnitMiniMapIcon so that
+	 * DrawUnitMiniMapIcons just walks flat arrays
+	 */
+	struct MiniMapIconBin {
+		icon::CIconData* icon;
+		std::vector<const CUnit*> units;
+	};
+
+	std::vector<MiniMapIconBin> miniMapIconBins;
+	std::map<icon::CIconData*, unsigned int> miniMapIconBinIndices;
+	/// unit id -> (bin, slot in bin), (-1, -1) if the unit has no icon
+	std::vector< std::pair<int, int> > miniMapIconSlots;
+
+	/**
+	 * opaque units deferred by DrawOpaqueUnit{Shadow} while
+	 * <collectInstancedUnits> is set, drawn per texture bin
+	 * with one instanced call per (team, model, piece)
+	 */
+	struct InstancedPieceBatch {
+		int team;
+		const S3DModelPiece* piece;
+		unsigned int firstInstance;
+		unsigned int numInstances;
+	};
+
+	std::vector<CUnit*> instancedUnits;
+	std::vector<CMatrix44f> unitMatrices;
+	std::vector<CMatrix44f> instanceMatrices;
+	std::vector<InstancedPieceBatch> instancedBatches;
+	VBO instanceMatrixVBO;
+	bool collectInstancedUnits;
 
 	IUnitDrawerState* unitDrawerStateSSP; // default shader-driven rendering path
 	IUnitDrawerState* unitDrawerStateFFP; // fallback shader-less rendering path
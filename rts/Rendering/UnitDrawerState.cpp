@@ -359,6 +359,7 @@ bool UnitDrawerStateGLSL::Init(const CUnitDrawer* ud) {
 		modelShaders[n]->SetUniformLocation("shadowMatrix");      // idx 13
 		modelShaders[n]->SetUniformLocation("shadowParams");      // idx 14
 		modelShaders[n]->SetUniformLocation("numModelDynLights"); // idx 15
+		modelShaders[n]->SetUniformLocation("instanced");         // idx 16
 
 		modelShaders[n]->Enable();
 		modelShaders[n]->SetUniform1i(0, 0); // diffuseTex  (idx 0, texunit 0)
@@ -371,6 +372,7 @@ bool UnitDrawerStateGLSL::Init(const CUnitDrawer* ud) {
 		modelShaders[n]->SetUniform3fv(11, &ud->unitSunColor[0]);
 		modelShaders[n]->SetUniform1f(12, sky->GetLight()->GetUnitShadowDensity());
 		modelShaders[n]->SetUniform1i(15, 0); // numModelDynLights
+		modelShaders[n]->SetUniform1i(16, 0); // instanced
 		modelShaders[n]->Disable();
 		modelShaders[n]->Validate();
 	}
@@ -431,6 +433,19 @@ void UnitDrawerStateGLSL::UpdateCurrentShader(const CUnitDrawer* ud, const ISkyL
 	modelShaders[MODEL_SHADER_SHADOW]->Disable();
 }
 
+int UnitDrawerStateGLSL::GetInstanceMatrixAttrib() const {
+	if (!globalRendering->supportInstancing)
+		return -1;
+	if (!modelShaders[MODEL_SHADER_ACTIVE]->IsBound())
+		return -1;
+
+	return modelShaders[MODEL_SHADER_ACTIVE]->GetAttribLocation("instanceMatrix");
+}
+
+void UnitDrawerStateGLSL::SetInstancing(bool enable) const {
+	modelShaders[MODEL_SHADER_ACTIVE]->SetUniform1i(16, int(enable));
+}
+
 void UnitDrawerStateGLSL::SetTeamColor(int team, float alpha) const {
 	const CTeam* t = teamHandler->Team(team);
 	const float4 c = float4(t->color[0] / 255.0f, t->color[1] / 255.0f, t->color[2] / 255.0f, alpha);
@@ -35,6 +35,11 @@ public:
 	virtual void UpdateCurrentShader(const CUnitDrawer*, const ISkyLight*) const {}
 	virtual void SetTeamColor(int team, float alpha = 1.0f) const {}
 
+	/// @return location of the per-instance model matrix attribute of
+	///   the bound model shader, or -1 if it can not draw instanced
+	virtual int GetInstanceMatrixAttrib() const { return -1; }
+	virtual void SetInstancing(bool enable) const {}
+
 	enum ModelShaderProgram {
 		MODEL_SHADER_BASIC  = 0, ///< model shader (V+F) without self-shadowing
 		MODEL_SHADER_SHADOW = 1, ///< model shader (V+F) with self-shadowing
@@ -106,6 +111,9 @@ public:
 
 	void UpdateCurrentShader(const CUnitDrawer*, const ISkyLight*) const;
 	void SetTeamColor(int team, float alpha = 1.0f) const;
+
+	int GetInstanceMatrixAttrib() const;
+	void SetInstancing(bool enable) const;
 };
 
 #endif
@@ -24,6 +24,7 @@
 #include "System/Exceptions.h"
 #include "System/float4.h"
 #include "System/bitops.h"
+#include "System/Platform/Threading.h"
 
 #undef GetCharWidth // winapi.h
 
@@ -47,6 +48,9 @@ CglFont* smallFont;
 
 #define GLYPH_MARGIN 2 //! margin between glyphs in texture-atlas
 
+#define MAX_LAYOUT_CACHE_SIZE 2048 //! laid out strings kept per font
+#define MAX_WRAP_CACHE_SIZE    256 //! wrapped texts kept per font
+
 static const unsigned char nullChar = 0;
 static const float4        white(1.00f, 1.00f, 1.00f, 0.95f);
 static const float4  darkOutline(0.05f, 0.05f, 0.05f, 0.95f);
@@ -414,6 +418,7 @@ CglFont::CglFont(const std::string& fontfile, int size, int _outlinewidth, float
 	outlineWidth(_outlinewidth),
 	outlineWeight(_outlineweight),
 	inBeginEnd(false),
+	multiColorText(false),
 	autoOutlineColor(true),
 	setColor(false)
 {
@@ -577,8 +582,7 @@ CglFont::CglFont(const std::string& fontfile, int size, int _outlinewidth, float
 	texHeight = 0;
 #endif // HEADLESS
 
-	textColor    = white;
-	outlineColor = darkOutline;
+	SetColors(&white, &darkOutline);
 }
 
 
@@ -721,10 +725,44 @@ static inline bool SkipColorCodesAndNewLines(const std::string& text, T* pos, fl
 }
 
 
-static inline void TextStripCallback(void* data)
+static inline void ColorToBytes(const float4& color, unsigned char* bytes)
 {
-	CglFont::ColorMap::iterator& sci = *reinterpret_cast<CglFont::ColorMap::iterator*>(data);
-	glColor4fv(*sci++);
+	bytes[0] = (unsigned char) (Clamp(color[0], 0.0f, 1.0f) * 255.0f);
+	bytes[1] = (unsigned char) (Clamp(color[1], 0.0f, 1.0f) * 255.0f);
+	bytes[2] = (unsigned char) (Clamp(color[2], 0.0f, 1.0f) * 255.0f);
+	bytes[3] = (unsigned char) (Clamp(color[3], 0.0f, 1.0f) * 255.0f);
+}
+
+
+static inline unsigned int GetCacheFrame()
+{
+	return ((globalRendering != NULL)? globalRendering->drawFrame: 0);
+}
+
+/**
+ * Called before inserting into a full cache: drops all entries that
+ * were not used in this or the previous frame, and everything if that
+ * does not free any room (e.g. during loading, when drawFrame stalls).
+ */
+template <typename K, typename V>
+static void PruneCache(std::map<K, V>& cache, const unsigned int maxSize)
+{
+	if (cache.size() < maxSize)
+		return;
+
+	const unsigned int frame = GetCacheFrame();
+
+	for (typename std::map<K, V>::iterator it = cache.begin(); it != cache.end(); ) {
+		if ((frame - it->second.lastUsedFrame) > 1) {
+			cache.erase(it++);
+		} else {
+			++it;
+		}
+	}
+
+	if (cache.size() >= maxSize) {
+		cache.clear();
+	}
 }
 
 
@@ -1434,12 +1472,18 @@ void CglFont::RemergeColorCodes(std::list<word>* words, std::list<colorcode>& co
 }
 
 
-int CglFont::WrapInPlace(std::string& text, float _fontSize, const float maxWidth, const float maxHeight) const
+bool CglFont::WrapCacheKey::operator < (const WrapCacheKey& k) const
 {
-	// TODO make an option to insert '-' for word wrappings (and perhaps try to syllabificate)
+	if (fontSize  != k.fontSize ) return (fontSize  < k.fontSize );
+	if (maxWidth  != k.maxWidth ) return (maxWidth  < k.maxWidth );
+	if (maxHeight != k.maxHeight) return (maxHeight < k.maxHeight);
+	return (text < k.text);
+}
 
-	if (_fontSize <= 0.0f)
-		_fontSize = fontSize;
+
+void CglFont::WrapText(const std::string& text, float _fontSize, const float maxWidth, const float maxHeight, WrappedText* wrapped) const
+{
+	// TODO make an option to insert '-' for word wrappings (and perhaps try to syllabificate)
 
 	const float maxWidthf  = maxWidth / _fontSize;
 	const float maxHeightf = maxHeight / _fontSize;
@@ -1452,72 +1496,90 @@ int CglFont::WrapInPlace(std::string& text, float _fontSize, const float maxWidt
 	//WrapTextKnuth(&lines, words, maxWidthf, maxHeightf);
 	RemergeColorCodes(&words, colorcodes);
 
-	//! create the wrapped string
-	text = "";
-	unsigned int numlines = 0;
-	if (!words.empty()) {
-		numlines++;
-		for (std::list<word>::iterator wi = words.begin(); wi != words.end(); ++wi) {
-			if (wi->isSpace) {
-				for (unsigned int j = 0; j < wi->numSpaces; ++j) {
-					text += " ";
-				}
-			} else if (wi->isLineBreak) {
-				text += "\x0d\x0a";
-				numlines++;
-			} else {
-				text += wi->text;
-			}
+	//! create the wrapped string and its lines
+	wrapped->text = "";
+	wrapped->lines.clear();
+	wrapped->numLines = 0;
+
+	if (words.empty())
+		return;
+
+	std::list<word>::iterator lastColorCode = words.end();
+
+	wrapped->lines.push_back("");
+	wrapped->numLines++;
+
+	std::string* sl = &wrapped->lines.back();
+
+	for (std::list<word>::iterator wi = words.begin(); wi != words.end(); ++wi) {
+		if (wi->isSpace) {
+			wrapped->text.append(wi->numSpaces, ' ');
+			sl->append(wi->numSpaces, ' ');
+		} else if (wi->isLineBreak) {
+			wrapped->text += "\x0d\x0a";
+			wrapped->numLines++;
+
+			wrapped->lines.push_back("");
+			sl = &wrapped->lines.back();
+			if (lastColorCode != words.end())
+				*sl += lastColorCode->text;
+		} else {
+			wrapped->text += wi->text;
+			*sl += wi->text;
+			if (wi->isColorCode)
+				lastColorCode = wi;
 		}
 	}
-
-	return numlines;
 }
 
 
-std::list<std::string> CglFont::Wrap(const std::string& text, float _fontSize, const float maxWidth, const float maxHeight) const
+const CglFont::WrappedText& CglFont::GetWrappedText(const std::string& text, float _fontSize, const float maxWidth, const float maxHeight, WrappedText* scratch) const
 {
-	// TODO make an option to insert '-' for word wrappings (and perhaps try to syllabificate)
-
 	if (_fontSize <= 0.0f)
 		_fontSize = fontSize;
 
-	const float maxWidthf  = maxWidth / _fontSize;
-	const float maxHeightf = maxHeight / _fontSize;
+	//! the cache is not shared with other threads
+	if (!Threading::IsMainThread()) {
+		WrapText(text, _fontSize, maxWidth, maxHeight, scratch);
+		return *scratch;
+	}
 
-	std::list<word> words;
-	std::list<colorcode> colorcodes;
+	WrapCacheKey key;
+	key.text      = text;
+	key.fontSize  = _fontSize;
+	key.maxWidth  = maxWidth;
+	key.maxHeight = maxHeight;
 
-	SplitTextInWords(text, &words, &colorcodes);
-	WrapTextConsole(words, maxWidthf, maxHeightf);
-	//WrapTextKnuth(&lines, words, maxWidthf, maxHeightf);
-	RemergeColorCodes(&words, colorcodes);
+	std::map<WrapCacheKey, WrappedText>::iterator it = wrapCache.find(key);
 
-	//! create the string lines of the wrapped text
-	std::list<word>::iterator lastColorCode = words.end();
-	std::list<std::string> strlines;
-	if (!words.empty()) {
-		strlines.push_back("");
-		std::string* sl = &strlines.back();
-		for (std::list<word>::iterator wi = words.begin(); wi != words.end(); ++wi) {
-			if (wi->isSpace) {
-				for (unsigned int j = 0; j < wi->numSpaces; ++j) {
-					*sl += " ";
-				}
-			} else if (wi->isLineBreak) {
-				strlines.push_back("");
-				sl = &strlines.back();
-				if (lastColorCode != words.end())
-					*sl += lastColorCode->text;
-			} else {
-				*sl += wi->text;
-				if (wi->isColorCode)
-					lastColorCode = wi;
-			}
-		}
+	if (it == wrapCache.end()) {
+		PruneCache(wrapCache, MAX_WRAP_CACHE_SIZE);
+
+		it = wrapCache.insert(std::make_pair(key, WrappedText())).first;
+		WrapText(text, _fontSize, maxWidth, maxHeight, &it->second);
 	}
 
-	return strlines;
+	it->second.lastUsedFrame = GetCacheFrame();
+	return it->second;
+}
+
+
+int CglFont::WrapInPlace(std::string& text, float _fontSize, const float maxWidth, const float maxHeight) const
+{
+	WrappedText scratch;
+	const WrappedText& wrapped = GetWrappedText(text, _fontSize, maxWidth, maxHeight, &scratch);
+
+	text = wrapped.text;
+	return wrapped.numLines;
+}
+
+
+std::list<std::string> CglFont::Wrap(const std::string& text, float _fontSize, const float maxWidth, const float maxHeight) const
+{
+	WrappedText scratch;
+	const WrappedText& wrapped = GetWrappedText(text, _fontSize, maxWidth, maxHeight, &scratch);
+
+	return wrapped.lines;
 }
 
 
@@ -1534,17 +1596,12 @@ void CglFont::SetTextColor(const float4* color)
 {
 	if (color == NULL) color = &white;
 
-	if (inBeginEnd && !(*color==textColor)) {
-		if ((va->stripArrayPos - va->stripArray) != (va->drawArrayPos - va->drawArray)) {
-			stripTextColors.push_back(*color);
-			va->EndStrip();
-		} else {
-			float4& back = stripTextColors.back();
-			back = *color;
-		}
+	if (inBeginEnd && !(*color==textColor) && va->drawIndex() > 0) {
+		multiColorText = true;
 	}
 
 	textColor = *color;
+	ColorToBytes(textColor, textColorBytes);
 }
 
 
@@ -1552,17 +1609,8 @@ void CglFont::SetOutlineColor(const float4* color)
 {
 	if (color == NULL) color = ChooseOutlineColor(textColor);
 
-	if (inBeginEnd && !(*color==outlineColor)) {
-		if ((va2->stripArrayPos - va2->stripArray) != (va2->drawArrayPos - va2->drawArray)) {
-			stripOutlineColors.push_back(*color);
-			va2->EndStrip();
-		} else {
-			float4& back = stripOutlineColors.back();
-			back = *color;
-		}
-	}
-
 	outlineColor = *color;
+	ColorToBytes(outlineColor, outlineColorBytes);
 }
 
 
@@ -1571,29 +1619,14 @@ void CglFont::SetColors(const float4* _textColor, const float4* _outlineColor)
 	if (_textColor == NULL) _textColor = &white;
 	if (_outlineColor == NULL) _outlineColor = ChooseOutlineColor(*_textColor);
 
-	if (inBeginEnd) {
-		if (!(*_textColor==textColor)) {
-			if ((va->stripArrayPos - va->stripArray) != (va->drawArrayPos - va->drawArray)) {
-				stripTextColors.push_back(*_textColor);
-				va->EndStrip();
-			} else {
-				float4& back = stripTextColors.back();
-				back = *_textColor;
-			}
-		}
-		if (!(*_outlineColor==outlineColor)) {
-			if ((va2->stripArrayPos - va2->stripArray) != (va2->drawArrayPos - va2->drawArray)) {
-				stripOutlineColors.push_back(*_outlineColor);
-				va2->EndStrip();
-			} else {
-				float4& back = stripOutlineColors.back();
-				back = *_outlineColor;
-			}
-		}
+	if (inBeginEnd && !(*_textColor==textColor) && va->drawIndex() > 0) {
+		multiColorText = true;
 	}
 
 	textColor    = *_textColor;
 	outlineColor = *_outlineColor;
+	ColorToBytes(textColor, textColorBytes);
+	ColorToBytes(outlineColor, outlineColorBytes);
 }
 
 
@@ -1629,12 +1662,10 @@ void CglFont::Begin(const bool immediate, const bool resetColors)
 
 	inBeginEnd = true;
 
+	multiColorText = false;
+
 	va->Initialize();
 	va2->Initialize();
-	stripTextColors.clear();
-	stripOutlineColors.clear();
-	stripTextColors.push_back(textColor);
-	stripOutlineColors.push_back(outlineColor);
 }
 
 
@@ -1658,29 +1689,154 @@ void CglFont::End()
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	//! colors are per-vertex, so each layer is a single draw call
+	//! no matter how often they changed in between Begin and End
 	if (va2->drawIndex() > 0) {
-		if (stripOutlineColors.size() > 1) {
-			ColorMap::iterator sci = stripOutlineColors.begin();
-			va2->DrawArray2dT(GL_QUADS,TextStripCallback,&sci);
-		} else {
-			glColor4fv(outlineColor);
-			va2->DrawArray2dT(GL_QUADS);
-		}
+		va2->DrawArray2dTC(GL_QUADS);
 	}
 
-	if (stripTextColors.size() > 1) {
-		ColorMap::iterator sci = stripTextColors.begin();
-		va->DrawArray2dT(GL_QUADS,TextStripCallback,&sci);
+	if (setColor || multiColorText) {
+		va->DrawArray2dTC(GL_QUADS);
 	} else {
-		if (setColor) glColor4fv(textColor);
-		va->DrawArray2dT(GL_QUADS);
+		//! backward compability: use the color set by the caller
+		va->DrawArray2dT(GL_QUADS, sizeof(float) * VA_SIZE_2DTC);
 	}
 
 	glPopAttrib();
 }
 
 
-void CglFont::RenderString(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+const CglFont::TextLayout& CglFont::GetTextLayout(const std::string& str, TextLayout* scratch)
+{
+	//! the cache is not shared with other threads
+	if (!Threading::IsMainThread()) {
+		BuildTextLayout(str, scratch);
+		return *scratch;
+	}
+
+	std::map<std::string, TextLayout>::iterator it = layoutCache.find(str);
+
+	if (it == layoutCache.end()) {
+		PruneCache(layoutCache, MAX_LAYOUT_CACHE_SIZE);
+		it = layoutCache.insert(std::make_pair(str, TextLayout())).first;
+		BuildTextLayout(str, &it->second);
+	}
+
+	it->second.lastUsedFrame = GetCacheFrame();
+	return it->second;
+}
+
+
+void CglFont::BuildTextLayout(const std::string& str, TextLayout* out)
+{
+	TextLayout& layout = *out;
+
+	//! same parsing as SkipColorCodesAndNewLines, but with
+	//! glyph positions kept in font units so any size can
+	//! be drawn from it
+	const unsigned int length = (unsigned int)str.length();
+
+	const GlyphInfo* g = NULL;
+	float x = 0.0f;
+	unsigned int line = 0;
+	bool newLine = false;
+
+	layout.glyphs.reserve(length);
+
+	for (unsigned int i = 0; i < length; ) {
+		switch (str[i]) {
+			case ColorCodeIndicator: {
+				i += 4;
+				if (i < length) {
+					LayoutColor lc;
+					lc.glyph = layout.glyphs.size();
+					lc.reset = false;
+					lc.color.x = ((unsigned char) str[i - 3]) / 255.0f;
+					lc.color.y = ((unsigned char) str[i - 2]) / 255.0f;
+					lc.color.z = ((unsigned char) str[i - 1]) / 255.0f;
+					layout.colors.push_back(lc);
+				}
+			} break;
+
+			case ColorResetIndicator: {
+				LayoutColor lc;
+				lc.glyph = layout.glyphs.size();
+				lc.reset = true;
+				layout.colors.push_back(lc);
+				i++;
+			} break;
+
+			case '\x0d': //! CR
+				line++;
+				i++;
+				newLine = true;
+				if (i < length && str[i] == '\x0a') { //! CR+LF
+					i++;
+				}
+				break;
+
+			case '\x0a': //! LF
+				line++;
+				i++;
+				newLine = true;
+				break;
+
+			default: {
+				const unsigned char c = str[i++];
+
+				if (newLine) {
+					x = 0.0f;
+					newLine = false;
+				} else if (g) {
+					x += g->kerning[c];
+				}
+
+				g = &glyphs[c];
+
+				LayoutGlyph lg;
+				lg.x = x;
+				lg.line = line;
+				lg.c = c;
+				layout.glyphs.push_back(lg);
+			}
+		}
+	}
+
+	layout.width = GetTextWidth(str);
+	layout.height = GetTextHeight(str, &layout.descender);
+}
+
+
+void CglFont::ApplyLayoutColors(const TextLayout& layout, unsigned int glyphIdx, unsigned int* colorIdx, float4* newColor)
+{
+	bool colorChanged = false;
+
+	while (*colorIdx < layout.colors.size() && layout.colors[*colorIdx].glyph == glyphIdx) {
+		const LayoutColor& lc = layout.colors[(*colorIdx)++];
+
+		if (lc.reset) {
+			*newColor = baseTextColor;
+		} else {
+			(*newColor)[0] = lc.color.x;
+			(*newColor)[1] = lc.color.y;
+			(*newColor)[2] = lc.color.z;
+		}
+
+		colorChanged = true;
+	}
+
+	if (!colorChanged)
+		return;
+
+	if (autoOutlineColor) {
+		SetColors(newColor, NULL);
+	} else {
+		SetTextColor(newColor);
+	}
+}
+
+
+void CglFont::RenderString(float x, float y, const float& scaleX, const float& scaleY, const TextLayout& layout)
 {
 	/**
 	 * NOTE:
@@ -1694,175 +1850,109 @@ void CglFont::RenderString(float x, float y, const float& scaleX, const float& s
 	 *    floating point multiplications and shouldn't be too expensive.
 	 */
 
-	const float startx = x;
 	const float lineHeight_ = scaleY * lineHeight;
-	unsigned int length = (unsigned int)str.length();
+	const unsigned int numGlyphs = layout.glyphs.size();
 
-	va->EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
+	va->EnlargeArrays(numGlyphs * 4, 0, VA_SIZE_2DTC);
 
-	int skippedLines;
-	bool endOfString, colorChanged;
-	const GlyphInfo* g = NULL;
-	const unsigned char* c;
 	float4 newColor; newColor[3] = 1.0f;
-	unsigned int i = 0;
-
-	do {
-		endOfString = SkipColorCodesAndNewLines(str, &i, &newColor, &colorChanged, &skippedLines, &baseTextColor);
-
-		if (endOfString)
-			return;
+	unsigned int colorIdx = 0;
 
-		c  = reinterpret_cast<const unsigned char*>(&str[i]);
-		++i;
-
-		if (colorChanged) {
-			if (autoOutlineColor) {
-				SetColors(&newColor,NULL);
-			} else {
-				SetTextColor(&newColor);
-			}
-		}
+	for (unsigned int i = 0; i < numGlyphs; i++) {
+		const LayoutGlyph& lg = layout.glyphs[i];
+		const GlyphInfo* g = &glyphs[lg.c];
 
-		if (skippedLines>0) {
-			x  = startx;
-			y -= skippedLines * lineHeight_;
-		} else if (g) {
-			x += scaleX * g->kerning[*c];
-		}
+		ApplyLayoutColors(layout, i, &colorIdx, &newColor);
 
-		g = &glyphs[*c];
+		const float gx = x + scaleX * lg.x;
+		const float gy = y - lineHeight_ * lg.line;
 
-		va->AddVertex2dQT(x+scaleX*g->x0, y+scaleY*g->y1, g->u0, g->v1);
-		va->AddVertex2dQT(x+scaleX*g->x0, y+scaleY*g->y0, g->u0, g->v0);
-		va->AddVertex2dQT(x+scaleX*g->x1, y+scaleY*g->y0, g->u1, g->v0);
-		va->AddVertex2dQT(x+scaleX*g->x1, y+scaleY*g->y1, g->u1, g->v1);
-	} while(true);
+		va->AddVertex2dQTC(gx+scaleX*g->x0, gy+scaleY*g->y1, g->u0, g->v1, textColorBytes);
+		va->AddVertex2dQTC(gx+scaleX*g->x0, gy+scaleY*g->y0, g->u0, g->v0, textColorBytes);
+		va->AddVertex2dQTC(gx+scaleX*g->x1, gy+scaleY*g->y0, g->u1, g->v0, textColorBytes);
+		va->AddVertex2dQTC(gx+scaleX*g->x1, gy+scaleY*g->y1, g->u1, g->v1, textColorBytes);
+	}
 }
 
 
-void CglFont::RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+void CglFont::RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const TextLayout& layout)
 {
 	const float shiftX = scaleX*0.1, shiftY = scaleY*0.1;
 	const float ssX = (scaleX/fontSize)*outlineWidth, ssY = (scaleY/fontSize)*outlineWidth;
 
-	const float startx = x;
 	const float lineHeight_ = scaleY * lineHeight;
-	unsigned int length = (unsigned int)str.length();
+	const unsigned int numGlyphs = layout.glyphs.size();
 
-	va->EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
-	va2->EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
+	va->EnlargeArrays(numGlyphs * 4, 0, VA_SIZE_2DTC);
+	va2->EnlargeArrays(numGlyphs * 4, 0, VA_SIZE_2DTC);
 
-	int skippedLines;
-	bool endOfString, colorChanged;
-	const GlyphInfo* g = NULL;
-	const unsigned char* c;
 	float4 newColor; newColor[3] = 1.0f;
-	unsigned int i = 0;
+	unsigned int colorIdx = 0;
 
-	do {
-		endOfString = SkipColorCodesAndNewLines(str, &i, &newColor, &colorChanged, &skippedLines, &baseTextColor);
+	for (unsigned int i = 0; i < numGlyphs; i++) {
+		const LayoutGlyph& lg = layout.glyphs[i];
+		const GlyphInfo* g = &glyphs[lg.c];
 
-		if (endOfString)
-			return;
+		ApplyLayoutColors(layout, i, &colorIdx, &newColor);
 
-		c  = reinterpret_cast<const unsigned char*>(&str[i]);
-		++i;
+		const float gx = x + scaleX * lg.x;
+		const float gy = y - lineHeight_ * lg.line;
 
-		if (colorChanged) {
-			if (autoOutlineColor) {
-				SetColors(&newColor,NULL);
-			} else {
-				SetTextColor(&newColor);
-			}
-		}
-
-		if (skippedLines>0) {
-			x  = startx;
-			y -= skippedLines * lineHeight_;
-		} else if (g) {
-			x += scaleX * g->kerning[*c];
-		}
-
-		g = &glyphs[*c];
-
-		const float dx0 = x + scaleX * g->x0, dy0 = y + scaleY * g->y0;
-		const float dx1 = x + scaleX * g->x1, dy1 = y + scaleY * g->y1;
+		const float dx0 = gx + scaleX * g->x0, dy0 = gy + scaleY * g->y0;
+		const float dx1 = gx + scaleX * g->x1, dy1 = gy + scaleY * g->y1;
 
 		//! draw shadow
-		va2->AddVertex2dQT(dx0+shiftX-ssX, dy1-shiftY-ssY, g->us0, g->vs1);
-		va2->AddVertex2dQT(dx0+shiftX-ssX, dy0-shiftY+ssY, g->us0, g->vs0);
-		va2->AddVertex2dQT(dx1+shiftX+ssX, dy0-shiftY+ssY, g->us1, g->vs0);
-		va2->AddVertex2dQT(dx1+shiftX+ssX, dy1-shiftY-ssY, g->us1, g->vs1);
+		va2->AddVertex2dQTC(dx0+shiftX-ssX, dy1-shiftY-ssY, g->us0, g->vs1, outlineColorBytes);
+		va2->AddVertex2dQTC(dx0+shiftX-ssX, dy0-shiftY+ssY, g->us0, g->vs0, outlineColorBytes);
+		va2->AddVertex2dQTC(dx1+shiftX+ssX, dy0-shiftY+ssY, g->us1, g->vs0, outlineColorBytes);
+		va2->AddVertex2dQTC(dx1+shiftX+ssX, dy1-shiftY-ssY, g->us1, g->vs1, outlineColorBytes);
 
 		//! draw the actual character
-		va->AddVertex2dQT(dx0, dy1, g->u0, g->v1);
-		va->AddVertex2dQT(dx0, dy0, g->u0, g->v0);
-		va->AddVertex2dQT(dx1, dy0, g->u1, g->v0);
-		va->AddVertex2dQT(dx1, dy1, g->u1, g->v1);
-	} while(true);
+		va->AddVertex2dQTC(dx0, dy1, g->u0, g->v1, textColorBytes);
+		va->AddVertex2dQTC(dx0, dy0, g->u0, g->v0, textColorBytes);
+		va->AddVertex2dQTC(dx1, dy0, g->u1, g->v0, textColorBytes);
+		va->AddVertex2dQTC(dx1, dy1, g->u1, g->v1, textColorBytes);
+	}
 }
 
 
-void CglFont::RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+void CglFont::RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const TextLayout& layout)
 {
 	const float shiftX = (scaleX/fontSize)*outlineWidth, shiftY = (scaleY/fontSize)*outlineWidth;
 
-	const float startx = x;
 	const float lineHeight_ = scaleY * lineHeight;
-	unsigned int length = (unsigned int)str.length();
+	const unsigned int numGlyphs = layout.glyphs.size();
 
-	va->EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
-	va2->EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
+	va->EnlargeArrays(numGlyphs * 4, 0, VA_SIZE_2DTC);
+	va2->EnlargeArrays(numGlyphs * 4, 0, VA_SIZE_2DTC);
 
-	int skippedLines;
-	bool endOfString, colorChanged;
-	const GlyphInfo* g = NULL;
-	const unsigned char* c;
 	float4 newColor; newColor[3] = 1.0f;
-	unsigned int i = 0;
-
-	do {
-		endOfString = SkipColorCodesAndNewLines(str, &i, &newColor, &colorChanged, &skippedLines, &baseTextColor);
+	unsigned int colorIdx = 0;
 
-		if (endOfString)
-			return;
+	for (unsigned int i = 0; i < numGlyphs; i++) {
+		const LayoutGlyph& lg = layout.glyphs[i];
+		const GlyphInfo* g = &glyphs[lg.c];
 
-		c  = reinterpret_cast<const unsigned char*>(&str[i]);
-		++i;
+		ApplyLayoutColors(layout, i, &colorIdx, &newColor);
 
-		if (colorChanged) {
-			if (autoOutlineColor) {
-				SetColors(&newColor,NULL);
-			} else {
-				SetTextColor(&newColor);
-			}
-		}
-
-		if (skippedLines>0) {
-			x  = startx;
-			y -= skippedLines * lineHeight_;
-		} else if (g) {
-			x += scaleX * g->kerning[*c];
-		}
+		const float gx = x + scaleX * lg.x;
+		const float gy = y - lineHeight_ * lg.line;
 
-		g = &glyphs[*c];
-
-		const float dx0 = x + scaleX * g->x0, dy0 = y + scaleY * g->y0;
-		const float dx1 = x + scaleX * g->x1, dy1 = y + scaleY * g->y1;
+		const float dx0 = gx + scaleX * g->x0, dy0 = gy + scaleY * g->y0;
+		const float dx1 = gx + scaleX * g->x1, dy1 = gy + scaleY * g->y1;
 
 		//! draw outline
-		va2->AddVertex2dQT(dx0-shiftX, dy1-shiftY, g->us0, g->vs1);
-		va2->AddVertex2dQT(dx0-shiftX, dy0+shiftY, g->us0, g->vs0);
-		va2->AddVertex2dQT(dx1+shiftX, dy0+shiftY, g->us1, g->vs0);
-		va2->AddVertex2dQT(dx1+shiftX, dy1-shiftY, g->us1, g->vs1);
+		va2->AddVertex2dQTC(dx0-shiftX, dy1-shiftY, g->us0, g->vs1, outlineColorBytes);
+		va2->AddVertex2dQTC(dx0-shiftX, dy0+shiftY, g->us0, g->vs0, outlineColorBytes);
+		va2->AddVertex2dQTC(dx1+shiftX, dy0+shiftY, g->us1, g->vs0, outlineColorBytes);
+		va2->AddVertex2dQTC(dx1+shiftX, dy1-shiftY, g->us1, g->vs1, outlineColorBytes);
 
 		//! draw the actual character
-		va->AddVertex2dQT(dx0, dy1, g->u0, g->v1);
-		va->AddVertex2dQT(dx0, dy0, g->u0, g->v0);
-		va->AddVertex2dQT(dx1, dy0, g->u1, g->v0);
-		va->AddVertex2dQT(dx1, dy1, g->u1, g->v1);
-	} while(true);
+		va->AddVertex2dQTC(dx0, dy1, g->u0, g->v1, textColorBytes);
+		va->AddVertex2dQTC(dx0, dy0, g->u0, g->v0, textColorBytes);
+		va->AddVertex2dQTC(dx1, dy0, g->u1, g->v0, textColorBytes);
+		va->AddVertex2dQTC(dx1, dy1, g->u1, g->v1, textColorBytes);
+	}
 }
 
 
@@ -1894,11 +1984,14 @@ void CglFont::glPrint(float x, float y, float s, const int options, const std::s
 		sizeY *= globalRendering->pixelY;
 	}
 
+	TextLayout scratch;
+	const TextLayout& layout = GetTextLayout(text, &scratch);
+
 	//! horizontal alignment (FONT_LEFT is default)
 	if (options & FONT_CENTER) {
-		x -= sizeX * 0.5f * GetTextWidth(text);
+		x -= sizeX * 0.5f * layout.width;
 	} else if (options & FONT_RIGHT) {
-		x -= sizeX * GetTextWidth(text);
+		x -= sizeX * layout.width;
 	}
 
 
@@ -1909,18 +2002,15 @@ void CglFont::glPrint(float x, float y, float s, const int options, const std::s
 	} else if (options & FONT_DESCENDER) {
 		y -= sizeY * fontDescender;
 	} else if (options & FONT_VCENTER) {
-		float textDescender;
-		y -= sizeY * 0.5f * GetTextHeight(text,&textDescender);
-		y -= sizeY * 0.5f * textDescender;
+		y -= sizeY * 0.5f * layout.height;
+		y -= sizeY * 0.5f * layout.descender;
 	} else if (options & FONT_TOP) {
-		y -= sizeY * GetTextHeight(text);
+		y -= sizeY * layout.height;
 	} else if (options & FONT_ASCENDER) {
 		y -= sizeY * fontDescender;
 		y -= sizeY;
 	} else if (options & FONT_BOTTOM) {
-		float textDescender;
-		GetTextHeight(text,&textDescender);
-		y -= sizeY * textDescender;
+		y -= sizeY * layout.descender;
 	}
 
 	if (options & FONT_NEAREST) {
@@ -1941,11 +2031,11 @@ void CglFont::glPrint(float x, float y, float s, const int options, const std::s
 
 	//! select correct decoration RenderString function
 	if (options & FONT_OUTLINE) {
-		RenderStringOutlined(x, y, sizeX, sizeY, text);
+		RenderStringOutlined(x, y, sizeX, sizeY, layout);
 	} else if (options & FONT_SHADOW) {
-		RenderStringShadow(x, y, sizeX, sizeY, text);
+		RenderStringShadow(x, y, sizeX, sizeY, layout);
 	} else {
-		RenderString(x, y, sizeX, sizeY, text);
+		RenderString(x, y, sizeX, sizeY, layout);
 	}
 
 
@@ -5,6 +5,8 @@
 
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
 #include <limits.h> // for INT_MAX
 
 #include "System/float4.h"
@@ -39,6 +41,7 @@ public:
 
 	//! The calling of Begin() .. End() is optional,
 	//! but can increase the performance of drawing multiple strings a lot (upto 10x)
+	//! (all strings printed in between are drawn with one call per text layer)
 	void Begin(const bool immediate = false, const bool resetColors = true);
 	void End();
 
@@ -64,6 +67,7 @@ public:
 	void SetOutlineColor(const float& r, const float& g, const float& b, const float& a) { const float4 f = float4(r,g,b,a); SetOutlineColor(&f); };
 
 	//! Adds \n's (and '...' if it would be too high) until the text fits into maxWidth/maxHeight
+	//! (results are cached per text, fontSize, maxWidth and maxHeight)
 	int WrapInPlace(std::string& text, float fontSize, const float maxWidth, const float maxHeight = 1e9) const;
 	std::list<std::string> Wrap(const std::string& text, float fontSize, const float maxWidth, const float maxHeight = 1e9) const;
 
@@ -93,8 +97,6 @@ public:
 	static const char ColorResetIndicator = '\x08'; //! =: '\\b'
 
 public:
-	typedef std::vector<float4> ColorMap;
-
 	struct GlyphInfo
 	{
 		GlyphInfo()
@@ -118,11 +120,57 @@ public:
 	} glyphs[256];
 
 private:
+	//! glyph of a laid out string, <x> is in unscaled font units
+	struct LayoutGlyph {
+		float x;
+		unsigned int line;
+		unsigned char c;
+	};
+	//! inlined colorcode, applied before glyph number <glyph>
+	struct LayoutColor {
+		unsigned int glyph;
+		bool reset;
+		float3 color;
+	};
+	//! size independent layout of a string, kept between frames
+	struct TextLayout {
+		TextLayout() : width(0.0f), height(0.0f), descender(0.0f), lastUsedFrame(0) {};
+
+		std::vector<LayoutGlyph> glyphs;
+		std::vector<LayoutColor> colors;
+		float width;
+		float height;
+		float descender;
+		unsigned int lastUsedFrame;
+	};
+
+	struct WrapCacheKey {
+		bool operator < (const WrapCacheKey& k) const;
+
+		std::string text;
+		float fontSize;
+		float maxWidth;
+		float maxHeight;
+	};
+	struct WrappedText {
+		WrappedText() : numLines(0), lastUsedFrame(0) {};
+
+		std::string text;
+		std::list<std::string> lines;
+		int numLines;
+		unsigned int lastUsedFrame;
+	};
+
 	static const float4* ChooseOutlineColor(const float4& textColor);
 
-	void RenderString(float x, float y, const float& scaleX, const float& scaleY, const std::string& str);
-	void RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const std::string& str);
-	void RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const std::string& str);
+	/// cached on the main thread, built into <scratch> on others
+	const TextLayout& GetTextLayout(const std::string& str, TextLayout* scratch);
+	void BuildTextLayout(const std::string& str, TextLayout* out);
+	void ApplyLayoutColors(const TextLayout& layout, unsigned int glyphIdx, unsigned int* colorIdx, float4* newColor);
+
+	void RenderString(float x, float y, const float& scaleX, const float& scaleY, const TextLayout& layout);
+	void RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const TextLayout& layout);
+	void RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const TextLayout& layout);
 
 private:
 	struct colorcode {
@@ -161,6 +209,9 @@ private:
 	void WrapTextConsole(std::list<word>& words, float maxWidth, float maxHeight) const;
 	void WrapTextKnuth(std::list<word>& words, float maxWidth, float maxHeight) const;
 
+	void WrapText(const std::string& text, float fontSize, float maxWidth, float maxHeight, WrappedText* wrapped) const;
+	const WrappedText& GetWrappedText(const std::string& text, float fontSize, float maxWidth, float maxHeight, WrappedText* scratch) const;
+
 private:
 	float fontSize;
 	float fontDescender;
@@ -177,10 +228,11 @@ private:
 	unsigned int fontTexture;
 	unsigned int texWidth,texHeight;
 
-	ColorMap stripTextColors;
-	ColorMap stripOutlineColors;
+	std::map<std::string, TextLayout> layoutCache;
+	mutable std::map<WrapCacheKey, WrappedText> wrapCache;
 
 	bool inBeginEnd;
+	bool multiColorText; //! text colors changed between glyphs since Begin()
 	CVertexArray* va;
 	CVertexArray* va2;
 
@@ -191,6 +243,10 @@ private:
 	float4 textColor;
 	float4 outlineColor;
 
+	//! per-vertex copies of the above
+	unsigned char textColorBytes[4];
+	unsigned char outlineColorBytes[4];
+
 	//! \::ColorResetIndicator will reset to those (they are the colors set when glPrint was called)
 	float4 baseTextColor;
 	float4 baseOutlineColor;
@@ -86,6 +86,8 @@ void CModInfo::Init(const char* modArchive)
 		allowGroundUnitGravity = movementTbl.GetBool("allowGroundUnitGravity", true);
 		allowHoverUnitStrafing = movementTbl.GetBool("allowHoverUnitStrafing", (pathFinderSystem == PFS_TYPE_QTPFS));
 		useClassicGroundMoveType = movementTbl.GetBool("useClassicGroundMoveType", (gameSetup->modName.find("Balanced Annihilation") != std::string::npos));
+		useParallelMoveTypeUpdate = movementTbl.GetBool("useParallelMoveTypeUpdate", false);
+		useCollisionBroadphase = movementTbl.GetBool("useCollisionBroadphase", false);
 	}
 
 	{
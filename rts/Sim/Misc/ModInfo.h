@@ -90,6 +90,8 @@ public:
 	bool allowGroundUnitGravity;     // determines if (ground-)units experience gravity during regular movement
 	bool allowHoverUnitStrafing;     // determines if (hover-)units carry their momentum sideways when turning
 	bool useClassicGroundMoveType;   // determines if (ground-)units use the CClassicGroundMoveType path-follower
+	bool useParallelMoveTypeUpdate;  // determines if movetypes precompute (eg. steering) on worker threads before the serial update
+	bool useCollisionBroadphase;     // determines if (ground-)unit collision candidates come from a per-frame broadphase instead of per-unit quadfield queries
 
 	// Build behaviour
 	/// Should constructions without builders decay?
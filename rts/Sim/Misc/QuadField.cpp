@@ -8,6 +8,7 @@
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Features/Feature.h"
+#include "Sim/MoveTypes/CollisionBroadphase.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Projectiles/Projectile.h"
 #include "System/creg/STL_List.h"
@@ -198,6 +199,28 @@ std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& pos, float radius, b
 	return units;
 }
 
+void CQuadField::GetUnitsExactConcurrent(const float3& pos, float radius, std::vector<CUnit*>& units) const
+{
+	const std::vector<int>& quads = GetQuads(pos, radius);
+
+	std::vector<int>::const_iterator qi;
+	std::list<CUnit*>::const_iterator ui;
+	std::set<const CUnit*> seen;
+
+	units.clear();
+
+	for (qi = quads.begin(); qi != quads.end(); ++qi) {
+		for (ui = baseQuads[*qi].units.begin(); ui != baseQuads[*qi].units.end(); ++ui) {
+			const float totRad = radius + (*ui)->radius;
+
+			if ((pos - (*ui)->midPos).SqLength() >= (totRad * totRad)) { continue; }
+			if (!seen.insert(*ui).second) { continue; }
+
+			units.push_back(*ui);
+		}
+	}
+}
+
 std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& mins, const float3& maxs)
 {
 	GML_RECMUTEX_LOCK(qnum); // GetUnitsExact
@@ -388,6 +411,11 @@ unsigned int CQuadField::GetQuadsOnRay(float3 start, float3 dir, float length, i
 
 void CQuadField::MovedUnit(CUnit* unit)
 {
+	if (collisionBroadphase != NULL) {
+		// teleports (Lua, transports) and other moves outside the movetype update
+		collisionBroadphase->UnitMoved(unit);
+	}
+
 	const std::vector<int>& newQuads = GetQuads(unit->pos, unit->radius);
 
 	// compare if the quads have changed, if not stop here
@@ -448,6 +476,10 @@ void CQuadField::AddFeature(CFeature* feature)
 {
 	GML_RECMUTEX_LOCK(quad); // AddFeature
 
+	if (collisionBroadphase != NULL) {
+		collisionBroadphase->AddFeature(feature);
+	}
+
 	const std::vector<int>& newQuads = GetQuads(feature->pos, feature->radius);
 
 	std::vector<int>::const_iterator qi;
@@ -460,6 +492,10 @@ void CQuadField::RemoveFeature(CFeature* feature)
 {
 	GML_RECMUTEX_LOCK(quad); // RemoveFeature
 
+	if (collisionBroadphase != NULL) {
+		collisionBroadphase->RemoveFeature(feature);
+	}
+
 	const std::vector<int>& quads = GetQuads(feature->pos, feature->radius);
 
 	std::vector<int>::const_iterator qi;
@@ -582,6 +618,28 @@ std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float rad
 	return features;
 }
 
+void CQuadField::GetFeaturesExactConcurrent(const float3& pos, float radius, std::vector<CFeature*>& features) const
+{
+	const std::vector<int>& quads = GetQuads(pos, radius);
+
+	std::vector<int>::const_iterator qi;
+	std::list<CFeature*>::const_iterator fi;
+	std::set<const CFeature*> seen;
+
+	features.clear();
+
+	for (qi = quads.begin(); qi != quads.end(); ++qi) {
+		for (fi = baseQuads[*qi].features.begin(); fi != baseQuads[*qi].features.end(); ++fi) {
+			const float totRad = radius + (*fi)->radius;
+
+			if ((pos - (*fi)->midPos).SqLength() >= (totRad * totRad)) { continue; }
+			if (!seen.insert(*fi).second) { continue; }
+
+			features.push_back(*fi);
+		}
+	}
+}
+
 std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float radius, bool spherical)
 {
 	GML_RECMUTEX_LOCK(qnum); // GetFeaturesExact
@@ -737,6 +795,41 @@ std::vector<CSolidObject*> CQuadField::GetSolidsExact(const float3& pos, float r
 	return solids;
 }
 
+void CQuadField::GetSolidsExactConcurrent(const float3& pos, float radius, std::vector<CSolidObject*>& solids) const
+{
+	const std::vector<int>& quads = GetQuads(pos, radius);
+
+	std::vector<int>::const_iterator qi;
+	std::list<CUnit*>::const_iterator ui;
+	std::list<CFeature*>::const_iterator fi;
+
+	solids.clear();
+
+	// objects spanning several quads are filtered by a linear search
+	// instead of tempNum, result-sets of these queries are always small
+	for (qi = quads.begin(); qi != quads.end(); ++qi) {
+		for (ui = baseQuads[*qi].units.begin(); ui != baseQuads[*qi].units.end(); ++ui) {
+			const float totRad = radius + (*ui)->radius;
+
+			if (!(*ui)->blocking) { continue; }
+			if ((pos - (*ui)->midPos).SqLength() >= (totRad * totRad)) { continue; }
+			if (std::find(solids.begin(), solids.end(), *ui) != solids.end()) { continue; }
+
+			solids.push_back(*ui);
+		}
+
+		for (fi = baseQuads[*qi].features.begin(); fi != baseQuads[*qi].features.end(); ++fi) {
+			const float totRad = radius + (*fi)->radius;
+
+			if (!(*fi)->blocking) { continue; }
+			if ((pos - (*fi)->midPos).SqLength() >= (totRad * totRad)) { continue; }
+			if (std::find(solids.begin(), solids.end(), *fi) != solids.end()) { continue; }
+
+			solids.push_back(*fi);
+		}
+	}
+}
+
 
 
 std::vector<int> CQuadField::GetQuadsRectangle(const float3& pos1, const float3& pos2) const
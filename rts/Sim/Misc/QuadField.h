@@ -55,12 +55,20 @@ public:
 	 * mins and maxs, which extends infinitely along the y-axis
 	 */
 	std::vector<CUnit*> GetUnitsExact(const float3& mins, const float3& maxs);
+	/**
+	 * Same result (and order) as GetUnitsExact(pos, radius), but does not
+	 * touch any tempNum's, for readers outside the sim- and render-threads
+	 * (threaded Skirmish AIs) while nothing moves in the quadfield
+	 */
+	void GetUnitsExactConcurrent(const float3& pos, float radius, std::vector<CUnit*>& units) const;
 
 	/**
 	 * Returns all features within @c radius of @c pos,
 	 * and takes the 3D model radius of each feature into account
 	 */
 	std::vector<CFeature*> GetFeaturesExact(const float3& pos, float radius);
+	/// tempNum-free version of GetFeaturesExact(pos, radius)
+	void GetFeaturesExactConcurrent(const float3& pos, float radius, std::vector<CFeature*>& features) const;
 	/**
 	 * Returns all features within @c radius of @c pos,
 	 * and performs the search within a sphere or cylinder depending on @c spherical
@@ -76,6 +84,12 @@ public:
 	std::vector<CProjectile*> GetProjectilesExact(const float3& mins, const float3& maxs);
 
 	std::vector<CSolidObject*> GetSolidsExact(const float3& pos, float radius);
+	/**
+	 * Same result (and order) as GetSolidsExact, but does not touch any
+	 * tempNum's and can therefore be used from multiple threads at once
+	 * as long as nothing moves or gets added to the quadfield meanwhile
+	 */
+	void GetSolidsExactConcurrent(const float3& pos, float radius, std::vector<CSolidObject*>& solids) const;
 
 	void MovedUnit(CUnit* unit);
 	void RemoveUnit(CUnit* unit);
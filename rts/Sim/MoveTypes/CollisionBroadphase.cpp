@@ -0,0 +1,284 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+
+#include "CollisionBroadphase.h"
+#include "MoveDefHandler.h"
+#include "MoveType.h"
+#include "Sim/Features/Feature.h"
+#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitHandler.h"
+#include "System/myMath.h"
+#include "System/TimeProfiler.h"
+
+// same as in GroundMoveType.cpp
+#define FOOTPRINT_RADIUS(xs, zs, s) ((math::sqrt((xs * xs + zs * zs)) * 0.5f * SQUARE_SIZE) * s)
+
+// largest distance a single push response can move a unit
+// (sepResponse in CGroundMoveType::HandleUnitCollisions)
+static const float PUSH_RESPONSE_MAX = SQUARE_SIZE * 2.0f;
+
+// edge length of a feature grid cell (elmos)
+static const float FEATURE_CELL_SIZE = SQUARE_SIZE * 8.0f;
+
+CCollisionBroadphase* collisionBroadphase = NULL;
+
+
+
+static bool CompareUnitIDs(const CUnit* a, const CUnit* b) { return (a->id < b->id); }
+static bool CompareFeatureIDs(const CFeature* a, const CFeature* b) { return (a->id < b->id); }
+
+
+
+CCollisionBroadphase::CCollisionBroadphase()
+	: updateFrame(-1)
+	, featureGridBuilt(false)
+	, numCellsX(0)
+	, numCellsZ(0)
+{
+}
+
+bool CCollisionBroadphase::IsValid() const
+{
+	return (updateFrame == gs->frameNum);
+}
+
+
+
+void CCollisionBroadphase::Update(const std::list<CUnit*>& units)
+{
+	SCOPED_TIMER("Unit::MoveType::Broadphase");
+
+	if (!featureGridBuilt) {
+		BuildFeatureGrid();
+	}
+
+	entries.clear();
+	entries.reserve(units.size());
+	unitPairs.clear();
+	overflowedUnits.clear();
+	unitSamples.resize(unitHandler->MaxUnits());
+
+	for (std::list<CUnit*>::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
+		CUnit* u = *ui;
+		const MoveDef* md = u->moveDef;
+
+		// NOTE:
+		//   positions are sampled before any movetype has updated, so extend
+		//   every footprint by the distance its owner can still cover (moving
+		//   or being pushed once) this frame; units that get further than that
+		//   are reported to UnitMoved and handled separately
+		const float radius = (md != NULL)?
+			FOOTPRINT_RADIUS(md->xsize, md->zsize, 0.75f):
+			FOOTPRINT_RADIUS(u ->xsize, u ->zsize, 0.75f);
+		const float margin = std::max(u->speed.Length(), u->moveType->GetMaxSpeed()) + PUSH_RESPONSE_MAX;
+
+		Entry e;
+		e.xmin = u->pos.x - (radius + margin);
+		e.xmax = u->pos.x + (radius + margin);
+		e.zmin = u->pos.z - (radius + margin);
+		e.zmax = u->pos.z + (radius + margin);
+		e.unit = u;
+		e.id = u->id;
+		e.isCollider = (md != NULL);
+
+		entries.push_back(e);
+
+		UnitSample& s = unitSamples[u->id];
+		s.x = u->pos.x;
+		s.z = u->pos.z;
+		s.margin = margin;
+		s.frame = gs->frameNum;
+		s.overflowed = false;
+	}
+
+	FindPairs();
+
+	updateFrame = gs->frameNum;
+}
+
+void CCollisionBroadphase::FindPairs()
+{
+	// sort-and-sweep along x; entries are ordered by (xmin, id)
+	// which only depends on synced state, as does everything after it
+	std::sort(entries.begin(), entries.end());
+
+	const int numEntries = entries.size();
+
+	for (int i = 0; i < numEntries; i++) {
+		const Entry& a = entries[i];
+
+		for (int j = i + 1; j < numEntries; j++) {
+			const Entry& b = entries[j];
+
+			if (b.xmin > a.xmax)
+				break;
+			if (b.zmin > a.zmax || b.zmax < a.zmin)
+				continue;
+
+			if (a.isCollider) { unitPairs.push_back(Pair(a.id, b.id, b.unit)); }
+			if (b.isCollider) { unitPairs.push_back(Pair(b.id, a.id, a.unit)); }
+		}
+	}
+
+	std::sort(unitPairs.begin(), unitPairs.end());
+}
+
+
+
+void CCollisionBroadphase::UnitMoved(const CUnit* unit)
+{
+	if (!IsValid())
+		return;
+	if (unit->id >= int(unitSamples.size()))
+		return;
+
+	UnitSample& s = unitSamples[unit->id];
+
+	// not swept this frame (created since), or already reported
+	if (s.frame != updateFrame || s.overflowed)
+		return;
+
+	const float dx = unit->pos.x - s.x;
+	const float dz = unit->pos.z - s.z;
+
+	if ((dx * dx + dz * dz) <= (s.margin * s.margin))
+		return;
+
+	s.overflowed = true;
+	overflowedUnits.push_back(const_cast<CUnit*>(unit));
+}
+
+bool CCollisionBroadphase::GetUnitCollidees(const CUnit* collider, std::vector<CUnit*>& collidees) const
+{
+	if (!IsValid())
+		return false;
+	if (collider->id >= int(unitSamples.size()))
+		return false;
+
+	const UnitSample& s = unitSamples[collider->id];
+
+	// the pairs do not cover where the collider is now
+	if (s.frame != updateFrame || s.overflowed)
+		return false;
+
+	std::vector<Pair>::const_iterator it = std::lower_bound(unitPairs.begin(), unitPairs.end(), Pair(collider->id, -1, NULL));
+
+	for (collidees.clear(); it != unitPairs.end() && it->colliderID == collider->id; ++it) {
+		collidees.push_back(it->collidee);
+	}
+
+	if (overflowedUnits.empty())
+		return true;
+
+	// units that left their margin can be anywhere near the collider now
+	for (std::vector<CUnit*>::const_iterator ui = overflowedUnits.begin(); ui != overflowedUnits.end(); ++ui) {
+		CUnit* u = *ui;
+
+		if (u == collider)
+			continue;
+		if (std::find(collidees.begin(), collidees.end(), u) != collidees.end())
+			continue;
+
+		collidees.push_back(u);
+	}
+
+	std::sort(collidees.begin(), collidees.end(), CompareUnitIDs);
+	return true;
+}
+
+
+
+void CCollisionBroadphase::BuildFeatureGrid()
+{
+	numCellsX = std::max(1, int(math::ceil((gs->mapx * SQUARE_SIZE) / FEATURE_CELL_SIZE)));
+	numCellsZ = std::max(1, int(math::ceil((gs->mapy * SQUARE_SIZE) / FEATURE_CELL_SIZE)));
+
+	featureCells.clear();
+	featureCells.resize(numCellsX * numCellsZ);
+	featureGridBuilt = true;
+
+	const CFeatureSet& features = featureHandler->GetActiveFeatures();
+
+	for (CFeatureSet::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
+		AddFeature(*fi);
+	}
+}
+
+void CCollisionBroadphase::GetCells(float x, float z, float radius, int& x1, int& z1, int& x2, int& z2) const
+{
+	x1 = Clamp(int((x - radius) / FEATURE_CELL_SIZE), 0, numCellsX - 1);
+	z1 = Clamp(int((z - radius) / FEATURE_CELL_SIZE), 0, numCellsZ - 1);
+	x2 = Clamp(int((x + radius) / FEATURE_CELL_SIZE), 0, numCellsX - 1);
+	z2 = Clamp(int((z + radius) / FEATURE_CELL_SIZE), 0, numCellsZ - 1);
+}
+
+void CCollisionBroadphase::GetFeatureCells(const CFeature* feature, int& x1, int& z1, int& x2, int& z2) const
+{
+	GetCells(feature->pos.x, feature->pos.z, FOOTPRINT_RADIUS(feature->xsize, feature->zsize, 0.75f), x1, z1, x2, z2);
+}
+
+void CCollisionBroadphase::AddFeature(CFeature* feature)
+{
+	// picked up by BuildFeatureGrid
+	if (!featureGridBuilt)
+		return;
+
+	int x1, z1, x2, z2;
+	GetFeatureCells(feature, x1, z1, x2, z2);
+
+	for (int z = z1; z <= z2; z++) {
+		for (int x = x1; x <= x2; x++) {
+			featureCells[z * numCellsX + x].push_back(feature);
+		}
+	}
+}
+
+void CCollisionBroadphase::RemoveFeature(CFeature* feature)
+{
+	if (!featureGridBuilt)
+		return;
+
+	// same cells as in AddFeature, the position does not change in between
+	int x1, z1, x2, z2;
+	GetFeatureCells(feature, x1, z1, x2, z2);
+
+	for (int z = z1; z <= z2; z++) {
+		for (int x = x1; x <= x2; x++) {
+			std::vector<CFeature*>& cell = featureCells[z * numCellsX + x];
+			std::vector<CFeature*>::iterator fi = std::find(cell.begin(), cell.end(), feature);
+
+			if (fi != cell.end()) {
+				*fi = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+}
+
+bool CCollisionBroadphase::GetFeatureCollidees(const CUnit* collider, float colliderRadius, std::vector<CFeature*>& collidees) const
+{
+	if (!featureGridBuilt)
+		return false;
+
+	int x1, z1, x2, z2;
+	GetCells(collider->pos.x, collider->pos.z, colliderRadius, x1, z1, x2, z2);
+
+	collidees.clear();
+
+	for (int z = z1; z <= z2; z++) {
+		for (int x = x1; x <= x2; x++) {
+			const std::vector<CFeature*>& cell = featureCells[z * numCellsX + x];
+			collidees.insert(collidees.end(), cell.begin(), cell.end());
+		}
+	}
+
+	// features spanning several cells are found once per cell; the
+	// order within a cell depends on removals, so sort by ID
+	std::sort(collidees.begin(), collidees.end(), CompareFeatureIDs);
+	collidees.erase(std::unique(collidees.begin(), collidees.end()), collidees.end());
+	return true;
+}
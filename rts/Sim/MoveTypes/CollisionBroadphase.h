@@ -0,0 +1,122 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef COLLISION_BROADPHASE_H
+#define COLLISION_BROADPHASE_H
+
+#include <list>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+class CUnit;
+class CFeature;
+class CSolidObject;
+
+/**
+ * Broadphase for ground unit collisions.
+ *
+ * Once per frame (before the movetype update) all units are sorted along x
+ * and swept to find every pair whose footprints, extended by how far either
+ * party can move or be pushed during the frame, overlap. Each pair is found
+ * exactly once, then handed to both colliders (sorted by collider- and
+ * collidee-ID, so the resolution order is deterministic and independent of
+ * quadfield layout). A unit that ends up further from its sampled position
+ * than its margin (eg. after being pushed several times) is reported by
+ * UnitMoved; it falls back to a quadfield query as a collider and is added
+ * to every other collider's candidates for the rest of the frame.
+ *
+ * Features are not swept: they are kept in a grid which only changes when
+ * a feature is created, moved or destroyed (CQuadField::AddFeature and
+ * RemoveFeature) and queried with the current position of each collider.
+ *
+ * CGroundMoveType uses these candidates in place of its per-unit quadfield
+ * queries and runs the same narrow-phase tests and responses on them.
+ */
+class CCollisionBroadphase : boost::noncopyable
+{
+public:
+	CCollisionBroadphase();
+
+	void Update(const std::list<CUnit*>& units);
+
+	/// true if the unit pairs were built during the current frame
+	bool IsValid() const;
+
+	/// any unit position change outside of the sweep's margins has to be reported here
+	void UnitMoved(const CUnit* unit);
+
+	/// @return false if there are no valid pairs for <collider> (query the quadfield instead)
+	bool GetUnitCollidees(const CUnit* collider, std::vector<CUnit*>& collidees) const;
+	/// @return false if the feature grid is not built yet
+	bool GetFeatureCollidees(const CUnit* collider, float colliderRadius, std::vector<CFeature*>& collidees) const;
+
+	void AddFeature(CFeature* feature);
+	void RemoveFeature(CFeature* feature);
+
+	size_t GetNumUnitPairs() const { return unitPairs.size(); }
+
+private:
+	struct Entry {
+		bool operator < (const Entry& e) const {
+			if (xmin != e.xmin) return (xmin < e.xmin);
+			return (id < e.id);
+		}
+
+		float xmin, xmax;
+		float zmin, zmax;
+
+		CUnit* unit;
+
+		int id;
+		bool isCollider; ///< only mobile (MoveDef-carrying) units resolve collisions
+	};
+
+	struct Pair {
+		Pair(int colliderID, int collideeID, CUnit* collidee)
+			: colliderID(colliderID), collideeID(collideeID), collidee(collidee) {}
+
+		bool operator < (const Pair& p) const {
+			if (colliderID != p.colliderID) return (colliderID < p.colliderID);
+			return (collideeID < p.collideeID);
+		}
+
+		int colliderID;
+		int collideeID;
+
+		CUnit* collidee;
+	};
+
+	/// where a unit was when the pairs were built, and how far it may move before they are invalid
+	struct UnitSample {
+		UnitSample(): x(0.0f), z(0.0f), margin(0.0f), frame(-1), overflowed(false) {}
+
+		float x, z;
+		float margin;
+
+		int frame;
+		bool overflowed;
+	};
+
+	void FindPairs();
+
+	void BuildFeatureGrid();
+	void GetFeatureCells(const CFeature* feature, int& x1, int& z1, int& x2, int& z2) const;
+	void GetCells(float x, float z, float radius, int& x1, int& z1, int& x2, int& z2) const;
+
+private:
+	int updateFrame;
+
+	std::vector<Entry> entries;
+	std::vector<Pair> unitPairs; ///< (unit, unit) pairs, stored once per colliding party
+
+	std::vector<UnitSample> unitSamples;   ///< indexed by unit ID
+	std::vector<CUnit*> overflowedUnits;   ///< units outside their margin this frame, in report order
+
+	bool featureGridBuilt;
+	int numCellsX;
+	int numCellsZ;
+	std::vector< std::vector<CFeature*> > featureCells;
+};
+
+extern CCollisionBroadphase* collisionBroadphase;
+
+#endif // COLLISION_BROADPHASE_H
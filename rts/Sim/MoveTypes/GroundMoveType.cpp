@@ -2,6 +2,7 @@
 
 #include "GroundMoveType.h"
 #include "MoveDefHandler.h"
+#include "CollisionBroadphase.h"
 #include "ExternalAI/EngineOutHandler.h"
 #include "Game/Camera.h"
 #include "Game/GameHelper.h"
@@ -161,6 +162,9 @@ CGroundMoveType::CGroundMoveType(CUnit* owner):
 	lastAvoidanceDir(ZeroVector),
 	mainHeadingPos(ZeroVector),
 
+	preAvoidanceVec(ZeroVector),
+	preAvoidanceFrame(-1),
+
 	nextObstacleAvoidanceUpdate(0),
 	pathRequestDelay(0),
 
@@ -203,6 +207,26 @@ void CGroundMoveType::PostLoad()
 	}
 }
 
+void CGroundMoveType::PreUpdate()
+{
+	// runs concurrently with the PreUpdate's of all other units, so
+	// we can not change anything but preAvoidance* here (see Update)
+	if (owner->GetTransporter() != NULL)
+		return;
+	if (owner->IsSkidding() || owner->IsFalling())
+		return;
+	if (owner->IsStunned() || owner->beingBuilt || owner->fpsControlPlayer != NULL)
+		return;
+	if (pathId == 0 || gs->frameNum < nextObstacleAvoidanceUpdate)
+		return;
+
+	// the obstacle scan only depends on the frame-start state of us
+	// and our neighbors, only the desired direction (which needs the
+	// next waypoint) is mixed in later by GetObstacleAvoidanceDir
+	preAvoidanceVec = GetObstacleAvoidanceVec(false, true);
+	preAvoidanceFrame = gs->frameNum;
+}
+
 bool CGroundMoveType::Update()
 {
 	ASSERT_SYNCED(owner->pos);
@@ -991,34 +1015,81 @@ float3 CGroundMoveType::GetObstacleAvoidanceDir(const float3& desiredDir) {
 	if (gs->frameNum < nextObstacleAvoidanceUpdate)
 		return lastAvoidanceDir;
 
-	float3 avoidanceVec = ZeroVector;
 	float3 avoidanceDir = desiredDir;
 
 	lastAvoidanceDir = desiredDir;
 	nextObstacleAvoidanceUpdate = gs->frameNum + 1;
 
-	CUnit* avoider = owner;
-	// const UnitDef* avoiderUD = avoider->unitDef;
-	const MoveDef* avoiderMD = avoider->moveDef;
-
 	// degenerate case: if facing anti-parallel to desired direction,
 	// do not actively avoid obstacles since that can interfere with
 	// normal waypoint steering (if the final avoidanceDir demands a
 	// turn in the opposite direction of desiredDir)
-	if (avoider->frontdir.dot(desiredDir) < 0.0f)
+	if (owner->frontdir.dot(desiredDir) < 0.0f)
 		return lastAvoidanceDir;
 
-	static const float AVOIDER_DIR_WEIGHT = 1.0f;
 	static const float DESIRED_DIR_WEIGHT = 0.5f;
-	static const float MAX_AVOIDEE_COSINE = math::cosf(120.0f * (PI / 180.0f));
 	static const float LAST_DIR_MIX_ALPHA = 0.7f;
 
+	// the (expensive) neighbor scan might already have been
+	// done for this frame on a worker thread by PreUpdate
+	const float3 avoidanceVec = (preAvoidanceFrame == gs->frameNum)?
+		preAvoidanceVec:
+		GetObstacleAvoidanceVec(DEBUG_DRAWING_ENABLED, false);
+
+	// use a weighted combination of the desired- and the avoidance-directions
+	// also linearly smooth it using the vector calculated the previous frame
+	avoidanceDir = (desiredDir * DESIRED_DIR_WEIGHT + avoidanceVec).SafeNormalize();
+	avoidanceDir = lastAvoidanceDir * LAST_DIR_MIX_ALPHA + avoidanceDir * (1.0f - LAST_DIR_MIX_ALPHA);
+
+	if (DEBUG_DRAWING_ENABLED) {
+		GML_RECMUTEX_LOCK(sel); // GetObstacleAvoidanceDir
+
+		if (selectedUnitsHandler.selectedUnits.find(owner) != selectedUnitsHandler.selectedUnits.end()) {
+			const float3 p0 = owner->pos + (    UpVector * 20.0f);
+			const float3 p1 =         p0 + (avoidanceVec * 40.0f);
+			const float3 p2 =         p0 + (avoidanceDir * 40.0f);
+
+			const int avFigGroupID = geometricObjects->AddLine(p0, p1, 8.0f, 1, 4);
+			const int adFigGroupID = geometricObjects->AddLine(p0, p2, 8.0f, 1, 4);
+
+			geometricObjects->SetColor(avFigGroupID, 1, 0.3f, 0.3f, 0.6f);
+			geometricObjects->SetColor(adFigGroupID, 1, 0.3f, 0.3f, 0.6f);
+		}
+	}
+
+	return (lastAvoidanceDir = avoidanceDir);
+}
+
+
+/*
+ * Sums the avoidance-responses of all obstacles near the unit; does
+ * not modify any state (so PreUpdate can run it on worker threads
+ * if <concurrent> is true)
+ */
+float3 CGroundMoveType::GetObstacleAvoidanceVec(bool debugDraw, bool concurrent) const {
+	static const float AVOIDER_DIR_WEIGHT = 1.0f;
+	static const float MAX_AVOIDEE_COSINE = math::cosf(120.0f * (PI / 180.0f));
+
+	const CUnit* avoider = owner;
+	// const UnitDef* avoiderUD = avoider->unitDef;
+	const MoveDef* avoiderMD = avoider->moveDef;
+
+	float3 avoidanceVec = ZeroVector;
+	float3 avoidanceDir = ZeroVector;
+
 	// now we do the obstacle avoidance proper
 	// avoider always uses its never-rotated MoveDef footprint
 	const float avoidanceRadius = std::max(currentSpeed, 1.0f) * (avoider->radius * 2.0f);
 	const float avoiderRadius = FOOTPRINT_RADIUS(avoiderMD->xsize, avoiderMD->zsize, 1.0f);
 
-	const vector<CSolidObject*>& objects = quadField->GetSolidsExact(avoider->pos, avoidanceRadius);
+	vector<CSolidObject*> objects;
+
+	if (concurrent) {
+		// worker thread (see PreUpdate), can not use the tempNum-based query
+		quadField->GetSolidsExactConcurrent(avoider->pos, avoidanceRadius, objects);
+	} else {
+		quadField->GetSolidsExact(avoider->pos, avoidanceRadius).swap(objects);
+	}
 
 	for (vector<CSolidObject*>::const_iterator oi = objects.begin(); oi != objects.end(); ++oi) {
 		const CSolidObject* avoidee = *oi;
@@ -1080,8 +1151,8 @@ float3 CGroundMoveType::GetObstacleAvoidanceDir(const float3& desiredDir) {
 		// if object and unit in relative motion are closing in on one another
 		// (or not yet fully apart), then the object is on the path of the unit
 		// and they are not collided
-		if (DEBUG_DRAWING_ENABLED) {
-			GML_RECMUTEX_LOCK(sel); // GetObstacleAvoidanceDir
+		if (debugDraw) {
+			GML_RECMUTEX_LOCK(sel); // GetObstacleAvoidanceVec
 
 			if (selectedUnitsHandler.selectedUnits.find(owner) != selectedUnitsHandler.selectedUnits.end()) {
 				geometricObjects->AddLine(avoider->pos + (UpVector * 20.0f), avoidee->pos + (UpVector * 20.0f), 3, 1, 4);
@@ -1113,29 +1184,7 @@ float3 CGroundMoveType::GetObstacleAvoidanceDir(const float3& desiredDir) {
 		avoidanceVec += (avoidanceDir * avoidanceResponse * avoidanceFallOff * avoideeMassScale);
 	}
 
-
-	// use a weighted combination of the desired- and the avoidance-directions
-	// also linearly smooth it using the vector calculated the previous frame
-	avoidanceDir = (desiredDir * DESIRED_DIR_WEIGHT + avoidanceVec).SafeNormalize();
-	avoidanceDir = lastAvoidanceDir * LAST_DIR_MIX_ALPHA + avoidanceDir * (1.0f - LAST_DIR_MIX_ALPHA);
-
-	if (DEBUG_DRAWING_ENABLED) {
-		GML_RECMUTEX_LOCK(sel); // GetObstacleAvoidanceDir
-
-		if (selectedUnitsHandler.selectedUnits.find(owner) != selectedUnitsHandler.selectedUnits.end()) {
-			const float3 p0 = owner->pos + (    UpVector * 20.0f);
-			const float3 p1 =         p0 + (avoidanceVec * 40.0f);
-			const float3 p2 =         p0 + (avoidanceDir * 40.0f);
-
-			const int avFigGroupID = geometricObjects->AddLine(p0, p1, 8.0f, 1, 4);
-			const int adFigGroupID = geometricObjects->AddLine(p0, p2, 8.0f, 1, 4);
-
-			geometricObjects->SetColor(avFigGroupID, 1, 0.3f, 0.3f, 0.6f);
-			geometricObjects->SetColor(adFigGroupID, 1, 0.3f, 0.3f, 0.6f);
-		}
-	}
-
-	return (lastAvoidanceDir = avoidanceDir);
+	return avoidanceVec;
 }
 
 
@@ -1666,8 +1715,12 @@ void CGroundMoveType::HandleUnitCollisions(
 ) {
 	const float searchRadius = std::max(colliderSpeed, 1.0f) * (colliderRadius * 1.0f);
 
-	const std::vector<CUnit*>& nearUnits = quadField->GetUnitsExact(collider->pos, searchRadius);
-	      std::vector<CUnit*>::const_iterator uit;
+	std::vector<CUnit*> nearUnits;
+	std::vector<CUnit*>::const_iterator uit;
+
+	if (collisionBroadphase == NULL || !collisionBroadphase->GetUnitCollidees(collider, nearUnits)) {
+		quadField->GetUnitsExact(collider->pos, searchRadius).swap(nearUnits);
+	}
 
 	// NOTE: probably too large for most units (eg. causes tree falling animations to be skipped)
 	const int dirSign = int(!reversing) * 2 - 1;
@@ -1849,6 +1902,11 @@ void CGroundMoveType::HandleUnitCollisions(
 			if (collideeMD->TestMoveSquare(collidee, collidee->pos + collideeSlideVec)) {
 				collidee->Move(collidee->pos + collideeSlideVec, false);
 			}
+
+			// the collider itself is checked after its own update
+			if (collisionBroadphase != NULL) {
+				collisionBroadphase->UnitMoved(collidee);
+			}
 		}
 	}
 }
@@ -1863,8 +1921,12 @@ void CGroundMoveType::HandleFeatureCollisions(
 ) {
 	const float searchRadius = std::max(colliderSpeed, 1.0f) * (colliderRadius * 1.0f);
 
-	const std::vector<CFeature*>& nearFeatures = quadField->GetFeaturesExact(collider->pos, searchRadius);
-	      std::vector<CFeature*>::const_iterator fit;
+	std::vector<CFeature*> nearFeatures;
+	std::vector<CFeature*>::const_iterator fit;
+
+	if (collisionBroadphase == NULL || !collisionBroadphase->GetFeatureCollidees(collider, colliderRadius, nearFeatures)) {
+		quadField->GetFeaturesExact(collider->pos, searchRadius).swap(nearFeatures);
+	}
 
 	const int dirSign = int(!reversing) * 2 - 1;
 	const float3 crushImpulse = collider->speed * collider->mass * dirSign;
@@ -21,6 +21,7 @@ public:
 
 	void PostLoad();
 
+	void PreUpdate();
 	bool Update();
 	void SlowUpdate();
 
@@ -40,6 +41,7 @@ public:
 
 private:
 	float3 GetObstacleAvoidanceDir(const float3& desiredDir);
+	float3 GetObstacleAvoidanceVec(bool debugDraw, bool concurrent) const;
 	float3 GetNewSpeedVector(const float hAcc, const float vAcc) const;
 
 	float Distance2D(CSolidObject* object1, CSolidObject* object2, float marginal = 0.0f);
@@ -142,6 +144,10 @@ private:
 	float3 lastAvoidanceDir;
 	float3 mainHeadingPos;
 
+	/// avoidance-vector precomputed by PreUpdate (not saved, only valid for the frame it was made in)
+	float3 preAvoidanceVec;
+	int preAvoidanceFrame;
+
 	unsigned int nextObstacleAvoidanceUpdate;
 	unsigned int pathRequestDelay;
 
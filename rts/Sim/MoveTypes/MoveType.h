@@ -39,6 +39,12 @@ public:
 	virtual void SetMaxSpeed(float speed) { maxSpeed = std::max(0.001f, speed); }
 	virtual void SetWantedMaxSpeed(float speed) { maxWantedSpeed = speed; }
 
+	// NOTE:
+	//   if modInfo.useParallelMoveTypeUpdate is set, PreUpdate is called
+	//   for every active unit from OpenMP worker threads before the serial
+	//   Update pass; it may only read (frame-start) simulation state and
+	//   write to members of this movetype that Update later consumes
+	virtual void PreUpdate() {}
 	virtual bool Update() = 0;
 	virtual void SlowUpdate();
 
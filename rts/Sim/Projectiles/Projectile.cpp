@@ -9,6 +9,7 @@
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
 #include "System/Matrix44f.h"
+#include "System/OpenMP_cond.h"
 
 CR_BIND_DERIVED(CProjectile, CExpGenSpawnable, );
 
@@ -30,6 +31,7 @@ CR_REG_METADATA(CProjectile,
 	CR_MEMBER_ENDFLAG(CM_Config),
 	CR_MEMBER(drawPos),
 	CR_IGNORED(tempdist),
+	CR_IGNORED(renderIndex),
 
 	CR_MEMBER(ownerID),
 	CR_MEMBER(teamID),
@@ -52,8 +54,18 @@ CR_REG_METADATA(CProjectile,
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-bool CProjectile::inArray = false;
-CVertexArray* CProjectile::va = NULL;
+CProjectileDrawFlag CProjectile::inArray;
+CProjectileVertexArray CProjectile::va;
+
+
+int CProjectileVertexArray::GetThreadNum()
+{
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
 
 
 CProjectile::CProjectile()
@@ -69,6 +81,7 @@ CProjectile::CProjectile()
 
 	, speed(ZeroVector)
 	, mygravity(mapInfo? mapInfo->map.gravity: 0.0f)
+	, renderIndex(-1u)
 
 	, ownerID(-1u)
 	, teamID(-1u)
@@ -96,6 +109,7 @@ CProjectile::CProjectile(const float3& pos, const float3& spd, CUnit* owner, boo
 	, dir((spd == ZeroVector) ? ZeroVector : spd / spd.Length())
 	, speed(spd)
 	, mygravity(mapInfo? mapInfo->map.gravity: 0.0f)
+	, renderIndex(-1u)
 
 	, ownerID(-1u)
 	, teamID(-1u)
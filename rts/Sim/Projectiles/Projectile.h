@@ -19,6 +19,61 @@ class CVertexArray;
 class CMatrix44f;
 
 
+/**
+ * Stands in for a plain CVertexArray pointer, but keeps one per
+ * thread, so CProjectileDrawer can run Draw() of many particles
+ * on several (OpenMP) threads, each writing into its own array.
+ */
+class CProjectileVertexArray
+{
+public:
+	static const int MAX_THREADS = 32;
+
+	CProjectileVertexArray() {
+		for (int n = 0; n < MAX_THREADS; n++) {
+			arrays[n] = NULL;
+		}
+	}
+
+	CVertexArray* operator -> () const { return arrays[GetThreadNum()]; }
+	operator CVertexArray* () const { return arrays[GetThreadNum()]; }
+
+	CProjectileVertexArray& operator = (CVertexArray* va) {
+		arrays[GetThreadNum()] = va; return *this;
+	}
+
+	static int GetThreadNum();
+
+private:
+	CVertexArray* arrays[MAX_THREADS];
+};
+
+
+/**
+ * Per-thread stand-in for the inArray flag, so the Draw() calls
+ * running on OpenMP workers never write to a shared bool. The
+ * main thread merges the workers' output after the parallel region.
+ */
+class CProjectileDrawFlag
+{
+public:
+	CProjectileDrawFlag() {
+		for (int n = 0; n < CProjectileVertexArray::MAX_THREADS; n++) {
+			flags[n] = false;
+		}
+	}
+
+	operator bool () const { return flags[CProjectileVertexArray::GetThreadNum()]; }
+
+	CProjectileDrawFlag& operator = (bool b) {
+		flags[CProjectileVertexArray::GetThreadNum()] = b; return *this;
+	}
+
+private:
+	bool flags[CProjectileVertexArray::MAX_THREADS];
+};
+
+
 class CProjectile: public CExpGenSpawnable
 {
 	CR_DECLARE(CProjectile);
@@ -38,6 +93,8 @@ public:
 	virtual void Init(const float3& pos, CUnit* owner);
 
 	virtual void Draw() {}
+	/// false if Draw() makes GL or Lua calls itself, not only fills <va>
+	virtual bool IsDrawThreadSafe() const { return true; }
 	virtual void DrawOnMinimap(CVertexArray& lines, CVertexArray& points);
 	virtual void DrawCallback() {}
 
@@ -60,8 +117,8 @@ public:
 	CMatrix44f GetTransformMatrix(bool offsetPos) const;
 
 public:
-	static bool inArray;
-	static CVertexArray* va;
+	static CProjectileDrawFlag inArray;
+	static CProjectileVertexArray va;
 	static int DrawArray();
 
 	bool synced; ///< is this projectile part of the simulation?
@@ -82,6 +139,7 @@ public:
 
 	float mygravity;
 	float tempdist; ///< temp distance used for sorting when rendering
+	unsigned int renderIndex; ///< index in CProjectileDrawer::renderProjectiles
 
 protected:
 	unsigned int ownerID;
@@ -59,6 +59,8 @@ public:
 	~ShieldSegmentProjectile();
 
 	void Draw();
+	/// Draw may call luaRules->DrawShield via AllowDrawing
+	bool IsDrawThreadSafe() const { return false; }
 	void Update();
 	void PreDelete() {
 		deleteMe = true;
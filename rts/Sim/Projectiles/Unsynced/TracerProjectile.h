@@ -16,6 +16,7 @@ public:
 	virtual ~CTracerProjectile();
 
 	void Draw();
+	bool IsDrawThreadSafe() const { return false; }
 	void Update();
 	void Init(const float3& pos, CUnit *owner);
 
@@ -5,6 +5,7 @@
 #include "CobFile.h"
 #include "CobInstance.h"
 #include "CobThread.h"
+#include "UnitScriptEngine.h"
 #include "UnitScriptLog.h"
 
 #ifndef _CONSOLE
@@ -77,16 +78,19 @@ CCobInstance::~CCobInstance()
 
 	do {
 		for (int animType = ATurn; animType <= AMove; animType++) {
-			for (std::list<AnimInfo *>::iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
+			for (size_t n = 0; n < anims[animType].size(); n++) {
 				// All threads blocking on animations can be killed safely from here since the scheduler does not
-				// know about them
-				std::list<IAnimListener *>& listeners = (*i)->listeners;
-				while (!listeners.empty()) {
-					IAnimListener* al = listeners.front();
-					listeners.pop_front();
-					delete al;
+				// know about them (they are taken out of the store first since deleting a thread can add new anims
+				// and listeners, those are picked up by the next pass)
+				std::vector<IAnimListener*> listeners;
+				listeners.swap(GUnitScriptEngine.GetAnims(AnimType(animType)).listeners[anims[animType][n]]);
+
+				for (std::vector<IAnimListener*>::iterator it = listeners.begin(); it != listeners.end(); ++it) {
+					delete *it;
 				}
-				// the anims are deleted in ~CUnitScript
+
+				listeners.clear();
+				// the anims are removed in ~CUnitScript
 			}
 		}
 		// callbacks may add new threads, and therefore listeners
@@ -8,6 +8,8 @@
 #include "CobInstance.h"
 #include "UnitScriptEngine.h"
 
+#include <algorithm>
+
 #ifndef _CONSOLE
 
 #include "Game/GameHelper.h"
@@ -82,20 +84,16 @@ CUnitScript::CUnitScript(CUnit* unit, const std::vector<LocalModelPiece*>& piece
 
 CUnitScript::~CUnitScript()
 {
-	bool haveAnimations = false;
-
+	// remove us from animation ticking; anim listeners are
+	// not owned by the anim in general, so don't delete them
 	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (std::list<AnimInfo*>::iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
-			// anim listeners are not owned by the anim in general, so don't delete them here
-			delete *i;
-		}
+		while (!anims[animType].empty()) {
+			const int slot = anims[animType].back();
 
-		haveAnimations = (haveAnimations || !anims[animType].empty());
+			anims[animType].pop_back();
+			GUnitScriptEngine.RemoveAnim(AnimType(animType), slot, NULL);
+		}
 	}
-
-	// Remove us from possible animation ticking
-	if (haveAnimations)
-		GUnitScriptEngine.RemoveInstance(this);
 }
 
 
@@ -104,14 +102,12 @@ CUnitScript::~CUnitScript()
 
 /**
  * @brief Unblocks all threads waiting on an animation
- * @param anim AnimInfo the corresponding animation
+ * @param listeners the listeners of the (already removed) animation
  */
-void CUnitScript::UnblockAll(AnimInfo* anim)
+void CUnitScript::UnblockAll(AnimType type, int piece, int axis, const std::vector<IAnimListener*>& listeners)
 {
-	std::list<IAnimListener *>::iterator li;
-
-	for (li = anim->listeners.begin(); li != anim->listeners.end(); ++li) {
-		(*li)->AnimFinished(anim->type, anim->piece, anim->axis);
+	for (std::vector<IAnimListener*>::const_iterator li = listeners.begin(); li != listeners.end(); ++li) {
+		(*li)->AnimFinished(type, piece, axis);
 	}
 }
 
@@ -213,124 +209,68 @@ bool CUnitScript::DoSpin(float& cur, float dest, float &speed, float accel, int
 
 
 
-void CUnitScript::TickAnims(int deltaTime, AnimType type, std::list< std::list<AnimInfo*>::iterator >& doneAnims) {
-	switch (type) {
-		case AMove: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
-
-				// NOTE: we should not need to copy-and-set here, because
-				// MoveToward/TurnToward/DoSpin modify pos/rot by reference
-				float3 pos = pieces[ai->piece]->GetPosition();
-
-				if (MoveToward(pos[ai->axis], ai->dest, ai->speed / (1000 / deltaTime))) {
-					ai->done = true; doneAnims.push_back(it);
-				}
-
-				pieces[ai->piece]->SetPosition(pos);
-				unit->localModel->PieceUpdated(ai->piece);
-			}
-		} break;
-
-		case ATurn: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
-				float3 rot = pieces[ai->piece]->GetRotation();
-
-				if (TurnToward(rot[ai->axis], ai->dest, ai->speed / (1000 / deltaTime))) {
-					ai->done = true; doneAnims.push_back(it);
-				}
+void CUnitScript::AnimSlotMoved(AnimType type, int oldSlot, int newSlot)
+{
+	std::vector<int>::iterator it = std::find(anims[type].begin(), anims[type].end(), oldSlot);
 
-				pieces[ai->piece]->SetRotation(rot);
-				unit->localModel->PieceUpdated(ai->piece);
-			}
-		} break;
+	assert(it != anims[type].end());
+	*it = newSlot;
+}
 
-		case ASpin: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
-				float3 rot = pieces[ai->piece]->GetRotation();
+void CUnitScript::AnimSlotRemoved(AnimType type, int slot)
+{
+	std::vector<int>::iterator it = std::find(anims[type].begin(), anims[type].end(), slot);
 
-				if (DoSpin(rot[ai->axis], ai->dest, ai->speed, ai->accel, 1000 / deltaTime)) {
-					ai->done = true; doneAnims.push_back(it);
-				}
+	assert(it != anims[type].end());
+	anims[type].erase(it);
+}
 
-				pieces[ai->piece]->SetRotation(rot);
-				unit->localModel->PieceUpdated(ai->piece);
-			}
-		} break;
 
-		default: {
-		} break;
-	}
-}
 
-/**
- * @brief Called by the engine when we are registered as animating.
-          If we return false there are no active animations left.
- * @param deltaTime int delta time to update
- * @return true if there are still active animations
- */
-bool CUnitScript::Tick(int deltaTime)
+int CUnitScript::FindAnim(AnimType type, int piece, int axis) const
 {
-	typedef std::list<AnimInfo*>::iterator AnimInfoIt;
-
-	// list of _iterators_ to finished animations,
-	// so we can get rid of them in constant time
-	std::list<AnimInfoIt> doneAnims;
+	const CUnitScriptEngine::AnimStore& store = GUnitScriptEngine.GetAnims(type);
 
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		TickAnims(deltaTime, AnimType(animType), doneAnims);
+	for (std::vector<int>::const_iterator i = anims[type].begin(); i != anims[type].end(); ++i) {
+		if ((store.pieces[*i] == piece) && (store.axes[*i] == axis))
+			return *i;
 	}
 
-	//! Tell listeners to unblock, and remove finished animations from the unit/script.
-	//! NOTE:
-	//!     removing a finished animation _must_ happen before notifying its listeners,
-	//!     otherwise the callback function (AnimFinished()) can call AddAnimListener()
-	//!     and append it to the listeners-list again (causing an endless loop)!
-	//! NOTE: UnblockAll might result in new anims being added
-	for (std::list<AnimInfoIt>::const_iterator it = doneAnims.begin(); it != doneAnims.end(); ++it) {
-		AnimInfoIt animInfoIt = *it;
-		AnimInfo* animInfo = *animInfoIt;
+	return -1;
+}
 
-		anims[animInfo->type].erase(animInfoIt);
-		UnblockAll(animInfo);
-		delete animInfo;
-	}
+void CUnitScript::RemoveAnim(AnimType type, int slot)
+{
+	if (slot == -1)
+		return;
 
-	return (HaveAnimations());
-}
+	const CUnitScriptEngine::AnimStore& store = GUnitScriptEngine.GetAnims(type);
 
+	const int piece = store.pieces[slot];
+	const int axis = store.axes[slot];
 
+	std::vector<IAnimListener*> listeners;
 
-std::list<CUnitScript::AnimInfo*>::iterator CUnitScript::FindAnim(AnimType type, int piece, int axis)
-{
-	for (std::list<AnimInfo*>::iterator i = anims[type].begin(); i != anims[type].end(); ++i) {
-		if (((*i)->piece == piece) && ((*i)->axis == axis))
-			return i;
-	}
+	AnimSlotRemoved(type, slot);
+	GUnitScriptEngine.RemoveAnim(type, slot, &listeners);
 
-	return anims[type].end();
+	//! We need to unblock threads waiting on this animation, otherwise they will be lost in the void
+	//! NOTE: UnblockAll might result in new anims being added
+	UnblockAll(type, piece, axis, listeners);
 }
 
-void CUnitScript::RemoveAnim(AnimType type, const std::list<AnimInfo*>::iterator& animInfoIt)
+bool CUnitScript::HaveListeners() const
 {
-	if (animInfoIt != anims[type].end()) {
-		AnimInfo* ai = *animInfoIt;
-		anims[type].erase(animInfoIt);
+	for (int animType = ATurn; animType <= AMove; animType++) {
+		const CUnitScriptEngine::AnimStore& store = GUnitScriptEngine.GetAnims(AnimType(animType));
 
-		// If this was the last animation, remove from currently animating list
-		// FIXME: this could be done in a cleaner way
-		if (!HaveAnimations()) {
-			GUnitScriptEngine.RemoveInstance(this);
+		for (std::vector<int>::const_iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
+			if (!store.listeners[*i].empty()) {
+				return true;
+			}
 		}
-
-		//! We need to unblock threads waiting on this animation, otherwise they will be lost in the void
-		//! NOTE: UnblockAll might result in new anims being added
-		UnblockAll(ai);
-
-		delete ai;
 	}
+	return false;
 }
 
 
@@ -355,8 +295,7 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 		}
 	}
 
-	std::list<AnimInfo*>::iterator animInfoIt;
-	AnimInfo* ai = NULL;
+	int animSlot = -1;
 	AnimType overrideType = ANone;
 
 	// first find an animation of a type we override
@@ -366,65 +305,56 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 	switch (type) {
 		case ATurn: {
 			overrideType = ASpin;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animSlot = FindAnim(overrideType, piece, axis);
 		} break;
 		case ASpin: {
 			overrideType = ATurn;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animSlot = FindAnim(overrideType, piece, axis);
 		} break;
 		case AMove: {
 			// ensure we never remove an animation of this type
 			overrideType = AMove;
-			animInfoIt = anims[overrideType].end();
+			animSlot = -1;
 		} break;
 		default: {
 		} break;
 	}
 
-	if (animInfoIt != anims[overrideType].end())
-		RemoveAnim(overrideType, animInfoIt);
+	if (animSlot != -1)
+		RemoveAnim(overrideType, animSlot);
 
 	// now find an animation of our own type
-	animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt == anims[type].end()) {
-		// If we were not animating before, inform the engine of this so it can schedule us
-		// FIXME: this could be done in a cleaner way
-		if (!HaveAnimations()) {
-			GUnitScriptEngine.AddInstance(this);
-		}
+	animSlot = FindAnim(type, piece, axis);
 
-		ai = new AnimInfo();
-		ai->type = type;
-		ai->piece = piece;
-		ai->axis = axis;
-		anims[type].push_back(ai);
-	} else {
-		ai = *animInfoIt;
+	if (animSlot == -1) {
+		animSlot = GUnitScriptEngine.AddAnim(this, type, piece, axis, pieces[piece]);
+		anims[type].push_back(animSlot);
 	}
 
-	ai->dest  = destf;
-	ai->speed = speed;
-	ai->accel = accel;
-	ai->done = false;
+	CUnitScriptEngine::AnimStore& store = GUnitScriptEngine.GetAnims(type);
+
+	store.dests[animSlot]  = destf;
+	store.speeds[animSlot] = speed;
+	store.accels[animSlot] = accel;
 }
 
 
 void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 {
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animSlot = FindAnim(ASpin, piece, axis);
 
 	//If we are already spinning, we may have to decelerate to the new speed
-	if (animInfoIt != anims[ASpin].end()) {
-		AnimInfo* ai = *animInfoIt;
-		ai->dest = speed;
+	if (animSlot != -1) {
+		CUnitScriptEngine::AnimStore& store = GUnitScriptEngine.GetAnims(ASpin);
+
+		store.dests[animSlot] = speed;
 
 		if (accel > 0) {
-			ai->accel = accel;
+			store.accels[animSlot] = accel;
 		} else {
 			//Go there instantly. Or have a defaul accel?
-			ai->speed = speed;
-			ai->accel = 0;
+			store.speeds[animSlot] = speed;
+			store.accels[animSlot] = 0;
 		}
 	} else {
 		//No accel means we start at desired speed instantly
@@ -438,17 +368,18 @@ void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 
 void CUnitScript::StopSpin(int piece, int axis, float decel)
 {
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animSlot = FindAnim(ASpin, piece, axis);
 
 	if (decel <= 0) {
-		RemoveAnim(ASpin, animInfoIt);
+		RemoveAnim(ASpin, animSlot);
 	} else {
-		if (animInfoIt == anims[ASpin].end())
+		if (animSlot == -1)
 			return;
 
-		AnimInfo* ai = *animInfoIt;
-		ai->dest = 0;
-		ai->accel = decel;
+		CUnitScriptEngine::AnimStore& store = GUnitScriptEngine.GetAnims(ASpin);
+
+		store.dests[animSlot] = 0;
+		store.accels[animSlot] = decel;
 	}
 }
 
@@ -734,26 +665,15 @@ void CUnitScript::DropUnit(int u)
 //Returns true if there was an animation to listen to
 bool CUnitScript::AddAnimListener(AnimType type, int piece, int axis, IAnimListener *listener)
 {
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt != anims[type].end()) {
-		AnimInfo* ai = *animInfoIt;
-
-		if (!ai->done) {
-			ai->listeners.push_back(listener);
-			return true;
-		}
-
-		// if the animation is already finished, listening for
-		// it just adds some overhead since either the current
-		// or the next Tick will remove it and call UnblockAll
-		// (which calls AnimFinished for each listener)
-		//
-		// we could notify the listener here, but a cleaner way
-		// is to treat the animation as if it did not exist and
-		// simply disregard the WaitFor* (no side-effects)
-		//
-		// listener->AnimFinished(ai->type, ai->piece, ai->axis);
+	const int animSlot = FindAnim(type, piece, axis);
+
+	// NOTE:
+	//   finished animations are removed from the engine's stores before
+	//   any listener is notified, so we can never see one here; waiting
+	//   on them is simply disregarded (no side-effects)
+	if (animSlot != -1) {
+		GUnitScriptEngine.GetAnims(type).listeners[animSlot].push_back(listener);
+		return true;
 	}
 
 	return false;
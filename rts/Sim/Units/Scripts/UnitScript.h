@@ -7,7 +7,6 @@
 
 #include <string>
 #include <vector>
-#include <list>
 
 #include "System/Object.h"
 #include "Rendering/Models/3DModel.h"
@@ -63,31 +62,15 @@ protected:
 	bool yardOpen;
 	bool busy;
 
-	struct AnimInfo {
-		AnimType type;
-		int axis;
-		int piece;
-		float speed;
-		float dest;     // means final position when turning or moving, final speed when spinning
-		float accel;    // used for spinning, can be negative
-		bool done;
-		std::list<IAnimListener*> listeners;
-	};
-
-	std::list<AnimInfo*> anims[AMove + 1];
+	// indices of our active animations in GUnitScriptEngine's per-type stores
+	std::vector<int> anims[AMove + 1];
 
 	bool hasSetSFXOccupy;
 	bool hasRockUnit;
 	bool hasStartBuilding;
 
-	void UnblockAll(AnimInfo* anim);
-
-	bool MoveToward(float& cur, float dest, float speed);
-	bool TurnToward(float& cur, float dest, float speed);
-	bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor);
-
-	std::list<AnimInfo*>::iterator FindAnim(AnimType anim, int piece, int axis);
-	void RemoveAnim(AnimType type, const std::list<AnimInfo*>::iterator& animInfoIt);
+	int FindAnim(AnimType type, int piece, int axis) const;
+	void RemoveAnim(AnimType type, int slot);
 	void AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel);
 
 	virtual void ShowScriptError(const std::string& msg) = 0;
@@ -138,8 +121,16 @@ public:
 	      CUnit* GetUnit()       { return unit; }
 	const CUnit* GetUnit() const { return unit; }
 
-	bool Tick(int deltaTime);
-	void TickAnims(int deltaTime, AnimType type, std::list< std::list<AnimInfo*>::iterator >& doneAnims);
+	// animation updates, used by CUnitScriptEngine::Tick
+	static bool MoveToward(float& cur, float dest, float speed);
+	static bool TurnToward(float& cur, float dest, float speed);
+	static bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor);
+
+	static void UnblockAll(AnimType type, int piece, int axis, const std::vector<IAnimListener*>& listeners);
+
+	// bookkeeping callbacks from CUnitScriptEngine when it reorders or drops our slots
+	void AnimSlotMoved(AnimType type, int oldSlot, int newSlot);
+	void AnimSlotRemoved(AnimType type, int slot);
 
 	// animation, used by CCobThread
 	void Spin(int piece, int axis, float speed, float accel);
@@ -163,12 +154,12 @@ public:
 	void SetUnitVal(int val, int param);
 
 	bool IsInAnimation(AnimType type, int piece, int axis) {
-		return (FindAnim(type, piece, axis) != anims[type].end());
+		return (FindAnim(type, piece, axis) != -1);
 	}
 	bool HaveAnimations() const {
 		return (!anims[ATurn].empty() || !anims[ASpin].empty() || !anims[AMove].empty());
 	}
-	inline bool HaveListeners() const;
+	bool HaveListeners() const;
 
 	// checks for callin existence
 	bool HasSetSFXOccupy () const { return hasSetSFXOccupy; }
@@ -224,15 +215,4 @@ public:
 	virtual float TargetWeight(int weaponNum, const CUnit* targetUnit) = 0; // returns target weight
 };
 
-inline bool CUnitScript::HaveListeners() const {
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (std::list<AnimInfo *>::const_iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
-			if (!(*i)->listeners.empty()) {
-				return true;
-			}
-		}
-	}
-	return false;
-}
-
 #endif // UNIT_SCRIPT_H
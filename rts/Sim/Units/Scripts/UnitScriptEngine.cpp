@@ -6,7 +6,8 @@
 #include "UnitScript.h"
 #include "UnitScriptLog.h"
 
-#include "System/FileSystem/FileHandler.h"
+#include "Rendering/Models/3DModel.h"
+#include "Sim/Units/Unit.h"
 
 #ifndef _CONSOLE
 	#include "System/TimeProfiler.h"
@@ -25,7 +26,7 @@ CUnitScriptEngine GUnitScriptEngine;
 /******************************************************************************/
 
 
-CUnitScriptEngine::CUnitScriptEngine() : currentScript(NULL)
+CUnitScriptEngine::CUnitScriptEngine()
 {
 }
 
@@ -35,42 +36,156 @@ CUnitScriptEngine::~CUnitScriptEngine()
 }
 
 
-void CUnitScriptEngine::CheckForDuplicates(const char* name, CUnitScript* instance)
+size_t CUnitScriptEngine::GetNumAnims() const
 {
-	int found = 0;
+	return (anims[CUnitScript::ATurn].size() + anims[CUnitScript::ASpin].size() + anims[CUnitScript::AMove].size());
+}
 
-	for (std::list<CUnitScript*>::iterator i = animating.begin(); i != animating.end(); ++i) {
-		if (*i == instance)
-			found++;
-	}
 
-	if (found > 1)
-		LOG_L(L_WARNING, "%s found duplicates %d", name, found);
+/**
+ * @brief Appends a new (zeroed) animation slot to the store of the given type
+ * @return the slot index, which the owner has to remember in its anims list
+ */
+int CUnitScriptEngine::AddAnim(CUnitScript* owner, AnimType type, int piece, int axis, LocalModelPiece* lmPiece)
+{
+	AnimStore& store = anims[type];
+
+	store.owners.push_back(owner);
+	store.lmPieces.push_back(lmPiece);
+	store.pieces.push_back(piece);
+	store.axes.push_back(axis);
+	store.speeds.push_back(0.0f);
+	store.dests.push_back(0.0f);
+	store.accels.push_back(0.0f);
+	store.values.push_back(0.0f);
+	store.done.push_back(0);
+	store.listeners.push_back(std::vector<IAnimListener*>());
+
+	return (store.size() - 1);
 }
 
 
-void CUnitScriptEngine::AddInstance(CUnitScript *instance)
+/**
+ * @brief Removes an animation slot by moving the last slot into its place
+ * @param listeners if not NULL, receives the listeners of the removed slot
+ *
+ * The owner of the moved slot is told about its new index, the owner of
+ * the removed slot is expected to have forgotten the index already.
+ */
+void CUnitScriptEngine::RemoveAnim(AnimType type, int slot, std::vector<IAnimListener*>* listeners)
 {
-	if (instance != currentScript)
-		animating.push_front(instance);
+	AnimStore& store = anims[type];
 
-	// Error checking
-#ifdef _DEBUG
-	CheckForDuplicates(__FUNCTION__, instance);
-#endif
+	assert(slot >= 0 && slot < int(store.size()));
+
+	if (listeners != NULL)
+		listeners->swap(store.listeners[slot]);
+
+	const int last = store.size() - 1;
+
+	if (slot != last) {
+		store.owners[slot]   = store.owners[last];
+		store.lmPieces[slot] = store.lmPieces[last];
+		store.pieces[slot]   = store.pieces[last];
+		store.axes[slot]     = store.axes[last];
+		store.speeds[slot]   = store.speeds[last];
+		store.dests[slot]    = store.dests[last];
+		store.accels[slot]   = store.accels[last];
+		store.values[slot]   = store.values[last];
+		store.done[slot]     = store.done[last];
+		store.listeners[slot].swap(store.listeners[last]);
+
+		store.owners[slot]->AnimSlotMoved(type, last, slot);
+	}
+
+	store.owners.pop_back();
+	store.lmPieces.pop_back();
+	store.pieces.pop_back();
+	store.axes.pop_back();
+	store.speeds.pop_back();
+	store.dests.pop_back();
+	store.accels.pop_back();
+	store.values.pop_back();
+	store.done.pop_back();
+	store.listeners.pop_back();
 }
 
 
-void CUnitScriptEngine::RemoveInstance(CUnitScript *instance)
+void CUnitScriptEngine::TickAnims(int deltaTime, AnimType type)
 {
-	// Error checking
-#ifdef _DEBUG
-	CheckForDuplicates(__FUNCTION__, instance);
-#endif
+	AnimStore& store = anims[type];
+
+	const int numAnims = store.size();
+	const int divisor = 1000 / deltaTime;
+
+	if (numAnims == 0)
+		return;
+
+	float* values = &store.values[0];
+	float* speeds = &store.speeds[0];
+	const float* dests = &store.dests[0];
+	const float* accels = &store.accels[0];
+	const int* axes = &store.axes[0];
+	unsigned char* done = &store.done[0];
+
+	// gather the current piece values; this is the only pass
+	// before the write-back that has to touch the pieces
+	if (type == CUnitScript::AMove) {
+		for (int i = 0; i < numAnims; i++) {
+			values[i] = (store.lmPieces[i]->GetPosition())[axes[i]];
+		}
+	} else {
+		for (int i = 0; i < numAnims; i++) {
+			values[i] = (store.lmPieces[i]->GetRotation())[axes[i]];
+		}
+	}
+
+	// NOTE:
+	//   each (piece, axis, position/rotation) component is driven by at most
+	//   one animation (turns and spins override each other), so updating all
+	//   values first and writing them back afterwards gives the same results
+	//   as the old per-script tick
+	switch (type) {
+		case CUnitScript::AMove: {
+			for (int i = 0; i < numAnims; i++) {
+				done[i] = CUnitScript::MoveToward(values[i], dests[i], speeds[i] / divisor);
+			}
+		} break;
+		case CUnitScript::ATurn: {
+			for (int i = 0; i < numAnims; i++) {
+				done[i] = CUnitScript::TurnToward(values[i], dests[i], speeds[i] / divisor);
+			}
+		} break;
+		case CUnitScript::ASpin: {
+			for (int i = 0; i < numAnims; i++) {
+				done[i] = CUnitScript::DoSpin(values[i], dests[i], speeds[i], accels[i], divisor);
+			}
+		} break;
+		default: {
+		} break;
+	}
+
+	// write back (only the animated component, several
+	// animations can share a piece) and note finished ones
+	for (int i = 0; i < numAnims; i++) {
+		LocalModelPiece* lmp = store.lmPieces[i];
 
-	//This is slow. would be better if instance was a hashlist perhaps
-	if (instance != currentScript)
-		animating.remove(instance);
+		if (type == CUnitScript::AMove) {
+			float3 pos = lmp->GetPosition();
+			pos[axes[i]] = values[i];
+			lmp->SetPosition(pos);
+		} else {
+			float3 rot = lmp->GetRotation();
+			rot[axes[i]] = values[i];
+			lmp->SetRotation(rot);
+		}
+
+		store.owners[i]->GetUnit()->localModel->PieceUpdated(store.pieces[i]);
+
+		if (done[i] != 0) {
+			doneSlots[type].push_back(i);
+		}
+	}
 }
 
 
@@ -78,18 +193,49 @@ void CUnitScriptEngine::Tick(int deltaTime)
 {
 	SCOPED_TIMER("UnitScriptEngine::Tick");
 
-	// Tick all instances that have registered themselves as animating
-	for (std::list<CUnitScript*>::iterator it = animating.begin(); it != animating.end(); ) {
-		currentScript = *it;
+	finishedAnims.clear();
 
-		if (currentScript->Tick(deltaTime)) {
-			++it;
-		} else {
-			it = animating.erase(it);
+	for (int animType = CUnitScript::ATurn; animType <= CUnitScript::AMove; animType++) {
+		doneSlots[animType].clear();
+		TickAnims(deltaTime, AnimType(animType));
+	}
+
+	// Remove finished animations from the stores, then tell listeners to unblock.
+	// NOTE:
+	//     removing a finished animation _must_ happen before notifying its listeners,
+	//     otherwise the callback function (AnimFinished()) can call AddAnimListener()
+	//     and append it to the listeners-list again (causing an endless loop)!
+	//     Slots are removed back to front so swap-removal never moves a slot that
+	//     is still pending, listeners are notified front to back (in slot order).
+	for (int animType = CUnitScript::ATurn; animType <= CUnitScript::AMove; animType++) {
+		const std::vector<int>& slots = doneSlots[animType];
+		const AnimStore& store = anims[animType];
+
+		const size_t numFinished = finishedAnims.size();
+
+		finishedAnims.resize(numFinished + slots.size());
+
+		for (int n = slots.size() - 1; n >= 0; n--) {
+			const int slot = slots[n];
+
+			FinishedAnim& fa = finishedAnims[numFinished + n];
+
+			fa.owner = store.owners[slot];
+			fa.type  = AnimType(animType);
+			fa.piece = store.pieces[slot];
+			fa.axis  = store.axes[slot];
+			fa.listeners.clear();
+
+			fa.owner->AnimSlotRemoved(fa.type, slot);
+			RemoveAnim(fa.type, slot, &fa.listeners);
 		}
 	}
 
-	currentScript = NULL;
+	// NOTE: UnblockAll might result in new anims being added
+	for (size_t n = 0; n < finishedAnims.size(); n++) {
+		const FinishedAnim& fa = finishedAnims[n];
+		CUnitScript::UnblockAll(fa.type, fa.piece, fa.axis, fa.listeners);
+	}
 }
 
 
@@ -5,27 +5,75 @@
 #ifndef UNIT_SCRIPT_ENGINE_H
 #define UNIT_SCRIPT_ENGINE_H
 
-#include <list>
+#include <vector>
+
+#include "UnitScript.h"
 
 class CUnit;
-class CUnitScript;
+struct LocalModelPiece;
 
 
 class CUnitScriptEngine
 {
-protected:
-	std::list<CUnitScript*> animating; // hash would be optimal, but not crucial
-	void CheckForDuplicates(const char* name, CUnitScript* instance);
+public:
+	typedef CUnitScript::AnimType AnimType;
+	typedef CUnitScript::IAnimListener IAnimListener;
+
+	/**
+	 * All active animations of one type (turn, spin or move) over all
+	 * unit scripts, kept as parallel arrays so Tick can update them in
+	 * a single tight loop. Slots are swap-removed, each owning script
+	 * keeps the indices of its own slots in CUnitScript::anims.
+	 */
+	struct AnimStore {
+		size_t size() const { return owners.size(); }
+
+		std::vector<CUnitScript*> owners;
+		std::vector<LocalModelPiece*> lmPieces;
+		std::vector<int> pieces;
+		std::vector<int> axes;
+
+		std::vector<float> speeds;
+		std::vector<float> dests;  // final position when turning or moving, final speed when spinning
+		std::vector<float> accels; // used for spinning, can be negative
+		std::vector<float> values; // current piece position or rotation along axis, scratch for Tick
+
+		std::vector<unsigned char> done;
+		std::vector< std::vector<IAnimListener*> > listeners;
+	};
+
+	/// a finished animation that was already removed from its store
+	struct FinishedAnim {
+		CUnitScript* owner;
+		AnimType type;
+		int piece;
+		int axis;
+		std::vector<IAnimListener*> listeners;
+	};
 
 public:
 	CUnitScriptEngine();
 	~CUnitScriptEngine();
-	void AddInstance(CUnitScript* instance);
-	void RemoveInstance(CUnitScript* instance);
+
+	int AddAnim(CUnitScript* owner, AnimType type, int piece, int axis, LocalModelPiece* lmPiece);
+	void RemoveAnim(AnimType type, int slot, std::vector<IAnimListener*>* listeners);
+
+	      AnimStore& GetAnims(AnimType type)       { return anims[type]; }
+	const AnimStore& GetAnims(AnimType type) const { return anims[type]; }
+
+	size_t GetNumAnims() const;
+
 	void Tick(int deltaTime);
 
 private:
-	CUnitScript* currentScript;
+	void TickAnims(int deltaTime, AnimType type);
+
+private:
+	AnimStore anims[CUnitScript::AMove + 1];
+
+	// re-used between ticks to avoid reallocations
+	std::vector<int> doneSlots[CUnitScript::AMove + 1];
+	std::vector<FinishedAnim> finishedAnims;
 };
 
 extern CUnitScriptEngine GUnitScriptEngine;
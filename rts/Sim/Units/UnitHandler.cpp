@@ -7,15 +7,21 @@
 #include "UnitHandler.h"
 #include "Unit.h"
 #include "UnitDefHandler.h"
+#include "VisibleUnitIndex.h"
 #include "CommandAI/BuilderCAI.h"
 #include "Sim/Misc/AirBaseHandler.h"
+#include "Sim/Misc/ModInfo.h"
 #include "Sim/Misc/TeamHandler.h"
+#include "Sim/MoveTypes/CollisionBroadphase.h"
 #include "Sim/MoveTypes/MoveType.h"
 #include "System/EventHandler.h"
 #include "System/EventBatchHandler.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
 #include "System/myMath.h"
+#include "System/OpenMP_cond.h"
+#include "System/Platform/Threading.h"
+#include "System/Sync/FPUCheck.h"
 #include "System/Sync/SyncTracer.h"
 #include "System/creg/STL_Deque.h"
 #include "System/creg/STL_List.h"
@@ -38,6 +44,7 @@ CR_REG_METADATA(CUnitHandler, (
 	CR_MEMBER(unitsToBeRemoved),
 	CR_MEMBER(maxUnits),
 	CR_MEMBER(maxUnitRadius),
+	CR_MEMBER(parallelMoveTypeUpdate),
 	CR_POSTLOAD(PostLoad)
 ));
 
@@ -47,11 +54,14 @@ void CUnitHandler::PostLoad()
 {
 	// reset any synced stuff that is not saved
 	activeSlowUpdateUnit = activeUnits.end();
+
+	visibleUnitIndex->Rebuild();
 }
 
 
 CUnitHandler::CUnitHandler()
 :
+	parallelMoveTypeUpdate(modInfo.useParallelMoveTypeUpdate),
 	maxUnits(0),
 	maxUnitRadius(0.0f)
 {
@@ -75,11 +85,19 @@ CUnitHandler::CUnitHandler()
 
 	activeSlowUpdateUnit = activeUnits.end();
 	airBaseHandler = new CAirBaseHandler();
+	visibleUnitIndex = new CVisibleUnitIndex();
+
+	if (modInfo.useCollisionBroadphase) {
+		collisionBroadphase = new CCollisionBroadphase();
+	}
 }
 
 
 CUnitHandler::~CUnitHandler()
 {
+	delete visibleUnitIndex;
+	visibleUnitIndex = NULL;
+
 	for (std::list<CUnit*>::iterator usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
 		// ~CUnit dereferences featureHandler which is destroyed already
 		(*usi)->delayedWreckLevel = -1;
@@ -87,6 +105,8 @@ CUnitHandler::~CUnitHandler()
 	}
 
 	delete airBaseHandler;
+	delete collisionBroadphase;
+	collisionBroadphase = NULL;
 }
 
 void CUnitHandler::InsertActiveUnit(CUnit* unit)
@@ -152,6 +172,7 @@ void CUnitHandler::DeleteUnitNow(CUnit* delUnit)
 			GML_STDMUTEX_LOCK(dque); // DeleteUnitNow
 
 			teamHandler->Team(delTeam)->RemoveUnit(delUnit, CTeam::RemoveDied);
+			visibleUnitIndex->RemoveUnit(delUnit);
 
 			activeUnits.erase(usi);
 			unitsByDefs[delTeam][delType].erase(delUnit);
@@ -234,28 +255,7 @@ void CUnitHandler::Update()
 		VECTOR_SANITY_CHECK(unit->frontdir);        \
 		MAPPOS_SANITY_CHECK(unit);
 
-	{
-		SCOPED_TIMER("Unit::MoveType::Update");
-		std::list<CUnit*>::iterator usi;
-		for (usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
-			CUnit* unit = *usi;
-			AMoveType* moveType = unit->moveType;
-
-			UNIT_SANITY_CHECK(unit);
-
-			if (moveType->Update()) {
-				eventHandler.UnitMoved(unit);
-			}
-			if (!unit->pos.IsInBounds() && (unit->speed.SqLength() > (MAX_UNIT_SPEED * MAX_UNIT_SPEED))) {
-				// this unit is not coming back, kill it now without any death
-				// sequence (so deathScriptFinished becomes true immediately)
-				unit->KillUnit(NULL, false, true, false);
-			}
-
-			UNIT_SANITY_CHECK(unit);
-			GML::GetTicks(unit->lastUnitUpdate);
-		}
-	}
+	UpdateMoveTypes();
 
 	{
 		SCOPED_TIMER("Unit::Update");
@@ -304,6 +304,72 @@ void CUnitHandler::Update()
 	}
 }
 
+void CUnitHandler::UpdateMoveTypes()
+{
+	if (parallelMoveTypeUpdate) {
+		SCOPED_TIMER("Unit::MoveType::PreUpdate");
+
+		activeMoveTypes.clear();
+		activeMoveTypes.reserve(activeUnits.size());
+
+		for (std::list<CUnit*>::const_iterator usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
+			activeMoveTypes.push_back((*usi)->moveType);
+		}
+
+		// compute phase: every PreUpdate reads only frame-start state and
+		// writes only to its own movetype, so the results do not depend on
+		// thread count or scheduling
+		const int numMoveTypes = activeMoveTypes.size();
+
+		Threading::OMPCheck();
+		#pragma omp parallel
+		{
+			// the FPU state is per thread, the workers have to use the same
+			// (synced) settings as the sim thread; OpenMP may have created
+			// new workers since streflop_init_omp ran at startup
+			streflop_init_omp_thread();
+
+			#pragma omp for schedule(dynamic, 64)
+			for (int n = 0; n < numMoveTypes; n++) {
+				activeMoveTypes[n]->PreUpdate();
+			}
+		}
+	}
+
+	if (collisionBroadphase != NULL) {
+		// collision pairs for this frame, from positions before any unit moved
+		collisionBroadphase->Update(activeUnits);
+	}
+
+	{
+		// commit phase: serial and in activeUnits order, this is where units
+		// move, collide, change the quadfield and generate events
+		SCOPED_TIMER("Unit::MoveType::Update");
+		std::list<CUnit*>::iterator usi;
+		for (usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
+			CUnit* unit = *usi;
+			AMoveType* moveType = unit->moveType;
+
+			UNIT_SANITY_CHECK(unit);
+
+			if (moveType->Update()) {
+				eventHandler.UnitMoved(unit);
+			}
+			if (collisionBroadphase != NULL) {
+				collisionBroadphase->UnitMoved(unit);
+			}
+			if (!unit->pos.IsInBounds() && (unit->speed.SqLength() > (MAX_UNIT_SPEED * MAX_UNIT_SPEED))) {
+				// this unit is not coming back, kill it now without any death
+				// sequence (so deathScriptFinished becomes true immediately)
+				unit->KillUnit(NULL, false, true, false);
+			}
+
+			UNIT_SANITY_CHECK(unit);
+			GML::GetTicks(unit->lastUnitUpdate);
+		}
+	}
+}
+
 
 
 void CUnitHandler::AddBuilderCAI(CBuilderCAI* b)
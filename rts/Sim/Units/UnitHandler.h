@@ -13,6 +13,7 @@
 
 class CUnit;
 class CBuilderCAI;
+class AMoveType;
 
 class CUnitHandler
 {
@@ -58,8 +59,14 @@ public:
 
 	std::map<unsigned int, CBuilderCAI*> builderCAIs;
 
+	///< if true, MoveType::PreUpdate is run for all active units on worker
+	///< threads before the serial MoveType::Update pass (changes synced
+	///< state, so this may only be toggled by synced code)
+	bool parallelMoveTypeUpdate;
+
 private:
 	void InsertActiveUnit(CUnit* unit);
+	void UpdateMoveTypes();
 
 private:
 	SimObjectIDPool idPool;
@@ -67,6 +74,8 @@ private:
 	std::vector<CUnit*> unitsToBeRemoved;              ///< units that will be removed at start of next update
 	std::list<CUnit*>::iterator activeSlowUpdateUnit;  ///< first unit of batch that will be SlowUpdate'd this frame
 
+	std::vector<AMoveType*> activeMoveTypes;           ///< random-access copy of activeUnits' movetypes for PreUpdate
+
 	///< global unit-limit (derived from the per-team limit)
 	///< units.size() is equal to this and constant at runtime
 	unsigned int maxUnits;
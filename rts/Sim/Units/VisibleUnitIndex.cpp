@@ -0,0 +1,140 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cassert>
+
+#include "VisibleUnitIndex.h"
+#include "Unit.h"
+#include "UnitHandler.h"
+#include "Sim/Misc/TeamHandler.h"
+#include "System/EventHandler.h"
+
+CVisibleUnitIndex* visibleUnitIndex = NULL;
+
+
+
+CVisibleUnitIndex::CVisibleUnitIndex()
+	: CEventClient("[CVisibleUnitIndex]", 271991, false)
+	, numAllyTeams(teamHandler->ActiveAllyTeams())
+{
+	units.resize(numAllyTeams * numAllyTeams * VIS_COUNT);
+	slots.resize(unitHandler->MaxUnits() * numAllyTeams * VIS_COUNT, -1);
+	unitAllyTeams.resize(unitHandler->MaxUnits(), -1);
+
+	eventHandler.AddClient(this);
+}
+
+CVisibleUnitIndex::~CVisibleUnitIndex()
+{
+	eventHandler.RemoveClient(this);
+}
+
+
+
+void CVisibleUnitIndex::Rebuild()
+{
+	for (size_t n = 0; n < units.size(); n++) {
+		units[n].clear();
+	}
+
+	std::fill(slots.begin(), slots.end(), -1);
+	std::fill(unitAllyTeams.begin(), unitAllyTeams.end(), -1);
+
+	for (std::list<CUnit*>::const_iterator ui = unitHandler->activeUnits.begin(); ui != unitHandler->activeUnits.end(); ++ui) {
+		for (int at = 0; at < numAllyTeams; at++) {
+			UpdateUnit(*ui, at);
+		}
+	}
+}
+
+void CVisibleUnitIndex::UnitGiven(const CUnit* unit, int oldTeam, int newTeam)
+{
+	// ChangeTeam resets some LOS-states without events
+	for (int at = 0; at < numAllyTeams; at++) {
+		UpdateUnit(unit, at);
+	}
+}
+
+
+
+void CVisibleUnitIndex::UpdateUnit(const CUnit* unit, int allyTeam)
+{
+	// dead units still receive LOS-events (from their last SlowUpdate's)
+	// until CUnitHandler deletes them, they must not be listed again
+	if (unit->isDead) {
+		RemoveUnit(unit);
+		return;
+	}
+
+	// a unit changing allyteams is removed (UnitTaken) before any event
+	// can see its new allyteam, so this only happens for new listings
+	if (unitAllyTeams[unit->id] != unit->allyteam)
+		RemoveUnit(unit);
+
+	// NOTE:
+	//   the events are sent from inside CUnit::SetLosStatus while some
+	//   bits may still be pending, but the last event of each change sees
+	//   the final state, so lists are always correct between changes
+	const unsigned short losStatus = (allyTeam != unit->allyteam)? unit->losStatus[allyTeam]: 0;
+
+	if ((losStatus & LOS_INLOS) != 0) {
+		Insert(unit, allyTeam, VIS_LOS);
+	} else {
+		Erase(unit, allyTeam, VIS_LOS);
+	}
+
+	if ((losStatus & (LOS_INLOS | LOS_INRADAR)) != 0) {
+		Insert(unit, allyTeam, VIS_ANY);
+	} else {
+		Erase(unit, allyTeam, VIS_ANY);
+	}
+
+	unitAllyTeams[unit->id] = unit->allyteam;
+}
+
+void CVisibleUnitIndex::RemoveUnit(const CUnit* unit)
+{
+	if (unitAllyTeams[unit->id] < 0)
+		return;
+
+	for (int at = 0; at < numAllyTeams; at++) {
+		Erase(unit, at, VIS_LOS);
+		Erase(unit, at, VIS_ANY);
+	}
+
+	unitAllyTeams[unit->id] = -1;
+}
+
+
+
+void CVisibleUnitIndex::Insert(const CUnit* unit, int allyTeam, VisibilityType visType)
+{
+	int& slot = Slot(unit->id, allyTeam, visType);
+
+	if (slot >= 0)
+		return;
+
+	std::vector<CUnit*>& list = units[(allyTeam * numAllyTeams + unit->allyteam) * VIS_COUNT + visType];
+
+	slot = list.size();
+	list.push_back(const_cast<CUnit*>(unit));
+}
+
+void CVisibleUnitIndex::Erase(const CUnit* unit, int allyTeam, VisibilityType visType)
+{
+	int& slot = Slot(unit->id, allyTeam, visType);
+
+	if (slot < 0)
+		return;
+
+	std::vector<CUnit*>& list = units[(allyTeam * numAllyTeams + unitAllyTeams[unit->id]) * VIS_COUNT + visType];
+
+	assert(list[slot] == unit);
+
+	// move the last unit of the list into the vacated slot
+	list[slot] = list.back();
+	Slot(list[slot]->id, allyTeam, visType) = slot;
+	list.pop_back();
+
+	slot = -1;
+}
@@ -0,0 +1,92 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef VISIBLE_UNIT_INDEX_H
+#define VISIBLE_UNIT_INDEX_H
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "System/EventClient.h"
+
+class CUnit;
+
+/**
+ * Lists of the units each allyteam currently sees, grouped by the allyteam
+ * owning them, so "all enemy units in LOS" style queries only touch units
+ * that are part of the answer instead of filtering every active unit.
+ *
+ * Kept up to date from the Unit{Entered,Left}{Los,Radar} events (plus
+ * destruction, deletion and team changes); units are never listed for their own
+ * allyteam, whose LOS-status is not event-driven. The index only serves
+ * unsynced consumers (AI callbacks, unsynced Lua) and does not influence
+ * the simulation.
+ */
+class CVisibleUnitIndex : public CEventClient, boost::noncopyable
+{
+public:
+	enum VisibilityType {
+		VIS_LOS   = 0, ///< LOS_INLOS
+		VIS_ANY   = 1, ///< LOS_INLOS or LOS_INRADAR
+		VIS_COUNT = 2,
+	};
+
+	CVisibleUnitIndex();
+	~CVisibleUnitIndex();
+
+	bool WantsEvent(const std::string& eventName) {
+		return
+			(eventName == "UnitEnteredLos"  ) || (eventName == "UnitLeftLos"  ) ||
+			(eventName == "UnitEnteredRadar") || (eventName == "UnitLeftRadar") ||
+			(eventName == "UnitDestroyed"   ) ||
+			(eventName == "UnitTaken"       ) || (eventName == "UnitGiven"    );
+	}
+	bool GetFullRead() const { return true; }
+	int GetReadAllyTeam() const { return AllAccessTeam; }
+
+	void UnitEnteredLos(const CUnit* unit, int allyTeam) { UpdateUnit(unit, allyTeam); }
+	void UnitLeftLos(const CUnit* unit, int allyTeam) { UpdateUnit(unit, allyTeam); }
+	void UnitEnteredRadar(const CUnit* unit, int allyTeam) { UpdateUnit(unit, allyTeam); }
+	void UnitLeftRadar(const CUnit* unit, int allyTeam) { UpdateUnit(unit, allyTeam); }
+
+	void UnitDestroyed(const CUnit* unit, const CUnit* attacker) { RemoveUnit(unit); }
+	void UnitTaken(const CUnit* unit, int oldTeam, int newTeam) { RemoveUnit(unit); }
+	void UnitGiven(const CUnit* unit, int oldTeam, int newTeam);
+
+	/// re-reads the LOS-status of every active unit (after loading a game)
+	void Rebuild();
+	/// called by CUnitHandler right before a unit is deleted and its ID freed
+	void RemoveUnit(const CUnit* unit);
+
+	/**
+	 * @return units of allyteam <unitAllyTeam> that allyteam <allyTeam>
+	 * sees in the given way (in no particular order)
+	 */
+	const std::vector<CUnit*>& GetUnits(int allyTeam, int unitAllyTeam, VisibilityType visType) const {
+		return units[(allyTeam * numAllyTeams + unitAllyTeam) * VIS_COUNT + visType];
+	}
+
+private:
+	void UpdateUnit(const CUnit* unit, int allyTeam);
+
+	void Insert(const CUnit* unit, int allyTeam, VisibilityType visType);
+	void Erase(const CUnit* unit, int allyTeam, VisibilityType visType);
+
+	int& Slot(int unitID, int allyTeam, VisibilityType visType) {
+		return slots[(unitID * numAllyTeams + allyTeam) * VIS_COUNT + visType];
+	}
+
+private:
+	int numAllyTeams;
+
+	/// one list per (allyteam, unit allyteam, visibility type)
+	std::vector< std::vector<CUnit*> > units;
+	/// position of each unit in its lists, -1 if not listed
+	/// (indexed by unit ID, allyteam and visibility type)
+	std::vector<int> slots;
+	/// allyteam each unit was listed under
+	std::vector<int> unitAllyTeams;
+};
+
+extern CVisibleUnitIndex* visibleUnitIndex;
+
+#endif // VISIBLE_UNIT_INDEX_H
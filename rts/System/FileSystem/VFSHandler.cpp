@@ -185,6 +185,18 @@ bool CVFSHandler::FileExists(const std::string& filePath)
 	return true;
 }
 
+std::string CVFSHandler::GetFileArchiveName(const std::string& filePath)
+{
+	const std::string normalizedPath = GetNormalizedPath(filePath);
+
+	const FileData* fileData = GetFileData(normalizedPath);
+	if (fileData == NULL) {
+		return "";
+	}
+
+	return fileData->ar->GetArchiveName();
+}
+
 std::vector<std::string> CVFSHandler::GetFilesInDir(const std::string& rawDir)
 {
 	LOG_L(L_DEBUG, "GetFilesInDir(rawDir = \"%s\")", rawDir.c_str());
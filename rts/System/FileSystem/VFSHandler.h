@@ -37,6 +37,13 @@ public:
 	 * @return true if the file exists in the VFS and was successfully read
 	 */
 	bool LoadFile(const std::string& filePath, std::vector<boost::uint8_t>& buffer);
+	/**
+	 * Returns the name of the archive a file would be read from.
+	 * @param filePath raw file path, for example "maps/myMap.smf",
+	 *   case-insensitive
+	 * @return the archive name, or "" if the file does not exist in the VFS
+	 */
+	std::string GetFileArchiveName(const std::string& filePath);
 
 	/**
 	 * Returns all the files in the given (virtual) directory without the
@@ -4,6 +4,7 @@
 
 #include "ALShared.h"
 #include "ISound.h"
+#include "SoundCommandQueue.h"
 #include "SoundItem.h"
 #include "SoundLog.h"
 #include "SoundSource.h"
@@ -11,9 +12,11 @@
 #include "Sim/Objects/WorldObject.h"
 #include "Sim/Units/Unit.h"
 
+#include <cassert>
 #include <climits>
 
 extern boost::recursive_mutex soundMutex;
+extern SoundCommandQueue soundCommands;
 
 const size_t AudioChannel::MAX_STREAM_QUEUESIZE = 10;
 
@@ -57,7 +60,7 @@ void AudioChannel::SoundSourceFinished(CSoundSource* sndSource)
 	if (curStreamSrc == sndSource) {
 		if (!streamQueue.empty()) {
 			StreamQueueItem& next = streamQueue.back();
-			StreamPlay(next.fileName, next.volume, false);
+			StartStream(next.fileName, next.volume, false);
 			streamQueue.pop_back();
 		} else {
 			curStreamSrc = NULL;
@@ -70,8 +73,6 @@ void AudioChannel::SoundSourceFinished(CSoundSource* sndSource)
 
 void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3& velocity, float volume, bool relative)
 {
-	boost::recursive_mutex::scoped_lock lck(soundMutex);
-
 	if (!enabled)
 		return;
 
@@ -84,6 +85,12 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 		return;
 	}
 
+	// still being decoded or failed to decode, would only play silence
+	if (sndItem->IsPending() || sndItem->IsFailed()) {
+		sound->numEmptyPlayRequests++;
+		return;
+	}
+
 	if (pos.distance(sound->GetListenerPos()) > sndItem->MaxDistance()) {
 		if (!relative) {
 			return;
@@ -97,6 +104,43 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 		return;
 	emmitsThisFrame++;
 
+	// the sound thread picks the source
+	SoundCommandQueue::Command cmd;
+	cmd.type = SoundCommandQueue::CMD_PLAY;
+	cmd.channel = this;
+	cmd.item = sndItem;
+	cmd.pos = pos;
+	cmd.vec = velocity;
+	cmd.volume = volume;
+	cmd.flag = relative;
+	soundCommands.Push(cmd);
+}
+
+void AudioChannel::ExecuteCommand(const SoundCommandQueue::Command& cmd)
+{
+	switch (cmd.type) {
+		case SoundCommandQueue::CMD_PLAY: {
+			PlayItem(cmd.item, cmd.pos, cmd.vec, cmd.volume, cmd.flag);
+		} break;
+		case SoundCommandQueue::CMD_STREAM_PLAY: {
+			StartStream(cmd.file, cmd.volume, cmd.flag);
+		} break;
+		case SoundCommandQueue::CMD_STREAM_STOP: {
+			if (curStreamSrc)
+				curStreamSrc->StreamStop();
+		} break;
+		case SoundCommandQueue::CMD_STREAM_PAUSE: {
+			if (curStreamSrc)
+				curStreamSrc->StreamPause();
+		} break;
+		default: {
+			assert(false);
+		} break;
+	}
+}
+
+void AudioChannel::PlayItem(SoundItem* sndItem, const float3& pos, const float3& velocity, float volume, bool relative)
+{
 	if (cur_sources.size() >= maxConcurrentSources) {
 		CSoundSource* src = NULL;
 		int prio = INT_MAX;
@@ -111,13 +155,15 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 			src->Stop();
 		} else {
 			LOG_L(L_DEBUG, "CSound::PlaySample: Max concurrent sounds in channel reached! Dropping playback!");
+			soundCommands.AddDropped();
 			return;
 		}
 	}
 
-	CSoundSource* sndSource = sound->GetNextBestSource();
+	CSoundSource* sndSource = sound->GetNextBestSource(false);
 	if (!sndSource) {
 		LOG_L(L_DEBUG, "CSound::PlaySample: Max sounds reached! Dropping playback!");
+		soundCommands.AddDropped();
 		return;
 	}
 
@@ -129,6 +175,8 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 		CheckError("CSound::FindSourceAndPlay");
 
 		cur_sources[sndSource] = true;
+	} else {
+		soundCommands.AddDropped();
 	}
 }
 
@@ -180,11 +228,20 @@ void AudioChannel::PlayRandomSample(const GuiSoundSet& soundSet, const float3& p
 
 void AudioChannel::StreamPlay(const std::string& filepath, float volume, bool enqueue)
 {
-	boost::recursive_mutex::scoped_lock lck(soundMutex);
-
 	if (!enabled)
 		return;
 
+	SoundCommandQueue::Command cmd;
+	cmd.type = SoundCommandQueue::CMD_STREAM_PLAY;
+	cmd.channel = this;
+	cmd.volume = volume;
+	cmd.flag = enqueue;
+	cmd.file = filepath;
+	soundCommands.Push(cmd);
+}
+
+void AudioChannel::StartStream(const std::string& filepath, float volume, bool enqueue)
+{
 	if (curStreamSrc && enqueue) {
 		if (streamQueue.size() > MAX_STREAM_QUEUESIZE) {
 			streamQueue.resize(MAX_STREAM_QUEUESIZE);
@@ -196,7 +253,7 @@ void AudioChannel::StreamPlay(const std::string& filepath, float volume, bool en
 	}
 
 	if (!curStreamSrc)
-		curStreamSrc = sound->GetNextBestSource(); //! may return 0 if no sources available
+		curStreamSrc = sound->GetNextBestSource(false); //! may return 0 if no sources available
 
 	if (curStreamSrc) {
 		cur_sources[curStreamSrc] = true; //! This one first, PlayStream may invoke Stop immediately thus setting curStreamSrc to NULL
@@ -206,18 +263,18 @@ void AudioChannel::StreamPlay(const std::string& filepath, float volume, bool en
 
 void AudioChannel::StreamPause()
 {
-	boost::recursive_mutex::scoped_lock lck(soundMutex);
-
-	if (curStreamSrc)
-		curStreamSrc->StreamPause();
+	SoundCommandQueue::Command cmd;
+	cmd.type = SoundCommandQueue::CMD_STREAM_PAUSE;
+	cmd.channel = this;
+	soundCommands.Push(cmd);
 }
 
 void AudioChannel::StreamStop()
 {
-	boost::recursive_mutex::scoped_lock lck(soundMutex);
-
-	if (curStreamSrc)
-		curStreamSrc->StreamStop();
+	SoundCommandQueue::Command cmd;
+	cmd.type = SoundCommandQueue::CMD_STREAM_STOP;
+	cmd.channel = this;
+	soundCommands.Push(cmd);
 }
 
 float AudioChannel::StreamGetTime()
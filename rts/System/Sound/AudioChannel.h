@@ -8,10 +8,12 @@
 #include <string.h>
 
 #include "IAudioChannel.h"
+#include "SoundCommandQueue.h"
 #include <boost/thread/recursive_mutex.hpp>
 
 struct GuiSoundSet;
 class CSoundSource;
+class SoundItem;
 class CUnit;
 class CWorldObject;
 
@@ -19,7 +21,8 @@ class CWorldObject;
  * @brief Channel for playing sounds
  *
  * Has its own volume "slider", and can be enabled / disabled seperately.
- * Abstract base class.
+ * Playback and stream requests are queued for the sound thread, which
+ * executes them (and selects the sources) in ExecuteCommand.
  */
 class AudioChannel : public IAudioChannel {
 public:
@@ -50,9 +53,15 @@ public:
 	float StreamGetTime();
 	float StreamGetPlayTime();
 
+	/// sound thread: executes a command queued by this channel
+	void ExecuteCommand(const SoundCommandQueue::Command& cmd);
+
 protected:
 	void FindSourceAndPlay(size_t id, const float3& pos, const float3& velocity, float volume, bool relative);
 
+	void PlayItem(SoundItem* sndItem, const float3& pos, const float3& velocity, float volume, bool relative);
+	void StartStream(const std::string& path, float volume, bool enqueue);
+
 	void SoundSourceFinished(CSoundSource* sndSource);
 
 private:
@@ -41,6 +41,8 @@ public:
 		return volume;
 	}
 
+	/// PlaySample and the Stream* functions only queue a command
+	/// for the sound thread, they do not wait for it to run
 	virtual void PlaySample(size_t id, float volume = 1.0f) = 0;
 	virtual void PlaySample(size_t id, const float3& p, float volume = 1.0f) = 0;
 	virtual void PlaySample(size_t id, const float3& p, const float3& velocity, float volume = 1.0f) = 0;
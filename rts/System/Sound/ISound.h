@@ -52,8 +52,10 @@ public:
 
 	virtual void PrintDebugInfo() = 0;
 	virtual bool LoadSoundDefs(const std::string& fileName) = 0;
+	/// blocks until all sound files queued for decoding are loaded
+	virtual void WaitForSoundBuffers() = 0;
 	
-	virtual const float3& GetListenerPos() const = 0;
+	virtual float3 GetListenerPos() const = 0;
 
 public:
 	unsigned numEmptyPlayRequests;
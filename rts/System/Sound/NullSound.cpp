@@ -52,9 +52,12 @@ bool NullSound::LoadSoundDefs(const std::string& fileName) {
 	return false;
 }
 
+void NullSound::WaitForSoundBuffers() {
+}
+
 void NullSound::NewFrame() {
 }
 
-const float3& NullSound::GetListenerPos() const {
+float3 NullSound::GetListenerPos() const {
 	return ZeroVector;
 }
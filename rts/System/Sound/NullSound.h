@@ -36,8 +36,9 @@ public:
 
 	void PrintDebugInfo();
 	bool LoadSoundDefs(const std::string& fileName);
+	void WaitForSoundBuffers();
 	
-	const float3& GetListenerPos() const;
+	float3 GetListenerPos() const;
 };
 
 #endif // _NULL_SOUND_H_
@@ -11,6 +11,7 @@
 #include "SoundLog.h"
 #include "SoundSource.h"
 #include "SoundBuffer.h"
+#include "SoundBufferLoader.h"
 #include "SoundItem.h"
 #include "ALShared.h"
 #include "EFX.h"
@@ -19,7 +20,9 @@
 #include "System/TimeProfiler.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/Exceptions.h"
+#include "System/FileSystem/ArchiveScanner.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/VFSHandler.h"
 #include "Lua/LuaParser.h"
 #include "Map/Ground.h"
 #include "Sim/Misc/GlobalConstants.h"
@@ -38,15 +41,25 @@ CONFIG(int, snd_volbattle).defaultValue(100);
 CONFIG(int, snd_volui).defaultValue(100);
 CONFIG(int, snd_volmusic).defaultValue(100);
 CONFIG(std::string, snd_device).defaultValue("");
+CONFIG(bool, snd_asyncload).defaultValue(true).description("Decode Ogg sound files on a background thread, sounds are silent until decoded.");
+CONFIG(bool, snd_pcmcache).defaultValue(true).description("Keep decoded Ogg sound files from archives in the cache directory.");
+CONFIG(int, snd_pcmcachesize).defaultValue(256).minimumValue(1).description("Size limit of the decoded sound cache in MB, the oldest files are removed beyond it.");
+CONFIG(bool, snd_preload).defaultValue(true).description("Wait at the end of loading until the sounds used by unit and weapon definitions are decoded.");
 
 boost::recursive_mutex soundMutex;
+// queueing commands does not take soundMutex, see SoundCommandQueue
+SoundCommandQueue soundCommands(1024);
 
 
 CSound::CSound()
 	: myPos(0., 0., 0.)
 	, prevVelocity(0., 0., 0.)
 	, soundThread(NULL)
+	, bufferLoader(NULL)
 	, soundThreadQuit(false)
+	, soundThreadReady(false)
+	, lastNumQueued(0)
+	, lastNumDropped(0)
 {
 	boost::recursive_mutex::scoped_lock lck(soundMutex);
 	mute = false;
@@ -71,6 +84,9 @@ CSound::CSound()
 	if (maxSounds <= 0) {
 		LOG_L(L_WARNING, "MaxSounds set to 0, sound is disabled");
 	} else {
+		if (configHandler->GetBool("snd_asyncload"))
+			bufferLoader = new SoundBufferLoader(configHandler->GetBool("snd_pcmcache"), configHandler->GetInt("snd_pcmcachesize") * size_t(1024 * 1024));
+
 		soundThread = new boost::thread(boost::bind(&CSound::StartThread, this, maxSounds));
 	}
 
@@ -87,6 +103,8 @@ CSound::~CSound()
 		soundThread = NULL;
 	}
 
+	SafeDelete(bufferLoader);
+
 	for (soundVecT::iterator it = sounds.begin(); it != sounds.end(); ++it)
 		delete *it;
 	sounds.clear();
@@ -365,14 +383,23 @@ void CSound::StartThread(int maxSounds)
 		alListenerf(AL_GAIN, masterVolume);
 	}
 	configHandler->Set("MaxSounds", maxSounds);
+	soundThreadReady = true;
 
 	Threading::SetThreadName("audio");
 	Watchdog::RegisterThread(WDT_AUDIO);
 
+	spring_time lastUpdate = spring_gettime();
+
 	while (!soundThreadQuit) {
-		boost::this_thread::sleep(boost::posix_time::millisec(50)); //! 20Hz
+		// short sleeps, queued sounds should start without much delay
+		boost::this_thread::sleep(boost::posix_time::millisec(5));
 		Watchdog::ClearTimer(WDT_AUDIO);
-		Update();
+		ExecuteCommands();
+
+		if ((spring_gettime() - lastUpdate).toMilliSecs() >= 50) { //! 20Hz
+			lastUpdate = spring_gettime();
+			Update();
+		}
 	}
 
 	Watchdog::DeregisterThread(WDT_AUDIO);
@@ -389,11 +416,30 @@ void CSound::StartThread(int maxSounds)
 void CSound::Update()
 {
 	boost::recursive_mutex::scoped_lock lck(soundMutex); // lock
+	if (bufferLoader != NULL)
+		bufferLoader->FinishDecoded();
 	for (sourceVecT::iterator it = sources.begin(); it != sources.end(); ++it)
 		it->Update();
 	CheckError("CSound::Update");
 }
 
+void CSound::ExecuteCommands()
+{
+	SoundCommandQueue::Command cmd;
+
+	boost::recursive_mutex::scoped_lock lck(soundMutex);
+
+	while (soundCommands.Pop(cmd)) {
+		if (cmd.type == SoundCommandQueue::CMD_LISTENER) {
+			SetListener(cmd);
+		} else {
+			cmd.channel->ExecuteCommand(cmd);
+		}
+	}
+
+	CheckError("CSound::ExecuteCommands");
+}
+
 size_t CSound::MakeItemFromDef(const soundItemDef& itemDef)
 {
 	//! MakeItemFromDef is private. Only caller is LoadSoundDefs and it sets the mutex itself.
@@ -416,21 +462,35 @@ size_t CSound::MakeItemFromDef(const soundItemDef& itemDef)
 
 void CSound::UpdateListener(const float3& campos, const float3& camdir, const float3& camup, float lastFrameTime)
 {
-	boost::recursive_mutex::scoped_lock lck(soundMutex);
-	if (sources.empty())
+	if (!soundThreadReady)
 		return;
 
-	myPos = campos;
-	const float3 myPosInMeters = myPos * ELMOS_TO_METERS;
-	alListener3f(AL_POSITION, myPosInMeters.x, myPosInMeters.y, myPosInMeters.z);
+	{
+		boost::mutex::scoped_lock lck(listenerMutex);
+		myPos = campos;
+	}
 
 	//! reduce the rolloff when the camera is high above the ground (so we still hear something in tab mode or far zoom)
 	//! for altitudes up to and including 600 elmos, the rolloff is always clamped to 1
 	const float camHeight = std::max(1.0f, campos.y - ground->GetHeightAboveWater(campos.x, campos.z));
 	const float newMod = std::min(600.0f / camHeight, 1.0f);
 
-	CSoundSource::SetHeightRolloffModifer(newMod);
-	efx->SetHeightRolloffModifer(newMod);
+	SoundCommandQueue::Command cmd;
+	cmd.type = SoundCommandQueue::CMD_LISTENER;
+	cmd.pos = campos;
+	cmd.vec = camdir;
+	cmd.up = camup;
+	cmd.heightRolloff = newMod;
+	soundCommands.Push(cmd);
+}
+
+void CSound::SetListener(const SoundCommandQueue::Command& cmd)
+{
+	const float3 myPosInMeters = cmd.pos * ELMOS_TO_METERS;
+	alListener3f(AL_POSITION, myPosInMeters.x, myPosInMeters.y, myPosInMeters.z);
+
+	CSoundSource::SetHeightRolloffModifer(cmd.heightRolloff);
+	efx->SetHeightRolloffModifer(cmd.heightRolloff);
 
 	//! Result were bad with listener related doppler effects.
 	//! The user experiences the camera/listener not as a world-interacting object.
@@ -449,7 +509,7 @@ void CSound::UpdateListener(const float3& campos, const float3& camdir, const fl
 	alListener3f(AL_VELOCITY, velocityAvg.x, velocityAvg.y, velocityAvg.z);
 	*/
 
-	ALfloat ListenerOri[] = {camdir.x, camdir.y, camdir.z, camup.x, camup.y, camup.z};
+	ALfloat ListenerOri[] = {cmd.vec.x, cmd.vec.y, cmd.vec.z, cmd.up.x, cmd.up.y, cmd.up.z};
 	alListenerfv(AL_ORIENTATION, ListenerOri);
 	CheckError("CSound::UpdateListener");
 }
@@ -461,10 +521,13 @@ void CSound::PrintDebugInfo()
 	LOG_L(L_DEBUG, "OpenAL Sound System:");
 	LOG_L(L_DEBUG, "# SoundSources: %i", (int)sources.size());
 	LOG_L(L_DEBUG, "# SoundBuffers: %i", (int)SoundBuffer::Count());
+	LOG_L(L_DEBUG, "# SoundBuffers being decoded: %i", (bufferLoader != NULL)? (int)bufferLoader->NumPending(): 0);
 
 	LOG_L(L_DEBUG, "# reserved for buffers: %i kB", (int)(SoundBuffer::AllocedSize() / 1024));
 	LOG_L(L_DEBUG, "# PlayRequests for empty sound: %i", numEmptyPlayRequests);
 	LOG_L(L_DEBUG, "# Samples disrupted: %i", numAbortedPlays);
+	LOG_L(L_DEBUG, "# Commands queued: %i", (int)soundCommands.GetNumQueued());
+	LOG_L(L_DEBUG, "# Commands dropped: %i", (int)soundCommands.GetNumDropped());
 	LOG_L(L_DEBUG, "# SoundItems: %i", (int)sounds.size());
 }
 
@@ -565,6 +628,24 @@ size_t CSound::LoadSoundBuffer(const std::string& path)
 		boost::shared_ptr<SoundBuffer> buffer(new SoundBuffer());
 		bool success = false;
 		const std::string ending = file.GetFileExt();
+
+		if (ending == "ogg" && bufferLoader != NULL) {
+			// only files from archives are cached, raw ones can change any time
+			unsigned int archiveChecksum = 0;
+
+			if (!CFileHandler::FileExists(path, SPRING_VFS_RAW)) {
+				const std::string archiveName = vfsHandler->GetFileArchiveName(path);
+
+				if (!archiveName.empty())
+					archiveChecksum = archiveScanner->GetSingleArchiveChecksum(archiveName);
+			}
+
+			// played silently until the loader has decoded it
+			buffer->SetPending(path);
+			bufferLoader->Queue(buffer, path, archiveChecksum, buf);
+			return SoundBuffer::Insert(buffer);
+		}
+
 		if (ending == "wav") {
 			success = buffer->LoadWAV(path, buf);
 		} else if (ending == "ogg") {
@@ -584,8 +665,28 @@ size_t CSound::LoadSoundBuffer(const std::string& path)
 	}
 }
 
+void CSound::WaitForSoundBuffers()
+{
+	if (bufferLoader == NULL)
+		return;
+
+	// not locked while waiting, the sound thread keeps loading buffers
+	bufferLoader->WaitForAll();
+
+	boost::recursive_mutex::scoped_lock lck(soundMutex);
+	bufferLoader->FinishDecoded();
+}
+
 void CSound::NewFrame()
 {
+	const boost::int64_t numQueued = soundCommands.GetNumQueued();
+	const boost::int64_t numDropped = soundCommands.GetNumDropped();
+
+	profiler.AddCounter("Sound::queued", numQueued - lastNumQueued);
+	profiler.AddCounter("Sound::dropped", numDropped - lastNumDropped);
+	lastNumQueued = numQueued;
+	lastNumDropped = numDropped;
+
 	Channels::General.UpdateFrame();
 	Channels::Battle.UpdateFrame();
 	Channels::UnitReply.UpdateFrame();
@@ -10,14 +10,17 @@
 #include <map>
 #include <vector>
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 
 #include "System/float3.h"
 
+#include "SoundCommandQueue.h"
 #include "SoundItem.h"
 
 class CSoundSource;
 class SoundBuffer;
+class SoundBufferLoader;
 class SoundItem;
 
 namespace boost {
@@ -52,8 +55,11 @@ public:
 
 	virtual void PrintDebugInfo();
 	virtual bool LoadSoundDefs(const std::string& fileName);
+	virtual void WaitForSoundBuffers();
 
-	const float3& GetListenerPos() const {
+	/// may be called by any thread playing a sample
+	float3 GetListenerPos() const {
+		boost::mutex::scoped_lock lck(listenerMutex);
 		return myPos;
 	}
 
@@ -64,6 +70,9 @@ private:
 private:
 	void StartThread(int maxSounds);
 	void Update();
+	/// sound thread: executes the queued commands
+	void ExecuteCommands();
+	void SetListener(const SoundCommandQueue::Command& cmd);
 
 	size_t MakeItemFromDef(const soundItemDef& itemDef);
 
@@ -83,6 +92,8 @@ private:
 
 	/// unscaled
 	float3 myPos;
+	/// guards myPos, which is written by UpdateListener and read by PlaySample
+	mutable boost::mutex listenerMutex;
 	float3 prevVelocity;
 
 	typedef boost::ptr_vector<CSoundSource> sourceVecT;
@@ -92,8 +103,16 @@ private:
 	soundItemDefMap soundItemDefs;
 
 	boost::thread* soundThread;
+	/// decodes Ogg files in the background, NULL if snd_asyncload is off
+	SoundBufferLoader* bufferLoader;
 
 	volatile bool soundThreadQuit;
+	/// set once the sound thread has created the sources
+	volatile bool soundThreadReady;
+
+	/// command counters at the last NewFrame
+	boost::int64_t lastNumQueued;
+	boost::int64_t lastNumDropped;
 };
 
 #endif // _SOUND_H_
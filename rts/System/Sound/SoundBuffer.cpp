@@ -10,13 +10,14 @@
 
 #include <vorbis/vorbisfile.h>
 #include <ogg/ogg.h>
+#include <cstdio>
 #include <cstring>
 
 namespace
 {
 struct VorbisInputBuffer
 {
-	boost::uint8_t* data;
+	const boost::uint8_t* data;
 	size_t pos;
 	size_t size;
 };
@@ -34,12 +35,36 @@ int	VorbisClose(void* datasource)
 {
 	return 0; // nothing to be done here
 };
+
+int VorbisSeek(void* datasource, ogg_int64_t offset, int whence)
+{
+	VorbisInputBuffer* buffer = static_cast<VorbisInputBuffer*>(datasource);
+	ogg_int64_t pos = offset;
+
+	switch (whence) {
+		case SEEK_SET: { } break;
+		case SEEK_CUR: { pos += buffer->pos;  } break;
+		case SEEK_END: { pos += buffer->size; } break;
+		default: return -1;
+	}
+
+	if (pos < 0 || pos > ogg_int64_t(buffer->size))
+		return -1;
+
+	buffer->pos = pos;
+	return 0;
+};
+
+long VorbisTell(void* datasource)
+{
+	return static_cast<VorbisInputBuffer*>(datasource)->pos;
+};
 }
 
 SoundBuffer::bufferMapT SoundBuffer::bufferMap; // filename, index into Buffers
 SoundBuffer::bufferVecT SoundBuffer::buffers;
 
-SoundBuffer::SoundBuffer() : id(0), channels(0), length(0.0f)
+SoundBuffer::SoundBuffer() : id(0), channels(0), length(0.0f), pending(false), failed(false)
 {
 }
 
@@ -148,18 +173,28 @@ bool SoundBuffer::LoadWAV(const std::string& file, std::vector<boost::uint8_t> b
 	return true;
 }
 
-bool SoundBuffer::LoadVorbis(const std::string& file, std::vector<boost::uint8_t> buffer)
+bool SoundBuffer::LoadVorbis(const std::string& file, const std::vector<boost::uint8_t>& buffer)
+{
+	DecodedSound decoded;
+
+	if (!DecodeVorbis(file, buffer, decoded))
+		return false;
+
+	return LoadDecoded(file, decoded);
+}
+
+bool SoundBuffer::DecodeVorbis(const std::string& file, const std::vector<boost::uint8_t>& buffer, DecodedSound& decoded)
 {
 	VorbisInputBuffer buf;
-	buf.data = &buffer[0];
+	buf.data = buffer.empty()? NULL: &buffer[0];
 	buf.pos = 0;
 	buf.size = buffer.size();
 	
 	ov_callbacks vorbisCallbacks;
 	vorbisCallbacks.read_func  = VorbisRead;
 	vorbisCallbacks.close_func = VorbisClose;
-	vorbisCallbacks.seek_func  = NULL;
-	vorbisCallbacks.tell_func  = NULL;
+	vorbisCallbacks.seek_func  = VorbisSeek;
+	vorbisCallbacks.tell_func  = VorbisTell;
 
 	OggVorbis_File oggStream;
 	const int result = ov_open_callbacks(&buf, &oggStream, NULL, 0, vorbisCallbacks);
@@ -185,16 +220,27 @@ bool SoundBuffer::LoadVorbis(const std::string& file, std::vector<boost::uint8_t
 	{
 		LOG_L(L_ERROR, "File %s: invalid number of channels: %i",
 					file.c_str(), vorbisInfo->channels);
+		ov_clear(&oggStream);
 		return false;
 	}
 
+	// the stream is seekable, so the decoded size is known up front
+	// (the buffer still grows should the stream contain more samples)
+	const ogg_int64_t numSamples = ov_pcm_total(&oggStream, -1);
+	const size_t readSize = 4096;
+
 	size_t pos = 0;
-	std::vector<boost::uint8_t> decodeBuffer(512*1024); // 512kb read buffer
+	std::vector<boost::uint8_t>& decodeBuffer = decoded.pcm;
+	if (numSamples > 0) {
+		decodeBuffer.resize(numSamples * vorbisInfo->channels * 2 + readSize);
+	} else {
+		decodeBuffer.resize(512*1024); // 512kb read buffer
+	}
 	int section = 0;
 	long read = 0;
 	do
 	{
-		if (4*pos > 3*decodeBuffer.size()) // enlarge buffer so ov_read has enough space
+		if (decodeBuffer.size() - pos < readSize) // enlarge buffer so ov_read has enough space
 			decodeBuffer.resize(decodeBuffer.size()*2);
 		read = ov_read(&oggStream, (char*)&decodeBuffer[pos], decodeBuffer.size() - pos, 0, 2, 1, &section);
 		switch(read)
@@ -206,9 +252,11 @@ bool SoundBuffer::LoadVorbis(const std::string& file, std::vector<boost::uint8_t
 				continue; // read next
 			case OV_EBADLINK:
 				LOG_L(L_WARNING, "%s: corrupted stream", file.c_str());
+				ov_clear(&oggStream);
 				return false; // abort
 			case OV_EINVAL:
 				LOG_L(L_WARNING, "%s: corrupted headers", file.c_str());
+				ov_clear(&oggStream);
 				return false; // abort
 			default:
 				break; // all good
@@ -216,10 +264,23 @@ bool SoundBuffer::LoadVorbis(const std::string& file, std::vector<boost::uint8_t
 		pos += read;
 	} while (read > 0); // read == 0 indicated EOF, read < 0 is error
 
-	AlGenBuffer(file, format, &decodeBuffer[0], pos, vorbisInfo->rate);
+	decodeBuffer.resize(pos);
+	decoded.format   = format;
+	decoded.rate     = vorbisInfo->rate;
+	decoded.channels = vorbisInfo->channels;
+	decoded.length   = ov_time_total(&oggStream, -1);
+
+	ov_clear(&oggStream);
+	return true;
+}
+
+bool SoundBuffer::LoadDecoded(const std::string& file, const DecodedSound& decoded)
+{
+	AlGenBuffer(file, decoded.format, decoded.pcm.empty()? NULL: &decoded.pcm[0], decoded.pcm.size(), decoded.rate);
 	filename = file;
-	channels = vorbisInfo->channels;
-	length   = ov_time_total(&oggStream, -1);
+	channels = decoded.channels;
+	length   = decoded.length;
+	pending  = false;
 	return true;
 }
 
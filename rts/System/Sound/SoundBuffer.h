@@ -11,12 +11,26 @@
 #include <vector>
 #include <boost/cstdint.hpp>
 
+/// PCM data of a decoded sound file which is not yet handed to OpenAL
+struct DecodedSound
+{
+	DecodedSound() : format(0), rate(0), channels(0), length(0.0f) {}
+
+	ALenum format;
+	int rate;
+	ALuint channels;
+	ALfloat length;
+	std::vector<boost::uint8_t> pcm;
+};
+
 /**
  * @brief A buffer holding a sound
  * 
  * One of this will be created for each wav-file used.
  * They are loaded on demand and unloaded when game ends.
  * They can be shared among multiple SoundItem
+ * Ogg files can be decoded on another thread (see SoundBufferLoader), their
+ * buffer stays empty and pending until LoadDecoded is called.
  */
 class SoundBuffer : boost::noncopyable
 {
@@ -27,7 +41,33 @@ public:
 	~SoundBuffer();
 
 	bool LoadWAV(const std::string& file, std::vector<boost::uint8_t> buffer);
-	bool LoadVorbis(const std::string& file, std::vector<boost::uint8_t> buffer);
+	bool LoadVorbis(const std::string& file, const std::vector<boost::uint8_t>& buffer);
+
+	/// decodes an Ogg file, does not call OpenAL so it can run on any thread
+	static bool DecodeVorbis(const std::string& file, const std::vector<boost::uint8_t>& buffer, DecodedSound& decoded);
+	/// fills the buffer with data returned by DecodeVorbis
+	bool LoadDecoded(const std::string& file, const DecodedSound& decoded);
+
+	/// marks the buffer as waiting for LoadDecoded
+	void SetPending(const std::string& file)
+	{
+		filename = file;
+		pending = true;
+	};
+	bool IsPending() const
+	{
+		return pending;
+	};
+	/// marks a pending buffer whose file could not be decoded, it stays silent
+	void SetFailed()
+	{
+		pending = false;
+		failed = true;
+	};
+	bool IsFailed() const
+	{
+		return failed;
+	};
 
 	const std::string& GetFilename() const
 	{
@@ -68,6 +108,8 @@ private:
 	ALuint id;
 	ALuint channels;
 	ALfloat length;
+	bool pending;
+	bool failed;
 	
 	typedef std::map<std::string, size_t> bufferMapT;
 	typedef std::vector< boost::shared_ptr<SoundBuffer> > bufferVecT;
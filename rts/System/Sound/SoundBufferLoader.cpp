@@ -0,0 +1,320 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SoundBufferLoader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "SoundLog.h"
+#include "ALShared.h"
+#include "System/CRC.h"
+#include "System/Util.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/FileSystemAbstraction.h"
+#include "System/Platform/Threading.h"
+
+namespace
+{
+static const char CACHE_MAGIC[4] = {'S', 'P', 'C', 'M'};
+static const boost::uint32_t CACHE_VERSION = 1;
+
+#pragma pack(push, 1)
+struct CacheHeader
+{
+	char magic[4];
+	boost::uint32_t version;
+	boost::int32_t format;
+	boost::int32_t rate;
+	boost::uint32_t channels;
+	float length;
+	boost::uint32_t fileNameSize; // followed by the (sound) file name
+	boost::uint32_t pcmSize;      // followed by the data, after the name
+};
+#pragma pack(pop)
+}
+
+
+SoundBufferLoader::SoundBufferLoader(bool useCache, size_t cacheSizeLimit)
+	: thread(NULL)
+	, numPending(0)
+	, quit(false)
+	, cacheSize(0)
+	, cacheSizeLimit(cacheSizeLimit)
+{
+	if (useCache) {
+		cacheDir = dataDirsAccess.LocateDir(FileSystem::GetCacheDir() + "/sounds/", FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS);
+	}
+
+	thread = new boost::thread(boost::bind(&SoundBufferLoader::Run, this));
+}
+
+SoundBufferLoader::~SoundBufferLoader()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		quit = true;
+		workCond.notify_one();
+	}
+
+	thread->join();
+	delete thread;
+
+	// buffers that did not get loaded stay silent
+	for (std::deque<Job*>::iterator it = queuedJobs.begin(); it != queuedJobs.end(); ++it)
+		delete *it;
+	for (std::vector<Job*>::iterator it = decodedJobs.begin(); it != decodedJobs.end(); ++it)
+		delete *it;
+}
+
+
+void SoundBufferLoader::Queue(boost::shared_ptr<SoundBuffer> buffer, const std::string& file, unsigned int archiveChecksum, std::vector<boost::uint8_t>& data)
+{
+	Job* job = new Job();
+	job->buffer = buffer;
+	job->file = file;
+	job->data.swap(data);
+	job->success = false;
+
+	if (!cacheDir.empty() && archiveChecksum != 0) {
+		const std::string lcFile = StringToLower(file);
+		const unsigned int fileChecksum = CRC().Update(lcFile.data(), lcFile.size()).GetDigest();
+
+		char cacheFile[64];
+		SNPRINTF(cacheFile, sizeof(cacheFile), "%08x-%08x.pcm", archiveChecksum, fileChecksum);
+		job->cacheFile = cacheDir + cacheFile;
+	}
+
+	boost::mutex::scoped_lock lock(mutex);
+	queuedJobs.push_back(job);
+	numPending++;
+	workCond.notify_one();
+}
+
+size_t SoundBufferLoader::FinishDecoded()
+{
+	std::vector<Job*> jobs;
+
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		jobs.swap(decodedJobs);
+		numPending -= jobs.size();
+	}
+
+	for (std::vector<Job*>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+		Job* job = *it;
+
+		if (job->success) {
+			job->buffer->LoadDecoded(job->file, job->decoded);
+			CheckError("SoundBufferLoader::FinishDecoded");
+		} else {
+			// the buffer stays registered, so the file is not queued again
+			job->buffer->SetFailed();
+			LOG_L(L_WARNING, "Failed to decode file: %s, it will not be played", job->file.c_str());
+		}
+
+		delete job;
+	}
+
+	return jobs.size();
+}
+
+void SoundBufferLoader::WaitForAll()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	while (!queuedJobs.empty()) {
+		doneCond.wait(lock);
+	}
+}
+
+size_t SoundBufferLoader::NumPending()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return numPending;
+}
+
+
+void SoundBufferLoader::Run()
+{
+	Threading::SetThreadName("sound-loader");
+
+	ScanCache();
+	TrimCache();
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	while (true) {
+		while (!quit && queuedJobs.empty()) {
+			workCond.wait(lock);
+		}
+
+		if (quit)
+			break;
+
+		// the job stays queued while decoding, so WaitForAll sees it
+		Job* job = queuedJobs.front();
+		lock.unlock();
+
+		if (!(job->success = ReadCache(job))) {
+			job->success = SoundBuffer::DecodeVorbis(job->file, job->data, job->decoded);
+
+			if (job->success) {
+				WriteCache(job);
+			}
+		}
+
+		std::vector<boost::uint8_t>().swap(job->data);
+
+		lock.lock();
+		queuedJobs.pop_front();
+		decodedJobs.push_back(job);
+
+		if (queuedJobs.empty()) {
+			doneCond.notify_all();
+		}
+	}
+}
+
+
+bool SoundBufferLoader::ReadCache(Job* job) const
+{
+	if (job->cacheFile.empty())
+		return false;
+
+	FILE* file = fopen(job->cacheFile.c_str(), "rb");
+
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	const long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	CacheHeader header;
+	std::string fileName;
+	bool valid = (fread(&header, sizeof(header), 1, file) == 1);
+
+	valid = valid && (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0);
+	valid = valid && (header.version == CACHE_VERSION);
+	// also catches files that were not completely written
+	valid = valid && (fileSize == long(sizeof(header) + header.fileNameSize + header.pcmSize));
+
+	if (valid) {
+		fileName.resize(header.fileNameSize);
+		valid = fileName.empty() || (fread(&fileName[0], fileName.size(), 1, file) == 1);
+		// guards against checksum collisions
+		valid = valid && (StringToLower(fileName) == StringToLower(job->file));
+	}
+	if (valid) {
+		job->decoded.pcm.resize(header.pcmSize);
+		valid = job->decoded.pcm.empty() || (fread(&job->decoded.pcm[0], job->decoded.pcm.size(), 1, file) == 1);
+	}
+
+	fclose(file);
+
+	if (!valid) {
+		job->decoded.pcm.clear();
+		return false;
+	}
+
+	job->decoded.format   = header.format;
+	job->decoded.rate     = header.rate;
+	job->decoded.channels = header.channels;
+	job->decoded.length   = header.length;
+	return true;
+}
+
+void SoundBufferLoader::WriteCache(const Job* job)
+{
+	if (job->cacheFile.empty())
+		return;
+
+	CacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version      = CACHE_VERSION;
+	header.format       = job->decoded.format;
+	header.rate         = job->decoded.rate;
+	header.channels     = job->decoded.channels;
+	header.length       = job->decoded.length;
+	header.fileNameSize = job->file.size();
+	header.pcmSize      = job->decoded.pcm.size();
+
+	FILE* file = fopen(job->cacheFile.c_str(), "wb");
+
+	if (file == NULL) {
+		LOG_L(L_WARNING, "Could not write sound cache file %s", job->cacheFile.c_str());
+		return;
+	}
+
+	bool written = (fwrite(&header, sizeof(header), 1, file) == 1);
+	written = written && (fwrite(job->file.data(), job->file.size(), 1, file) == 1);
+	written = written && (job->decoded.pcm.empty() || fwrite(&job->decoded.pcm[0], job->decoded.pcm.size(), 1, file) == 1);
+
+	fclose(file);
+
+	if (!written) {
+		remove(job->cacheFile.c_str());
+		return;
+	}
+
+	// a rewritten (invalid) cache file replaces its old entry
+	for (std::deque< std::pair<std::string, size_t> >::iterator it = cacheFiles.begin(); it != cacheFiles.end(); ++it) {
+		if (it->first == job->cacheFile) {
+			cacheSize -= it->second;
+			cacheFiles.erase(it);
+			break;
+		}
+	}
+
+	const size_t fileSize = sizeof(header) + header.fileNameSize + header.pcmSize;
+
+	cacheFiles.push_back(std::make_pair(job->cacheFile, fileSize));
+	cacheSize += fileSize;
+
+	TrimCache();
+}
+
+
+void SoundBufferLoader::ScanCache()
+{
+	if (cacheDir.empty())
+		return;
+
+	std::vector<std::string> files;
+	FileSystemAbstraction::FindFiles(files, cacheDir, "", ".*\\.pcm", 0);
+
+	// (modification date, file name); the date strings sort chronologically
+	std::vector< std::pair<std::string, std::string> > datedFiles;
+	datedFiles.reserve(files.size());
+
+	for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it) {
+		const std::string path = cacheDir + *it;
+		datedFiles.push_back(std::make_pair(FileSystemAbstraction::GetFileModificationDate(path), path));
+	}
+
+	std::sort(datedFiles.begin(), datedFiles.end());
+
+	for (std::vector< std::pair<std::string, std::string> >::const_iterator it = datedFiles.begin(); it != datedFiles.end(); ++it) {
+		const size_t fileSize = FileSystemAbstraction::GetFileSize(it->second);
+
+		cacheFiles.push_back(std::make_pair(it->second, fileSize));
+		cacheSize += fileSize;
+	}
+}
+
+void SoundBufferLoader::TrimCache()
+{
+	// the newest file is kept even if it alone exceeds the limit
+	while (cacheSize > cacheSizeLimit && cacheFiles.size() > 1) {
+		const std::pair<std::string, size_t>& oldest = cacheFiles.front();
+
+		remove(oldest.first.c_str());
+		cacheSize -= oldest.second;
+		cacheFiles.pop_front();
+	}
+}
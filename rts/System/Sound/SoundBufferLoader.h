@@ -0,0 +1,97 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SOUNDBUFFERLOADER_H
+#define SOUNDBUFFERLOADER_H
+
+#include <deque>
+#include <utility>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "SoundBuffer.h"
+
+namespace boost {
+	class thread;
+};
+
+/**
+ * @brief Decodes Ogg files for SoundBuffers on a background thread
+ *
+ * The buffers stay pending (silent) until FinishDecoded hands the decoded
+ * data to OpenAL, which has to happen with the sound mutex held.
+ * Decoded data of files from archives can be kept in the cache directory,
+ * keyed by the checksum of the archive and the file name, so the next
+ * game using the same archive skips decoding. The oldest cache files are
+ * removed when the cache grows beyond its size limit.
+ * Files that fail to decode are marked as failed and never played.
+ */
+class SoundBufferLoader : boost::noncopyable
+{
+public:
+	/// @param cacheSizeLimit size of the cache directory in bytes, ignored without useCache
+	SoundBufferLoader(bool useCache, size_t cacheSizeLimit);
+	~SoundBufferLoader();
+
+	/**
+	 * Queue an Ogg file for decoding.
+	 * @param data contents of the file, taken over by the loader
+	 * @param archiveChecksum checksum of the archive containing the file,
+	 *   0 if the decoded data should not be cached
+	 */
+	void Queue(boost::shared_ptr<SoundBuffer> buffer, const std::string& file, unsigned int archiveChecksum, std::vector<boost::uint8_t>& data);
+
+	/// loads all buffers decoded so far into OpenAL
+	/// @return number of buffers loaded
+	size_t FinishDecoded();
+	/// blocks until all queued files are decoded
+	void WaitForAll();
+
+	/// files queued or decoded, but not yet loaded
+	size_t NumPending();
+
+private:
+	struct Job {
+		boost::shared_ptr<SoundBuffer> buffer;
+		std::string file;
+		std::string cacheFile;
+		std::vector<boost::uint8_t> data;
+		DecodedSound decoded;
+		bool success;
+	};
+
+	void Run();
+
+	bool ReadCache(Job* job) const;
+	void WriteCache(const Job* job);
+
+	/// collects the files present in the cache directory, oldest first
+	void ScanCache();
+	/// removes the oldest cache files until the cache fits into its limit
+	void TrimCache();
+
+private:
+	boost::thread* thread;
+	boost::mutex mutex;
+	boost::condition_variable workCond; ///< wakes the loader thread
+	boost::condition_variable doneCond; ///< wakes WaitForAll
+
+	std::deque<Job*> queuedJobs;
+	std::vector<Job*> decodedJobs;
+	size_t numPending;
+	bool quit;
+
+	/// empty if decoded data is not cached
+	std::string cacheDir;
+
+	/// (file name, size) of the cache files, oldest first; loader thread only
+	std::deque< std::pair<std::string, size_t> > cacheFiles;
+	size_t cacheSize;
+	size_t cacheSizeLimit;
+};
+
+#endif
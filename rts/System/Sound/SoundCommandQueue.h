@@ -0,0 +1,137 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SOUNDCOMMANDQUEUE_H
+#define SOUNDCOMMANDQUEUE_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "System/float3.h"
+#include "System/Platform/Threading.h"
+
+class AudioChannel;
+class SoundItem;
+
+/**
+ * @brief Queue of the commands the sound thread executes
+ *
+ * Commands may be pushed by several threads at once (sim and draw thread
+ * with GML, the loading thread and LuaIntro / the load screen while a game
+ * loads), so producers serialize on a mutex that only guards the write
+ * position. The only consumer, the sound thread, never takes that mutex:
+ * neither side ever waits for the other, and commands that do not fit
+ * into the queue are dropped.
+ */
+class SoundCommandQueue : boost::noncopyable
+{
+public:
+	enum CommandType {
+		CMD_PLAY,
+		CMD_LISTENER,
+		CMD_STREAM_PLAY,
+		CMD_STREAM_STOP,
+		CMD_STREAM_PAUSE,
+	};
+
+	struct Command {
+		Command()
+			: type(CMD_PLAY)
+			, channel(NULL)
+			, item(NULL)
+			, volume(0.0f)
+			, heightRolloff(1.0f)
+			, flag(false)
+		{}
+
+		CommandType type;
+		AudioChannel* channel;
+		SoundItem* item;
+
+		/// position and velocity of the sound,
+		/// or position, direction and up-vector of the listener
+		float3 pos;
+		float3 vec;
+		float3 up;
+
+		float volume;
+		float heightRolloff;
+		/// CMD_PLAY: relative, CMD_STREAM_PLAY: enqueue
+		bool flag;
+		std::string file;
+	};
+
+public:
+	SoundCommandQueue(size_t capacity)
+		: commands(capacity + 1)
+		, head(0)
+		, tail(0)
+	{}
+
+	/// producer (any thread): @return false (and counts the command as dropped) if full
+	bool Push(const Command& cmd)
+	{
+		boost::mutex::scoped_lock lck(pushMutex);
+
+		const size_t next = (head + 1) % commands.size();
+
+		if (next == tail) {
+			++numDropped;
+			return false;
+		}
+
+		commands[head] = cmd;
+		Barrier(); // the command has to be written before it is published
+		head = next;
+
+		++numQueued;
+		return true;
+	}
+
+	/// consumer: @return false if there is no command
+	bool Pop(Command& cmd)
+	{
+		if (tail == head)
+			return false;
+
+		Barrier(); // do not read the command before seeing it published
+		cmd = commands[tail];
+		Barrier(); // nor release its slot before it has been read
+		tail = (tail + 1) % commands.size();
+		return true;
+	}
+
+	/// commands queued or dropped since the start (may be read by any thread)
+	boost::int64_t GetNumQueued() { return numQueued; }
+	boost::int64_t GetNumDropped() { return numDropped; }
+
+	/// consumer: count a command that could not be executed
+	void AddDropped() { ++numDropped; }
+
+private:
+	static void Barrier()
+	{
+	#ifdef _MSC_VER
+		MemoryBarrier();
+	#else // assuming GCC (__sync_synchronize is a builtin)
+		__sync_synchronize();
+	#endif
+	}
+
+private:
+	std::vector<Command> commands;
+
+	/// serializes the producers
+	boost::mutex pushMutex;
+
+	/// next slot to write, only changed by the producers (with pushMutex held)
+	volatile size_t head;
+	/// next slot to read, only changed by the consumer
+	volatile size_t tail;
+
+	Threading::AtomicCounterInt64 numQueued;
+	Threading::AtomicCounterInt64 numDropped;
+};
+
+#endif
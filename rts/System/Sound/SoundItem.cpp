@@ -86,6 +86,16 @@ void SoundItem::StopPlay()
 	--currentlyPlaying;
 }
 
+bool SoundItem::IsPending() const
+{
+	return buffer->IsPending();
+}
+
+bool SoundItem::IsFailed() const
+{
+	return buffer->IsFailed();
+}
+
 float SoundItem::GetGain() const
 {
 	float tgain = 0;
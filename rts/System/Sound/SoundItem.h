@@ -37,6 +37,10 @@ public:
 	{
 		return priority;
 	};
+	/// true while the buffer is still being decoded
+	bool IsPending() const;
+	/// true if the buffer could not be decoded
+	bool IsFailed() const;
 	
 	float GetGain() const;
 	float GetPitch() const;
@@ -35,6 +35,7 @@
 #include "Rendering/glFont.h"
 #include "Rendering/GLContext.h"
 #include "Rendering/VerticalSync.h"
+#include "Rendering/Textures/BitmapLoader.h"
 #include "Rendering/Textures/NamedTextures.h"
 #include "Rendering/Textures/TextureAtlas.h"
 #include "Sim/Misc/DefinitionTag.h"
@@ -231,6 +232,8 @@ bool SpringApp::Initialize()
 
 	// Initialize named texture handler
 	CNamedTextures::Init();
+	// the render thread and the loading thread are busy, so leave them a core
+	bitmapLoader = new CBitmapLoader(Clamp(Threading::GetAvailableCores() - 1, 1, 4));
 
 	// Initialize Lua GL
 	LuaOpenGL::Init();
@@ -1089,6 +1092,7 @@ void SpringApp::Shutdown()
 	SafeDelete(font);
 	SafeDelete(smallFont);
 	CNamedTextures::Kill();
+	SafeDelete(bitmapLoader);
 	GLContext::Free();
 	GlobalConfig::Deallocate();
 	ConfigHandler::Deallocate();
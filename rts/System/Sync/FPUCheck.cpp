@@ -182,23 +182,31 @@ void good_fpu_init()
 void streflop_init_omp() {
 #if defined(STREFLOP_H) && !defined(DEDICATED)
 	// Initialize FPU in all OpenMP threads, too
-	// Note: It's not needed for sync'ness cause all precision relevant
-	//       mode flags are shared across the process!
-	//       But the exception ones aren't (but are copied from the calling thread).
+	// (see streflop_init_omp_thread, regions running synced code
+	// should call it again in case the runtime spawned new workers)
 	#ifdef _OPENMP
 		Threading::OMPCheck();
 		#pragma omp parallel
 		{
 			//good_fpu_control_registers("OMP-Init");
-			streflop::streflop_init<streflop::Simple>();
-		#if defined(__SUPPORT_SNAN__)
-			streflop::feraiseexcept(streflop::FPU_Exceptions(streflop::FE_INVALID | streflop::FE_DIVBYZERO | streflop::FE_OVERFLOW));
-		#endif
+			streflop_init_omp_thread();
 		}
 	#endif
 #endif
 }
 
+void streflop_init_omp_thread() {
+#if defined(STREFLOP_H) && !defined(DEDICATED)
+	// the control registers are per thread (MXCSR and FPUCW are saved and
+	// restored on context switches), so synced code running on a worker
+	// must not rely on whatever state the OpenMP runtime created it with
+	streflop::streflop_init<streflop::Simple>();
+	#if defined(__SUPPORT_SNAN__)
+	streflop::feraiseexcept(streflop::FPU_Exceptions(streflop::FE_INVALID | streflop::FE_DIVBYZERO | streflop::FE_OVERFLOW));
+	#endif
+#endif
+}
+
 namespace proc {
 	#if defined(__GNUC__)
 		// function inlining breaks this
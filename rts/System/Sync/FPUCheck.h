@@ -14,6 +14,8 @@
 extern void good_fpu_control_registers(const char* text);
 extern void good_fpu_init();
 extern void streflop_init_omp();
+/// sets up the FPU of the calling thread, for use inside omp parallel regions
+extern void streflop_init_omp_thread();
 
 #if defined(__GNUC__)
 	#define _noinline __attribute__((__noinline__))
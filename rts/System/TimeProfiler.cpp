@@ -2,6 +2,7 @@
 
 #include "System/TimeProfiler.h"
 
+#include <algorithm>
 #include <cstring>
 #include <boost/unordered_map.hpp>
 
@@ -88,6 +89,13 @@ void CTimeProfiler::Update()
 			else
 				pi->second.newpeak = false;
 		}
+		for (std::map<std::string,CounterRecord>::iterator ci = counters.begin(); ci != counters.end(); ++ci)
+		{
+			ci->second.last = ci->second.current;
+			// let the peak decay so a single spike (eg. a big explosion) does not stick forever
+			ci->second.peak = std::max((ci->second.peak * 7) / 8, ci->second.last);
+			ci->second.current = 0;
+		}
 		lastBigUpdate = curTime;
 	}
 }
@@ -124,6 +132,13 @@ void CTimeProfiler::AddTime(const std::string& name, spring_time time, bool show
 	}
 }
 
+void CTimeProfiler::AddCounter(const std::string& name, int value)
+{
+	GML_STDMUTEX_LOCK_NOPROF(time); // AddCounter
+
+	counters[name].current += value;
+}
+
 void CTimeProfiler::PrintProfilingInfo() const
 {
 	LOG("%35s|%18s|%s",
@@ -137,4 +152,19 @@ void CTimeProfiler::PrintProfilingInfo() const
 				pi->second.total.toSecsf(),
 				pi->second.percent * 100);
 	}
+
+	if (counters.empty())
+		return;
+
+	LOG("%35s|%18s|%s",
+			"Counter",
+			"Last 0.5s",
+			"Peak");
+	std::map<std::string, CTimeProfiler::CounterRecord>::const_iterator ci;
+	for (ci = counters.begin(); ci != counters.end(); ++ci) {
+		LOG("%35s %17d %d",
+				ci->first.c_str(),
+				ci->second.last,
+				ci->second.peak);
+	}
 }
@@ -81,16 +81,26 @@ public:
 		bool newpeak;
 	};
 
+	/// event counts (eg. items processed) shown next to the timers
+	struct CounterRecord {
+		CounterRecord() : current(0), last(0), peak(0) {}
+		int current; ///< sum of the values added since the last 0.5s update
+		int last;    ///< sum over the previous 0.5s
+		int peak;    ///< largest recent <last>, decays by 1/8 each 0.5s update
+	};
+
 	CTimeProfiler();
 	~CTimeProfiler();
 
 	float GetPercent(const char *name);
 	void AddTime(const std::string& name, spring_time time, bool showGraph = false);
+	void AddCounter(const std::string& name, int value);
 	void Update();
 
 	void PrintProfilingInfo() const;
 
 	std::map<std::string,TimeRecord> profile;
+	std::map<std::string,CounterRecord> counters;
 
 private:
 	spring_time lastBigUpdate;
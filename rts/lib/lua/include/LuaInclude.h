@@ -77,18 +77,28 @@ inline bool luaL_optboolean(lua_State* L, int idx, bool def)
 struct luaContextData;
 extern boost::recursive_mutex* getLuaMutex(bool userMode, bool primary);
 
-inline lua_State* LUA_OPEN(luaContextData* lcd = NULL, bool userMode = true, bool primary = true) {
+/// the state takes ownership of allocState (if NULL, a default one is created)
+inline lua_State* LUA_OPEN(luaContextData* lcd = NULL, bool userMode = true, bool primary = true, SLuaAllocState* allocState = NULL) {
+	if (allocState == NULL)
+		allocState = spring_lua_alloc_create(NULL, 256 * 1024 * 1024, true);
+
 	//lua_State* L = lua_open();
-	lua_State* L = lua_newstate(spring_lua_alloc, NULL);
+	lua_State* L = lua_newstate(spring_lua_alloc, allocState);
 	L->lcd = lcd;
 	L->luamutex = getLuaMutex(userMode, primary);
 	return L;
 }
 
 inline void LUA_CLOSE(lua_State *L_Old) {
+	void* allocState = NULL;
+	lua_getallocf(L_Old, &allocState);
+
 	if(L_Old->luamutex != getLuaMutex(false, false) && L_Old->luamutex != getLuaMutex(false, true))
 		delete L_Old->luamutex;
 	lua_close(L_Old);
+
+	// must outlive lua_close, which frees everything through it
+	spring_lua_alloc_destroy(static_cast<SLuaAllocState*>(allocState));
 }
 
 
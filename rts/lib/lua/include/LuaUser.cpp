@@ -1,64 +1,230 @@
 
-#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include "lua.h"
-#include <boost/thread/recursive_mutex.hpp>
+#include "LuaUser.h"
+#include <boost/thread/mutex.hpp>
 #include "System/Platform/Threading.h"
 
-/*boost::recursive_mutex* getLuaMutex(bool userMode, bool primary) {
-#if (LUA_MT_OPT & LUA_MUTEX)
-	if(userMode)
-		return new boost::recursive_mutex();
-	else // LuaGaia & LuaRules will share mutexes to avoid deadlocks during XCalls etc.
-		return primary ? &luaprimmutex : &luasecmutex;
-#else
-		return &luaprimmutex;
-#endif
-}*/
-
-std::map<lua_State*, boost::recursive_mutex*> mutexes;
-std::map<lua_State*, bool> isCoroutine;
-
-void LuaCreateMutex(lua_State* L)
-{
-	//L_New->luamutex = getLuaMutex(bool userMode, bool primary);
-	mutexes[L] = new boost::recursive_mutex();
-}
-void LuaMutexLock(lua_State* L)
-{
-	mutexes[L]->lock(); //FIXME count (un)locks?
-}
-void LuaMutexUnlock(lua_State* L)
+///////////////////////////////////////////////////////////////////////////
+// Allocator
+//
+// Every lua_State gets its own SLuaAllocState (passed as the ud pointer of
+// spring_lua_alloc), so states never contend with each other. Small blocks
+// come from per-size-class freelists carved out of larger chunks, larger
+// ones from malloc. Lua always passes the correct old size of a block, so
+// no per-block header is needed to find its size class again.
+//
+
+static const size_t LUA_ALLOC_CLASS_GRANULARITY = 16; // also the alignment of pooled blocks
+static const size_t LUA_ALLOC_NUM_CLASSES = 16;      // pooled blocks are at most 256 bytes
+static const size_t LUA_ALLOC_MAX_POOLED_SIZE = LUA_ALLOC_CLASS_GRANULARITY * LUA_ALLOC_NUM_CLASSES;
+static const size_t LUA_ALLOC_CHUNK_SIZE = 16 * 1024;
+
+struct SLuaAllocState {
+	SLuaAllocState(const char* _name, size_t _maxAllocedBytes, bool _usePools)
+		: name((_name != NULL)? _name: "")
+		, maxAllocedBytes(_maxAllocedBytes)
+		, usePools(_usePools)
+		, allocedBytes(0)
+		, peakAllocedBytes(0)
+		, pooledBytes(0)
+		, numAllocs(0)
+		, numFailed(0)
+		, numAllocsReported(0)
+	{
+		for (size_t n = 0; n < LUA_ALLOC_NUM_CLASSES; n++) {
+			freeLists[n] = NULL;
+		}
+	}
+
+	~SLuaAllocState() {
+		for (size_t n = 0; n < chunks.size(); n++) {
+			free(chunks[n]);
+		}
+	}
+
+	static size_t GetSizeClass(size_t size) {
+		return ((size + LUA_ALLOC_CLASS_GRANULARITY - 1) / LUA_ALLOC_CLASS_GRANULARITY - 1);
+	}
+	bool IsPooled(size_t size) const {
+		return (usePools && size <= LUA_ALLOC_MAX_POOLED_SIZE);
+	}
+
+	void* PoolAlloc(size_t size) {
+		const size_t sizeClass = GetSizeClass(size);
+
+		if (freeLists[sizeClass] == NULL && !AddChunk(sizeClass))
+			return NULL;
+
+		void* block = freeLists[sizeClass];
+		freeLists[sizeClass] = *reinterpret_cast<void**>(block);
+		return block;
+	}
+	void PoolFree(void* block, size_t size) {
+		const size_t sizeClass = GetSizeClass(size);
+
+		*reinterpret_cast<void**>(block) = freeLists[sizeClass];
+		freeLists[sizeClass] = block;
+	}
+
+	bool AddChunk(size_t sizeClass) {
+		const size_t blockSize = (sizeClass + 1) * LUA_ALLOC_CLASS_GRANULARITY;
+		const size_t numBlocks = LUA_ALLOC_CHUNK_SIZE / blockSize;
+
+		char* chunk = static_cast<char*>(malloc(numBlocks * blockSize));
+
+		if (chunk == NULL)
+			return false;
+
+		// thread the new blocks onto the (empty) freelist
+		for (size_t n = 0; n < numBlocks; n++) {
+			*reinterpret_cast<void**>(chunk + n * blockSize) = (n < (numBlocks - 1))? (chunk + (n + 1) * blockSize): NULL;
+		}
+
+		chunks.push_back(chunk);
+		freeLists[sizeClass] = chunk;
+		pooledBytes += (numBlocks * blockSize);
+		return true;
+	}
+
+	void* Alloc(void* ptr, size_t osize, size_t nsize);
+
+	const std::string name;
+	const size_t maxAllocedBytes;
+	const bool usePools;
+
+	// guards the pools and the stats below, Alloc holds it
+	// throughout; uncontended except while stats are read
+	boost::mutex mutex;
+
+	size_t allocedBytes;
+	size_t peakAllocedBytes;
+	size_t pooledBytes;
+	unsigned int numAllocs;
+	unsigned int numFailed;
+
+	// only written by spring_lua_alloc_get_state_stats
+	unsigned int numAllocsReported;
+
+	void* freeLists[LUA_ALLOC_NUM_CLASSES];
+	std::vector<char*> chunks;
+};
+
+
+void* SLuaAllocState::Alloc(void* ptr, size_t osize, size_t nsize)
 {
-	mutexes[L]->unlock(); //FIXME count (un)locks?
+	boost::mutex::scoped_lock lock(mutex);
+
+	if (nsize == 0) {
+		if (ptr != NULL) {
+			if (IsPooled(osize)) {
+				PoolFree(ptr, osize);
+			} else {
+				free(ptr);
+			}
+		}
+
+		allocedBytes -= osize;
+		return NULL;
+	}
+
+	// only growing can be refused, Lua assumes that shrinking never fails
+	if (nsize > osize && (allocedBytes + (nsize - osize)) > maxAllocedBytes) {
+		numFailed++;
+		return NULL;
+	}
+
+	void* block = NULL;
+
+	const bool oldPooled = (ptr != NULL && IsPooled(osize));
+	const bool newPooled = IsPooled(nsize);
+
+	if (oldPooled && newPooled && GetSizeClass(osize) == GetSizeClass(nsize)) {
+		// still fits into its current block
+		block = ptr;
+	} else if (!oldPooled && !newPooled) {
+		block = realloc(ptr, nsize);
+	} else {
+		block = newPooled? PoolAlloc(nsize): malloc(nsize);
+
+		if (block == NULL) {
+			if (nsize > osize) {
+				numFailed++;
+				return NULL;
+			}
+
+			// shrinking must not fail, keep the old (larger) block; a malloc'ed
+			// one is adopted by the pool since it will be PoolFree'd as <nsize>
+			if (!oldPooled) {
+				chunks.push_back(static_cast<char*>(ptr));
+				pooledBytes += osize;
+			}
+
+			allocedBytes -= osize;
+			allocedBytes += nsize;
+			return ptr;
+		}
+
+		if (ptr != NULL) {
+			memcpy(block, ptr, std::min(osize, nsize));
+
+			if (oldPooled) {
+				PoolFree(ptr, osize);
+			} else {
+				free(ptr);
+			}
+		}
+	}
+
+	if (block == NULL) {
+		numFailed++;
+		return NULL;
+	}
+
+	allocedBytes -= osize;
+	allocedBytes += nsize;
+	peakAllocedBytes = std::max(peakAllocedBytes, allocedBytes);
+	numAllocs += (ptr == NULL);
+	return block;
 }
-void LuaLinkMutex(lua_State* L_parent, lua_State* L_child)
+
+
+// all live allocator states, for the stats functions
+static std::vector<SLuaAllocState*> allocStates;
+static boost::mutex allocStatesMutex;
+
+// allocations of states without their own allocator state (ud == NULL)
+static Threading::AtomicCounterInt64 allocedCur = 0;
+
+
+SLuaAllocState* spring_lua_alloc_create(const char* name, size_t maxAllocedBytes, bool usePools)
 {
-	isCoroutine[L_child] = true;
-	mutexes[L_child] = mutexes[L_parent];
+	SLuaAllocState* state = new SLuaAllocState(name, maxAllocedBytes, usePools);
+
+	boost::mutex::scoped_lock lock(allocStatesMutex);
+	allocStates.push_back(state);
+	return state;
 }
-void LuaDestroyMutex(lua_State* L)
+
+void spring_lua_alloc_destroy(SLuaAllocState* state)
 {
-	if (!L)
+	if (state == NULL)
 		return;
 
-	if (isCoroutine.find(L) != isCoroutine.end()) {
-		mutexes.erase(L);
-		isCoroutine.erase(L);
-	} else {
-		assert(isCoroutine.find(L) == isCoroutine.end());
-		assert(mutexes.find(L) != mutexes.end());
-		//delete mutexes[L];
-		mutexes.erase(L);
-		isCoroutine.erase(L);
-		//TODO erase all children too?
+	{
+		boost::mutex::scoped_lock lock(allocStatesMutex);
+		allocStates.erase(std::find(allocStates.begin(), allocStates.end(), state));
 	}
-}
 
-static Threading::AtomicCounterInt64 allocedCur = 0;
+	delete state;
+}
 
 void* spring_lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize)
 {
-	(void)ud;
+	if (ud != NULL)
+		return (static_cast<SLuaAllocState*>(ud))->Alloc(ptr, osize, nsize);
 
 	if (nsize == 0) {
 		allocedCur -= osize;
@@ -79,5 +245,39 @@ void* spring_lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize)
 
 void spring_lua_alloc_get_stats(int* allocedBytes)
 {
+	boost::mutex::scoped_lock lock(allocStatesMutex);
+
 	*allocedBytes = allocedCur;
+
+	for (size_t n = 0; n < allocStates.size(); n++) {
+		boost::mutex::scoped_lock stateLock(allocStates[n]->mutex);
+		*allocedBytes += allocStates[n]->allocedBytes;
+	}
+}
+
+void spring_lua_alloc_get_state_stats(std::vector<SLuaAllocStats>* stats, bool resetNumAllocs)
+{
+	boost::mutex::scoped_lock lock(allocStatesMutex);
+
+	stats->clear();
+	stats->reserve(allocStates.size());
+
+	for (size_t n = 0; n < allocStates.size(); n++) {
+		SLuaAllocState* state = allocStates[n];
+		boost::mutex::scoped_lock stateLock(state->mutex);
+
+		SLuaAllocStats s;
+		s.name             = state->name;
+		s.allocedBytes     = state->allocedBytes;
+		s.peakAllocedBytes = state->peakAllocedBytes;
+		s.pooledBytes      = state->pooledBytes;
+		s.maxAllocedBytes  = state->maxAllocedBytes;
+		s.numAllocs        = state->numAllocs - state->numAllocsReported;
+		s.numFailed        = state->numFailed;
+
+		if (resetNumAllocs)
+			state->numAllocsReported += s.numAllocs;
+
+		stats->push_back(s);
+	}
 }
@@ -1,7 +1,28 @@
 #ifndef SPRING_LUA_USER_H
 #define SPRING_LUA_USER_H
 
+#include <string>
+#include <vector>
+
+struct SLuaAllocState;
+
+/// per-state allocator statistics, see spring_lua_alloc_get_state_stats
+struct SLuaAllocStats {
+	std::string name;
+	size_t allocedBytes;     ///< bytes currently in use by the state
+	size_t peakAllocedBytes;
+	size_t pooledBytes;      ///< bytes held by the size-class pools (in use or free)
+	size_t maxAllocedBytes;  ///< allocations beyond this fail with a Lua memory error
+	unsigned int numAllocs;  ///< new blocks since the previous call with resetNumAllocs
+	unsigned int numFailed;  ///< refused allocations since the state was created
+};
+
+/// ud for spring_lua_alloc, released by spring_lua_alloc_destroy after lua_close
+extern SLuaAllocState* spring_lua_alloc_create(const char* name, size_t maxAllocedBytes, bool usePools);
+extern void spring_lua_alloc_destroy(SLuaAllocState* state);
+
 extern void* spring_lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize);
 extern void spring_lua_alloc_get_stats(int* allocedBytes);
+extern void spring_lua_alloc_get_state_stats(std::vector<SLuaAllocStats>* stats, bool resetNumAllocs);
 
 #endif // SPRING_LUA_USER_H
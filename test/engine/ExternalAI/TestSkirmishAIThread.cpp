@@ -0,0 +1,342 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ExternalAI/SkirmishAIThread.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE SkirmishAIThread
+#include <boost/test/unit_test.hpp>
+
+// the worker names itself, nothing else is needed from Threading
+namespace Threading {
+	void SetThreadName(std::string newname) {}
+}
+
+
+/// what the AIs (worker) and the engine (test thread) did, in order
+class CallLog {
+public:
+	void Add(const std::string& entry) {
+		boost::mutex::scoped_lock lock(mutex);
+		entries.push_back(entry);
+	}
+	std::vector<std::string> Get() {
+		boost::mutex::scoped_lock lock(mutex);
+		return entries;
+	}
+	bool Contains(const std::string& entry) {
+		const std::vector<std::string> e = Get();
+		return (std::find(e.begin(), e.end(), entry) != e.end());
+	}
+	/// @return false if <entry> was not added within a few seconds
+	bool WaitFor(const std::string& entry) {
+		for (int n = 0; n < 5000; n++) {
+			if (Contains(entry))
+				return true;
+
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+		}
+		return false;
+	}
+
+private:
+	boost::mutex mutex;
+	std::vector<std::string> entries;
+};
+
+
+static void AddEntry(CallLog* log, std::string entry) { log->Add(entry); }
+static void Sleep(int ms) { boost::this_thread::sleep(boost::posix_time::milliseconds(ms)); }
+static void Throw(std::string what) { throw std::runtime_error(what); }
+
+static void AddThreadEntry(CallLog* log, boost::thread::id engineThreadId, std::string entry) {
+	log->Add(entry + ((boost::this_thread::get_id() == engineThreadId)? " (engine)": " (worker)"));
+}
+
+static int GetAnswer() { return 42; }
+static void InvokeAnswer(CSkirmishAIThread* t, CallLog* log) {
+	const int answer = t->Invoke<int>(1, &GetAnswer);
+	log->Add((answer == 42)? "answer": "no answer");
+}
+
+
+static void InvokeEntry(CSkirmishAIThread* t, CallLog* log, boost::thread::id engineThreadId) {
+	t->Invoke(1, boost::bind(&AddThreadEntry, log, engineThreadId, std::string("invoke")));
+}
+
+static void EnterWorld(CSkirmishAIThread* t, CallLog* log, std::string entry) {
+	CSkirmishAIThread::WorldLock lock(t);
+	log->Add(entry);
+}
+
+static void LogWhileSleeping(CallLog* log, std::string entry, int ms) {
+	log->Add(entry + " start");
+	Sleep(ms);
+	log->Add(entry + " done");
+}
+
+static void QueueCallThenInvoke(CSkirmishAIThread* t, CallLog* log, boost::thread::id engineThreadId) {
+	CSkirmishAIThread::WorldLock lock(t);
+	t->QueueCall(1, boost::bind(&AddThreadEntry, log, engineThreadId, std::string("call")));
+	t->Invoke(1, boost::bind(&AddThreadEntry, log, engineThreadId, std::string("invoke")));
+	log->Add("returned");
+}
+
+
+BOOST_AUTO_TEST_CASE(EventOrder)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("1a")));
+	t.QueueEvent(2, 0, boost::bind(&AddEntry, &log, std::string("2a")));
+	t.QueueEvent(1, 1, boost::bind(&AddEntry, &log, std::string("1b")));
+	t.Flush();
+
+	const std::vector<std::string> e = log.Get();
+	BOOST_REQUIRE(e.size() == 3);
+	BOOST_CHECK(e[0] == "1a");
+	BOOST_CHECK(e[1] == "2a");
+	BOOST_CHECK(e[2] == "1b");
+}
+
+BOOST_AUTO_TEST_CASE(RemoveEvents)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	{
+		CSkirmishAIThread::ScopedPause pause(&t);
+
+		t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("1a")));
+		t.QueueEvent(2, 0, boost::bind(&AddEntry, &log, std::string("2a")));
+		t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("1b")));
+		t.RemoveEvents(1);
+
+		Sleep(20);
+		BOOST_CHECK(log.Get().empty());
+	}
+
+	t.Flush();
+
+	const std::vector<std::string> e = log.Get();
+	BOOST_REQUIRE(e.size() == 1);
+	BOOST_CHECK(e[0] == "2a");
+}
+
+BOOST_AUTO_TEST_CASE(InvokeRunsOnEngineThread)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+	const boost::thread::id engineThreadId = boost::this_thread::get_id();
+
+	t.QueueEvent(1, 0, boost::bind(&InvokeAnswer, &t, &log));
+	t.QueueEvent(1, 0, boost::bind(&InvokeEntry, &t, &log, engineThreadId));
+
+	// nothing but Poll runs the requests here
+	for (int n = 0; n < 5000 && log.Get().size() < 2; n++) {
+		t.Poll();
+		Sleep(1);
+	}
+
+	const std::vector<std::string> e = log.Get();
+	BOOST_REQUIRE(e.size() == 2);
+	BOOST_CHECK(e[0] == "answer");
+	BOOST_CHECK(e[1] == "invoke (engine)");
+}
+
+BOOST_AUTO_TEST_CASE(QueuedCallsRunBeforeInvoke)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+	const boost::thread::id engineThreadId = boost::this_thread::get_id();
+
+	t.QueueEvent(1, 0, boost::bind(&QueueCallThenInvoke, &t, &log, engineThreadId));
+	t.Flush();
+
+	const std::vector<std::string> e = log.Get();
+	BOOST_REQUIRE(e.size() == 3);
+	BOOST_CHECK(e[0] == "call (engine)");
+	BOOST_CHECK(e[1] == "invoke (engine)");
+	BOOST_CHECK(e[2] == "returned");
+}
+
+BOOST_AUTO_TEST_CASE(QueuedCallsRunWhenEngineTakesWorld)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+	const boost::thread::id engineThreadId = boost::this_thread::get_id();
+
+	t.QueueEvent(1, 0, boost::bind(&CSkirmishAIThread::QueueCall, &t, 1, CSkirmishAIThread::Func(boost::bind(&AddThreadEntry, &log, engineThreadId, std::string("call")))));
+	t.Flush();
+	BOOST_CHECK(log.Get().empty());
+
+	t.LockWorld(1);
+	BOOST_CHECK(log.Contains("call (engine)"));
+	t.UnlockWorld();
+
+	// calls made on the engine thread itself run right away
+	t.QueueCall(1, boost::bind(&AddEntry, &log, std::string("direct")));
+	BOOST_CHECK(log.Contains("direct"));
+}
+
+BOOST_AUTO_TEST_CASE(WorldExcludesWorker)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	t.LockWorld(0);
+	t.LockWorld(0); // reentrant
+	t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("event")));
+	t.QueueEvent(1, 0, boost::bind(&EnterWorld, &t, &log, std::string("world")));
+
+	// events run while the engine holds the world, callbacks do not
+	BOOST_CHECK(log.WaitFor("event"));
+	Sleep(20);
+	BOOST_CHECK(!log.Contains("world"));
+	t.UnlockWorld();
+	Sleep(20);
+	BOOST_CHECK(!log.Contains("world"));
+	t.UnlockWorld();
+
+	BOOST_CHECK(log.WaitFor("world"));
+
+	// on the engine thread the lock is a no-op
+	CSkirmishAIThread::WorldLock lock(&t);
+	t.Flush();
+}
+
+BOOST_AUTO_TEST_CASE(LagWithinLimitDoesNotStall)
+{
+	CallLog log;
+	CSkirmishAIThread t(2);
+
+	t.QueueEvent(1, 0, boost::bind(&LogWhileSleeping, &log, std::string("event"), 100));
+	BOOST_CHECK(log.WaitFor("event start"));
+
+	t.LockWorld(2);
+	BOOST_CHECK(!log.Contains("event done"));
+	t.UnlockWorld();
+	t.Flush();
+
+	std::map<int, CSkirmishAIThread::Stats> stats;
+	t.GetStats(stats);
+	BOOST_CHECK(stats[1].numStalls == 0);
+}
+
+BOOST_AUTO_TEST_CASE(LagBeyondLimitStalls)
+{
+	CallLog log;
+	CSkirmishAIThread t(2);
+
+	t.QueueEvent(1, 0, boost::bind(&LogWhileSleeping, &log, std::string("event"), 50));
+	t.QueueEvent(2, 0, boost::bind(&AddEntry, &log, std::string("next")));
+	t.QueueEvent(2, 4, boost::bind(&LogWhileSleeping, &log, std::string("recent"), 50));
+	BOOST_CHECK(log.WaitFor("event start"));
+
+	// the events of frame 0 are too old for frame 3, the one of frame 4 is not
+	t.LockWorld(3);
+	BOOST_CHECK(log.Contains("event done"));
+	BOOST_CHECK(log.Contains("next"));
+	t.UnlockWorld();
+	t.Flush();
+
+	std::map<int, CSkirmishAIThread::Stats> stats;
+	t.GetStats(stats);
+	BOOST_CHECK(stats[1].numStalls == 1);
+	BOOST_CHECK(stats[1].busyTime.toMilliSecs() >= 40);
+}
+
+BOOST_AUTO_TEST_CASE(LagIsMeasuredInFrames)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	{
+		CSkirmishAIThread::ScopedPause pause(&t);
+
+		t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("event")));
+		t.LockWorld(3);
+		t.UnlockWorld();
+	}
+
+	t.Flush();
+
+	std::map<int, CSkirmishAIThread::Stats> stats;
+	t.GetStats(stats);
+	BOOST_CHECK(stats[1].maxLag == 3);
+
+	// collected since the last call
+	t.GetStats(stats);
+	BOOST_CHECK(stats.empty());
+}
+
+BOOST_AUTO_TEST_CASE(PauseWaitsForCurrentEvent)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	t.QueueEvent(1, 0, boost::bind(&LogWhileSleeping, &log, std::string("event"), 50));
+	t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("next")));
+	BOOST_CHECK(log.WaitFor("event start"));
+
+	{
+		CSkirmishAIThread::ScopedPause pause(&t);
+
+		BOOST_CHECK(log.Contains("event done"));
+		Sleep(20);
+		BOOST_CHECK(!log.Contains("next"));
+	}
+
+	BOOST_CHECK(log.WaitFor("next"));
+}
+
+BOOST_AUTO_TEST_CASE(PauseLendsWorld)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	t.LockWorld(0);
+	t.QueueEvent(1, 0, boost::bind(&EnterWorld, &t, &log, std::string("world")));
+	Sleep(20); // let the worker block on the world
+
+	{
+		// must not deadlock on the callback waiting for the world
+		CSkirmishAIThread::ScopedPause pause(&t);
+	}
+
+	t.Flush();
+	BOOST_CHECK(log.Contains("world"));
+	t.UnlockWorld();
+}
+
+BOOST_AUTO_TEST_CASE(FailedAIGetsNoMoreEvents)
+{
+	CallLog log;
+	CSkirmishAIThread t(10);
+
+	t.QueueEvent(1, 0, boost::bind(&Throw, std::string("boom")));
+	t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("1")));
+	t.QueueEvent(2, 0, boost::bind(&AddEntry, &log, std::string("2")));
+	t.Flush();
+
+	std::vector< std::pair<int, std::string> > failed;
+	t.GetFailedAIs(failed);
+	BOOST_REQUIRE(failed.size() == 1);
+	BOOST_CHECK(failed[0].first == 1);
+	BOOST_CHECK(failed[0].second == "boom");
+
+	const std::vector<std::string> e = log.Get();
+	BOOST_REQUIRE(e.size() == 1);
+	BOOST_CHECK(e[0] == "2");
+
+	// a new AI with the same ID (see CEngineOutHandler::DestroySkirmishAI)
+	t.RemoveEvents(1);
+	t.QueueEvent(1, 0, boost::bind(&AddEntry, &log, std::string("1 again")));
+	t.Flush();
+	BOOST_CHECK(log.Contains("1 again"));
+}
@@ -0,0 +1,327 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Lua/LuaOpenGLBatch.h"
+
+#include <vector>
+
+#define BOOST_TEST_MODULE LuaOpenGLBatch
+#include <boost/test/unit_test.hpp>
+
+
+/******************************************************************************/
+/******************************************************************************/
+//
+//  Recording GL stubs, only the functions used by LuaOpenGLBatch
+//
+
+struct Vertex {
+	Vertex(const float* p, const float* c): x(p[0]), y(p[1]), z(p[2]), r(c[0]), g(c[1]), b(c[2]), a(c[3]) {}
+
+	float x, y, z;
+	float r, g, b, a;
+};
+
+struct DrawCall {
+	DrawCall(GLenum _mode, bool _immediate): mode(_mode), immediate(_immediate) {}
+
+	GLenum mode;
+	/// glBegin / glEnd or glDrawArrays
+	bool immediate;
+	std::vector<Vertex> vertices;
+};
+
+static struct GLState {
+	void Reset() {
+		*this = GLState();
+		color[0] = color[1] = color[2] = color[3] = 1.0f;
+	}
+
+	std::vector<DrawCall> draws;
+	bool inBeginEnd;
+
+	bool vertexArray;
+	bool colorArray;
+	const GLubyte* vertexPointer;
+	const GLubyte* colorPointer;
+	GLsizei vertexStride;
+	GLsizei colorStride;
+
+	float color[4];
+	int numColorCalls;
+} gl;
+
+static void AddVertex(const float* pos)
+{
+	BOOST_REQUIRE(gl.inBeginEnd);
+	gl.draws.back().vertices.push_back(Vertex(pos, gl.color));
+}
+
+extern "C" {
+	void glBegin(GLenum mode) {
+		BOOST_REQUIRE(!gl.inBeginEnd);
+		gl.inBeginEnd = true;
+		gl.draws.push_back(DrawCall(mode, true));
+	}
+	void glEnd() {
+		BOOST_REQUIRE(gl.inBeginEnd);
+		gl.inBeginEnd = false;
+	}
+
+	void glVertex3f(GLfloat x, GLfloat y, GLfloat z) { const float pos[3] = {x, y, z}; AddVertex(pos); }
+	void glVertex3fv(const GLfloat* v) { AddVertex(v); }
+	void glColor4fv(const GLfloat* v) { std::copy(v, v + 4, gl.color); gl.numColorCalls++; }
+	void glNormal3fv(const GLfloat* v) {}
+	void glTexCoord2fv(const GLfloat* v) {}
+
+	void glEnableClientState(GLenum cap) {
+		if (cap == GL_VERTEX_ARRAY) { gl.vertexArray = true; }
+		if (cap == GL_COLOR_ARRAY)  { gl.colorArray  = true; }
+	}
+	void glDisableClientState(GLenum cap) {
+		if (cap == GL_VERTEX_ARRAY) { gl.vertexArray = false; }
+		if (cap == GL_COLOR_ARRAY)  { gl.colorArray  = false; }
+	}
+	void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* ptr) {
+		gl.vertexPointer = static_cast<const GLubyte*>(ptr);
+		gl.vertexStride = stride;
+	}
+	void glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* ptr) {
+		gl.colorPointer = static_cast<const GLubyte*>(ptr);
+		gl.colorStride = stride;
+	}
+	void glNormalPointer(GLenum type, GLsizei stride, const GLvoid* ptr) {}
+	void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* ptr) {}
+
+	void glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+		BOOST_REQUIRE(!gl.inBeginEnd);
+		BOOST_REQUIRE(gl.vertexArray);
+
+		gl.draws.push_back(DrawCall(mode, false));
+
+		for (GLsizei n = first; n < (first + count); n++) {
+			const float* pos = reinterpret_cast<const float*>(gl.vertexPointer + n * gl.vertexStride);
+			const float* col = gl.colorArray? reinterpret_cast<const float*>(gl.colorPointer + n * gl.colorStride): gl.color;
+			gl.draws.back().vertices.push_back(Vertex(pos, col));
+		}
+	}
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+struct BatchFixture {
+	BatchFixture() { gl.Reset(); }
+
+	void Quad(float x) {
+		batch.Begin(GL_QUADS);
+		batch.Vertex(x, 0.0f, 0.0f);
+		batch.Vertex(x, 1.0f, 0.0f);
+		batch.Vertex(x, 1.0f, 1.0f);
+		batch.Vertex(x, 0.0f, 1.0f);
+		batch.End();
+	}
+
+	LuaOpenGLBatch batch;
+};
+
+static const float red[4]  = {1.0f, 0.0f, 0.0f, 1.0f};
+static const float blue[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+
+
+BOOST_FIXTURE_TEST_CASE(MergeBlocks, BatchFixture)
+{
+	Quad(0.0f);
+	Quad(1.0f);
+	Quad(2.0f);
+
+	// nothing is drawn before the next state boundary
+	BOOST_CHECK(gl.draws.empty());
+
+	batch.Interrupt();
+
+	BOOST_REQUIRE(gl.draws.size() == 1);
+	BOOST_CHECK(!gl.draws[0].immediate);
+	BOOST_CHECK(gl.draws[0].mode == GL_QUADS);
+	BOOST_REQUIRE(gl.draws[0].vertices.size() == 12);
+	BOOST_CHECK(gl.draws[0].vertices[0].x == 0.0f);
+	BOOST_CHECK(gl.draws[0].vertices[4].x == 1.0f);
+	BOOST_CHECK(gl.draws[0].vertices[8].x == 2.0f);
+	BOOST_CHECK(!gl.vertexArray && !gl.colorArray);
+
+	// an empty batch draws nothing
+	batch.Interrupt();
+	BOOST_CHECK(gl.draws.size() == 1);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(ModeChangeFlushes, BatchFixture)
+{
+	batch.Begin(GL_LINES);
+	batch.Vertex(0.0f, 0.0f, 0.0f);
+	batch.Vertex(1.0f, 0.0f, 0.0f);
+	batch.End();
+
+	Quad(0.0f);
+	batch.Interrupt();
+
+	BOOST_REQUIRE(gl.draws.size() == 2);
+	BOOST_CHECK(gl.draws[0].mode == GL_LINES && gl.draws[0].vertices.size() == 2);
+	BOOST_CHECK(gl.draws[1].mode == GL_QUADS && gl.draws[1].vertices.size() == 4);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(DependentPrimitivesAreNotMerged, BatchFixture)
+{
+	for (int n = 0; n < 2; n++) {
+		batch.Begin(GL_LINE_STRIP);
+		batch.Vertex(0.0f, 0.0f, 0.0f);
+		batch.Vertex(1.0f, 0.0f, 0.0f);
+		batch.Vertex(1.0f, 1.0f, 0.0f);
+		batch.End();
+
+		// strips are drawn at the end of their block
+		BOOST_REQUIRE(gl.draws.size() == size_t(n + 1));
+		BOOST_CHECK(gl.draws[n].mode == GL_LINE_STRIP);
+		BOOST_CHECK(gl.draws[n].vertices.size() == 3);
+	}
+}
+
+
+BOOST_FIXTURE_TEST_CASE(IncompletePrimitiveIsDropped, BatchFixture)
+{
+	batch.Begin(GL_TRIANGLES);
+	for (int n = 0; n < 5; n++) {
+		batch.Vertex(float(n), 0.0f, 0.0f);
+	}
+	batch.End();
+
+	Quad(0.0f);
+	batch.Begin(GL_TRIANGLES);
+	batch.Vertex(0.0f, 0.0f, 0.0f);
+	batch.End();
+	batch.Interrupt();
+
+	BOOST_REQUIRE(gl.draws.size() == 2);
+	BOOST_CHECK(gl.draws[0].vertices.size() == 3);
+	BOOST_CHECK(gl.draws[1].mode == GL_QUADS && gl.draws[1].vertices.size() == 4);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(Passthrough, BatchFixture)
+{
+	Quad(0.0f);
+
+	batch.Begin(GL_QUADS);
+	batch.Vertex(1.0f, 0.0f, 0.0f);
+	batch.Vertex(1.0f, 1.0f, 0.0f);
+
+	// a call that can not be recorded inside the open block
+	batch.Interrupt();
+
+	BOOST_CHECK(batch.InBeginEnd());
+	BOOST_CHECK(!batch.IsRecording());
+	BOOST_CHECK(gl.inBeginEnd);
+
+	batch.Vertex(1.0f, 1.0f, 1.0f);
+	batch.Vertex(1.0f, 0.0f, 1.0f);
+	batch.End();
+
+	BOOST_CHECK(!batch.InBeginEnd());
+	BOOST_CHECK(!gl.inBeginEnd);
+
+	// the merged block in front is drawn first, then the open one in immediate mode
+	BOOST_REQUIRE(gl.draws.size() == 2);
+	BOOST_CHECK(!gl.draws[0].immediate && gl.draws[0].vertices.size() == 4);
+	BOOST_CHECK(gl.draws[0].vertices[0].x == 0.0f);
+	BOOST_CHECK(gl.draws[1].immediate && gl.draws[1].mode == GL_QUADS);
+	BOOST_REQUIRE(gl.draws[1].vertices.size() == 4);
+	BOOST_CHECK(gl.draws[1].vertices[0].y == 0.0f && gl.draws[1].vertices[0].z == 0.0f);
+	BOOST_CHECK(gl.draws[1].vertices[1].y == 1.0f && gl.draws[1].vertices[1].z == 0.0f);
+	BOOST_CHECK(gl.draws[1].vertices[3].y == 0.0f && gl.draws[1].vertices[3].z == 1.0f);
+
+	// recording resumes with the next block
+	Quad(2.0f);
+	BOOST_CHECK(gl.draws.size() == 2);
+	batch.Interrupt();
+	BOOST_CHECK(gl.draws.size() == 3);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(RecordedColors, BatchFixture)
+{
+	batch.Color(red);
+	Quad(0.0f);
+	batch.Color(blue);
+	Quad(1.0f);
+
+	// the colors travel with the vertices instead of being set one at a time
+	BOOST_CHECK(gl.numColorCalls == 1);
+
+	batch.Interrupt();
+
+	BOOST_REQUIRE(gl.draws.size() == 1);
+	BOOST_REQUIRE(gl.draws[0].vertices.size() == 8);
+	BOOST_CHECK(gl.draws[0].vertices[0].r == 1.0f && gl.draws[0].vertices[0].b == 0.0f);
+	BOOST_CHECK(gl.draws[0].vertices[7].r == 0.0f && gl.draws[0].vertices[7].b == 1.0f);
+
+	// the current color is the last one set, as in immediate mode
+	BOOST_CHECK(gl.color[0] == 0.0f && gl.color[2] == 1.0f);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(UnknownColorStaysWithGL, BatchFixture)
+{
+	// set by something the batch does not know about (eg. a display list)
+	const float green[4] = {0.0f, 1.0f, 0.0f, 1.0f};
+	glColor4fv(green);
+
+	Quad(0.0f);
+	batch.Interrupt();
+
+	BOOST_REQUIRE(gl.draws.size() == 1);
+	BOOST_CHECK(gl.draws[0].vertices[0].g == 1.0f && gl.draws[0].vertices[0].r == 0.0f);
+	BOOST_CHECK(gl.numColorCalls == 1);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(ColorChangeBeforeUnrecordedVertices, BatchFixture)
+{
+	// pending vertices use the GL color, it has to be drawn before the color changes
+	Quad(0.0f);
+	batch.Color(red);
+
+	BOOST_REQUIRE(gl.draws.size() == 1);
+	BOOST_CHECK(gl.draws[0].vertices[0].g == 1.0f);
+	BOOST_CHECK(gl.color[0] == 1.0f && gl.color[1] == 0.0f);
+
+	Quad(1.0f);
+	batch.Interrupt();
+
+	BOOST_REQUIRE(gl.draws.size() == 2);
+	BOOST_CHECK(gl.draws[1].vertices[0].r == 1.0f && gl.draws[1].vertices[0].g == 0.0f);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(ColorChangeInsideOpenBlock, BatchFixture)
+{
+	batch.Begin(GL_QUADS);
+	batch.Vertex(0.0f, 0.0f, 0.0f);
+	batch.Vertex(0.0f, 1.0f, 0.0f);
+
+	// the first vertices use the GL color, the block has to switch to immediate mode
+	batch.Color(red);
+
+	BOOST_CHECK(!batch.IsRecording());
+	BOOST_CHECK(gl.color[0] == 1.0f && gl.color[1] == 0.0f);
+
+	batch.Vertex(0.0f, 1.0f, 1.0f);
+	batch.Vertex(0.0f, 0.0f, 1.0f);
+	batch.End();
+
+	BOOST_REQUIRE(gl.draws.size() == 1);
+	BOOST_REQUIRE(gl.draws[0].vertices.size() == 4);
+	BOOST_CHECK(gl.draws[0].immediate);
+	BOOST_CHECK(gl.draws[0].vertices[1].g == 1.0f);
+	BOOST_CHECK(gl.draws[0].vertices[2].r == 1.0f && gl.draws[0].vertices[2].g == 0.0f);
+}
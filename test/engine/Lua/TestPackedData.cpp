@@ -0,0 +1,117 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Lua/LuaUtils.h"
+
+#include <string>
+#include <sstream>
+
+#define BOOST_TEST_MODULE PackedData
+#include <boost/test/unit_test.hpp>
+
+
+struct LuaStates {
+	LuaStates(): src(luaL_newstate()), dst(luaL_newstate()) {}
+	~LuaStates() { lua_close(src); lua_close(dst); }
+
+	lua_State* src;
+	lua_State* dst;
+};
+
+
+static std::string GetTestString(int n)
+{
+	std::ostringstream buf;
+	buf << "string" << n;
+	return buf.str();
+}
+
+
+static void RoundTrip(LuaStates& states, int count)
+{
+	LuaUtils::PackedData packed;
+
+	BOOST_CHECK(LuaUtils::Pack(packed, states.src, count) == count);
+	BOOST_CHECK(packed.size() == count);
+	BOOST_CHECK(LuaUtils::Unpack(packed, states.dst) == count);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(ManyStrings, LuaStates)
+{
+	// enough distinct strings to grow the packer's string table several times
+	const int numStrings = 1000;
+
+	lua_createtable(src, numStrings, 0);
+	for (int n = 1; n <= numStrings; n++) {
+		lua_pushsstring(src, GetTestString(n));
+		lua_rawseti(src, -2, n);
+	}
+
+	RoundTrip(*this, 1);
+
+	BOOST_REQUIRE(lua_istable(dst, -1));
+	BOOST_CHECK(int(lua_objlen(dst, -1)) == numStrings);
+
+	for (int n = 1; n <= numStrings; n++) {
+		lua_rawgeti(dst, -1, n);
+		BOOST_CHECK(lua_israwstring(dst, -1));
+		BOOST_CHECK(lua_tostring(dst, -1) == GetTestString(n));
+		lua_pop(dst, 1);
+	}
+}
+
+
+BOOST_FIXTURE_TEST_CASE(RepeatedStrings, LuaStates)
+{
+	const int numStrings = 100;
+
+	// every string is used as a key and as a value
+	lua_newtable(src);
+	for (int n = 1; n <= numStrings; n++) {
+		lua_pushsstring(src, GetTestString(n));
+		lua_pushsstring(src, GetTestString(numStrings - n + 1));
+		lua_rawset(src, -3);
+	}
+
+	RoundTrip(*this, 1);
+
+	BOOST_REQUIRE(lua_istable(dst, -1));
+
+	for (int n = 1; n <= numStrings; n++) {
+		lua_pushsstring(dst, GetTestString(n));
+		lua_rawget(dst, -2);
+		BOOST_CHECK(lua_israwstring(dst, -1));
+		BOOST_CHECK(lua_tostring(dst, -1) == GetTestString(numStrings - n + 1));
+		lua_pop(dst, 1);
+	}
+}
+
+
+BOOST_FIXTURE_TEST_CASE(MixedValues, LuaStates)
+{
+	lua_pushnil(src);
+	lua_pushboolean(src, true);
+	lua_pushnumber(src, 42.5);
+	lua_pushstring(src, "value");
+
+	lua_newtable(src);
+	lua_pushstring(src, "nested");
+	lua_newtable(src);
+	lua_pushboolean(src, false);
+	lua_rawseti(src, -2, 1);
+	lua_rawset(src, -3);
+
+	RoundTrip(*this, 5);
+
+	BOOST_REQUIRE(lua_gettop(dst) == 5);
+	BOOST_CHECK(lua_isnil(dst, 1));
+	BOOST_CHECK(lua_isboolean(dst, 2) && lua_toboolean(dst, 2));
+	BOOST_CHECK(lua_tonumber(dst, 3) == 42.5);
+	BOOST_CHECK(std::string(lua_tostring(dst, 4)) == "value");
+
+	BOOST_REQUIRE(lua_istable(dst, 5));
+	lua_getfield(dst, 5, "nested");
+	BOOST_REQUIRE(lua_istable(dst, -1));
+	lua_rawgeti(dst, -1, 1);
+	BOOST_CHECK(lua_isboolean(dst, -1) && !lua_toboolean(dst, -1));
+}
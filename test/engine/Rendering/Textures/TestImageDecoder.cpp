@@ -0,0 +1,371 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Rendering/Textures/ImageDecoder.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#define BOOST_TEST_MODULE ImageDecoder
+#include <boost/test/unit_test.hpp>
+
+using ImageDecoder::DecodedImage;
+
+typedef std::vector<unsigned char> Bytes;
+
+
+static void AppendBE32(Bytes& out, unsigned int v)
+{
+	out.push_back((v >> 24) & 0xFF);
+	out.push_back((v >> 16) & 0xFF);
+	out.push_back((v >>  8) & 0xFF);
+	out.push_back((v      ) & 0xFF);
+}
+
+static void AppendChunk(Bytes& png, const char* type, const Bytes& data)
+{
+	AppendBE32(png, data.size());
+
+	const size_t typePos = png.size();
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data.begin(), data.end());
+
+	AppendBE32(png, crc32(crc32(0L, Z_NULL, 0), &png[typePos], png.size() - typePos));
+}
+
+static int Paeth(int a, int b, int c)
+{
+	const int p = a + b - c;
+	const int pa = std::abs(p - a);
+	const int pb = std::abs(p - b);
+	const int pc = std::abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return a;
+	if (pb <= pc)
+		return b;
+
+	return c;
+}
+
+/// filters every row of <rows> with filters[y % filters.size()]
+static Bytes FilterRows(const Bytes& rows, size_t stride, size_t bpp, const std::vector<int>& filters)
+{
+	const size_t height = rows.size() / stride;
+	Bytes raw;
+
+	for (size_t y = 0; y < height; ++y) {
+		const unsigned char* line = &rows[y * stride];
+		const unsigned char* prev = (y > 0)? (line - stride): NULL;
+		const int filter = filters[y % filters.size()];
+
+		raw.push_back(filter);
+
+		for (size_t i = 0; i < stride; ++i) {
+			const int a = (i >= bpp)? line[i - bpp]: 0;
+			const int b = (prev != NULL)? prev[i]: 0;
+			const int c = (prev != NULL && i >= bpp)? prev[i - bpp]: 0;
+
+			int pred = 0;
+
+			switch (filter) {
+				case 1: { pred = a; } break;
+				case 2: { pred = b; } break;
+				case 3: { pred = (a + b) >> 1; } break;
+				case 4: { pred = Paeth(a, b, c); } break;
+				default: {} break;
+			}
+
+			raw.push_back((line[i] - pred) & 0xFF);
+		}
+	}
+
+	return raw;
+}
+
+static Bytes MakePNG(int width, int height, int bitDepth, int colorType, const Bytes& raw, const Bytes& palette = Bytes(), int interlace = 0)
+{
+	static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+	Bytes png(signature, signature + 8);
+	Bytes ihdr;
+
+	AppendBE32(ihdr, width);
+	AppendBE32(ihdr, height);
+	ihdr.push_back(bitDepth);
+	ihdr.push_back(colorType);
+	ihdr.push_back(0); // compression
+	ihdr.push_back(0); // filter method
+	ihdr.push_back(interlace);
+	AppendChunk(png, "IHDR", ihdr);
+
+	if (!palette.empty())
+		AppendChunk(png, "PLTE", palette);
+
+	uLongf idatSize = compressBound(raw.size());
+	Bytes idat(idatSize);
+	compress(&idat[0], &idatSize, &raw[0], raw.size());
+	idat.resize(idatSize);
+
+	// split into two chunks, the decoder has to join them
+	AppendChunk(png, "IDAT", Bytes(idat.begin(), idat.begin() + idat.size() / 2));
+	AppendChunk(png, "IDAT", Bytes(idat.begin() + idat.size() / 2, idat.end()));
+	AppendChunk(png, "IEND", Bytes());
+	return png;
+}
+
+static Bytes MakeTestPixels(size_t count)
+{
+	Bytes pixels(count);
+
+	for (size_t i = 0; i < count; ++i)
+		pixels[i] = (i * 37 + 11) & 0xFF;
+
+	return pixels;
+}
+
+static Bytes MakeTGAHeader(int imageType, int width, int height, int bitsPerPixel, int descriptor)
+{
+	Bytes tga(18, 0);
+	tga[2]  = imageType;
+	tga[12] = width & 0xFF;
+	tga[13] = width >> 8;
+	tga[14] = height & 0xFF;
+	tga[15] = height >> 8;
+	tga[16] = bitsPerPixel;
+	tga[17] = descriptor;
+	return tga;
+}
+
+
+BOOST_AUTO_TEST_CASE(PNG_RGB)
+{
+	const int width = 5;
+	const int height = 3;
+	const Bytes pixels = MakeTestPixels(width * height * 3);
+	const Bytes png = MakePNG(width, height, 8, 2, FilterRows(pixels, width * 3, 3, std::vector<int>(1, 0)));
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodePNG(&png[0], png.size(), img));
+	BOOST_CHECK(img.xsize == width);
+	BOOST_CHECK(img.ysize == height);
+	BOOST_CHECK(img.channels == 3);
+	BOOST_CHECK(img.pixels == pixels);
+}
+
+
+BOOST_AUTO_TEST_CASE(PNG_RGBA_AllFilters)
+{
+	const int width = 7;
+	const int height = 10;
+	const Bytes pixels = MakeTestPixels(width * height * 4);
+
+	std::vector<int> filters;
+	for (int f = 0; f <= 4; ++f)
+		filters.push_back(f);
+
+	const Bytes png = MakePNG(width, height, 8, 6, FilterRows(pixels, width * 4, 4, filters));
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodePNG(&png[0], png.size(), img));
+	BOOST_CHECK(img.xsize == width);
+	BOOST_CHECK(img.ysize == height);
+	BOOST_CHECK(img.channels == 4);
+	BOOST_CHECK(img.pixels == pixels);
+}
+
+
+BOOST_AUTO_TEST_CASE(PNG_Gray)
+{
+	const int width = 4;
+	const int height = 4;
+	const Bytes pixels = MakeTestPixels(width * height);
+	const Bytes png = MakePNG(width, height, 8, 0, FilterRows(pixels, width, 1, std::vector<int>(1, 4)));
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodePNG(&png[0], png.size(), img));
+	BOOST_CHECK(img.channels == 1);
+	BOOST_CHECK(img.pixels == pixels);
+}
+
+
+BOOST_AUTO_TEST_CASE(PNG_Palette)
+{
+	// 2 bit indices, 5 pixels per row need 2 bytes
+	const int width = 5;
+	const int height = 2;
+	const unsigned char paletteData[] = {255, 0, 0,  0, 255, 0,  0, 0, 255,  10, 20, 30};
+	const int indices[height][width] = {{0, 1, 2, 3, 0}, {3, 3, 1, 0, 2}};
+
+	Bytes rows;
+	Bytes expected;
+
+	for (int y = 0; y < height; ++y) {
+		unsigned char packed[2] = {0, 0};
+
+		for (int x = 0; x < width; ++x) {
+			packed[x / 4] |= (indices[y][x] << (6 - 2 * (x % 4)));
+			expected.insert(expected.end(), paletteData + indices[y][x] * 3, paletteData + indices[y][x] * 3 + 3);
+		}
+
+		rows.insert(rows.end(), packed, packed + 2);
+	}
+
+	const Bytes palette(paletteData, paletteData + sizeof(paletteData));
+	const Bytes png = MakePNG(width, height, 2, 3, FilterRows(rows, 2, 1, std::vector<int>(1, 0)), palette);
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodePNG(&png[0], png.size(), img));
+	BOOST_CHECK(img.xsize == width);
+	BOOST_CHECK(img.channels == 3);
+	BOOST_CHECK(img.pixels == expected);
+}
+
+
+BOOST_AUTO_TEST_CASE(PNG_Unsupported)
+{
+	const Bytes pixels = MakeTestPixels(4 * 4 * 4);
+	const Bytes raw = FilterRows(pixels, 4 * 4, 4, std::vector<int>(1, 0));
+
+	DecodedImage img;
+
+	// interlaced
+	const Bytes interlaced = MakePNG(4, 4, 8, 6, raw, Bytes(), 1);
+	BOOST_CHECK(!ImageDecoder::DecodePNG(&interlaced[0], interlaced.size(), img));
+
+	// 16 bit gray has the same row size
+	const Bytes deep = MakePNG(4, 4, 16, 0, FilterRows(MakeTestPixels(4 * 4 * 2), 4 * 2, 2, std::vector<int>(1, 0)));
+	BOOST_CHECK(!ImageDecoder::DecodePNG(&deep[0], deep.size(), img));
+
+	// gray-alpha
+	const Bytes grayAlpha = MakePNG(4, 4, 8, 4, FilterRows(MakeTestPixels(4 * 4 * 2), 4 * 2, 2, std::vector<int>(1, 0)));
+	BOOST_CHECK(!ImageDecoder::DecodePNG(&grayAlpha[0], grayAlpha.size(), img));
+
+	// not a PNG
+	Bytes broken = MakePNG(4, 4, 8, 6, raw);
+	broken[1] = 'X';
+	BOOST_CHECK(!ImageDecoder::DecodePNG(&broken[0], broken.size(), img));
+
+	// less image data than the header announces
+	const Bytes shortData = MakePNG(4, 5, 8, 6, raw);
+	BOOST_CHECK(!ImageDecoder::DecodePNG(&shortData[0], shortData.size(), img));
+
+	// cut off in the middle of a chunk
+	const Bytes truncated = MakePNG(4, 4, 8, 6, raw);
+	BOOST_CHECK(!ImageDecoder::DecodePNG(&truncated[0], truncated.size() / 2, img));
+}
+
+
+BOOST_AUTO_TEST_CASE(TGA_BGR_BottomUp)
+{
+	const int width = 3;
+	const int height = 2;
+	const Bytes pixels = MakeTestPixels(width * height * 3);
+
+	Bytes tga = MakeTGAHeader(2, width, height, 24, 0);
+	tga.insert(tga.end(), pixels.begin(), pixels.end());
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodeTGA(&tga[0], tga.size(), img));
+	BOOST_CHECK(img.xsize == width);
+	BOOST_CHECK(img.ysize == height);
+	BOOST_CHECK(img.channels == 3);
+
+	// rows are flipped and BGR becomes RGB
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const unsigned char* src = &pixels[((height - 1 - y) * width + x) * 3];
+			const unsigned char* dst = &img.pixels[(y * width + x) * 3];
+
+			BOOST_CHECK(dst[0] == src[2]);
+			BOOST_CHECK(dst[1] == src[1]);
+			BOOST_CHECK(dst[2] == src[0]);
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(TGA_RLE_TopDown)
+{
+	const int width = 4;
+	const int height = 2;
+	const unsigned char red[4]  = {0, 0, 255, 128}; // BGRA
+	const unsigned char blue[4] = {255, 0, 0, 64};
+
+	// an ID field, then a run of 5 red pixels and 3 raw pixels
+	Bytes tga = MakeTGAHeader(10, width, height, 32, 0x20 | 8);
+	tga[0] = 3;
+	tga.insert(tga.end(), 3, 'x');
+
+	tga.push_back(0x80 | 4);
+	tga.insert(tga.end(), red, red + 4);
+	tga.push_back(2);
+	tga.insert(tga.end(), blue, blue + 4);
+	tga.insert(tga.end(), red, red + 4);
+	tga.insert(tga.end(), blue, blue + 4);
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodeTGA(&tga[0], tga.size(), img));
+	BOOST_CHECK(img.channels == 4);
+	BOOST_REQUIRE(img.pixels.size() == size_t(width * height * 4));
+
+	const unsigned char rgbaRed[4]  = {255, 0, 0, 128};
+	const unsigned char rgbaBlue[4] = {0, 0, 255, 64};
+	const unsigned char* expected[8] = {rgbaRed, rgbaRed, rgbaRed, rgbaRed, rgbaRed, rgbaBlue, rgbaRed, rgbaBlue};
+
+	for (int n = 0; n < width * height; ++n) {
+		BOOST_CHECK(memcmp(&img.pixels[n * 4], expected[n], 4) == 0);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(TGA_Gray)
+{
+	const int width = 2;
+	const int height = 2;
+	const unsigned char gray[4] = {1, 2, 3, 4};
+
+	Bytes tga = MakeTGAHeader(3, width, height, 8, 0x20);
+	tga.insert(tga.end(), gray, gray + 4);
+
+	DecodedImage img;
+	BOOST_REQUIRE(ImageDecoder::DecodeTGA(&tga[0], tga.size(), img));
+	BOOST_CHECK(img.channels == 1);
+	BOOST_CHECK(img.pixels == Bytes(gray, gray + 4));
+}
+
+
+BOOST_AUTO_TEST_CASE(TGA_Unsupported)
+{
+	const Bytes pixels = MakeTestPixels(2 * 2 * 3);
+	DecodedImage img;
+
+	// color mapped
+	Bytes mapped = MakeTGAHeader(1, 2, 2, 8, 0);
+	mapped[1] = 1;
+	mapped.insert(mapped.end(), 4, 0);
+	BOOST_CHECK(!ImageDecoder::DecodeTGA(&mapped[0], mapped.size(), img));
+
+	// right-to-left pixel order
+	Bytes mirrored = MakeTGAHeader(2, 2, 2, 24, 0x10);
+	mirrored.insert(mirrored.end(), pixels.begin(), pixels.end());
+	BOOST_CHECK(!ImageDecoder::DecodeTGA(&mirrored[0], mirrored.size(), img));
+
+	// 16 bit
+	Bytes highColor = MakeTGAHeader(2, 2, 2, 16, 0);
+	highColor.insert(highColor.end(), 8, 0);
+	BOOST_CHECK(!ImageDecoder::DecodeTGA(&highColor[0], highColor.size(), img));
+
+	// truncated raw data
+	Bytes truncated = MakeTGAHeader(2, 2, 2, 24, 0);
+	truncated.insert(truncated.end(), pixels.begin(), pixels.end() - 1);
+	BOOST_CHECK(!ImageDecoder::DecodeTGA(&truncated[0], truncated.size(), img));
+
+	// RLE packet running past the end of the file
+	Bytes truncatedRLE = MakeTGAHeader(10, 2, 2, 24, 0);
+	truncatedRLE.push_back(3);
+	truncatedRLE.insert(truncatedRLE.end(), pixels.begin(), pixels.begin() + 6);
+	BOOST_CHECK(!ImageDecoder::DecodeTGA(&truncatedRLE[0], truncatedRLE.size(), img));
+}
@@ -0,0 +1,59 @@
+function widget:GetInfo()
+return {
+	name    = "Benchmark-LuaAlloc",
+	desc    = "Churns small tables and strings every frame like a busy gadget and reports the time spent",
+	author  = "",
+	date    = "Oct. 2026",
+	license = "GNU GPL, v2 or later",
+	layer   = 0,
+	enabled = false,
+}
+end
+
+-- usage: enable this widget in any game, results are printed to infolog.txt
+-- and the engine quits when done; compare runs with the LuaPooledAllocator
+-- config tag set to 1 (size-class pools) and 0 (system allocator)
+
+local warmupFrames = 100
+local measureFrames = 1000
+local objectsPerFrame = 20000
+
+local frame = 0
+local elapsed = 0
+local keep = {}
+
+local function Churn(n)
+	-- short-lived small tables, strings and closures, the typical per-frame
+	-- garbage of unit-iterating gadgets; a few survive for a while so the
+	-- collector has to deal with a mixed heap
+	for i = 1, n do
+		local t = {i, i * 2, x = i, z = -i}
+		t.name = "unit" .. (i % 512)
+		t.cb = function() return t.x end
+
+		if (i % 64) == 0 then
+			keep[(i / 64) % 256 + 1] = t
+		end
+	end
+end
+
+function widget:Update()
+	frame = frame + 1
+
+	if frame <= warmupFrames then
+		Churn(objectsPerFrame)
+		return
+	end
+
+	local timer = Spring.GetTimer()
+	Churn(objectsPerFrame)
+	elapsed = elapsed + Spring.DiffTimers(Spring.GetTimer(), timer)
+
+	if frame < (warmupFrames + measureFrames) then
+		return
+	end
+
+	Spring.Echo(string.format("[Benchmark-LuaAlloc] LuaPooledAllocator=%i: %.3f ms/frame (%i objects/frame), %.1f KB in use",
+		Spring.GetConfigInt("LuaPooledAllocator", 1), elapsed * 1000 / measureFrames, objectsPerFrame, collectgarbage("count")))
+	Spring.SendCommands("quit")
+end
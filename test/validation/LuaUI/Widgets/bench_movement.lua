@@ -0,0 +1,128 @@
+function widget:GetInfo()
+return {
+	name    = "Benchmark-Movement",
+	desc    = "Spawns a large army, keeps it moving and compares sim frame times with serial and parallel movetype updates",
+	author  = "",
+	date    = "Oct. 2026",
+	license = "GNU GPL, v2 or later",
+	layer   = 0,
+	enabled = false,
+}
+end
+
+-- usage: enable this widget and run a game (spring-headless works, any
+-- map with enough flat space) with cheats allowed; results are printed
+-- to infolog.txt and the engine quits when done
+
+local unitName = "armpw" -- any cheap ground unit of the game
+local numUnits = 5000
+local warmupFrames = 300
+local orderInterval = 2 * Game.gameSpeed
+
+-- the modes are measured in alternating windows on the same (still
+-- moving) army, so both see the same mix of clumped and spread-out
+-- units; within each pair of windows both get the same move targets
+-- and the mode that goes first alternates
+local modes = {
+	{ name = "serial",   command = "parallelmovetypes 0" },
+	{ name = "parallel", command = "parallelmovetypes 1" },
+}
+local numPairs = 5
+local windowFrames = 3 * orderInterval
+-- frames at the start of a window that are not timed (the mode switch
+-- is a synced command and takes a few frames to come into effect)
+local settleFrames = 10
+local randomSeed = 1234
+
+local window = 0
+local windowStartFrame = 0
+local windowTimer
+local times = { 0, 0 }
+local timedFrames = { 0, 0 }
+
+local function WindowMode(w)
+	local pair = math.floor((w - 1) / 2)
+	local first = (pair % 2) + 1
+	if (w % 2) == 1 then
+		return first
+	end
+	return 3 - first
+end
+
+local function GiveRandomMoveOrders()
+	local units = Spring.GetTeamUnits(Spring.GetMyTeamID())
+	local sizeX = Game.mapSizeX
+	local sizeZ = Game.mapSizeZ
+
+	for i = 1, #units do
+		local x = math.random(sizeX * 0.1, sizeX * 0.9)
+		local z = math.random(sizeZ * 0.1, sizeZ * 0.9)
+		Spring.GiveOrderToUnit(units[i], CMD.MOVE, {x, Spring.GetGroundHeight(x, z), z}, {})
+	end
+end
+
+local function StartWindow(w, frame)
+	window = w
+	windowStartFrame = frame
+	windowTimer = nil
+	Spring.SendCommands(modes[WindowMode(w)].command)
+
+	-- both windows of a pair draw the same sequence of targets
+	math.randomseed(randomSeed + math.floor((w - 1) / 2))
+	GiveRandomMoveOrders()
+end
+
+function widget:GameFrame(n)
+	if n == 1 then
+		local x = Game.mapSizeX * 0.5
+		local z = Game.mapSizeZ * 0.5
+
+		Spring.SendCommands("setmaxspeed 1000", "setminspeed 1000", "cheat 1")
+		Spring.SendCommands(string.format("give %i %s @%i,%i,%i", numUnits, unitName, x, Spring.GetGroundHeight(x, z), z))
+		return
+	end
+
+	if window == 0 then
+		if (n % orderInterval) == 0 then
+			GiveRandomMoveOrders()
+		end
+		if n == warmupFrames then
+			StartWindow(1, n)
+		end
+		return
+	end
+
+	local age = n - windowStartFrame
+
+	if age > 0 and (age % orderInterval) == 0 and age < windowFrames then
+		GiveRandomMoveOrders()
+	end
+
+	if age == settleFrames then
+		windowTimer = Spring.GetTimer()
+		return
+	end
+
+	if age < windowFrames then
+		return
+	end
+
+	local mode = WindowMode(window)
+	times[mode] = times[mode] + Spring.DiffTimers(Spring.GetTimer(), windowTimer)
+	timedFrames[mode] = timedFrames[mode] + (windowFrames - settleFrames)
+
+	if window < (numPairs * 2) then
+		StartWindow(window + 1, n)
+		return
+	end
+
+	local results = {}
+
+	for m = 1, #modes do
+		results[m] = times[m] * 1000 / timedFrames[m]
+		Spring.Echo(string.format("[Benchmark-Movement] %s: %.3f ms/frame (%i units, %i frames)", modes[m].name, results[m], #Spring.GetAllUnits(), timedFrames[m]))
+	end
+
+	Spring.Echo(string.format("[Benchmark-Movement] parallel/serial frame time ratio: %.3f", results[2] / results[1]))
+	Spring.SendCommands("quit")
+end